@@ -136,6 +136,9 @@ struct Settings {
   std::optional<std::vector<std::string>> trace_skia_allowlist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // Report the memory retained by the DisplayLists of each frame to the
+  // timeline. Collecting it walks every op of every list in the frame.
+  bool trace_display_list_memory = false;
   bool enable_timeline_event_handler = true;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
@@ -259,6 +262,23 @@ struct Settings {
   // calls in this callback will cause applications to jank.
   LogMessageCallback log_message_callback;
   bool enable_software_rendering = false;
+  // Render large frames into software surfaces in parallel tiles on the
+  // concurrent worker threads of the VM.
+  bool enable_software_tiled_rasterization = false;
+  // Rasterize raster cache entries for software frames on the concurrent
+  // worker threads of the VM instead of during preroll.
+  bool enable_async_raster_cache = false;
+  // Preroll the children of layers with many children in parallel on the
+  // concurrent worker threads of the VM, for frames that are rendered in
+  // software without platform views.
+  bool enable_parallel_preroll = false;
+  // Reuse the Preroll and Paint of layer subtrees that are retained
+  // unchanged from the previous frame, see |Layer::PrerollOrReuse|.
+  bool enable_retained_subtree_reuse = false;
+  // The path of a table of DisplayList op costs measured on this device,
+  // which replaces the built in estimates used to decide which pictures
+  // the raster cache should cache. See display_list_complexity_calibrated.h.
+  std::string complexity_cost_table_path;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
@@ -2,10 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <type_traits>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/display_list/display_list_hash.h"
 #include "flutter/display_list/display_list_ops.h"
 #include "flutter/display_list/display_list_utils.h"
 #include "flutter/fml/trace_event.h"
@@ -33,27 +35,39 @@ DisplayList::DisplayList()
       unique_id_(0),
       bounds_({0, 0, 0, 0}),
       bounds_cull_({0, 0, 0, 0}),
-      can_apply_group_opacity_(true) {}
+      can_apply_group_opacity_(true),
+      has_image_filtered_layers_(false),
+      rtree_(nullptr) {
+  ComputeContentHash();
+}
 
-DisplayList::DisplayList(uint8_t* ptr,
+DisplayList::DisplayList(DisplayListStorage&& storage,
                          size_t byte_count,
                          unsigned int op_count,
                          size_t nested_byte_count,
                          unsigned int nested_op_count,
                          const SkRect& cull_rect,
-                         bool can_apply_group_opacity)
-    : storage_(ptr),
+                         bool can_apply_group_opacity,
+                         bool has_image_filtered_layers,
+                         bool prepare_rtree)
+    : storage_(std::move(storage)),
       byte_count_(byte_count),
       op_count_(op_count),
       nested_byte_count_(nested_byte_count),
       nested_op_count_(nested_op_count),
       bounds_({0, 0, -1, -1}),
       bounds_cull_(cull_rect),
-      can_apply_group_opacity_(can_apply_group_opacity) {
+      can_apply_group_opacity_(can_apply_group_opacity),
+      has_image_filtered_layers_(has_image_filtered_layers),
+      rtree_(nullptr) {
   static std::atomic<uint32_t> nextID{1};
   do {
     unique_id_ = nextID.fetch_add(+1, std::memory_order_relaxed);
   } while (unique_id_ == 0);
+  ComputeContentHash();
+  if (prepare_rtree) {
+    ComputeRTree();
+  }
 }
 
 DisplayList::~DisplayList() {
@@ -67,28 +81,163 @@ void DisplayList::ComputeBounds() {
   bounds_ = calculator.bounds();
 }
 
-void DisplayList::Dispatch(Dispatcher& dispatcher,
-                           uint8_t* ptr,
-                           uint8_t* end) const {
-  TRACE_EVENT0("flutter", "DisplayList::Dispatch");
+void DisplayList::ComputeContentHash() {
+  TRACE_EVENT0("flutter", "DisplayList::ComputeContentHash");
+  // The hash covers the same op data that |Equals| compares. It is
+  // computed here rather than as each op is recorded because the
+  // builder still modifies some ops after they have been recorded,
+  // such as when it extends a batch of rects or updates the options
+  // of a saveLayer when it is restored.
+  DisplayListHasher hasher;
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
   while (ptr < end) {
     auto op = reinterpret_cast<const DLOp*>(ptr);
     ptr += op->size;
     FML_DCHECK(ptr <= end);
+    bool hashed;
     switch (op->type) {
+#define DL_OP_HASH(name)                                     \
+  case DisplayListOpType::k##name:                           \
+    hashed = static_cast<const name##Op*>(op)->hash(hasher); \
+    break;
+
+      FOR_EACH_DISPLAY_LIST_OP(DL_OP_HASH)
+
+#undef DL_OP_HASH
+
+      default:
+        FML_DCHECK(false);
+        hashed = false;
+        break;
+    }
+    if (hashed) {
+      hasher.Add<DisplayListOpType>(op->type);
+      hasher.Add<uint32_t>(op->size);
+    } else {
+      hasher.AddBytes(op, op->size);
+    }
+  }
+  content_hash_ = hasher.Finish();
+}
+
+DisplayListMemoryUsage DisplayList::MemoryUsage() const {
+  DisplayListMemoryAccountant accountant;
+  accountant.AddDisplayList(this);
+  return accountant.usage();
+}
+
+void DisplayList::AccountMemory(DisplayListMemoryAccountant& accountant) const {
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    switch (op->type) {
+#define DL_OP_ACCOUNT_MEMORY(name)                               \
+  case DisplayListOpType::k##name:                               \
+    static_cast<const name##Op*>(op)->AccountMemory(accountant); \
+    break;
+
+      FOR_EACH_DISPLAY_LIST_OP(DL_OP_ACCOUNT_MEMORY)
+
+#undef DL_OP_ACCOUNT_MEMORY
+
+      default:
+        FML_DCHECK(false);
+        break;
+    }
+  }
+}
+
+// Dispatches a single op. This is the body of the dispatch loops below,
+// factored out so that the full and the culled dispatch loops share it.
+static inline void DispatchOneOp(Dispatcher& dispatcher, const DLOp* op) {
+  switch (op->type) {
 #define DL_OP_DISPATCH(name)                                \
   case DisplayListOpType::k##name:                          \
     static_cast<const name##Op*>(op)->dispatch(dispatcher); \
     break;
 
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
 
 #undef DL_OP_DISPATCH
 
-      default:
-        FML_DCHECK(false);
-        return;
+    default:
+      FML_DCHECK(false);
+      return;
+  }
+}
+
+void DisplayList::ComputeRTree() {
+  // The rtree is computed from the same bounds calculations that produce
+  // the overall bounds so we fill in both at the same time.
+  DisplayListBoundsCalculator calculator(&bounds_cull_);
+  std::vector<SkRect> op_rects;
+  op_rects.reserve(op_count_);
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    if (IsRenderingOp(op->type)) {
+      calculator.ResetOpBounds();
+      DispatchOneOp(calculator, op);
+      op_rects.push_back(calculator.op_bounds());
+    } else {
+      DispatchOneOp(calculator, op);
+    }
+  }
+  bounds_ = calculator.bounds();
+  rtree_ = SkRTreeFactory()();
+  // Empty rects are never returned from a search so ops that were
+  // clipped out or have no visible extent will never be dispatched
+  // by the culling |Dispatch| method.
+  rtree_->insert(op_rects.data(), op_rects.size());
+}
+
+void DisplayList::Dispatch(Dispatcher& dispatcher,
+                           uint8_t* ptr,
+                           uint8_t* end) const {
+  TRACE_EVENT0("flutter", "DisplayList::Dispatch");
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    DispatchOneOp(dispatcher, op);
+  }
+}
+
+void DisplayList::Dispatch(Dispatcher& dispatcher,
+                           const SkRect& cull_rect) const {
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  // The bounds are always computed along with the rtree so we can
+  // check |bounds_| directly here.
+  if (!rtree_ || cull_rect.contains(bounds_)) {
+    Dispatch(dispatcher, ptr, end);
+    return;
+  }
+  TRACE_EVENT0("flutter", "DisplayList::Dispatch (culled)");
+  std::vector<int> visible_ops;
+  rtree_->search(cull_rect, &visible_ops);
+  std::sort(visible_ops.begin(), visible_ops.end());
+  auto next_visible = visible_ops.begin();
+  int rendering_op_index = 0;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    if (IsRenderingOp(op->type)) {
+      if (next_visible == visible_ops.end() ||
+          *next_visible != rendering_op_index++) {
+        continue;
+      }
+      ++next_visible;
     }
+    DispatchOneOp(dispatcher, op);
   }
 }
 
@@ -193,7 +342,11 @@ void DisplayList::RenderTo(DisplayListBuilder* builder,
 
 void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
   DisplayListCanvasDispatcher dispatcher(canvas, opacity);
-  Dispatch(dispatcher);
+  if (rtree_) {
+    Dispatch(dispatcher, canvas->getLocalClipBounds());
+  } else {
+    Dispatch(dispatcher);
+  }
 }
 
 bool DisplayList::Equals(const DisplayList* other) const {
@@ -208,6 +361,9 @@ bool DisplayList::Equals(const DisplayList* other) const {
   if (ptr == o_ptr) {
     return true;
   }
+  if (content_hash_ != other->content_hash_) {
+    return false;
+  }
   return CompareOps(ptr, ptr + byte_count_, o_ptr, o_ptr + other->byte_count_);
 }
 
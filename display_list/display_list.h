@@ -5,10 +5,14 @@
 #ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 #define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 
+#include <mutex>
 #include <optional>
 
+#include "flutter/display_list/display_list_memory_usage.h"
+#include "flutter/display_list/display_list_storage.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
 
 // The Flutter DisplayList mechanism encapsulates a persistent sequence of
 // rendering operations.
@@ -120,6 +124,7 @@ namespace flutter {
                                     \
   V(DrawLine)                       \
   V(DrawRect)                       \
+  V(DrawRects)                      \
   V(DrawOval)                       \
   V(DrawCircle)                     \
   V(DrawRRect)                      \
@@ -136,6 +141,7 @@ namespace flutter {
   V(DrawImage)                      \
   V(DrawImageWithAttr)              \
   V(DrawImageRect)                  \
+  V(DrawImageRects)                 \
   V(DrawImageNine)                  \
   V(DrawImageNineWithAttr)          \
   V(DrawImageLattice)               \
@@ -150,6 +156,11 @@ namespace flutter {
   V(DrawShadow)                     \
   V(DrawShadowTransparentOccluder)
 
+// All of the rendering ops (those that actually produce pixels) must
+// appear at the end of the list above, starting with |DrawPaint|, so
+// that they can be recognized by a single comparison of their type.
+// See |DisplayList::IsRenderingOp|.
+
 #define DL_OP_TO_ENUM_VALUE(name) k##name,
 enum class DisplayListOpType { FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_ENUM_VALUE) };
 #undef DL_OP_TO_ENUM_VALUE
@@ -226,6 +237,15 @@ class DisplayList : public SkRefCnt {
     Dispatch(ctx, ptr, ptr + byte_count_);
   }
 
+  // Dispatches only those rendering ops whose bounds intersect the
+  // indicated |cull_rect|. All attribute, transform, clip, save and
+  // restore ops are still dispatched so that the rendering ops which
+  // are dispatched see the same state that they would see in a full
+  // dispatch. The culling relies on the per-op bounds index which is
+  // only available if the DisplayList was built with |prepare_rtree|
+  // set to true, otherwise this method performs a full dispatch.
+  void Dispatch(Dispatcher& ctx, const SkRect& cull_rect) const;
+
   void RenderTo(DisplayListBuilder* builder,
                 SkScalar opacity = SK_Scalar1) const;
 
@@ -245,12 +265,27 @@ class DisplayList : public SkRefCnt {
 
   uint32_t unique_id() const { return unique_id_; }
 
+  // Reports the memory retained by this list, including nested lists and
+  // the images, paths and other objects that its ops refer to, which are
+  // not included in |bytes|. The ops are walked on every call.
+  DisplayListMemoryUsage MemoryUsage() const;
+
+  // A hash of the ops in this list that is computed when the list is
+  // built. Lists that are |Equals| always have the same content hash, so
+  // it can stand in for a deep comparison wherever an occasional false
+  // match from a 64-bit hash collision is acceptable.
+  uint64_t content_hash() const { return content_hash_; }
+
+  // The bounds are computed on first use, which may happen on several
+  // threads at once when layers are prerolled in parallel.
   const SkRect& bounds() {
-    if (bounds_.width() < 0.0) {
-      // ComputeBounds() will leave the variable with a
-      // non-negative width and height
-      ComputeBounds();
-    }
+    std::call_once(bounds_once_, [this] {
+      if (bounds_.width() < 0.0) {
+        // ComputeBounds() will leave the variable with a
+        // non-negative width and height
+        ComputeBounds();
+      }
+    });
     return bounds_;
   }
 
@@ -262,18 +297,38 @@ class DisplayList : public SkRefCnt {
 
   bool can_apply_group_opacity() { return can_apply_group_opacity_; }
 
+  // Whether any saveLayer in this list, or in the lists nested within it,
+  // applies an ImageFilter to its contents. Such layers sample their
+  // contents outside of the area that they are rendered into.
+  bool has_image_filtered_layers() const {
+    return has_image_filtered_layers_;
+  }
+
+  // The spatial index of the bounds of the rendering ops in this list,
+  // or null if the list was not built with |prepare_rtree| set to true.
+  // The indices stored in the rtree count only the rendering ops in the
+  // order in which they appear in the list.
+  sk_sp<const SkBBoxHierarchy> rtree() const { return rtree_; }
+  bool has_rtree() const { return rtree_ != nullptr; }
+
   static void DisposeOps(uint8_t* ptr, uint8_t* end);
 
+  static bool IsRenderingOp(DisplayListOpType type) {
+    return type >= DisplayListOpType::kDrawPaint;
+  }
+
  private:
-  DisplayList(uint8_t* ptr,
+  DisplayList(DisplayListStorage&& storage,
               size_t byte_count,
               unsigned int op_count,
               size_t nested_byte_count,
               unsigned int nested_op_count,
               const SkRect& cull_rect,
-              bool can_apply_group_opacity);
+              bool can_apply_group_opacity,
+              bool has_image_filtered_layers,
+              bool prepare_rtree);
 
-  std::unique_ptr<uint8_t, SkFunctionWrapper<void(void*), sk_free>> storage_;
+  DisplayListStorage storage_;
   size_t byte_count_;
   unsigned int op_count_;
 
@@ -281,17 +336,28 @@ class DisplayList : public SkRefCnt {
   unsigned int nested_op_count_;
 
   uint32_t unique_id_;
+  uint64_t content_hash_;
   SkRect bounds_;
+  std::once_flag bounds_once_;
 
   // Only used for drawPaint() and drawColor()
   SkRect bounds_cull_;
 
   bool can_apply_group_opacity_;
+  bool has_image_filtered_layers_;
+
+  sk_sp<SkBBoxHierarchy> rtree_;
 
   void ComputeBounds();
+  void ComputeRTree();
+  void ComputeContentHash();
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const;
   void Dispatch(Dispatcher& ctx, uint8_t* ptr, uint8_t* end) const;
 
   friend class DisplayListBuilder;
+  friend class DisplayListMemoryAccountant;
+  friend class DisplayListOptimizer;
+  friend class DisplayListSerializer;
 };
 
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/display_list/display_list_benchmarks.h"
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_complexity_calibrated.h"
 #include "flutter/display_list/display_list_flags.h"
 
 #include "third_party/skia/include/core/SkPoint.h"
@@ -74,6 +75,69 @@ void AnnotateAttributes(unsigned attributes,
   }
 }
 
+// Tallies the calls to one kind of op in a DisplayList along with their
+// cost units, as defined by DisplayListCostTable.
+class CostUnitsProfiler : public CostUnitsHelper {
+ public:
+  explicit CostUnitsProfiler(DisplayListCostTable::Op op)
+      : CostUnitsHelper(std::numeric_limits<unsigned int>::max()), op_(op) {}
+
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override {
+    display_list->Dispatch(*this);
+  }
+
+  size_t calls() const { return calls_; }
+  double units() const { return units_; }
+  DisplayListCostTable::Style style() const { return style_; }
+  bool anti_alias() const { return anti_alias_; }
+
+ protected:
+  void AccumulateCost(DisplayListCostTable::Op op,
+                      DisplayListCostTable::Style style,
+                      bool anti_alias,
+                      double units) override {
+    if (op != op_) {
+      return;
+    }
+    if (calls_ == 0) {
+      style_ = style;
+      anti_alias_ = anti_alias;
+    }
+    calls_++;
+    units_ += units;
+  }
+
+ private:
+  const DisplayListCostTable::Op op_;
+  size_t calls_ = 0;
+  double units_ = 0;
+  DisplayListCostTable::Style style_ = DisplayListCostTable::Style::kFill;
+  bool anti_alias_ = false;
+};
+
+// Labels the benchmark with the DisplayListCostTable entry that it
+// measures and records the number of calls to the op and their total
+// cost units. The --cost-table option of displaylist_benchmark_parser.py
+// fits the costs in the table to these values and the measured times.
+//
+// The time of each benchmark is attributed entirely to |op|, so any
+// other ops in the DisplayList should be cheap in comparison.
+void AnnotateCostUnits(benchmark::State& state,
+                       const std::string& backend_name,
+                       const sk_sp<DisplayList>& display_list,
+                       DisplayListCostTable::Op op) {
+  CostUnitsProfiler profiler(op);
+  display_list->Dispatch(profiler);
+  if (profiler.calls() == 0) {
+    return;
+  }
+  state.SetLabel(backend_name + " " + DisplayListCostTable::OpName(op) + " " +
+                 DisplayListCostTable::StyleName(profiler.style()) + " " +
+                 (profiler.anti_alias() ? "AA" : "NoAA"));
+  state.counters["CostCalls"] = profiler.calls();
+  state.counters["CostUnits"] = profiler.units();
+}
+
 // Constants chosen to produce benchmark results in the region of 1-50ms
 constexpr size_t kLinesToDraw = 10000;
 constexpr size_t kRectsToDraw = 5000;
@@ -112,12 +176,16 @@ void BM_DrawLine(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawLine);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawLine-" +
                   std::to_string(state.range(0)) + ".png";
@@ -160,18 +228,80 @@ void BM_DrawRect(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawRect);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawRect-" +
                   std::to_string(state.range(0)) + ".png";
   canvas_provider->Snapshot(filename);
 }
 
+// Draws a grid of `state.range(0)` small rects across a fixed size canvas
+// so that the cost per rect is dominated by dispatch rather than by
+// rasterization.
+//
+// When `batched` is true the rects are recorded back to back and end up
+// in a single DrawRectsOp. Otherwise the color alternates between two
+// nearly identical values after every rect so that each rect is recorded
+// and dispatched as its own DrawRectOp.
+void BM_DrawRectBatch(benchmark::State& state,
+                      BackendType backend_type,
+                      unsigned attributes,
+                      bool batched) {
+  auto canvas_provider = CreateCanvasProvider(backend_type);
+  DisplayListBuilder builder;
+  builder.setAttributesFromPaint(GetPaintForRun(attributes),
+                                 DisplayListOpFlags::kDrawRectFlags);
+  AnnotateAttributes(attributes, state, DisplayListOpFlags::kDrawRectFlags);
+
+  size_t rect_count = state.range(0);
+  canvas_provider->InitializeSurface(kFixedCanvasSize, kFixedCanvasSize);
+  auto canvas = canvas_provider->GetSurface()->getCanvas();
+
+  const size_t kRectSize = 8;
+  const size_t kRectsPerRow = kFixedCanvasSize / kRectSize;
+  const SkColor kColors[] = {SK_ColorBLUE, SK_ColorBLUE - 1};
+
+  state.counters["DrawCallCount"] = rect_count;
+  for (size_t i = 0; i < rect_count; i++) {
+    if (!batched) {
+      builder.setColor(kColors[i & 1]);
+    }
+    size_t cell = i % (kRectsPerRow * kRectsPerRow);
+    builder.drawRect(SkRect::MakeXYWH((cell % kRectsPerRow) * kRectSize,
+                                      (cell / kRectsPerRow) * kRectSize,
+                                      kRectSize - 2, kRectSize - 2));
+  }
+
+  auto display_list = builder.Build();
+  state.counters["ByteCount"] = display_list->bytes();
+
+  // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
+  for ([[maybe_unused]] auto _ : state) {
+    display_list->RenderTo(canvas);
+    canvas_provider->GetSurface()->flushAndSubmit(true);
+  }
+  canvas_provider->StopCounters(state);
+  // Reports the cost per rect as the inverse of the rects per second.
+  state.counters["TimePerRect"] = benchmark::Counter(
+      rect_count, benchmark::Counter::kIsIterationInvariantRate |
+                      benchmark::Counter::kInvert);
+
+  auto filename = canvas_provider->BackendName() + "-DrawRectBatch-" +
+                  (batched ? "Batched-" : "Unbatched-") +
+                  std::to_string(state.range(0)) + ".png";
+  canvas_provider->Snapshot(filename);
+}
+
 // Draws a series of ovals of the requested height with aspect ratio 3:2 across
 // the canvas and repeats until `kOvalsToDraw` ovals have been drawn.
 //
@@ -205,12 +335,16 @@ void BM_DrawOval(benchmark::State& state,
     }
   }
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawOval);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawOval-" +
                   std::to_string(state.range(0)) + ".png";
@@ -252,12 +386,16 @@ void BM_DrawCircle(benchmark::State& state,
     }
   }
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawCircle);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawCircle-" +
                   std::to_string(state.range(0)) + ".png";
@@ -329,12 +467,16 @@ void BM_DrawRRect(benchmark::State& state,
     }
   }
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawRRect);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawRRect-" +
                   std::to_string(state.range(0)) + ".png";
@@ -410,12 +552,16 @@ void BM_DrawDRRect(benchmark::State& state,
     }
   }
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawDRRect);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawDRRect-" +
                   std::to_string(state.range(0)) + ".png";
@@ -462,12 +608,16 @@ void BM_DrawArc(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawArc);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawArc-" +
                   std::to_string(state.range(0)) + ".png";
@@ -664,12 +814,16 @@ void BM_DrawPath(benchmark::State& state,
 
   builder.drawPath(path);
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawPath);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawPath-" + label + "-" +
                   std::to_string(state.range(0)) + ".png";
@@ -809,12 +963,16 @@ void BM_DrawVertices(benchmark::State& state,
   state.SetComplexityN(total_vertex_count);
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawVertices);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawVertices-" +
                   std::to_string(disc_count) + "-" + VertexModeToString(mode) +
@@ -913,11 +1071,15 @@ void BM_DrawPoints(benchmark::State& state,
   builder.drawPoints(mode, points.size(), points.data());
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawPoints);
 
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawPoints-" +
                   PointModeToString(mode) + "-" + std::to_string(point_count) +
@@ -987,11 +1149,15 @@ void BM_DrawImage(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawImage);
 
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawImage-" +
                   (upload_bitmap ? "Upload-" : "Texture-") +
@@ -1070,11 +1236,15 @@ void BM_DrawImageRect(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawImageRect);
 
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawImageRect-" +
                   (upload_bitmap ? "Upload-" : "Texture-") +
@@ -1154,11 +1324,15 @@ void BM_DrawImageNine(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawImageNine);
 
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawImageNine-" +
                   (upload_bitmap ? "Upload-" : "Texture-") +
@@ -1199,11 +1373,15 @@ void BM_DrawTextBlob(benchmark::State& state,
   }
 
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawTextBlob);
 
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawTextBlob-" +
                   std::to_string(draw_calls) + ".png";
@@ -1262,12 +1440,16 @@ void BM_DrawShadow(benchmark::State& state,
   // ever used in conjunction with elevation.
   builder.drawShadow(path, SK_ColorBLUE, elevation, transparent_occluder, 1.0f);
   auto display_list = builder.Build();
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kDrawShadow);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-DrawShadow-" +
                   VerbToString(type) + "-" +
@@ -1315,12 +1497,18 @@ void BM_SaveLayer(benchmark::State& state,
     }
   }
   auto display_list = builder.Build();
+  // The cost measured for each saveLayer includes drawing the two rects
+  // into the layer.
+  AnnotateCostUnits(state, canvas_provider->BackendName(), display_list,
+                    DisplayListCostTable::Op::kSaveLayer);
 
   // We only want to time the actual rasterization.
+  canvas_provider->StartCounters();
   for ([[maybe_unused]] auto _ : state) {
     display_list->RenderTo(canvas);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
+  canvas_provider->StopCounters(state);
 
   auto filename = canvas_provider->BackendName() + "-SaveLayer-" +
                   std::to_string(save_depth) + "-" +
@@ -1328,5 +1516,45 @@ void BM_SaveLayer(benchmark::State& state,
   canvas_provider->Snapshot(filename);
 }
 
+// Records a frame worth of DisplayLists per iteration, each holding
+// state.range(0) ops, and releases them before the next frame as the
+// framework would after rasterizing them.
+//
+// The storage for the ops is either recycled through a pool that
+// retains the blocks of the previous frame, or allocated from the heap
+// for every list. The number of blocks that had to be obtained from
+// the heap is reported per frame.
+void BM_RecordFrames(benchmark::State& state, bool pooled_storage) {
+  constexpr size_t kListsPerFrame = 4;
+  size_t op_count = state.range(0);
+  auto pool = std::make_shared<DisplayListStoragePool>(
+      pooled_storage ? DisplayListStoragePool::kDefaultMaxRetainedBytes : 0);
+
+  state.counters["DrawCallCount"] = op_count * kListsPerFrame;
+  size_t heap_allocations_before = pool->heap_allocation_count();
+  for ([[maybe_unused]] auto _ : state) {
+    std::vector<sk_sp<DisplayList>> frame;
+    for (size_t i = 0; i < kListsPerFrame; i++) {
+      DisplayListBuilder builder;
+      builder.SetStoragePool(pool);
+      for (size_t j = 0; j < op_count; j++) {
+        builder.drawRect(SkRect::MakeXYWH(j % 100, j % 50, 10, 10));
+      }
+      frame.push_back(builder.Build());
+    }
+    benchmark::DoNotOptimize(frame.data());
+  }
+  state.counters["HeapAllocationsPerFrame"] = benchmark::Counter(
+      pool->heap_allocation_count() - heap_allocations_before,
+      benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_RecordFrames, Pooled, true)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RecordFrames, Unpooled, false)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace testing
 }  // namespace flutter
@@ -49,6 +49,10 @@ void BM_DrawLine(benchmark::State& state,
 void BM_DrawRect(benchmark::State& state,
                  BackendType backend_type,
                  unsigned attributes);
+void BM_DrawRectBatch(benchmark::State& state,
+                      BackendType backend_type,
+                      unsigned attributes,
+                      bool batched);
 void BM_DrawCircle(benchmark::State& state,
                    BackendType backend_type,
                    unsigned attributes);
@@ -106,6 +110,7 @@ void BM_SaveLayer(benchmark::State& state,
                   BackendType backend_type,
                   unsigned attributes,
                   size_t save_depth);
+void BM_RecordFrames(benchmark::State& state, bool pooled_storage);
 // clang-format off
 
 // DrawLine
@@ -128,6 +133,24 @@ void BM_SaveLayer(benchmark::State& state,
       ->UseRealTime()                                                   \
       ->Unit(benchmark::kMillisecond);
 
+// DrawRectBatch
+#define DRAW_RECT_BATCH_BENCHMARKS(BACKEND, ATTRIBUTES)                 \
+  BENCHMARK_CAPTURE(BM_DrawRectBatch, Batched/BACKEND,                  \
+                    BackendType::k##BACKEND##_Backend,                  \
+                    ATTRIBUTES, true)                                   \
+      ->Arg(1000)                                                       \
+      ->Arg(10000)                                                      \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMicrosecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawRectBatch, Unbatched/BACKEND,                \
+                    BackendType::k##BACKEND##_Backend,                  \
+                    ATTRIBUTES, false)                                  \
+      ->Arg(1000)                                                       \
+      ->Arg(10000)                                                      \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMicrosecond);
+
 // DrawOval
 #define DRAW_OVAL_BENCHMARKS(BACKEND, ATTRIBUTES)                       \
   BENCHMARK_CAPTURE(BM_DrawOval, BACKEND,                               \
@@ -577,7 +600,8 @@ void BM_SaveLayer(benchmark::State& state,
   DRAW_IMAGE_NINE_BENCHMARKS(BACKEND, ATTRIBUTES)                        \
   DRAW_VERTICES_BENCHMARKS(BACKEND, ATTRIBUTES)                          \
   DRAW_SHADOW_BENCHMARKS(BACKEND, ATTRIBUTES)                            \
-  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)
+  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)                             \
+  DRAW_RECT_BATCH_BENCHMARKS(BACKEND, ATTRIBUTES)
 
 #define RUN_DISPLAYLIST_BENCHMARKS(BACKEND)                              \
   STROKE_BENCHMARKS(BACKEND, kStrokedStyle_Flag)                         \
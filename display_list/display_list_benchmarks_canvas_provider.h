@@ -8,6 +8,7 @@
 #include "flutter/fml/mapping.h"
 #include "flutter/testing/testing.h"
 
+#include "third_party/benchmark/include/benchmark/benchmark.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -23,6 +24,12 @@ class CanvasProvider {
   virtual sk_sp<SkSurface> MakeOffscreenSurface(const size_t width,
                                                 const size_t height) = 0;
 
+  // Brackets the timed loop of a benchmark. Providers that can measure
+  // the CPU cost of rendering beyond its wall time add their measurements
+  // to |state| as counters in |StopCounters|.
+  virtual void StartCounters() {}
+  virtual void StopCounters(benchmark::State& state) {}
+
   virtual bool Snapshot(std::string filename) {
 #ifdef BENCHMARKS_NO_SNAPSHOT
     return false;
@@ -0,0 +1,260 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_benchmarks_cpu_counters.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "flutter/fml/build_config.h"
+
+#if defined(FML_OS_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(FML_OS_WIN)
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Only the allocations made by the thread running the timed loop of a
+// benchmark between |CpuCounters::Start| and |CpuCounters::Stop| are
+// counted, so the setup of the benchmark and other threads of the
+// executable don't show up in the results.
+thread_local bool counting_allocations = false;
+thread_local uint64_t allocation_count = 0;
+thread_local uint64_t allocated_byte_count = 0;
+
+void* Allocate(size_t size) {
+  if (counting_allocations) {
+    allocation_count++;
+    allocated_byte_count += size;
+  }
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* AllocateAligned(size_t size, std::align_val_t alignment) {
+  if (counting_allocations) {
+    allocation_count++;
+    allocated_byte_count += size;
+  }
+  size = size == 0 ? 1 : size;
+#if defined(FML_OS_WIN)
+  return _aligned_malloc(size, static_cast<size_t>(alignment));
+#else
+  void* ptr = nullptr;
+  size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+  return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void FreeAligned(void* ptr) {
+#if defined(FML_OS_WIN)
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void* CheckAllocation(void* ptr) {
+  // The engine is built without exceptions, so std::bad_alloc can't be
+  // thrown.
+  if (!ptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+// Every replaceable form of the global operator new and delete is replaced
+// so that all of the allocations of a benchmark are counted, and memory is
+// always released by the function matching the one that allocated it.
+
+void* operator new(size_t size) {
+  return CheckAllocation(Allocate(size));
+}
+
+void* operator new[](size_t size) {
+  return CheckAllocation(Allocate(size));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return CheckAllocation(AllocateAligned(size, alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return CheckAllocation(AllocateAligned(size, alignment));
+}
+
+void* operator new(size_t size,
+                   std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size,
+                     std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+  FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+  FreeAligned(ptr);
+}
+
+void operator delete(void* ptr,
+                     size_t size,
+                     std::align_val_t alignment) noexcept {
+  FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr,
+                       size_t size,
+                       std::align_val_t alignment) noexcept {
+  FreeAligned(ptr);
+}
+
+void operator delete(void* ptr,
+                     std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr,
+                       std::align_val_t alignment,
+                       const std::nothrow_t&) noexcept {
+  FreeAligned(ptr);
+}
+
+namespace flutter {
+namespace testing {
+
+#if defined(FML_OS_LINUX)
+static int OpenHardwareCounter(uint64_t config) {
+  perf_event_attr attr = {};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Counts the calling thread on whichever CPU it runs.
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+CpuCounters::CpuCounters() {
+#if defined(FML_OS_LINUX)
+  instructions_.fd = OpenHardwareCounter(PERF_COUNT_HW_INSTRUCTIONS);
+  cache_misses_.fd = OpenHardwareCounter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+}
+
+CpuCounters::~CpuCounters() {
+#if defined(FML_OS_LINUX)
+  for (auto fd : {instructions_.fd, cache_misses_.fd}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+void CpuCounters::StartCounter(HardwareCounter& counter) {
+#if defined(FML_OS_LINUX)
+  if (counter.fd >= 0) {
+    ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+void CpuCounters::StopCounter(HardwareCounter& counter) {
+#if defined(FML_OS_LINUX)
+  if (counter.fd >= 0) {
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(counter.fd, &counter.count, sizeof(counter.count)) !=
+        sizeof(counter.count)) {
+      close(counter.fd);
+      counter.fd = -1;
+    }
+  }
+#endif
+}
+
+void CpuCounters::Start() {
+  allocations_ = allocation_count;
+  allocated_bytes_ = allocated_byte_count;
+  counting_allocations = true;
+  StartCounter(instructions_);
+  StartCounter(cache_misses_);
+}
+
+void CpuCounters::Stop() {
+  StopCounter(instructions_);
+  StopCounter(cache_misses_);
+  counting_allocations = false;
+  allocations_ = allocation_count - allocations_;
+  allocated_bytes_ = allocated_byte_count - allocated_bytes_;
+}
+
+void CpuCounters::Report(benchmark::State& state) const {
+  if (instructions_.fd >= 0) {
+    state.counters["Instructions"] = benchmark::Counter(
+        instructions_.count, benchmark::Counter::kAvgIterations);
+  }
+  if (cache_misses_.fd >= 0) {
+    state.counters["CacheMisses"] = benchmark::Counter(
+        cache_misses_.count, benchmark::Counter::kAvgIterations);
+  }
+  state.counters["Allocations"] =
+      benchmark::Counter(allocations_, benchmark::Counter::kAvgIterations);
+  state.counters["AllocatedBytes"] =
+      benchmark::Counter(allocated_bytes_, benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_CPU_COUNTERS_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_CPU_COUNTERS_H_
+
+#include <cstdint>
+
+#include "flutter/fml/macros.h"
+
+#include "third_party/benchmark/include/benchmark/benchmark.h"
+
+namespace flutter {
+namespace testing {
+
+// Measures the CPU cost of the timed loop of a benchmark beyond its wall
+// time and reports it as per iteration counters of the benchmark:
+//
+//   Instructions      instructions retired by the calling thread
+//   CacheMisses       last level cache misses of the calling thread
+//   Allocations       heap allocations made with operator new by the
+//                     calling thread
+//   AllocatedBytes    bytes requested from operator new by the calling
+//                     thread
+//
+// The hardware counters are read with perf_event_open and are only
+// available on Linux when the kernel allows access to them, see
+// /proc/sys/kernel/perf_event_paranoid. Counters that can't be opened
+// are left out of the results rather than reported as zero.
+//
+// Allocations are counted by replacing all forms of the global operator
+// new in the benchmark executable, and only while the counters of the
+// thread are started. Pixel memory that Skia allocates with sk_malloc is
+// not included, and neither are the blocks of op storage recycled through
+// a |DisplayListStoragePool|, whose own |heap_allocation_count| covers the
+// recording of DisplayLists.
+class CpuCounters {
+ public:
+  CpuCounters();
+  ~CpuCounters();
+
+  void Start();
+  void Stop();
+
+  // Adds the counts measured between |Start| and |Stop| to |state|.
+  void Report(benchmark::State& state) const;
+
+ private:
+  struct HardwareCounter {
+    int fd = -1;
+    uint64_t count = 0;
+  };
+
+  static void StartCounter(HardwareCounter& counter);
+  static void StopCounter(HardwareCounter& counter);
+
+  HardwareCounter instructions_;
+  HardwareCounter cache_misses_;
+
+  uint64_t allocations_ = 0;
+  uint64_t allocated_bytes_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(CpuCounters);
+};
+
+}  // namespace testing
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_CPU_COUNTERS_H_
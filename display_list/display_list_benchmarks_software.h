@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_SOFTWARE_H_
 
 #include "flutter/display_list/display_list_benchmarks_canvas_provider.h"
+#include "flutter/display_list/display_list_benchmarks_cpu_counters.h"
 
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -21,8 +22,15 @@ class SoftwareCanvasProvider : public CanvasProvider {
                                         const size_t height) override;
   const std::string BackendName() override { return "Software"; }
 
+  void StartCounters() override { counters_.Start(); }
+  void StopCounters(benchmark::State& state) override {
+    counters_.Stop();
+    counters_.Report(state);
+  }
+
  private:
   sk_sp<SkSurface> surface_;
+  CpuCounters counters_;
 };
 
 }  // namespace testing
@@ -9,8 +9,6 @@
 
 namespace flutter {
 
-#define DL_BUILDER_PAGE 4096
-
 // CopyV(dst, src,n, src,n, ...) copies any number of typed srcs into dst.
 static void CopyV(void* dst) {}
 
@@ -27,17 +25,15 @@ template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
   size_t size = SkAlignPtr(sizeof(T) + pod);
   FML_DCHECK(size < (1 << 24));
-  if (used_ + size > allocated_) {
-    static_assert(SkIsPow2(DL_BUILDER_PAGE),
-                  "This math needs updating for non-pow2.");
-    // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
-    storage_.realloc(allocated_);
-    FML_DCHECK(storage_.get());
-    memset(storage_.get() + used_, 0, allocated_ - used_);
-  }
-  FML_DCHECK(used_ + size <= allocated_);
+  storage_.Grow(used_, used_ + size);
+  FML_DCHECK(storage_.get());
+  FML_DCHECK(used_ + size <= storage_.capacity());
   auto op = reinterpret_cast<T*>(storage_.get() + used_);
+  // Blocks recycled through the storage pool contain stale data from
+  // previous lists, but the padding in each op must be deterministic
+  // for the bulk memcmp performed by |DisplayList::Equals|.
+  memset(op, 0, size);
+  last_op_offset_ = used_;
   used_ += size;
   new (op) T{std::forward<Args>(args)...};
   op->type = T::kType;
@@ -54,17 +50,26 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   int count = op_count_;
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
-  used_ = allocated_ = op_count_ = 0;
+  bool has_image_filtered_layers = has_image_filtered_layers_;
+  used_ = op_count_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
-  storage_.realloc(bytes);
+  has_image_filtered_layers_ = false;
+  // Blocks with little slack are handed to the DisplayList intact so
+  // that they can be returned to the pool and reused by the lists
+  // recorded in later frames, the others are trimmed so that bytes()
+  // does not hide up to half of the memory held by the list.
+  storage_.Shrink(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_, compatible));
+  return sk_sp<DisplayList>(new DisplayList(
+      std::move(storage_), bytes, count, nested_bytes, nested_count,
+      cull_rect_, compatible, has_image_filtered_layers, prepare_rtree_));
 }
 
-DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
-    : cull_rect_(cull_rect) {
+DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
+                                       bool prepare_rtree)
+    : storage_(DisplayListStoragePool::GetDefault()),
+      cull_rect_(cull_rect),
+      prepare_rtree_(prepare_rtree) {
   layer_stack_.emplace_back();
   current_layer_ = &layer_stack_.back();
 }
@@ -76,6 +81,12 @@ DisplayListBuilder::~DisplayListBuilder() {
   }
 }
 
+void DisplayListBuilder::SetStoragePool(
+    std::shared_ptr<DisplayListStoragePool> pool) {
+  FML_DCHECK(used_ == 0);
+  storage_ = DisplayListStorage(std::move(pool));
+}
+
 void DisplayListBuilder::onSetAntiAlias(bool aa) {
   current_.setAntiAlias(aa);
   Push<SetAntiAliasOp>(0, 0, aa);
@@ -464,6 +475,9 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         current_.getImageFilter() != nullptr) {
       UpdateLayerOpacityCompatibility(false);
     }
+    if (current_.getImageFilter() != nullptr) {
+      has_image_filtered_layers_ = true;
+    }
   }
 }
 void DisplayListBuilder::saveLayer(const SkRect* bounds, const DlPaint* paint) {
@@ -623,10 +637,83 @@ void DisplayListBuilder::drawLine(const SkPoint& p0,
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawLineFlags);
   drawLine(p0, p1);
 }
+void* DisplayListBuilder::GrowLastOp(size_t bytes) {
+  FML_DCHECK(used_ > 0);
+  FML_DCHECK(SkIsAlignPtr(bytes));
+  storage_.Grow(used_, used_ + bytes);
+  auto op = reinterpret_cast<DLOp*>(storage_.get() + last_op_offset_);
+  FML_DCHECK(op->size + bytes < (1 << 24));
+  op->size += bytes;
+  void* data_ptr = storage_.get() + used_;
+  used_ += bytes;
+  return data_ptr;
+}
+bool DisplayListBuilder::AppendToRectsBatch(const SkRect rects[],
+                                            uint32_t count) {
+  // The rtree holds the bounds of each op, so the union of a batch would
+  // defeat the culling of the rects that it is used for.
+  if (used_ == 0 || prepare_rtree_) {
+    return false;
+  }
+  auto op = reinterpret_cast<DLOp*>(storage_.get() + last_op_offset_);
+  if (op->type == DisplayListOpType::kDrawRect) {
+    if (count >= kMaxBatchCount) {
+      return false;
+    }
+    // The DrawRectOp is the most recent op so it can be replaced in place
+    // by a DrawRectsOp holding its rect followed by the new rects.
+    SkRect first = static_cast<DrawRectOp*>(op)->rect;
+    used_ = last_op_offset_;
+    op_count_--;
+    void* data_ptr =
+        Push<DrawRectsOp>((count + 1) * sizeof(SkRect), count + 1, count + 1);
+    CopyV(data_ptr, &first, 1, rects, count);
+    return true;
+  }
+  if (op->type == DisplayListOpType::kDrawRects) {
+    auto rects_op = static_cast<DrawRectsOp*>(op);
+    if (rects_op->count + count > kMaxBatchCount) {
+      return false;
+    }
+    // |GrowLastOp| may move the op so it must be updated first.
+    rects_op->count += count;
+    CopyV(GrowLastOp(count * sizeof(SkRect)), rects, count);
+    op_count_ += count;
+    return true;
+  }
+  return false;
+}
 void DisplayListBuilder::drawRect(const SkRect& rect) {
-  Push<DrawRectOp>(0, 1, rect);
+  if (!AppendToRectsBatch(&rect, 1)) {
+    Push<DrawRectOp>(0, 1, rect);
+  }
   CheckLayerOpacityCompatibility();
 }
+void DisplayListBuilder::drawRects(const SkRect rects[], uint32_t count) {
+  while (count > kMaxBatchCount) {
+    drawRects(rects, kMaxBatchCount);
+    rects += kMaxBatchCount;
+    count -= kMaxBatchCount;
+  }
+  if (count == 0) {
+    return;
+  }
+  if (count == 1 || prepare_rtree_) {
+    // The rects of a list with an rtree are recorded as separate ops so
+    // that each of them can be culled on its own.
+    for (uint32_t i = 0; i < count; i++) {
+      drawRect(rects[i]);
+    }
+    return;
+  }
+  if (!AppendToRectsBatch(rects, count)) {
+    void* data_ptr = Push<DrawRectsOp>(count * sizeof(SkRect), count, count);
+    CopyV(data_ptr, rects, count);
+  }
+  // As with separate drawRect calls, we cannot ensure distribution of
+  // group opacity to multiple rects without analyzing their bounds.
+  UpdateLayerOpacityCompatibility(false);
+}
 void DisplayListBuilder::drawRect(const SkRect& rect, const DlPaint& paint) {
   setAttributesFromDlPaint(paint, DisplayListOpFlags::kDrawRectFlags);
   drawRect(rect);
@@ -806,8 +893,12 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
                                        const SkSamplingOptions& sampling,
                                        bool render_with_attributes,
                                        SkCanvas::SrcRectConstraint constraint) {
-  Push<DrawImageRectOp>(0, 1, std::move(image), src, dst, sampling,
-                        render_with_attributes, constraint);
+  SkRect rects[] = {src, dst};
+  if (!AppendToImageRectsBatch(image, rects, 1, sampling,
+                               render_with_attributes, constraint)) {
+    Push<DrawImageRectOp>(0, 1, std::move(image), src, dst, sampling,
+                          render_with_attributes, constraint);
+  }
   CheckLayerOpacityCompatibility(render_with_attributes);
 }
 void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
@@ -824,6 +915,90 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
     drawImageRect(image, src, dst, sampling, false, constraint);
   }
 }
+bool DisplayListBuilder::AppendToImageRectsBatch(
+    const sk_sp<DlImage>& image,
+    const SkRect rects[],
+    uint32_t count,
+    const SkSamplingOptions& sampling,
+    bool render_with_attributes,
+    SkCanvas::SrcRectConstraint constraint) {
+  // See |AppendToRectsBatch|.
+  if (used_ == 0 || prepare_rtree_) {
+    return false;
+  }
+  auto op = reinterpret_cast<DLOp*>(storage_.get() + last_op_offset_);
+  if (op->type == DisplayListOpType::kDrawImageRect) {
+    auto image_op = static_cast<DrawImageRectOp*>(op);
+    if (count >= kMaxBatchCount || image_op->image != image ||
+        image_op->sampling != sampling ||
+        image_op->render_with_attributes != render_with_attributes ||
+        image_op->constraint != constraint) {
+      return false;
+    }
+    // The DrawImageRectOp is the most recent op so it can be replaced in
+    // place by a DrawImageRectsOp holding its rects followed by the new
+    // rects.
+    SkRect first[] = {image_op->src, image_op->dst};
+    image_op->~DrawImageRectOp();
+    used_ = last_op_offset_;
+    op_count_--;
+    void* data_ptr = Push<DrawImageRectsOp>(
+        (count + 1) * 2 * sizeof(SkRect), count + 1, image, count + 1,
+        sampling, render_with_attributes, constraint);
+    CopyV(data_ptr, first, 2, rects, count * 2);
+    return true;
+  }
+  if (op->type == DisplayListOpType::kDrawImageRects) {
+    auto image_op = static_cast<DrawImageRectsOp*>(op);
+    if (image_op->count + count > kMaxBatchCount ||
+        image_op->image != image || image_op->sampling != sampling ||
+        image_op->render_with_attributes != render_with_attributes ||
+        image_op->constraint != constraint) {
+      return false;
+    }
+    // |GrowLastOp| may move the op so it must be updated first.
+    image_op->count += count;
+    CopyV(GrowLastOp(count * 2 * sizeof(SkRect)), rects, count * 2);
+    op_count_ += count;
+    return true;
+  }
+  return false;
+}
+void DisplayListBuilder::drawImageRects(
+    const sk_sp<DlImage> image,
+    const SkRect rects[],
+    uint32_t count,
+    const SkSamplingOptions& sampling,
+    bool render_with_attributes,
+    SkCanvas::SrcRectConstraint constraint) {
+  while (count > kMaxBatchCount) {
+    drawImageRects(image, rects, kMaxBatchCount, sampling,
+                   render_with_attributes, constraint);
+    rects += kMaxBatchCount * 2;
+    count -= kMaxBatchCount;
+  }
+  if (count == 0) {
+    return;
+  }
+  if (count == 1 || prepare_rtree_) {
+    // See |drawRects|.
+    for (uint32_t i = 0; i < count; i++) {
+      drawImageRect(image, rects[i * 2], rects[i * 2 + 1], sampling,
+                    render_with_attributes, constraint);
+    }
+    return;
+  }
+  if (!AppendToImageRectsBatch(image, rects, count, sampling,
+                               render_with_attributes, constraint)) {
+    void* data_ptr = Push<DrawImageRectsOp>(count * 2 * sizeof(SkRect), count,
+                                            image, count, sampling,
+                                            render_with_attributes, constraint);
+    CopyV(data_ptr, rects, count * 2);
+  }
+  // As with separate drawImageRect calls, we cannot ensure distribution
+  // of group opacity to multiple images without analyzing their bounds.
+  UpdateLayerOpacityCompatibility(false);
+}
 void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
                                        const SkIRect& center,
                                        const SkRect& dst,
@@ -957,6 +1132,9 @@ void DisplayListBuilder::drawDisplayList(
   nested_op_count_ += display_list->op_count(true) - 1;
   nested_bytes_ += display_list->bytes(true);
   UpdateLayerOpacityCompatibility(display_list->can_apply_group_opacity());
+  if (display_list->has_image_filtered_layers()) {
+    has_image_filtered_layers_ = true;
+  }
 }
 void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
                                       SkScalar x,
@@ -12,6 +12,7 @@
 #include "flutter/display_list/display_list_flags.h"
 #include "flutter/display_list/display_list_image.h"
 #include "flutter/display_list/display_list_paint.h"
+#include "flutter/display_list/display_list_storage.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/macros.h"
 
@@ -26,10 +27,23 @@ class DisplayListBuilder final : public virtual Dispatcher,
                                  public SkRefCnt,
                                  DisplayListOpFlags {
  public:
-  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_);
+  // If |prepare_rtree| is true then the DisplayList returned from |Build|
+  // will contain a spatial index of the bounds of its rendering ops which
+  // allows it to skip the ops that fall outside of the cull rect supplied
+  // to |DisplayList::Dispatch(Dispatcher&, const SkRect&)|.
+  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_,
+                              bool prepare_rtree = false);
+  explicit DisplayListBuilder(bool prepare_rtree)
+      : DisplayListBuilder(kMaxCullRect_, prepare_rtree) {}
 
   ~DisplayListBuilder();
 
+  // Sets the pool from which this builder, and the DisplayList objects
+  // that it builds, obtain their op storage. By default all builders
+  // share |DisplayListStoragePool::GetDefault|. This method may only be
+  // called before any ops are recorded.
+  void SetStoragePool(std::shared_ptr<DisplayListStoragePool> pool);
+
   void setAntiAlias(bool aa) override {
     if (current_.isAntiAlias() != aa) {
       onSetAntiAlias(aa);
@@ -201,6 +215,9 @@ class DisplayListBuilder final : public virtual Dispatcher,
   void drawLine(const SkPoint& p0, const SkPoint& p1, const DlPaint& paint);
   void drawRect(const SkRect& rect) override;
   void drawRect(const SkRect& rect, const DlPaint& paint);
+  // Consecutive rects drawn with the same attributes, whether through
+  // |drawRect| or |drawRects|, are recorded into a single batched op.
+  void drawRects(const SkRect rects[], uint32_t count) override;
   void drawOval(const SkRect& bounds) override;
   void drawOval(const SkRect& bounds, const DlPaint& paint);
   void drawCircle(const SkPoint& center, SkScalar radius) override;
@@ -267,6 +284,15 @@ class DisplayListBuilder final : public virtual Dispatcher,
                      const DlPaint* paint = nullptr,
                      SkCanvas::SrcRectConstraint constraint =
                          SkCanvas::SrcRectConstraint::kFast_SrcRectConstraint);
+  // Consecutive image rects drawn from the same image with the same
+  // attributes, sampling and constraint, whether through |drawImageRect|
+  // or |drawImageRects|, are recorded into a single batched op.
+  void drawImageRects(const sk_sp<DlImage> image,
+                      const SkRect rects[],
+                      uint32_t count,
+                      const SkSamplingOptions& sampling,
+                      bool render_with_attributes,
+                      SkCanvas::SrcRectConstraint constraint) override;
   void drawImageNine(const sk_sp<DlImage> image,
                      const SkIRect& center,
                      const SkRect& dst,
@@ -316,9 +342,8 @@ class DisplayListBuilder final : public virtual Dispatcher,
   sk_sp<DisplayList> Build();
 
  private:
-  SkAutoTMalloc<uint8_t> storage_;
+  DisplayListStorage storage_;
   size_t used_ = 0;
-  size_t allocated_ = 0;
   int op_count_ = 0;
 
   // bytes and ops from |drawPicture| and |drawDisplayList|
@@ -326,12 +351,37 @@ class DisplayListBuilder final : public virtual Dispatcher,
   int nested_op_count_ = 0;
 
   SkRect cull_rect_;
+  bool prepare_rtree_;
+  bool has_image_filtered_layers_ = false;
   static constexpr SkRect kMaxCullRect_ =
       SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 
   template <typename T, typename... Args>
   void* Push(size_t extra, int op_inc, Args&&... args);
 
+  // The offset of the most recently pushed op, only valid if |used_| is
+  // not 0. Batched draw ops can only be extended while they are the most
+  // recent op since any intervening op might change their rendering.
+  size_t last_op_offset_ = 0;
+
+  // The maximum number of draws coalesced into a single batched op.
+  static constexpr uint32_t kMaxBatchCount = 1 << 16;
+
+  // Appends the indicated draws to the most recent op if it is a
+  // compatible DrawRect(s) or DrawImageRect(s) op, returning false if
+  // a new op must be recorded instead. Draws are never batched when an
+  // rtree is prepared.
+  bool AppendToRectsBatch(const SkRect rects[], uint32_t count);
+  bool AppendToImageRectsBatch(const sk_sp<DlImage>& image,
+                               const SkRect rects[],
+                               uint32_t count,
+                               const SkSamplingOptions& sampling,
+                               bool render_with_attributes,
+                               SkCanvas::SrcRectConstraint constraint);
+  // Grows the most recent op by |bytes| and returns a pointer to the
+  // newly added bytes at its end.
+  void* GrowLastOp(size_t bytes);
+
   void setAttributesFromDlPaint(const DlPaint& paint,
                                 const DisplayListAttributeFlags flags);
 
@@ -145,6 +145,13 @@ void DisplayListCanvasDispatcher::drawLine(const SkPoint& p0,
 void DisplayListCanvasDispatcher::drawRect(const SkRect& rect) {
   canvas_->drawRect(rect, paint());
 }
+void DisplayListCanvasDispatcher::drawRects(const SkRect rects[],
+                                            uint32_t count) {
+  const SkPaint& sk_paint = paint();
+  for (uint32_t i = 0; i < count; i++) {
+    canvas_->drawRect(rects[i], sk_paint);
+  }
+}
 void DisplayListCanvasDispatcher::drawOval(const SkRect& bounds) {
   canvas_->drawOval(bounds, paint());
 }
@@ -200,6 +207,20 @@ void DisplayListCanvasDispatcher::drawImageRect(
                          sampling, safe_paint(render_with_attributes),
                          constraint);
 }
+void DisplayListCanvasDispatcher::drawImageRects(
+    const sk_sp<DlImage> image,
+    const SkRect rects[],
+    uint32_t count,
+    const SkSamplingOptions& sampling,
+    bool render_with_attributes,
+    SkCanvas::SrcRectConstraint constraint) {
+  sk_sp<SkImage> skia_image = image ? image->skia_image() : nullptr;
+  const SkPaint* sk_paint = safe_paint(render_with_attributes);
+  for (uint32_t i = 0; i < count; i++) {
+    canvas_->drawImageRect(skia_image, rects[i * 2], rects[i * 2 + 1],
+                           sampling, sk_paint, constraint);
+  }
+}
 void DisplayListCanvasDispatcher::drawImageNine(const sk_sp<DlImage> image,
                                                 const SkIRect& center,
                                                 const SkRect& dst,
@@ -57,6 +57,7 @@ class DisplayListCanvasDispatcher : public virtual Dispatcher,
   void drawColor(DlColor color, DlBlendMode mode) override;
   void drawLine(const SkPoint& p0, const SkPoint& p1) override;
   void drawRect(const SkRect& rect) override;
+  void drawRects(const SkRect rects[], uint32_t count) override;
   void drawOval(const SkRect& bounds) override;
   void drawCircle(const SkPoint& center, SkScalar radius) override;
   void drawRRect(const SkRRect& rrect) override;
@@ -82,6 +83,12 @@ class DisplayListCanvasDispatcher : public virtual Dispatcher,
                      const SkSamplingOptions& sampling,
                      bool render_with_attributes,
                      SkCanvas::SrcRectConstraint constraint) override;
+  void drawImageRects(const sk_sp<DlImage> image,
+                      const SkRect rects[],
+                      uint32_t count,
+                      const SkSamplingOptions& sampling,
+                      bool render_with_attributes,
+                      SkCanvas::SrcRectConstraint constraint) override;
   void drawImageNine(const sk_sp<DlImage> image,
                      const SkIRect& center,
                      const SkRect& dst,
@@ -9,9 +9,10 @@
 
 namespace flutter {
 
-DisplayListCanvasRecorder::DisplayListCanvasRecorder(const SkRect& bounds)
+DisplayListCanvasRecorder::DisplayListCanvasRecorder(const SkRect& bounds,
+                                                     bool prepare_rtree)
     : SkCanvasVirtualEnforcer(bounds.width(), bounds.height()),
-      builder_(sk_make_sp<DisplayListBuilder>(bounds)) {}
+      builder_(sk_make_sp<DisplayListBuilder>(bounds, prepare_rtree)) {}
 
 sk_sp<DisplayList> DisplayListCanvasRecorder::Build() {
   sk_sp<DisplayList> display_list = builder_->Build();
@@ -4,6 +4,7 @@
 
 #include "flutter/display_list/display_list_complexity.h"
 #include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_complexity_calibrated.h"
 #include "flutter/display_list/display_list_complexity_gl.h"
 #include "flutter/display_list/display_list_complexity_metal.h"
 
@@ -24,8 +25,16 @@ DisplayListComplexityCalculator* DisplayListComplexityCalculator::GetForBackend(
     GrBackendApi backend) {
   switch (backend) {
     case GrBackendApi::kMetal:
+      if (auto calibrated = DisplayListCalibratedComplexityCalculator::
+              GetInstance(DisplayListCostTable::Backend::kMetal)) {
+        return calibrated;
+      }
       return DisplayListMetalComplexityCalculator::GetInstance();
     case GrBackendApi::kOpenGL:
+      if (auto calibrated = DisplayListCalibratedComplexityCalculator::
+              GetInstance(DisplayListCostTable::Backend::kOpenGL)) {
+        return calibrated;
+      }
       return DisplayListGLComplexityCalculator::GetInstance();
     default:
       return DisplayListNaiveComplexityCalculator::GetInstance();
@@ -34,6 +43,10 @@ DisplayListComplexityCalculator* DisplayListComplexityCalculator::GetForBackend(
 
 DisplayListComplexityCalculator*
 DisplayListComplexityCalculator::GetForSoftware() {
+  if (auto calibrated = DisplayListCalibratedComplexityCalculator::GetInstance(
+          DisplayListCostTable::Backend::kSoftware)) {
+    return calibrated;
+  }
   return DisplayListNaiveComplexityCalculator::GetInstance();
 }
 
@@ -0,0 +1,479 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_complexity_calibrated.h"
+
+#include <cmath>
+#include <mutex>
+#include <sstream>
+
+#include "flutter/display_list/display_list_vertices.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace flutter {
+
+// The complexity scores use a scale where 100 is roughly 0.0005ms.
+static constexpr double kNanosecondsPerScore = 5.0;
+
+// The score given to ops that are missing from the table. This is the
+// same placeholder that is used for drawColor and drawPaint.
+static constexpr unsigned int kUnmeasuredOpScore = 50;
+
+static constexpr DisplayListCostTable::Backend kBackends[] = {
+    DisplayListCostTable::Backend::kSoftware,
+    DisplayListCostTable::Backend::kOpenGL,
+    DisplayListCostTable::Backend::kMetal,
+};
+
+static constexpr DisplayListCostTable::Op kOps[] = {
+    DisplayListCostTable::Op::kDrawLine,
+    DisplayListCostTable::Op::kDrawRect,
+    DisplayListCostTable::Op::kDrawOval,
+    DisplayListCostTable::Op::kDrawCircle,
+    DisplayListCostTable::Op::kDrawRRect,
+    DisplayListCostTable::Op::kDrawDRRect,
+    DisplayListCostTable::Op::kDrawArc,
+    DisplayListCostTable::Op::kDrawPath,
+    DisplayListCostTable::Op::kDrawPoints,
+    DisplayListCostTable::Op::kDrawVertices,
+    DisplayListCostTable::Op::kDrawImage,
+    DisplayListCostTable::Op::kDrawImageRect,
+    DisplayListCostTable::Op::kDrawImageNine,
+    DisplayListCostTable::Op::kDrawTextBlob,
+    DisplayListCostTable::Op::kDrawShadow,
+    DisplayListCostTable::Op::kSaveLayer,
+};
+
+static constexpr DisplayListCostTable::Style kStyles[] = {
+    DisplayListCostTable::Style::kFill,
+    DisplayListCostTable::Style::kStroke,
+    DisplayListCostTable::Style::kHairline,
+};
+
+const char* DisplayListCostTable::BackendName(Backend backend) {
+  switch (backend) {
+    case Backend::kSoftware:
+      return "Software";
+    case Backend::kOpenGL:
+      return "OpenGL";
+    case Backend::kMetal:
+      return "Metal";
+  }
+}
+
+const char* DisplayListCostTable::OpName(Op op) {
+  switch (op) {
+    case Op::kDrawLine:
+      return "DrawLine";
+    case Op::kDrawRect:
+      return "DrawRect";
+    case Op::kDrawOval:
+      return "DrawOval";
+    case Op::kDrawCircle:
+      return "DrawCircle";
+    case Op::kDrawRRect:
+      return "DrawRRect";
+    case Op::kDrawDRRect:
+      return "DrawDRRect";
+    case Op::kDrawArc:
+      return "DrawArc";
+    case Op::kDrawPath:
+      return "DrawPath";
+    case Op::kDrawPoints:
+      return "DrawPoints";
+    case Op::kDrawVertices:
+      return "DrawVertices";
+    case Op::kDrawImage:
+      return "DrawImage";
+    case Op::kDrawImageRect:
+      return "DrawImageRect";
+    case Op::kDrawImageNine:
+      return "DrawImageNine";
+    case Op::kDrawTextBlob:
+      return "DrawTextBlob";
+    case Op::kDrawShadow:
+      return "DrawShadow";
+    case Op::kSaveLayer:
+      return "SaveLayer";
+  }
+}
+
+const char* DisplayListCostTable::StyleName(Style style) {
+  switch (style) {
+    case Style::kFill:
+      return "Fill";
+    case Style::kStroke:
+      return "Stroke";
+    case Style::kHairline:
+      return "Hairline";
+  }
+}
+
+std::optional<DisplayListCostTable::Backend>
+DisplayListCostTable::BackendForName(const std::string& name) {
+  for (Backend backend : kBackends) {
+    if (name == BackendName(backend)) {
+      return backend;
+    }
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<DisplayListCostTable> DisplayListCostTable::Parse(
+    const std::string& text) {
+  auto table = std::make_shared<DisplayListCostTable>();
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string backend_name;
+    if (!(fields >> backend_name) || backend_name[0] == '#') {
+      continue;
+    }
+    std::string op_name, style_name, aa_name;
+    Cost cost;
+    if (!(fields >> op_name >> style_name >> aa_name >> cost.fixed_ns >>
+          cost.ns_per_unit)) {
+      return nullptr;
+    }
+    std::string extra;
+    if (fields >> extra) {
+      return nullptr;
+    }
+
+    std::optional<Backend> backend = BackendForName(backend_name);
+    std::optional<Op> op;
+    for (Op candidate : kOps) {
+      if (op_name == OpName(candidate)) {
+        op = candidate;
+      }
+    }
+    std::optional<Style> style;
+    for (Style candidate : kStyles) {
+      if (style_name == StyleName(candidate)) {
+        style = candidate;
+      }
+    }
+    if (!backend || !op || !style || (aa_name != "AA" && aa_name != "NoAA") ||
+        !std::isfinite(cost.fixed_ns) || !std::isfinite(cost.ns_per_unit)) {
+      return nullptr;
+    }
+    table->SetCost({*backend, *op, *style, aa_name == "AA"}, cost);
+  }
+  return table;
+}
+
+void DisplayListCostTable::SetCost(const Key& key, const Cost& cost) {
+  costs_[{key.backend, key.op, key.style, key.anti_alias}] = cost;
+}
+
+const DisplayListCostTable::Cost* DisplayListCostTable::Find(Backend backend,
+                                                             Op op,
+                                                             Style style,
+                                                             bool aa) const {
+  auto it = costs_.find({backend, op, style, aa});
+  return it == costs_.end() ? nullptr : &it->second;
+}
+
+const DisplayListCostTable::Cost* DisplayListCostTable::GetCost(
+    const Key& key) const {
+  // Prefer an entry with the same style, since the style changes the
+  // meaning of the units of shapes, and then an entry for a filled op.
+  const Cost* cost;
+  if ((cost = Find(key.backend, key.op, key.style, key.anti_alias)) ||
+      (cost = Find(key.backend, key.op, key.style, !key.anti_alias)) ||
+      (cost = Find(key.backend, key.op, Style::kFill, key.anti_alias)) ||
+      (cost = Find(key.backend, key.op, Style::kFill, !key.anti_alias))) {
+    return cost;
+  }
+  return nullptr;
+}
+
+bool DisplayListCostTable::HasCostsFor(Backend backend) const {
+  auto it = costs_.lower_bound({backend, kOps[0], kStyles[0], false});
+  return it != costs_.end() && std::get<0>(it->first) == backend;
+}
+
+std::string DisplayListCostTable::ToString() const {
+  std::ostringstream text;
+  for (const auto& [index, cost] : costs_) {
+    const auto& [backend, op, style, aa] = index;
+    text << BackendName(backend) << " " << OpName(op) << " "
+         << StyleName(style) << " " << (aa ? "AA" : "NoAA") << " "
+         << cost.fixed_ns << " " << cost.ns_per_unit << "\n";
+  }
+  return text.str();
+}
+
+DisplayListCostTable::Style CostUnitsHelper::ShapeStyle() {
+  if (Style() == SkPaint::Style::kFill_Style) {
+    return DisplayListCostTable::Style::kFill;
+  }
+  return StrokeStyle();
+}
+
+DisplayListCostTable::Style CostUnitsHelper::StrokeStyle() {
+  return IsHairline() ? DisplayListCostTable::Style::kHairline
+                      : DisplayListCostTable::Style::kStroke;
+}
+
+void CostUnitsHelper::AccumulateShape(DisplayListCostTable::Op op,
+                                      const SkRect& bounds) {
+  DisplayListCostTable::Style style = ShapeStyle();
+  double units = style == DisplayListCostTable::Style::kFill
+                     ? bounds.width() * bounds.height()
+                     : bounds.width() + bounds.height();
+  AccumulateCost(op, style, IsAntiAliased(), units);
+}
+
+void CostUnitsHelper::saveLayer(const SkRect* bounds,
+                                const SaveLayerOptions options) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kSaveLayer,
+                 DisplayListCostTable::Style::kFill, false, 0);
+}
+
+void CostUnitsHelper::drawLine(const SkPoint& p0, const SkPoint& p1) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawLine, StrokeStyle(),
+                 IsAntiAliased(), SkPoint::Distance(p0, p1));
+}
+
+void CostUnitsHelper::drawRect(const SkRect& rect) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawRect, rect);
+}
+
+void CostUnitsHelper::drawOval(const SkRect& bounds) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawOval, bounds);
+}
+
+void CostUnitsHelper::drawCircle(const SkPoint& center, SkScalar radius) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawCircle,
+                  SkRect::MakeLTRB(center.fX - radius, center.fY - radius,
+                                   center.fX + radius, center.fY + radius));
+}
+
+void CostUnitsHelper::drawRRect(const SkRRect& rrect) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawRRect, rrect.rect());
+}
+
+void CostUnitsHelper::drawDRRect(const SkRRect& outer, const SkRRect& inner) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawDRRect, outer.rect());
+}
+
+void CostUnitsHelper::drawPath(const SkPath& path) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawPath, ShapeStyle(),
+                 IsAntiAliased(), path.countVerbs());
+}
+
+void CostUnitsHelper::drawArc(const SkRect& oval_bounds,
+                              SkScalar start_degrees,
+                              SkScalar sweep_degrees,
+                              bool use_center) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateShape(DisplayListCostTable::Op::kDrawArc, oval_bounds);
+}
+
+void CostUnitsHelper::drawPoints(SkCanvas::PointMode mode,
+                                 uint32_t count,
+                                 const SkPoint points[]) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawPoints, StrokeStyle(),
+                 IsAntiAliased(), count);
+}
+
+void CostUnitsHelper::drawSkVertices(const sk_sp<SkVertices> vertices,
+                                     SkBlendMode mode) {
+  if (IsComplex()) {
+    return;
+  }
+  // As in the GL and Metal calculators, the vertex count of an
+  // SkVertices object can only be estimated from its approximate size.
+  AccumulateCost(DisplayListCostTable::Op::kDrawVertices,
+                 DisplayListCostTable::Style::kFill, false,
+                 vertices->approximateSize() / 20);
+}
+
+void CostUnitsHelper::drawVertices(const DlVertices* vertices,
+                                   DlBlendMode mode) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawVertices,
+                 DisplayListCostTable::Style::kFill, false,
+                 vertices->vertex_count());
+}
+
+void CostUnitsHelper::drawImage(const sk_sp<DlImage> image,
+                                const SkPoint point,
+                                const SkSamplingOptions& sampling,
+                                bool render_with_attributes) {
+  if (IsComplex()) {
+    return;
+  }
+  SkISize dimensions = image->dimensions();
+  AccumulateCost(DisplayListCostTable::Op::kDrawImage,
+                 DisplayListCostTable::Style::kFill, false,
+                 static_cast<double>(dimensions.area()));
+}
+
+void CostUnitsHelper::ImageRect(const SkISize& size,
+                                bool texture_backed,
+                                bool render_with_attributes,
+                                SkCanvas::SrcRectConstraint constraint) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawImageRect,
+                 DisplayListCostTable::Style::kFill, false,
+                 static_cast<double>(size.area()));
+}
+
+void CostUnitsHelper::drawImageNine(const sk_sp<DlImage> image,
+                                    const SkIRect& center,
+                                    const SkRect& dst,
+                                    SkFilterMode filter,
+                                    bool render_with_attributes) {
+  if (IsComplex()) {
+    return;
+  }
+  SkISize dimensions = image->dimensions();
+  AccumulateCost(DisplayListCostTable::Op::kDrawImageNine,
+                 DisplayListCostTable::Style::kFill, false,
+                 static_cast<double>(dimensions.area()));
+}
+
+void CostUnitsHelper::drawTextBlob(const sk_sp<SkTextBlob> blob,
+                                   SkScalar x,
+                                   SkScalar y) {
+  if (IsComplex()) {
+    return;
+  }
+  int glyph_count = 0;
+  SkTextBlob::Iter iter(*blob);
+  SkTextBlob::Iter::Run run;
+  while (iter.next(&run)) {
+    glyph_count += run.fGlyphCount;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawTextBlob,
+                 DisplayListCostTable::Style::kFill, false, glyph_count);
+}
+
+void CostUnitsHelper::drawShadow(const SkPath& path,
+                                 const DlColor color,
+                                 const SkScalar elevation,
+                                 bool transparent_occluder,
+                                 SkScalar dpr) {
+  if (IsComplex()) {
+    return;
+  }
+  AccumulateCost(DisplayListCostTable::Op::kDrawShadow,
+                 DisplayListCostTable::Style::kFill, false, elevation);
+}
+
+static std::mutex cost_table_mutex;
+static std::shared_ptr<const DisplayListCostTable> cost_table;
+
+void DisplayListCalibratedComplexityCalculator::SetCostTable(
+    std::shared_ptr<const DisplayListCostTable> table) {
+  std::scoped_lock lock(cost_table_mutex);
+  if (table && table->empty()) {
+    table = nullptr;
+  }
+  cost_table = std::move(table);
+}
+
+DisplayListComplexityCalculator*
+DisplayListCalibratedComplexityCalculator::GetInstance(
+    DisplayListCostTable::Backend backend) {
+  {
+    std::scoped_lock lock(cost_table_mutex);
+    if (!cost_table || !cost_table->HasCostsFor(backend)) {
+      return nullptr;
+    }
+  }
+  static DisplayListCalibratedComplexityCalculator* instances[] = {
+      new DisplayListCalibratedComplexityCalculator(kBackends[0]),
+      new DisplayListCalibratedComplexityCalculator(kBackends[1]),
+      new DisplayListCalibratedComplexityCalculator(kBackends[2]),
+  };
+  return instances[static_cast<int>(backend)];
+}
+
+unsigned int DisplayListCalibratedComplexityCalculator::Compute(
+    DisplayList* display_list) {
+  std::shared_ptr<const DisplayListCostTable> table;
+  {
+    std::scoped_lock lock(cost_table_mutex);
+    table = cost_table;
+  }
+  if (!table) {
+    return display_list->op_count(true);
+  }
+  CalibratedHelper helper(ceiling_, *table, backend_);
+  display_list->Dispatch(helper);
+  return helper.ComplexityScore();
+}
+
+void DisplayListCalibratedComplexityCalculator::CalibratedHelper::
+    drawDisplayList(const sk_sp<DisplayList> display_list) {
+  if (IsComplex()) {
+    return;
+  }
+  CalibratedHelper helper(Ceiling() - CurrentComplexityScore(), table_,
+                          backend_);
+  display_list->Dispatch(helper);
+  AccumulateComplexity(helper.ComplexityScore());
+}
+
+void DisplayListCalibratedComplexityCalculator::CalibratedHelper::
+    AccumulateCost(DisplayListCostTable::Op op,
+                   DisplayListCostTable::Style style,
+                   bool anti_alias,
+                   double units) {
+  const DisplayListCostTable::Cost* cost =
+      table_.GetCost({backend_, op, style, anti_alias});
+  if (!cost) {
+    AccumulateComplexity(kUnmeasuredOpScore);
+    return;
+  }
+  double score =
+      (cost->fixed_ns + cost->ns_per_unit * units) / kNanosecondsPerScore;
+  if (score <= 0) {
+    return;
+  }
+  if (score >= Ceiling()) {
+    AccumulateComplexity(Ceiling());
+    return;
+  }
+  AccumulateComplexity(static_cast<unsigned int>(std::ceil(score)));
+}
+
+}  // namespace flutter
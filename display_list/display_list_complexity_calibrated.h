@@ -0,0 +1,246 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_COMPLEXITY_CALIBRATED_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_COMPLEXITY_CALIBRATED_H_
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "flutter/display_list/display_list_complexity_helper.h"
+
+namespace flutter {
+
+// A table of the measured cost of each kind of rendering op on a device.
+//
+// The cost of an op is modeled as a fixed cost per call plus a cost
+// that is proportional to a measure of the size of the op, called its
+// units. The units of each op are computed by |CostUnitsHelper|:
+//
+//   kDrawLine        the length of the line
+//   kDrawRect, kDrawOval, kDrawCircle, kDrawRRect, kDrawDRRect, kDrawArc
+//                    the area of the bounds when filled, or the sum of
+//                    the width and height of the bounds when stroked
+//   kDrawPath        the number of verbs in the path
+//   kDrawPoints      the number of points
+//   kDrawVertices    the number of vertices
+//   kDrawImage, kDrawImageRect, kDrawImageNine
+//                    the number of pixels in the image
+//   kDrawTextBlob    the number of glyphs
+//   kDrawShadow      the elevation of the shadow
+//   kSaveLayer       none, only the fixed cost applies
+//
+// The costs are measured separately for each backend and for each
+// combination of draw style and anti-aliasing, since those can change
+// the cost of an op by an order of magnitude.
+//
+// A table is normally produced on the device in question by running the
+// display_list_benchmarks and processing the results with the
+// --cost-table option of testing/benchmark/displaylist_benchmark_parser.py.
+// The text form of a table has one entry per line:
+//
+//   <backend> <op> <style> <AA|NoAA> <fixed ns> <ns per unit>
+//
+// for example "Software DrawRect Fill AA 85.2 0.0031". Empty lines and
+// lines starting with # are ignored.
+class DisplayListCostTable {
+ public:
+  enum class Backend { kSoftware, kOpenGL, kMetal };
+
+  enum class Op {
+    kDrawLine,
+    kDrawRect,
+    kDrawOval,
+    kDrawCircle,
+    kDrawRRect,
+    kDrawDRRect,
+    kDrawArc,
+    kDrawPath,
+    kDrawPoints,
+    kDrawVertices,
+    kDrawImage,
+    kDrawImageRect,
+    kDrawImageNine,
+    kDrawTextBlob,
+    kDrawShadow,
+    kSaveLayer,
+  };
+
+  enum class Style { kFill, kStroke, kHairline };
+
+  struct Key {
+    Backend backend;
+    Op op;
+    Style style;
+    bool anti_alias;
+  };
+
+  struct Cost {
+    double fixed_ns;
+    double ns_per_unit;
+  };
+
+  // Returns null if the text is not a well formed table.
+  static std::shared_ptr<DisplayListCostTable> Parse(const std::string& text);
+
+  static const char* BackendName(Backend backend);
+  static const char* OpName(Op op);
+  static const char* StyleName(Style style);
+
+  static std::optional<Backend> BackendForName(const std::string& name);
+
+  void SetCost(const Key& key, const Cost& cost);
+
+  // Returns the cost of the indicated op. If the table has no entry for
+  // the exact style and anti-aliasing of the key, the closest entry for
+  // the same op and backend is returned instead. Returns null if the op
+  // was not measured at all.
+  const Cost* GetCost(const Key& key) const;
+
+  bool HasCostsFor(Backend backend) const;
+
+  bool empty() const { return costs_.empty(); }
+
+  std::string ToString() const;
+
+ private:
+  using Index = std::tuple<Backend, Op, Style, bool>;
+
+  const Cost* Find(Backend backend, Op op, Style style, bool aa) const;
+
+  std::map<Index, Cost> costs_;
+};
+
+// A Dispatcher that computes the units of each rendering op, as defined
+// by |DisplayListCostTable|, and hands them to |AccumulateCost| along
+// with the draw style and anti-aliasing that apply to the op.
+class CostUnitsHelper : public ComplexityCalculatorHelper {
+ public:
+  explicit CostUnitsHelper(unsigned int ceiling)
+      : ComplexityCalculatorHelper(ceiling) {}
+
+  void saveLayer(const SkRect* bounds,
+                 const SaveLayerOptions options) override;
+
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override;
+  void drawRect(const SkRect& rect) override;
+  void drawOval(const SkRect& bounds) override;
+  void drawCircle(const SkPoint& center, SkScalar radius) override;
+  void drawRRect(const SkRRect& rrect) override;
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override;
+  void drawPath(const SkPath& path) override;
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override;
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override;
+  void drawSkVertices(const sk_sp<SkVertices>, SkBlendMode mode) override;
+  void drawVertices(const DlVertices* vertices, DlBlendMode mode) override;
+  void drawImage(const sk_sp<DlImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override;
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override;
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override;
+  void drawShadow(const SkPath& path,
+                  const DlColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override;
+
+ protected:
+  virtual void AccumulateCost(DisplayListCostTable::Op op,
+                              DisplayListCostTable::Style style,
+                              bool anti_alias,
+                              double units) = 0;
+
+  void ImageRect(const SkISize& size,
+                 bool texture_backed,
+                 bool render_with_attributes,
+                 SkCanvas::SrcRectConstraint constraint) override;
+
+  // The cost of every op is accumulated as it is dispatched.
+  unsigned int BatchedComplexity() override { return 0; }
+
+ private:
+  // The style of the current paint, for ops that can be filled.
+  DisplayListCostTable::Style ShapeStyle();
+  // The style of the current paint, for ops that are always stroked.
+  DisplayListCostTable::Style StrokeStyle();
+
+  void AccumulateShape(DisplayListCostTable::Op op, const SkRect& bounds);
+};
+
+// A complexity calculator that scores DisplayLists with the costs
+// measured on the current device instead of the hand tuned estimates of
+// the GL and Metal calculators. The scores use the same scale as those
+// calculators, where 100 is roughly 0.0005ms.
+class DisplayListCalibratedComplexityCalculator
+    : public DisplayListComplexityCalculator {
+ public:
+  // Installs the table of measured costs that will be used by the
+  // calculators returned from |GetInstance|. A null or empty table
+  // removes any previously installed table.
+  static void SetCostTable(std::shared_ptr<const DisplayListCostTable> table);
+
+  // Returns the calibrated calculator for the backend, or null if the
+  // installed table has no costs that were measured on that backend.
+  static DisplayListComplexityCalculator* GetInstance(
+      DisplayListCostTable::Backend backend);
+
+  unsigned int Compute(DisplayList* display_list) override;
+
+  bool ShouldBeCached(unsigned int complexity_score) override {
+    // Set cache threshold at 1ms
+    return complexity_score > 200000u;
+  }
+
+  void SetComplexityCeiling(unsigned int ceiling) override {
+    ceiling_ = ceiling;
+  }
+
+ private:
+  class CalibratedHelper : public CostUnitsHelper {
+   public:
+    CalibratedHelper(unsigned int ceiling,
+                     const DisplayListCostTable& table,
+                     DisplayListCostTable::Backend backend)
+        : CostUnitsHelper(ceiling), table_(table), backend_(backend) {}
+
+    void drawDisplayList(const sk_sp<DisplayList> display_list) override;
+
+   protected:
+    void AccumulateCost(DisplayListCostTable::Op op,
+                        DisplayListCostTable::Style style,
+                        bool anti_alias,
+                        double units) override;
+
+   private:
+    const DisplayListCostTable& table_;
+    const DisplayListCostTable::Backend backend_;
+  };
+
+  explicit DisplayListCalibratedComplexityCalculator(
+      DisplayListCostTable::Backend backend)
+      : backend_(backend), ceiling_(std::numeric_limits<unsigned int>::max()) {}
+
+  const DisplayListCostTable::Backend backend_;
+  unsigned int ceiling_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_COMPLEXITY_CALIBRATED_H_
@@ -5,6 +5,7 @@
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_complexity.h"
+#include "flutter/display_list/display_list_complexity_calibrated.h"
 #include "flutter/display_list/display_list_complexity_gl.h"
 #include "flutter/display_list/display_list_complexity_metal.h"
 #include "flutter/display_list/display_list_test_utils.h"
@@ -430,5 +431,89 @@ TEST(DisplayListComplexity, DrawAtlas) {
   }
 }
 
+TEST(DisplayListComplexity, CostTableParsesAndPrints) {
+  auto table = DisplayListCostTable::Parse(
+      "# Measured on a test machine\n"
+      "\n"
+      "Software DrawRect Fill AA 100 0.5\n"
+      "OpenGL DrawPath Stroke NoAA 20 2\n");
+  ASSERT_NE(table, nullptr);
+  ASSERT_TRUE(table->HasCostsFor(DisplayListCostTable::Backend::kSoftware));
+  ASSERT_TRUE(table->HasCostsFor(DisplayListCostTable::Backend::kOpenGL));
+  ASSERT_FALSE(table->HasCostsFor(DisplayListCostTable::Backend::kMetal));
+
+  auto cost = table->GetCost({DisplayListCostTable::Backend::kSoftware,
+                              DisplayListCostTable::Op::kDrawRect,
+                              DisplayListCostTable::Style::kFill, true});
+  ASSERT_NE(cost, nullptr);
+  ASSERT_EQ(cost->fixed_ns, 100);
+  ASSERT_EQ(cost->ns_per_unit, 0.5);
+
+  auto reparsed = DisplayListCostTable::Parse(table->ToString());
+  ASSERT_NE(reparsed, nullptr);
+  ASSERT_EQ(reparsed->ToString(), table->ToString());
+}
+
+TEST(DisplayListComplexity, CostTableRejectsMalformedText) {
+  ASSERT_EQ(DisplayListCostTable::Parse("Vulkan DrawRect Fill AA 1 1"),
+            nullptr);
+  ASSERT_EQ(DisplayListCostTable::Parse("Software DrawSquare Fill AA 1 1"),
+            nullptr);
+  ASSERT_EQ(DisplayListCostTable::Parse("Software DrawRect Fill Maybe 1 1"),
+            nullptr);
+  ASSERT_EQ(DisplayListCostTable::Parse("Software DrawRect Fill AA 1"),
+            nullptr);
+  ASSERT_EQ(DisplayListCostTable::Parse("Software DrawRect Fill AA 1 1 1"),
+            nullptr);
+}
+
+TEST(DisplayListComplexity, CostTableFallsBackToClosestVariant) {
+  auto table = DisplayListCostTable::Parse(
+      "Software DrawRect Fill NoAA 100 0\n"
+      "Software DrawRect Stroke AA 200 0\n");
+  ASSERT_NE(table, nullptr);
+
+  auto cost = table->GetCost({DisplayListCostTable::Backend::kSoftware,
+                              DisplayListCostTable::Op::kDrawRect,
+                              DisplayListCostTable::Style::kStroke, false});
+  ASSERT_NE(cost, nullptr);
+  ASSERT_EQ(cost->fixed_ns, 200);
+
+  cost = table->GetCost({DisplayListCostTable::Backend::kSoftware,
+                         DisplayListCostTable::Op::kDrawRect,
+                         DisplayListCostTable::Style::kHairline, true});
+  ASSERT_NE(cost, nullptr);
+  ASSERT_EQ(cost->fixed_ns, 100);
+
+  ASSERT_EQ(table->GetCost({DisplayListCostTable::Backend::kSoftware,
+                            DisplayListCostTable::Op::kDrawOval,
+                            DisplayListCostTable::Style::kFill, false}),
+            nullptr);
+}
+
+TEST(DisplayListComplexity, CalibratedCalculatorUsesInstalledTable) {
+  auto naive = DisplayListNaiveComplexityCalculator::GetInstance();
+  ASSERT_EQ(DisplayListComplexityCalculator::GetForSoftware(), naive);
+
+  // 1000ns per call plus 1ns per pixel of area.
+  DisplayListCalibratedComplexityCalculator::SetCostTable(
+      DisplayListCostTable::Parse("Software DrawRect Fill NoAA 1000 1\n"));
+  auto calculator = DisplayListComplexityCalculator::GetForSoftware();
+  ASSERT_NE(calculator, naive);
+  ASSERT_EQ(DisplayListComplexityCalculator::GetForBackend(
+                GrBackendApi::kOpenGL),
+            DisplayListGLComplexityCalculator::GetInstance());
+
+  DisplayListBuilder builder;
+  builder.drawRect(SkRect::MakeWH(10, 10));
+  builder.drawRect(SkRect::MakeWH(20, 20));
+  auto display_list = builder.Build();
+  // (1000 + 100) / 5 + (1000 + 400) / 5
+  ASSERT_EQ(calculator->Compute(display_list.get()), 500u);
+
+  DisplayListCalibratedComplexityCalculator::SetCostTable(nullptr);
+  ASSERT_EQ(DisplayListComplexityCalculator::GetForSoftware(), naive);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -6,6 +6,22 @@
 
 namespace flutter {
 
-//
+void Dispatcher::drawRects(const SkRect rects[], uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    drawRect(rects[i]);
+  }
+}
+
+void Dispatcher::drawImageRects(const sk_sp<DlImage> image,
+                                const SkRect rects[],
+                                uint32_t count,
+                                const SkSamplingOptions& sampling,
+                                bool render_with_attributes,
+                                SkCanvas::SrcRectConstraint constraint) {
+  for (uint32_t i = 0; i < count; i++) {
+    drawImageRect(image, rects[i * 2], rects[i * 2 + 1], sampling,
+                  render_with_attributes, constraint);
+  }
+}
 
 }  // namespace flutter
@@ -195,6 +195,11 @@ class Dispatcher {
   virtual void drawPaint() = 0;
   virtual void drawLine(const SkPoint& p0, const SkPoint& p1) = 0;
   virtual void drawRect(const SkRect& rect) = 0;
+  // Renders each of the |count| rects in order using the current attributes,
+  // with the same output as calling |drawRect| for each of them. The
+  // default implementation does exactly that, dispatchers that can render
+  // the rects more efficiently as a batch should override it.
+  virtual void drawRects(const SkRect rects[], uint32_t count);
   virtual void drawOval(const SkRect& bounds) = 0;
   virtual void drawCircle(const SkPoint& center, SkScalar radius) = 0;
   virtual void drawRRect(const SkRRect& rrect) = 0;
@@ -220,6 +225,16 @@ class Dispatcher {
                              const SkSamplingOptions& sampling,
                              bool render_with_attributes,
                              SkCanvas::SrcRectConstraint constraint) = 0;
+  // Renders |count| portions of the |image| with the same output as
+  // calling |drawImageRect| for each of them. The |rects| array holds
+  // the src rect followed by the dst rect for each of the |count| draws.
+  // The default implementation calls |drawImageRect| for each pair.
+  virtual void drawImageRects(const sk_sp<DlImage> image,
+                              const SkRect rects[],
+                              uint32_t count,
+                              const SkSamplingOptions& sampling,
+                              bool render_with_attributes,
+                              SkCanvas::SrcRectConstraint constraint);
   virtual void drawImageNine(const sk_sp<DlImage> image,
                              const SkIRect& center,
                              const SkRect& dst,
@@ -0,0 +1,182 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_hash.h"
+
+#include <cstring>
+#include <vector>
+
+namespace flutter {
+
+static constexpr uint64_t kMultiplier1 = 0x87c37b91114253d5u;
+static constexpr uint64_t kMultiplier2 = 0x4cf5ad432745937fu;
+
+static inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+void DisplayListHasher::AddWord(uint64_t word) {
+  word *= kMultiplier1;
+  word = RotateLeft(word, 31);
+  word *= kMultiplier2;
+  state_ ^= word;
+  state_ = RotateLeft(state_, 27) * 5 + 0x52dce729;
+}
+
+void DisplayListHasher::AddBytes(const void* data, size_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  length_ += length;
+  while (length >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    AddWord(word);
+    bytes += sizeof(word);
+    length -= sizeof(word);
+  }
+  if (length > 0) {
+    uint64_t word = 0;
+    memcpy(&word, bytes, length);
+    AddWord(word);
+  }
+}
+
+void DisplayListHasher::AddMatrix(const SkMatrix& matrix) {
+  for (int i = 0; i < 9; i++) {
+    AddScalar(matrix[i]);
+  }
+}
+
+void DisplayListHasher::AddSampling(const SkSamplingOptions& sampling) {
+  Add(sampling.useCubic);
+  if (sampling.useCubic) {
+    AddScalar(sampling.cubic.B);
+    AddScalar(sampling.cubic.C);
+  } else {
+    Add(sampling.filter);
+    Add(sampling.mipmap);
+  }
+}
+
+void DisplayListHasher::AddPath(const SkPath& path) {
+  // SkPath::operator== compares the fill type, verbs, points and conic
+  // weights. The weights are left out of the hash since a curve that
+  // differs only in its weights is rare and will still be caught by
+  // the full comparison.
+  Add(path.getFillType());
+  int verb_count = path.countVerbs();
+  int point_count = path.countPoints();
+  Add(verb_count);
+  Add(point_count);
+  std::vector<uint8_t> verbs(verb_count);
+  path.getVerbs(verbs.data(), verb_count);
+  AddBytes(verbs.data(), verb_count);
+  std::vector<SkPoint> points(point_count);
+  path.getPoints(points.data(), point_count);
+  for (const SkPoint& point : points) {
+    AddScalar(point.fX);
+    AddScalar(point.fY);
+  }
+}
+
+void DisplayListHasher::AddColorFilter(const DlColorFilter* filter) {
+  if (!filter) {
+    Add<uint64_t>(0);
+    return;
+  }
+  Add(filter->type());
+  switch (filter->type()) {
+    case DlColorFilterType::kBlend: {
+      const DlBlendColorFilter* blend = filter->asBlend();
+      FML_DCHECK(blend);
+      Add(blend->color());
+      Add(blend->mode());
+      break;
+    }
+    case DlColorFilterType::kMatrix: {
+      const DlMatrixColorFilter* matrix = filter->asMatrix();
+      FML_DCHECK(matrix);
+      float values[20];
+      matrix->get_matrix(values);
+      for (float value : values) {
+        AddScalar(value);
+      }
+      break;
+    }
+    case DlColorFilterType::kSrgbToLinearGamma:
+    case DlColorFilterType::kLinearToSrgbGamma:
+      break;
+    case DlColorFilterType::kUnknown:
+      Add(filter->skia_object().get());
+      break;
+  }
+}
+
+void DisplayListHasher::AddImageFilter(const DlImageFilter* filter) {
+  if (!filter) {
+    Add<uint64_t>(0);
+    return;
+  }
+  Add(filter->type());
+  switch (filter->type()) {
+    case DlImageFilterType::kBlur: {
+      const DlBlurImageFilter* blur = filter->asBlur();
+      FML_DCHECK(blur);
+      AddScalar(blur->sigma_x());
+      AddScalar(blur->sigma_y());
+      Add(blur->tile_mode());
+      break;
+    }
+    case DlImageFilterType::kDilate: {
+      const DlDilateImageFilter* dilate = filter->asDilate();
+      FML_DCHECK(dilate);
+      AddScalar(dilate->radius_x());
+      AddScalar(dilate->radius_y());
+      break;
+    }
+    case DlImageFilterType::kErode: {
+      const DlErodeImageFilter* erode = filter->asErode();
+      FML_DCHECK(erode);
+      AddScalar(erode->radius_x());
+      AddScalar(erode->radius_y());
+      break;
+    }
+    case DlImageFilterType::kMatrix: {
+      const DlMatrixImageFilter* matrix = filter->asMatrix();
+      FML_DCHECK(matrix);
+      AddMatrix(matrix->matrix());
+      AddSampling(matrix->sampling());
+      break;
+    }
+    case DlImageFilterType::kComposeFilter: {
+      const DlComposeImageFilter* compose = filter->asCompose();
+      FML_DCHECK(compose);
+      AddImageFilter(compose->outer().get());
+      AddImageFilter(compose->inner().get());
+      break;
+    }
+    case DlImageFilterType::kColorFilter: {
+      const DlColorFilterImageFilter* color_filter = filter->asColorFilter();
+      FML_DCHECK(color_filter);
+      AddColorFilter(color_filter->color_filter().get());
+      break;
+    }
+    case DlImageFilterType::kUnknown:
+      // Unknown filters are compared by the identity of the Skia filter.
+      Add(filter->skia_object().get());
+      break;
+  }
+}
+
+uint64_t DisplayListHasher::Finish() const {
+  // The MurmurHash3 finalizer, to spread the bits of the last words.
+  uint64_t hash = state_ ^ length_;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdu;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53u;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace flutter
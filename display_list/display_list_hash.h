@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
+
+#include <cstdint>
+#include <type_traits>
+
+#include "flutter/display_list/display_list_color_filter.h"
+#include "flutter/display_list/display_list_image_filter.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkSamplingOptions.h"
+
+namespace flutter {
+
+// Accumulates a 64-bit hash of the contents of a DisplayList.
+//
+// The hash is only a fast rejection test for the comparisons that are
+// performed by |DisplayList::Equals|, so any two values that would
+// compare as equal must produce the same hash. Values that are compared
+// by identity, such as the sk_sp references stored in most ops, are
+// hashed by their pointer values and values that are compared deeply,
+// such as paths and image filters, are hashed by their contents.
+class DisplayListHasher {
+ public:
+  DisplayListHasher() = default;
+
+  void AddBytes(const void* data, size_t length);
+
+  // Only appropriate for types whose bytes are fully determined by
+  // their value, i.e. types without any padding or floating point
+  // fields that could hold either 0 or -0.
+  template <typename T>
+  void Add(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    AddBytes(&value, sizeof(T));
+  }
+
+  // Folds -0 into 0 so that scalars which compare as equal hash equally.
+  void AddScalar(SkScalar value) { Add<SkScalar>(value == 0 ? 0 : value); }
+
+  void AddMatrix(const SkMatrix& matrix);
+  void AddSampling(const SkSamplingOptions& sampling);
+  void AddPath(const SkPath& path);
+  void AddColorFilter(const DlColorFilter* filter);
+  void AddImageFilter(const DlImageFilter* filter);
+
+  uint64_t Finish() const;
+
+ private:
+  void AddWord(uint64_t word);
+
+  uint64_t state_ = 0x84222325cbf29ce4u;
+  uint64_t length_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListHasher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_HASH_H_
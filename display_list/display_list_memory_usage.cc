@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_memory_usage.h"
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_image.h"
+#include "flutter/display_list/display_list_image_filter.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+void DisplayListMemoryAccountant::AddDisplayList(
+    const DisplayList* display_list) {
+  if (!FirstSighting(display_list)) {
+    return;
+  }
+  usage_.op_bytes += display_list->bytes(false);
+  display_list->AccountMemory(*this);
+}
+
+void DisplayListMemoryAccountant::AddNestedDisplayList(
+    const DisplayList* display_list) {
+  bool was_shared = in_shared_display_list_;
+  in_shared_display_list_ = was_shared || !display_list->unique();
+  AddDisplayList(display_list);
+  in_shared_display_list_ = was_shared;
+}
+
+void DisplayListMemoryAccountant::AddPath(const SkPath& path) {
+  // Copies of a path share their point and verb data, which is
+  // identified by the generation ID. The SkPath object itself is
+  // already counted as part of the op storage.
+  if (!seen_path_ids_.insert(path.getGenerationID()).second) {
+    return;
+  }
+  usage_.path_bytes += path.approximateBytesUsed() - sizeof(SkPath);
+}
+
+void DisplayListMemoryAccountant::AddVertices(const SkVertices* vertices) {
+  if (FirstSighting(vertices)) {
+    usage_.vertices_bytes += vertices->approximateSize();
+  }
+}
+
+void DisplayListMemoryAccountant::AddTextBlob(const SkTextBlob* blob) {
+  if (!FirstSighting(blob)) {
+    return;
+  }
+  // SkTextBlob does not report its size, so it is estimated from the
+  // glyph IDs and positions of its runs.
+  size_t bytes = sizeof(SkTextBlob);
+  SkTextBlob::Iter iter(*blob);
+  SkTextBlob::Iter::Run run;
+  while (iter.next(&run)) {
+    bytes += run.fGlyphCount * (sizeof(SkGlyphID) + sizeof(SkPoint));
+  }
+  usage_.text_blob_bytes += bytes;
+}
+
+void DisplayListMemoryAccountant::AddImageFilter(const DlImageFilter* filter) {
+  if (FirstSighting(filter)) {
+    usage_.filter_bytes += filter->size();
+  }
+}
+
+void DisplayListMemoryAccountant::AddPicture(const SkPicture* picture) {
+  if (FirstSighting(picture)) {
+    usage_.picture_bytes += picture->approximateBytesUsed();
+  }
+}
+
+void DisplayListMemoryAccountant::AddImage(const DlImage* image) {
+  if (!FirstSighting(image)) {
+    return;
+  }
+  // An image that is referenced by more than one op is never unique, so
+  // a second sighting would not change how it was classified.
+  if (in_shared_display_list_ || !image->unique()) {
+    usage_.shared_image_bytes += image->GetApproximateByteSize();
+  } else {
+    usage_.unique_image_bytes += image->GetApproximateByteSize();
+  }
+}
+
+void DisplayListMemoryAccountant::AddColorSourceImage(const SkImage* image) {
+  if (FirstSighting(image)) {
+    usage_.shared_image_bytes += image->imageInfo().computeMinByteSize();
+  }
+}
+
+}  // namespace flutter
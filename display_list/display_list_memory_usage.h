@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_MEMORY_USAGE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_MEMORY_USAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+#include "flutter/fml/macros.h"
+
+class SkImage;
+class SkPath;
+class SkPicture;
+class SkTextBlob;
+class SkVertices;
+
+namespace flutter {
+
+class DisplayList;
+class DlImage;
+class DlImageFilter;
+
+// A breakdown of the memory retained by one or more DisplayLists,
+// including the objects that their ops refer to.
+//
+// Objects that are referenced more than once are only counted once.
+// The bytes of the objects that Skia manages, such as paths, vertices,
+// text blobs and pictures, are the estimates provided by Skia.
+struct DisplayListMemoryUsage {
+  // The storage of the ops and the DisplayList objects themselves,
+  // including the storage of nested DisplayLists. Pod data stored
+  // along with the ops, such as DlVertices and most filters, is
+  // counted here.
+  size_t op_bytes = 0;
+
+  // The point and verb data of the SkPaths held by clip and draw ops.
+  size_t path_bytes = 0;
+
+  // SkVertices objects. DlVertices are stored in the op storage.
+  size_t vertices_bytes = 0;
+
+  size_t text_blob_bytes = 0;
+
+  // Image filters that are shared with the objects that set them
+  // rather than copied into the op storage.
+  size_t filter_bytes = 0;
+
+  size_t picture_bytes = 0;
+
+  // The pixels of images which are only referenced by a single op, so
+  // their memory will be released along with the DisplayList.
+  size_t unique_image_bytes = 0;
+
+  // The pixels of images which are referenced more than once, either by
+  // multiple ops or from outside of the DisplayList, and which may live
+  // on after the DisplayList is released.
+  size_t shared_image_bytes = 0;
+
+  size_t total_bytes() const {
+    return op_bytes + path_bytes + vertices_bytes + text_blob_bytes +
+           filter_bytes + picture_bytes + unique_image_bytes +
+           shared_image_bytes;
+  }
+};
+
+// Accumulates the |DisplayListMemoryUsage| of the DisplayLists that are
+// added to it. The ops of each list report the objects they refer to
+// through the Add methods.
+class DisplayListMemoryAccountant {
+ public:
+  DisplayListMemoryAccountant() = default;
+
+  // Adds the usage of the list, its ops and any nested lists, unless the
+  // list was already added.
+  void AddDisplayList(const DisplayList* display_list);
+
+  // Adds a list that is drawn by an op of a list being added. Objects in
+  // the nested list are counted as shared if the nested list is shared.
+  void AddNestedDisplayList(const DisplayList* display_list);
+
+  void AddPath(const SkPath& path);
+  void AddVertices(const SkVertices* vertices);
+  void AddTextBlob(const SkTextBlob* blob);
+  void AddImageFilter(const DlImageFilter* filter);
+  void AddPicture(const SkPicture* picture);
+  void AddImage(const DlImage* image);
+
+  // The images of image color sources are always counted as shared as
+  // they are also held by the shader objects that the color sources
+  // were created from.
+  void AddColorSourceImage(const SkImage* image);
+
+  const DisplayListMemoryUsage& usage() const { return usage_; }
+
+ private:
+  // Whether the objects being added are shared because they are
+  // reached through a nested DisplayList that is itself shared.
+  bool in_shared_display_list_ = false;
+
+  std::unordered_set<const void*> seen_objects_;
+  std::unordered_set<uint32_t> seen_path_ids_;
+  DisplayListMemoryUsage usage_;
+
+  bool FirstSighting(const void* object) {
+    return object && seen_objects_.insert(object).second;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListMemoryAccountant);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_MEMORY_USAGE_H_
@@ -8,6 +8,8 @@
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
 #include "flutter/display_list/display_list_dispatcher.h"
+#include "flutter/display_list/display_list_hash.h"
+#include "flutter/display_list/display_list_memory_usage.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/macros.h"
 
@@ -23,6 +25,11 @@ namespace flutter {
 //
 // Only a DLOp that wants to do a deep compare needs to override the
 // DLOp::equals() method and return a value of kEqual or kNotEqual.
+//
+// The same applies to the DLOp::hash() method which computes the
+// content hash of the DisplayList. By default the bytes of each Op
+// are hashed and only an Op that overrides equals() needs to override
+// hash() to hash the same values that its equals() method compares.
 enum class DisplayListCompare {
   // The Op is deferring comparisons to a bulk memcmp performed lazily
   // across all bulk-comparable ops.
@@ -56,6 +63,12 @@ struct DLOp {
   DisplayListCompare equals(const DLOp* other) const {
     return DisplayListCompare::kUseBulkCompare;
   }
+
+  // Returns false if the bytes of the Op should be hashed instead.
+  bool hash(DisplayListHasher& hasher) const { return false; }
+
+  // Reports the objects that the Op refers to, beyond its own bytes.
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {}
 };
 
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
@@ -243,6 +256,10 @@ struct SetImageColorSourceOp : DLOp {
   void dispatch(Dispatcher& dispatcher) const {
     dispatcher.setColorSource(&source);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddColorSourceImage(source.image().get());
+  }
 };
 
 // 4 byte header + 24 bytes for the DlColorFilterImageFilter
@@ -263,6 +280,15 @@ struct SetSharedImageFilterOp : DLOp {
     return Equals(filter, other->filter) ? DisplayListCompare::kEqual
                                          : DisplayListCompare::kNotEqual;
   }
+
+  bool hash(DisplayListHasher& hasher) const {
+    hasher.AddImageFilter(filter.get());
+    return true;
+  }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddImageFilter(filter.get());
+  }
 };
 
 // 4 byte header + no payload uses minimum 8 bytes (4 bytes unused)
@@ -460,6 +486,16 @@ DEFINE_CLIP_SHAPE_OP(RRect, Difference)
       return is_aa == other->is_aa && path == other->path                \
                  ? DisplayListCompare::kEqual                            \
                  : DisplayListCompare::kNotEqual;                        \
+    }                                                                    \
+                                                                         \
+    bool hash(DisplayListHasher& hasher) const {                         \
+      hasher.Add(is_aa);                                                 \
+      hasher.AddPath(path);                                              \
+      return true;                                                       \
+    }                                                                    \
+                                                                         \
+    void AccountMemory(DisplayListMemoryAccountant& accountant) const {  \
+      accountant.AddPath(path);                                          \
     }                                                                    \
   };
 DEFINE_CLIP_PATH_OP(Intersect)
@@ -511,6 +547,23 @@ DEFINE_DRAW_1ARG_OP(Oval, SkRect, oval)
 DEFINE_DRAW_1ARG_OP(RRect, SkRRect, rrect)
 #undef DEFINE_DRAW_1ARG_OP
 
+// 4 byte header + 4 byte count packs efficiently into 8 bytes
+// followed by |count| SkRects which are always a multiple of 8 bytes.
+// The builder coalesces consecutive drawRect calls into this op, so the
+// |count| is not const as the batch is extended in place.
+struct DrawRectsOp final : DLOp {
+  static const auto kType = DisplayListOpType::kDrawRects;
+
+  explicit DrawRectsOp(uint32_t count) : count(count) {}
+
+  uint32_t count;
+
+  void dispatch(Dispatcher& dispatcher) const {
+    const SkRect* rects = reinterpret_cast<const SkRect*>(this + 1);
+    dispatcher.drawRects(rects, count);
+  }
+};
+
 // 4 byte header + 16 byte payload uses 20 bytes but is rounded up to 24 bytes
 // (4 bytes unused)
 struct DrawPathOp final : DLOp {
@@ -526,6 +579,15 @@ struct DrawPathOp final : DLOp {
     return path == other->path ? DisplayListCompare::kEqual
                                : DisplayListCompare::kNotEqual;
   }
+
+  bool hash(DisplayListHasher& hasher) const {
+    hasher.AddPath(path);
+    return true;
+  }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddPath(path);
+  }
 };
 
 // The common data is a 4 byte header with an unused 4 bytes
@@ -627,26 +689,34 @@ struct DrawSkVerticesOp final : DLOp {
   void dispatch(Dispatcher& dispatcher) const {
     dispatcher.drawSkVertices(vertices, mode);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddVertices(vertices.get());
+  }
 };
 
 // 4 byte header + 40 byte payload uses 44 bytes but is rounded up to 48 bytes
 // (4 bytes unused)
-#define DEFINE_DRAW_IMAGE_OP(name, with_attributes)                    \
-  struct name##Op final : DLOp {                                       \
-    static const auto kType = DisplayListOpType::k##name;              \
-                                                                       \
-    name##Op(const sk_sp<DlImage> image,                               \
-             const SkPoint& point,                                     \
-             const SkSamplingOptions& sampling)                        \
-        : point(point), sampling(sampling), image(std::move(image)) {} \
-                                                                       \
-    const SkPoint point;                                               \
-    const SkSamplingOptions sampling;                                  \
-    const sk_sp<DlImage> image;                                        \
-                                                                       \
-    void dispatch(Dispatcher& dispatcher) const {                      \
-      dispatcher.drawImage(image, point, sampling, with_attributes);   \
-    }                                                                  \
+#define DEFINE_DRAW_IMAGE_OP(name, with_attributes)                     \
+  struct name##Op final : DLOp {                                        \
+    static const auto kType = DisplayListOpType::k##name;               \
+                                                                        \
+    name##Op(const sk_sp<DlImage> image,                                \
+             const SkPoint& point,                                      \
+             const SkSamplingOptions& sampling)                         \
+        : point(point), sampling(sampling), image(std::move(image)) {}  \
+                                                                        \
+    const SkPoint point;                                                \
+    const SkSamplingOptions sampling;                                   \
+    const sk_sp<DlImage> image;                                         \
+                                                                        \
+    void dispatch(Dispatcher& dispatcher) const {                       \
+      dispatcher.drawImage(image, point, sampling, with_attributes);    \
+    }                                                                   \
+                                                                        \
+    void AccountMemory(DisplayListMemoryAccountant& accountant) const { \
+      accountant.AddImage(image.get());                                 \
+    }                                                                   \
   };
 DEFINE_DRAW_IMAGE_OP(DrawImage, false)
 DEFINE_DRAW_IMAGE_OP(DrawImageWithAttr, true)
@@ -681,6 +751,47 @@ struct DrawImageRectOp final : DLOp {
     dispatcher.drawImageRect(image, src, dst, sampling, render_with_attributes,
                              constraint);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddImage(image.get());
+  }
+};
+
+// 4 byte header + 44 byte payload packs efficiently into 48 bytes
+// followed by |count| pairs of src and dst SkRects, each of which is
+// 32 bytes and so always packs efficiently.
+// The builder coalesces consecutive drawImageRect calls that share the
+// same image, sampling and constraint into this op, so the |count| is
+// not const as the batch is extended in place.
+struct DrawImageRectsOp final : DLOp {
+  static const auto kType = DisplayListOpType::kDrawImageRects;
+
+  DrawImageRectsOp(const sk_sp<DlImage> image,
+                   uint32_t count,
+                   const SkSamplingOptions& sampling,
+                   bool render_with_attributes,
+                   SkCanvas::SrcRectConstraint constraint)
+      : count(count),
+        sampling(sampling),
+        render_with_attributes(render_with_attributes),
+        constraint(constraint),
+        image(std::move(image)) {}
+
+  uint32_t count;
+  const SkSamplingOptions sampling;
+  const bool render_with_attributes;
+  const SkCanvas::SrcRectConstraint constraint;
+  const sk_sp<DlImage> image;
+
+  void dispatch(Dispatcher& dispatcher) const {
+    const SkRect* rects = reinterpret_cast<const SkRect*>(this + 1);
+    dispatcher.drawImageRects(image, rects, count, sampling,
+                              render_with_attributes, constraint);
+  }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddImage(image.get());
+  }
 };
 
 // 4 byte header + 44 byte payload packs efficiently into 48 bytes
@@ -702,6 +813,10 @@ struct DrawImageRectOp final : DLOp {
     void dispatch(Dispatcher& dispatcher) const {                              \
       dispatcher.drawImageNine(image, center, dst, filter,                     \
                                render_with_attributes);                        \
+    }                                                                          \
+                                                                               \
+    void AccountMemory(DisplayListMemoryAccountant& accountant) const {        \
+      accountant.AddImage(image.get());                                        \
     }                                                                          \
   };
 DEFINE_DRAW_IMAGE_NINE_OP(DrawImageNine, false)
@@ -753,6 +868,10 @@ struct DrawImageLatticeOp final : DLOp {
         image, {xDivs, yDivs, types, x_count, y_count, &src, colors}, dst,
         filter, with_paint);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddImage(image.get());
+  }
 };
 
 // 4 byte header + 40 byte payload uses 44 bytes but is rounded up to 48 bytes
@@ -782,6 +901,10 @@ struct DrawAtlasBaseOp : DLOp {
   const uint8_t render_with_attributes;
   const SkSamplingOptions sampling;
   const sk_sp<DlImage> atlas;
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddImage(atlas.get());
+  }
 };
 
 // Packs into 48 bytes as per DrawAtlasBaseOp
@@ -862,6 +985,10 @@ struct DrawSkPictureOp final : DLOp {
   void dispatch(Dispatcher& dispatcher) const {
     dispatcher.drawPicture(picture, nullptr, render_with_attributes);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddPicture(picture.get());
+  }
 };
 
 // 4 byte header + 52 byte payload packs evenly into 56 bytes
@@ -882,6 +1009,10 @@ struct DrawSkPictureMatrixOp final : DLOp {
   void dispatch(Dispatcher& dispatcher) const {
     dispatcher.drawPicture(picture, &matrix, render_with_attributes);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddPicture(picture.get());
+  }
 };
 
 // 4 byte header + ptr aligned payload uses 12 bytes round up to 16
@@ -903,6 +1034,15 @@ struct DrawDisplayListOp final : DLOp {
                ? DisplayListCompare::kEqual
                : DisplayListCompare::kNotEqual;
   }
+
+  bool hash(DisplayListHasher& hasher) const {
+    hasher.Add(display_list->content_hash());
+    return true;
+  }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddNestedDisplayList(display_list.get());
+  }
 };
 
 // 4 byte header + 8 payload bytes + an aligned pointer take 24 bytes
@@ -920,6 +1060,10 @@ struct DrawTextBlobOp final : DLOp {
   void dispatch(Dispatcher& dispatcher) const {
     dispatcher.drawTextBlob(blob, x, y);
   }
+
+  void AccountMemory(DisplayListMemoryAccountant& accountant) const {
+    accountant.AddTextBlob(blob.get());
+  }
 };
 
 // 4 byte header + 28 byte payload packs evenly into 32 bytes
@@ -941,6 +1085,10 @@ struct DrawTextBlobOp final : DLOp {
     void dispatch(Dispatcher& dispatcher) const {                         \
       dispatcher.drawShadow(path, color, elevation, transparent_occluder, \
                             dpr);                                         \
+    }                                                                     \
+                                                                          \
+    void AccountMemory(DisplayListMemoryAccountant& accountant) const {   \
+      accountant.AddPath(path);                                           \
     }                                                                     \
   };
 DEFINE_DRAW_SHADOW_OP(Shadow, false)
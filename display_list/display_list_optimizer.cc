@@ -0,0 +1,699 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_optimizer.h"
+
+#include <vector>
+
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_comparable.h"
+#include "flutter/display_list/display_list_dispatcher.h"
+#include "flutter/display_list/display_list_paint.h"
+#include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// A Dispatcher that re-records the ops of a DisplayList into a builder,
+// deferring attribute, save, transform and clip ops until a rendering op
+// needs them so that the ops which are never needed can be dropped.
+//
+// A |DisplayListBoundsCalculator| sees every op in its original form so
+// that the bounds of each rendering op are computed against the true
+// transform and clip, regardless of which of those ops end up in the
+// optimized DisplayList.
+class OptimizingDispatcher final : public virtual Dispatcher {
+ public:
+  OptimizingDispatcher(const SkRect& cull_rect,
+                       bool prepare_rtree,
+                       DisplayListOptimizer::Stats& stats)
+      : builder_(cull_rect, prepare_rtree),
+        calculator_(&cull_rect),
+        cull_rect_(cull_rect),
+        stats_(stats) {}
+
+  sk_sp<DisplayList> Build() {
+    // Any save, transform or clip ops that are still pending at the end
+    // of the list did not affect any rendering op.
+    DropPendingOps(0);
+    stats_.attribute_ops_removed =
+        attribute_ops_received_ - attribute_ops_emitted_;
+    stats_.transform_ops_removed =
+        transform_ops_received_ - transform_ops_emitted_;
+    return builder_.Build();
+  }
+
+  void setAntiAlias(bool aa) override {
+    attribute_ops_received_++;
+    calculator_.setAntiAlias(aa);
+    desired_.setAntiAlias(aa);
+  }
+  void setDither(bool dither) override {
+    attribute_ops_received_++;
+    calculator_.setDither(dither);
+    desired_.setDither(dither);
+  }
+  void setStyle(DlDrawStyle style) override {
+    attribute_ops_received_++;
+    calculator_.setStyle(style);
+    desired_.setDrawStyle(style);
+  }
+  void setColor(DlColor color) override {
+    attribute_ops_received_++;
+    calculator_.setColor(color);
+    desired_.setColor(color);
+  }
+  void setStrokeWidth(float width) override {
+    attribute_ops_received_++;
+    calculator_.setStrokeWidth(width);
+    desired_.setStrokeWidth(width);
+  }
+  void setStrokeMiter(float limit) override {
+    attribute_ops_received_++;
+    calculator_.setStrokeMiter(limit);
+    desired_.setStrokeMiter(limit);
+  }
+  void setStrokeCap(DlStrokeCap cap) override {
+    attribute_ops_received_++;
+    calculator_.setStrokeCap(cap);
+    desired_.setStrokeCap(cap);
+  }
+  void setStrokeJoin(DlStrokeJoin join) override {
+    attribute_ops_received_++;
+    calculator_.setStrokeJoin(join);
+    desired_.setStrokeJoin(join);
+  }
+  void setColorSource(const DlColorSource* source) override {
+    attribute_ops_received_++;
+    calculator_.setColorSource(source);
+    desired_.setColorSource(source);
+  }
+  void setColorFilter(const DlColorFilter* filter) override {
+    attribute_ops_received_++;
+    calculator_.setColorFilter(filter);
+    desired_.setColorFilter(filter);
+  }
+  void setInvertColors(bool invert) override {
+    attribute_ops_received_++;
+    calculator_.setInvertColors(invert);
+    desired_.setInvertColors(invert);
+  }
+  void setBlendMode(DlBlendMode mode) override {
+    attribute_ops_received_++;
+    calculator_.setBlendMode(mode);
+    desired_.setBlendMode(mode);
+    desired_blender_ = nullptr;
+  }
+  void setBlender(sk_sp<SkBlender> blender) override {
+    attribute_ops_received_++;
+    calculator_.setBlender(blender);
+    if (blender) {
+      desired_blender_ = std::move(blender);
+    } else {
+      desired_.setBlendMode(DlBlendMode::kSrcOver);
+      desired_blender_ = nullptr;
+    }
+  }
+  void setPathEffect(sk_sp<SkPathEffect> effect) override {
+    attribute_ops_received_++;
+    calculator_.setPathEffect(effect);
+    desired_path_effect_ = std::move(effect);
+  }
+  void setMaskFilter(const DlMaskFilter* filter) override {
+    attribute_ops_received_++;
+    calculator_.setMaskFilter(filter);
+    desired_.setMaskFilter(filter);
+  }
+  void setImageFilter(const DlImageFilter* filter) override {
+    attribute_ops_received_++;
+    calculator_.setImageFilter(filter);
+    desired_.setImageFilter(filter);
+  }
+
+  void save() override {
+    calculator_.save();
+    save_stack_.push_back(pending_ops_.size());
+    pending_ops_.emplace_back(PendingOp::Type::kSave);
+  }
+  void saveLayer(const SkRect* bounds,
+                 const SaveLayerOptions options) override {
+    calculator_.saveLayer(bounds, options);
+    // A saveLayer is always kept since an ImageFilter or a destructive
+    // blend mode on the layer can affect pixels even if nothing is
+    // rendered into it.
+    if (options.renders_with_attributes()) {
+      SyncAttributes();
+    }
+    FlushPendingOps();
+    builder_.saveLayer(bounds, options);
+    save_stack_.push_back(kFlushed);
+  }
+  void restore() override {
+    if (save_stack_.empty()) {
+      return;
+    }
+    calculator_.restore();
+    size_t save_index = save_stack_.back();
+    save_stack_.pop_back();
+    if (save_index == kFlushed) {
+      DropPendingOps(0);
+      builder_.restore();
+    } else {
+      // The save op itself is dropped along with everything after it.
+      DropPendingOps(save_index + 1);
+      pending_ops_.pop_back();
+      stats_.save_restore_pairs_removed++;
+    }
+  }
+
+  void translate(SkScalar tx, SkScalar ty) override {
+    calculator_.translate(tx, ty);
+    PendingTransform().matrix.preTranslate(tx, ty);
+  }
+  void scale(SkScalar sx, SkScalar sy) override {
+    calculator_.scale(sx, sy);
+    PendingTransform().matrix.preScale(sx, sy);
+  }
+  void rotate(SkScalar degrees) override {
+    calculator_.rotate(degrees);
+    PendingTransform().matrix.preConcat(SkMatrix::RotateDeg(degrees));
+  }
+  void skew(SkScalar sx, SkScalar sy) override {
+    calculator_.skew(sx, sy);
+    PendingTransform().matrix.preConcat(SkMatrix::Skew(sx, sy));
+  }
+
+  // clang-format off
+
+  void transform2DAffine(SkScalar mxx, SkScalar mxy, SkScalar mxt,
+                         SkScalar myx, SkScalar myy, SkScalar myt) override {
+    calculator_.transform2DAffine(mxx, mxy, mxt,
+                                  myx, myy, myt);
+    PendingTransform().matrix.preConcat({
+        mxx, mxy,  0 , mxt,
+        myx, myy,  0 , myt,
+         0 ,  0 ,  1 ,  0 ,
+         0 ,  0 ,  0 ,  1 ,
+    });
+  }
+  void transformFullPerspective(
+      SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+      SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+      SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+      SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) override {
+    calculator_.transformFullPerspective(mxx, mxy, mxz, mxt,
+                                         myx, myy, myz, myt,
+                                         mzx, mzy, mzz, mzt,
+                                         mwx, mwy, mwz, mwt);
+    PendingTransform().matrix.preConcat({
+        mxx, mxy, mxz, mxt,
+        myx, myy, myz, myt,
+        mzx, mzy, mzz, mzt,
+        mwx, mwy, mwz, mwt,
+    });
+  }
+
+  // clang-format on
+
+  void transformReset() override {
+    calculator_.transformReset();
+    PendingOp& op = PendingTransform();
+    // Any transforms merged into this op so far are overwritten.
+    op.matrix.setIdentity();
+    op.reset = true;
+  }
+
+  void clipRect(const SkRect& rect, SkClipOp clip_op, bool is_aa) override {
+    calculator_.clipRect(rect, clip_op, is_aa);
+    if (clip_op == SkClipOp::kIntersect && !is_aa && !pending_ops_.empty()) {
+      // Consecutive non-antialiased rect intersections are equivalent to
+      // a single intersection with the intersection of the rects.
+      PendingOp& last = pending_ops_.back();
+      if (last.type == PendingOp::Type::kClipRect &&
+          last.clip_op == SkClipOp::kIntersect && !last.is_aa) {
+        if (!last.rect.intersect(rect)) {
+          last.rect.setEmpty();
+        }
+        stats_.clip_ops_removed++;
+        return;
+      }
+    }
+    PendingOp& op = pending_ops_.emplace_back(PendingOp::Type::kClipRect);
+    op.rect = rect;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+  }
+  void clipRRect(const SkRRect& rrect, SkClipOp clip_op, bool is_aa) override {
+    calculator_.clipRRect(rrect, clip_op, is_aa);
+    PendingOp& op = pending_ops_.emplace_back(PendingOp::Type::kClipRRect);
+    op.rrect = rrect;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+  }
+  void clipPath(const SkPath& path, SkClipOp clip_op, bool is_aa) override {
+    calculator_.clipPath(path, clip_op, is_aa);
+    PendingOp& op = pending_ops_.emplace_back(PendingOp::Type::kClipPath);
+    op.path = path;
+    op.clip_op = clip_op;
+    op.is_aa = is_aa;
+  }
+
+  void drawColor(DlColor color, DlBlendMode mode) override {
+    calculator_.drawColor(color, mode);
+    if (PrepareToRender()) {
+      builder_.drawColor(color, mode);
+    }
+  }
+  void drawPaint() override {
+    calculator_.drawPaint();
+    if (PrepareToRender()) {
+      builder_.drawPaint();
+    }
+  }
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override {
+    calculator_.drawLine(p0, p1);
+    if (PrepareToRender()) {
+      builder_.drawLine(p0, p1);
+    }
+  }
+  void drawRect(const SkRect& rect) override {
+    calculator_.drawRect(rect);
+    if (PrepareToRender()) {
+      builder_.drawRect(rect);
+    }
+  }
+  void drawOval(const SkRect& bounds) override {
+    calculator_.drawOval(bounds);
+    if (PrepareToRender()) {
+      builder_.drawOval(bounds);
+    }
+  }
+  void drawCircle(const SkPoint& center, SkScalar radius) override {
+    calculator_.drawCircle(center, radius);
+    if (PrepareToRender()) {
+      builder_.drawCircle(center, radius);
+    }
+  }
+  void drawRRect(const SkRRect& rrect) override {
+    calculator_.drawRRect(rrect);
+    if (PrepareToRender()) {
+      builder_.drawRRect(rrect);
+    }
+  }
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override {
+    calculator_.drawDRRect(outer, inner);
+    if (PrepareToRender()) {
+      builder_.drawDRRect(outer, inner);
+    }
+  }
+  void drawPath(const SkPath& path) override {
+    calculator_.drawPath(path);
+    if (PrepareToRender()) {
+      builder_.drawPath(path);
+    }
+  }
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override {
+    calculator_.drawArc(oval_bounds, start_degrees, sweep_degrees,
+                        use_center);
+    if (PrepareToRender()) {
+      builder_.drawArc(oval_bounds, start_degrees, sweep_degrees, use_center);
+    }
+  }
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override {
+    calculator_.drawPoints(mode, count, points);
+    if (PrepareToRender()) {
+      builder_.drawPoints(mode, count, points);
+    }
+  }
+  void drawSkVertices(const sk_sp<SkVertices> vertices,
+                      SkBlendMode mode) override {
+    calculator_.drawSkVertices(vertices, mode);
+    if (PrepareToRender()) {
+      builder_.drawSkVertices(vertices, mode);
+    }
+  }
+  void drawVertices(const DlVertices* vertices, DlBlendMode mode) override {
+    calculator_.drawVertices(vertices, mode);
+    if (PrepareToRender()) {
+      builder_.drawVertices(vertices, mode);
+    }
+  }
+  void drawImage(const sk_sp<DlImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override {
+    calculator_.drawImage(image, point, sampling, render_with_attributes);
+    if (PrepareToRender()) {
+      builder_.drawImage(image, point, sampling, render_with_attributes);
+    }
+  }
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override {
+    calculator_.drawImageRect(image, src, dst, sampling,
+                              render_with_attributes, constraint);
+    if (PrepareToRender()) {
+      builder_.drawImageRect(image, src, dst, sampling, render_with_attributes,
+                             constraint);
+    }
+  }
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override {
+    calculator_.drawImageNine(image, center, dst, filter,
+                              render_with_attributes);
+    if (PrepareToRender()) {
+      builder_.drawImageNine(image, center, dst, filter,
+                             render_with_attributes);
+    }
+  }
+  void drawImageLattice(const sk_sp<DlImage> image,
+                        const SkCanvas::Lattice& lattice,
+                        const SkRect& dst,
+                        SkFilterMode filter,
+                        bool render_with_attributes) override {
+    calculator_.drawImageLattice(image, lattice, dst, filter,
+                                 render_with_attributes);
+    if (PrepareToRender()) {
+      builder_.drawImageLattice(image, lattice, dst, filter,
+                                render_with_attributes);
+    }
+  }
+  void drawAtlas(const sk_sp<DlImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const DlColor colors[],
+                 int count,
+                 DlBlendMode mode,
+                 const SkSamplingOptions& sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override {
+    calculator_.drawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                          cull_rect, render_with_attributes);
+    if (PrepareToRender()) {
+      builder_.drawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                         cull_rect, render_with_attributes);
+    }
+  }
+  void drawPicture(const sk_sp<SkPicture> picture,
+                   const SkMatrix* matrix,
+                   bool render_with_attributes) override {
+    calculator_.drawPicture(picture, matrix, render_with_attributes);
+    if (PrepareToRender()) {
+      builder_.drawPicture(picture, matrix, render_with_attributes);
+    }
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override {
+    calculator_.drawDisplayList(display_list);
+    if (PrepareToRender()) {
+      builder_.drawDisplayList(display_list);
+    }
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override {
+    calculator_.drawTextBlob(blob, x, y);
+    if (PrepareToRender()) {
+      builder_.drawTextBlob(blob, x, y);
+    }
+  }
+  void drawShadow(const SkPath& path,
+                  const DlColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override {
+    calculator_.drawShadow(path, color, elevation, transparent_occluder, dpr);
+    if (PrepareToRender()) {
+      builder_.drawShadow(path, color, elevation, transparent_occluder, dpr);
+    }
+  }
+
+ private:
+  // A save, transform or clip op that has not yet been recorded in the
+  // builder because no rendering op has needed it yet.
+  struct PendingOp {
+    enum class Type {
+      kSave,
+      kTransform,
+      kClipRect,
+      kClipRRect,
+      kClipPath,
+    };
+
+    explicit PendingOp(Type type) : type(type) {}
+
+    Type type;
+
+    // kTransform
+    SkM44 matrix;
+    bool reset = false;
+
+    // kClipRect, kClipRRect, kClipPath
+    SkRect rect;
+    SkRRect rrect;
+    SkPath path;
+    SkClipOp clip_op = SkClipOp::kIntersect;
+    bool is_aa = false;
+  };
+
+  // The value recorded in |save_stack_| for a save or saveLayer that
+  // has already been recorded in the builder.
+  static constexpr size_t kFlushed = static_cast<size_t>(-1);
+
+  DisplayListBuilder builder_;
+  DisplayListBoundsCalculator calculator_;
+  const SkRect cull_rect_;
+  DisplayListOptimizer::Stats& stats_;
+
+  // The attributes most recently dispatched to us and the attributes
+  // most recently recorded in the builder.
+  DlPaint desired_;
+  sk_sp<SkBlender> desired_blender_;
+  sk_sp<SkPathEffect> desired_path_effect_;
+  DlPaint emitted_;
+  sk_sp<SkBlender> emitted_blender_;
+  sk_sp<SkPathEffect> emitted_path_effect_;
+
+  std::vector<PendingOp> pending_ops_;
+
+  // One entry for each save or saveLayer that has not been restored,
+  // holding either the index of its op in |pending_ops_| or |kFlushed|.
+  std::vector<size_t> save_stack_;
+
+  int attribute_ops_received_ = 0;
+  int attribute_ops_emitted_ = 0;
+  int transform_ops_received_ = 0;
+  int transform_ops_emitted_ = 0;
+
+  // Returns the pending transform op that the next transform should be
+  // merged into, creating it if the most recent pending op is not a
+  // transform.
+  PendingOp& PendingTransform() {
+    transform_ops_received_++;
+    if (pending_ops_.empty() ||
+        pending_ops_.back().type != PendingOp::Type::kTransform) {
+      pending_ops_.emplace_back(PendingOp::Type::kTransform);
+    }
+    return pending_ops_.back();
+  }
+
+  // Determines whether the rendering op that was just dispatched to the
+  // |calculator_| is visible and, if so, records the attributes and
+  // pending ops that it depends on in the builder. An op is visible if
+  // its bounds, after the transform and clips in effect, intersect the
+  // cull rect of the DisplayList.
+  bool PrepareToRender() {
+    bool visible = calculator_.op_bounds().intersects(cull_rect_);
+    calculator_.ResetOpBounds();
+    if (!visible) {
+      stats_.draw_ops_culled++;
+      return false;
+    }
+    SyncAttributes();
+    FlushPendingOps();
+    return true;
+  }
+
+  void SyncAttributes() {
+    if (emitted_.isAntiAlias() != desired_.isAntiAlias()) {
+      builder_.setAntiAlias(desired_.isAntiAlias());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.isDither() != desired_.isDither()) {
+      builder_.setDither(desired_.isDither());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.isInvertColors() != desired_.isInvertColors()) {
+      builder_.setInvertColors(desired_.isInvertColors());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getColor() != desired_.getColor()) {
+      builder_.setColor(desired_.getColor());
+      attribute_ops_emitted_++;
+    }
+    if (desired_blender_) {
+      if (emitted_blender_ != desired_blender_) {
+        builder_.setBlender(desired_blender_);
+        attribute_ops_emitted_++;
+      }
+    } else if (emitted_blender_ ||
+               emitted_.getBlendMode() != desired_.getBlendMode()) {
+      builder_.setBlendMode(desired_.getBlendMode());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getDrawStyle() != desired_.getDrawStyle()) {
+      builder_.setStyle(desired_.getDrawStyle());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getStrokeCap() != desired_.getStrokeCap()) {
+      builder_.setStrokeCap(desired_.getStrokeCap());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getStrokeJoin() != desired_.getStrokeJoin()) {
+      builder_.setStrokeJoin(desired_.getStrokeJoin());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getStrokeWidth() != desired_.getStrokeWidth()) {
+      builder_.setStrokeWidth(desired_.getStrokeWidth());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_.getStrokeMiter() != desired_.getStrokeMiter()) {
+      builder_.setStrokeMiter(desired_.getStrokeMiter());
+      attribute_ops_emitted_++;
+    }
+    if (emitted_path_effect_ != desired_path_effect_) {
+      builder_.setPathEffect(desired_path_effect_);
+      attribute_ops_emitted_++;
+    }
+    if (NotEquals(emitted_.getColorSource(), desired_.getColorSource())) {
+      builder_.setColorSource(desired_.getColorSourcePtr());
+      attribute_ops_emitted_++;
+    }
+    if (NotEquals(emitted_.getColorFilter(), desired_.getColorFilter())) {
+      builder_.setColorFilter(desired_.getColorFilterPtr());
+      attribute_ops_emitted_++;
+    }
+    if (NotEquals(emitted_.getImageFilter(), desired_.getImageFilter())) {
+      builder_.setImageFilter(desired_.getImageFilterPtr());
+      attribute_ops_emitted_++;
+    }
+    if (NotEquals(emitted_.getMaskFilter(), desired_.getMaskFilter())) {
+      builder_.setMaskFilter(desired_.getMaskFilterPtr());
+      attribute_ops_emitted_++;
+    }
+    emitted_ = desired_;
+    emitted_blender_ = desired_blender_;
+    emitted_path_effect_ = desired_path_effect_;
+  }
+
+  void FlushPendingOps() {
+    for (const PendingOp& op : pending_ops_) {
+      switch (op.type) {
+        case PendingOp::Type::kSave:
+          builder_.save();
+          break;
+        case PendingOp::Type::kTransform:
+          EmitTransform(op);
+          break;
+        case PendingOp::Type::kClipRect:
+          builder_.clipRect(op.rect, op.clip_op, op.is_aa);
+          break;
+        case PendingOp::Type::kClipRRect:
+          builder_.clipRRect(op.rrect, op.clip_op, op.is_aa);
+          break;
+        case PendingOp::Type::kClipPath:
+          builder_.clipPath(op.path, op.clip_op, op.is_aa);
+          break;
+      }
+    }
+    pending_ops_.clear();
+    // The unflushed saves are always the most recent entries.
+    for (auto it = save_stack_.rbegin();
+         it != save_stack_.rend() && *it != kFlushed; ++it) {
+      *it = kFlushed;
+    }
+  }
+
+  // Drops the pending ops starting at |start| without recording them.
+  void DropPendingOps(size_t start) {
+    for (size_t i = start; i < pending_ops_.size(); i++) {
+      switch (pending_ops_[i].type) {
+        case PendingOp::Type::kClipRect:
+        case PendingOp::Type::kClipRRect:
+        case PendingOp::Type::kClipPath:
+          stats_.clip_ops_removed++;
+          break;
+        case PendingOp::Type::kSave:
+          // Only reachable at the end of the list since restore pops
+          // the unflushed saves before their enclosing ops are dropped.
+          stats_.save_restore_pairs_removed++;
+          break;
+        case PendingOp::Type::kTransform:
+          // Accounted for by |transform_ops_received_|.
+          break;
+      }
+    }
+    pending_ops_.erase(pending_ops_.begin() + start, pending_ops_.end());
+  }
+
+  // Records a merged transform op in the simplest form that represents
+  // its matrix.
+  void EmitTransform(const PendingOp& op) {
+    if (op.reset) {
+      builder_.transformReset();
+      transform_ops_emitted_++;
+    }
+    const SkM44& m = op.matrix;
+    if (m == SkM44()) {
+      return;
+    }
+    transform_ops_emitted_++;
+    bool is_scale_translate =
+        m.rc(0, 1) == 0 && m.rc(0, 2) == 0 &&  //
+        m.rc(1, 0) == 0 && m.rc(1, 2) == 0 &&  //
+        m.rc(2, 0) == 0 && m.rc(2, 1) == 0 &&  //
+        m.rc(2, 2) == 1 && m.rc(2, 3) == 0 &&  //
+        m.rc(3, 0) == 0 && m.rc(3, 1) == 0 &&  //
+        m.rc(3, 2) == 0 && m.rc(3, 3) == 1;
+    if (is_scale_translate && m.rc(0, 0) == 1 && m.rc(1, 1) == 1) {
+      builder_.translate(m.rc(0, 3), m.rc(1, 3));
+    } else if (is_scale_translate && m.rc(0, 3) == 0 && m.rc(1, 3) == 0) {
+      builder_.scale(m.rc(0, 0), m.rc(1, 1));
+    } else {
+      // Reduces to a 2D affine op where possible.
+      builder_.transform(&m);
+    }
+  }
+};
+
+}  // namespace
+
+sk_sp<DisplayList> DisplayListOptimizer::Optimize(
+    const sk_sp<DisplayList>& display_list,
+    Stats* stats) {
+  TRACE_EVENT0("flutter", "DisplayListOptimizer::Optimize");
+  Stats local_stats;
+  if (stats) {
+    *stats = Stats();
+  }
+  OptimizingDispatcher dispatcher(display_list->bounds_cull_,
+                                  display_list->has_rtree(),
+                                  stats ? *stats : local_stats);
+  display_list->Dispatch(dispatcher);
+  return dispatcher.Build();
+}
+
+}  // namespace flutter
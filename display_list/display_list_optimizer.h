@@ -0,0 +1,60 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// Produces a new DisplayList that renders the same output as an existing
+// DisplayList with fewer ops. The optimizer removes:
+//
+//  - attribute ops whose values are overwritten before any rendering
+//    op uses them or which restore a value that is already in effect,
+//  - save/restore pairs that do not enclose any rendering ops, along
+//    with the transform and clip ops recorded inside of them,
+//  - transform and clip ops that are not followed by any rendering op,
+//  - rendering ops whose bounds are empty, are entirely clipped out or
+//    do not intersect the cull rect of the DisplayList.
+//
+// Consecutive transform ops are merged into a single transform op of
+// the simplest type that can represent their concatenation.
+//
+// The optimization costs a full dispatch of the DisplayList and so it
+// is meant for lists that are recorded once and rendered many times,
+// such as those captured from a picture that will be raster cached or
+// reused across frames.
+class DisplayListOptimizer {
+ public:
+  // The number of ops removed from a DisplayList by each of the
+  // optimizations performed in |Optimize|.
+  struct Stats {
+    int attribute_ops_removed = 0;
+    int save_restore_pairs_removed = 0;
+    int transform_ops_removed = 0;
+    int clip_ops_removed = 0;
+    int draw_ops_culled = 0;
+
+    int ops_removed() const {
+      return attribute_ops_removed + 2 * save_restore_pairs_removed +
+             transform_ops_removed + clip_ops_removed + draw_ops_culled;
+    }
+  };
+
+  // Returns an optimized copy of |display_list| built with the same cull
+  // rect and with an rtree if the original has one. If |stats| is not
+  // null it is filled in with the number of ops that were removed.
+  static sk_sp<DisplayList> Optimize(const sk_sp<DisplayList>& display_list,
+                                     Stats* stats = nullptr);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListOptimizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
@@ -0,0 +1,1238 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_ops.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+
+namespace flutter {
+
+namespace {
+
+enum SideTable : uint32_t {
+  kPathTable,
+  kImageTable,
+  kTextBlobTable,
+  kPictureTable,
+  kDisplayListTable,
+  kColorFilterTable,
+  kColorSourceTable,
+  kImageFilterTable,
+  kMaskFilterTable,
+  kBlenderTable,
+  kPathEffectTable,
+
+  kSideTableCount,
+  kNoSideTable = kSideTableCount,
+};
+
+struct SideTableLocation {
+  uint64_t offset;
+  uint32_t count;
+  uint32_t reserved;
+};
+
+struct DisplayListFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t layout_signature;
+  uint32_t op_count;
+  uint64_t op_offset;
+  uint64_t op_bytes;
+  SkRect cull_rect;
+  SkRect bounds;
+  uint32_t can_apply_group_opacity;
+  uint32_t reserved;
+  SideTableLocation side_tables[kSideTableCount];
+};
+
+// Each entry in a side table is preceded by this header and padded
+// so that the next entry starts on a |kFileAlignment| boundary.
+struct SideTableEntryHeader {
+  uint32_t byte_count;
+  uint32_t reserved;
+};
+
+constexpr size_t kFileAlignment = 8;
+
+static_assert(sizeof(DisplayListFileHeader) % kFileAlignment == 0);
+static_assert(sizeof(SideTableEntryHeader) % kFileAlignment == 0);
+
+constexpr size_t AlignToFile(size_t size) {
+  return (size + kFileAlignment - 1) & ~(kFileAlignment - 1);
+}
+
+#define DL_OP_TO_COUNT(name) +1
+constexpr int kOpTypeCount = 0 FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_COUNT);
+#undef DL_OP_TO_COUNT
+
+#pragma pack(push, DLRecordPackLabel, 8)
+
+// The records that replace ops which refer to objects in the op stream.
+// Every record starts with the index of its object in the side table
+// so that the indices can be validated without knowing the record type.
+struct RefRecord : DLOp {
+  uint32_t index;
+};
+
+struct ClipPathRecord : RefRecord {
+  bool is_aa;
+};
+
+struct DrawImageRecord : RefRecord {
+  SkPoint point;
+  SkSamplingOptions sampling;
+};
+
+struct DrawImageRectRecord : RefRecord {
+  SkRect src;
+  SkRect dst;
+  SkSamplingOptions sampling;
+  bool render_with_attributes;
+  SkCanvas::SrcRectConstraint constraint;
+};
+
+// Followed by the same rect pairs as |DrawImageRectsOp|.
+struct DrawImageRectsRecord : RefRecord {
+  uint32_t count;
+  SkSamplingOptions sampling;
+  bool render_with_attributes;
+  SkCanvas::SrcRectConstraint constraint;
+};
+
+struct DrawImageNineRecord : RefRecord {
+  SkIRect center;
+  SkRect dst;
+  SkFilterMode filter;
+};
+
+// Followed by the same lattice arrays as |DrawImageLatticeOp|.
+struct DrawImageLatticeRecord : RefRecord {
+  bool with_paint;
+  int x_count;
+  int y_count;
+  int cell_count;
+  SkFilterMode filter;
+  SkIRect src;
+  SkRect dst;
+};
+
+// Followed by the same arrays as |DrawAtlasOp|. The |cull_rect| is only
+// used by the records of |DrawAtlasCulledOp|.
+struct DrawAtlasRecord : RefRecord {
+  int count;
+  uint16_t mode_index;
+  uint8_t has_colors;
+  uint8_t render_with_attributes;
+  SkSamplingOptions sampling;
+  SkRect cull_rect;
+};
+
+// The |matrix| is only used by the records of |DrawSkPictureMatrixOp|.
+struct DrawPictureRecord : RefRecord {
+  bool render_with_attributes;
+  SkMatrix matrix;
+};
+
+struct DrawTextBlobRecord : RefRecord {
+  SkScalar x;
+  SkScalar y;
+};
+
+struct DrawShadowRecord : RefRecord {
+  DlColor color;
+  SkScalar elevation;
+  SkScalar dpr;
+};
+
+#pragma pack(pop, DLRecordPackLabel)
+
+// Describes how the ops of a given type are stored in the op stream.
+struct OpStorage {
+  // Whether the op bytes are copied verbatim from the DisplayList.
+  bool verbatim;
+  // The minimum size of the op or record, 0 if it cannot be stored.
+  size_t min_size;
+  // The side table referenced by a record.
+  SideTable table;
+};
+
+static OpStorage GetOpStorage(DisplayListOpType type) {
+  switch (type) {
+#define DL_RECORD_STORAGE(name, record, table) \
+  case DisplayListOpType::k##name:             \
+    return {false, sizeof(record), table};
+
+    DL_RECORD_STORAGE(SetBlender, RefRecord, kBlenderTable)
+    DL_RECORD_STORAGE(SetPathEffect, RefRecord, kPathEffectTable)
+    DL_RECORD_STORAGE(SetPodColorFilter, RefRecord, kColorFilterTable)
+    DL_RECORD_STORAGE(SetSkColorFilter, RefRecord, kColorFilterTable)
+    DL_RECORD_STORAGE(SetPodColorSource, RefRecord, kColorSourceTable)
+    DL_RECORD_STORAGE(SetSkColorSource, RefRecord, kColorSourceTable)
+    DL_RECORD_STORAGE(SetImageColorSource, RefRecord, kColorSourceTable)
+    DL_RECORD_STORAGE(SetPodImageFilter, RefRecord, kImageFilterTable)
+    DL_RECORD_STORAGE(SetSkImageFilter, RefRecord, kImageFilterTable)
+    DL_RECORD_STORAGE(SetSharedImageFilter, RefRecord, kImageFilterTable)
+    DL_RECORD_STORAGE(SetPodMaskFilter, RefRecord, kMaskFilterTable)
+    DL_RECORD_STORAGE(SetSkMaskFilter, RefRecord, kMaskFilterTable)
+    DL_RECORD_STORAGE(ClipIntersectPath, ClipPathRecord, kPathTable)
+    DL_RECORD_STORAGE(ClipDifferencePath, ClipPathRecord, kPathTable)
+    DL_RECORD_STORAGE(DrawPath, RefRecord, kPathTable)
+    DL_RECORD_STORAGE(DrawImage, DrawImageRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageWithAttr, DrawImageRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageRect, DrawImageRectRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageRects, DrawImageRectsRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageNine, DrawImageNineRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageNineWithAttr, DrawImageNineRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawImageLattice, DrawImageLatticeRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawAtlas, DrawAtlasRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawAtlasCulled, DrawAtlasRecord, kImageTable)
+    DL_RECORD_STORAGE(DrawSkPicture, DrawPictureRecord, kPictureTable)
+    DL_RECORD_STORAGE(DrawSkPictureMatrix, DrawPictureRecord, kPictureTable)
+    DL_RECORD_STORAGE(DrawDisplayList, RefRecord, kDisplayListTable)
+    DL_RECORD_STORAGE(DrawTextBlob, DrawTextBlobRecord, kTextBlobTable)
+    DL_RECORD_STORAGE(DrawShadow, DrawShadowRecord, kPathTable)
+    DL_RECORD_STORAGE(DrawShadowTransparentOccluder,
+                      DrawShadowRecord,
+                      kPathTable)
+
+#undef DL_RECORD_STORAGE
+
+    // SkVertices offers no public means of serialization.
+    case DisplayListOpType::kDrawSkVertices:
+      return {false, 0, kNoSideTable};
+
+    default:
+      break;
+  }
+  switch (type) {
+#define DL_OP_STORAGE(name)        \
+  case DisplayListOpType::k##name: \
+    return {true, sizeof(name##Op), kNoSideTable};
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_STORAGE)
+
+#undef DL_OP_STORAGE
+  }
+  return {false, 0, kNoSideTable};
+}
+
+// Accumulates the op stream and side tables of a DisplayList file.
+class DisplayListWriter {
+ public:
+  DisplayListWriter() = default;
+
+  bool WriteOps(const uint8_t* ptr, const uint8_t* end);
+
+  sk_sp<SkData> Finish(DisplayListFileHeader& header) const;
+
+ private:
+  template <typename T>
+  T* AddRecord(const DLOp* op,
+               uint32_t index,
+               const void* trailing = nullptr,
+               size_t trailing_bytes = 0) {
+    size_t size = SkAlignPtr(sizeof(T) + trailing_bytes);
+    size_t offset = ops_.size();
+    ops_.resize(offset + size);
+    T* record = new (ops_.data() + offset) T();
+    record->type = op->type;
+    record->size = size;
+    record->index = index;
+    if (trailing_bytes > 0) {
+      memcpy(record + 1, trailing, trailing_bytes);
+    }
+    return record;
+  }
+
+  uint32_t AddEntry(SideTable table, sk_sp<SkData> data);
+  uint32_t AddPath(const SkPath& path);
+  uint32_t AddImage(const sk_sp<DlImage>& image);
+  uint32_t AddTextBlob(const sk_sp<SkTextBlob>& blob);
+  uint32_t AddPicture(const sk_sp<SkPicture>& picture);
+  uint32_t AddDisplayList(const sk_sp<DisplayList>& display_list);
+  uint32_t AddFlattenable(SideTable table, const SkFlattenable* object);
+
+  uint32_t Fail(const char* reason) {
+    FML_LOG(ERROR) << "Could not serialize DisplayList: " << reason;
+    valid_ = false;
+    return 0;
+  }
+
+  std::vector<uint8_t> ops_;
+  std::vector<sk_sp<SkData>> entries_[kSideTableCount];
+  // Identical entries are only stored once.
+  std::unordered_map<std::string, uint32_t> entry_indices_[kSideTableCount];
+  // Avoids serializing the same shared object repeatedly.
+  std::unordered_map<const void*, uint32_t> object_indices_[kSideTableCount];
+  bool valid_ = true;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListWriter);
+};
+
+uint32_t DisplayListWriter::AddEntry(SideTable table, sk_sp<SkData> data) {
+  if (!data) {
+    data = SkData::MakeEmpty();
+  }
+  std::string key(static_cast<const char*>(data->data()), data->size());
+  auto found = entry_indices_[table].find(key);
+  if (found != entry_indices_[table].end()) {
+    return found->second;
+  }
+  uint32_t index = entries_[table].size();
+  entries_[table].push_back(std::move(data));
+  entry_indices_[table].emplace(std::move(key), index);
+  return index;
+}
+
+uint32_t DisplayListWriter::AddPath(const SkPath& path) {
+  sk_sp<SkData> data = SkData::MakeUninitialized(path.writeToMemory(nullptr));
+  path.writeToMemory(data->writable_data());
+  return AddEntry(kPathTable, std::move(data));
+}
+
+uint32_t DisplayListWriter::AddImage(const sk_sp<DlImage>& image) {
+  auto found = object_indices_[kImageTable].find(image.get());
+  if (found != object_indices_[kImageTable].end()) {
+    return found->second;
+  }
+  sk_sp<SkImage> sk_image = image ? image->skia_image() : nullptr;
+  if (!sk_image || sk_image->isTextureBacked()) {
+    return Fail("image is not a raster or lazy generated image");
+  }
+  sk_sp<SkData> encoded = sk_image->refEncodedData();
+  if (!encoded) {
+    encoded = sk_image->encodeToData();
+  }
+  if (!encoded) {
+    return Fail("image could not be encoded");
+  }
+  uint32_t index = AddEntry(kImageTable, std::move(encoded));
+  object_indices_[kImageTable][image.get()] = index;
+  return index;
+}
+
+uint32_t DisplayListWriter::AddTextBlob(const sk_sp<SkTextBlob>& blob) {
+  auto found = object_indices_[kTextBlobTable].find(blob.get());
+  if (found != object_indices_[kTextBlobTable].end()) {
+    return found->second;
+  }
+  uint32_t index = AddEntry(kTextBlobTable, blob->serialize(SkSerialProcs()));
+  object_indices_[kTextBlobTable][blob.get()] = index;
+  return index;
+}
+
+uint32_t DisplayListWriter::AddPicture(const sk_sp<SkPicture>& picture) {
+  auto found = object_indices_[kPictureTable].find(picture.get());
+  if (found != object_indices_[kPictureTable].end()) {
+    return found->second;
+  }
+  uint32_t index = AddEntry(kPictureTable, picture->serialize());
+  object_indices_[kPictureTable][picture.get()] = index;
+  return index;
+}
+
+uint32_t DisplayListWriter::AddDisplayList(
+    const sk_sp<DisplayList>& display_list) {
+  auto found = object_indices_[kDisplayListTable].find(display_list.get());
+  if (found != object_indices_[kDisplayListTable].end()) {
+    return found->second;
+  }
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(display_list);
+  if (!data) {
+    return Fail("nested DisplayList could not be serialized");
+  }
+  uint32_t index = AddEntry(kDisplayListTable, std::move(data));
+  object_indices_[kDisplayListTable][display_list.get()] = index;
+  return index;
+}
+
+uint32_t DisplayListWriter::AddFlattenable(SideTable table,
+                                           const SkFlattenable* object) {
+  // A null object is stored as an empty entry.
+  return AddEntry(table, object ? object->serialize() : nullptr);
+}
+
+bool DisplayListWriter::WriteOps(const uint8_t* ptr, const uint8_t* end) {
+  while (ptr < end && valid_) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    switch (op->type) {
+      case DisplayListOpType::kSetBlender: {
+        auto blender = static_cast<const SetBlenderOp*>(op)->blender.get();
+        AddRecord<RefRecord>(op, AddFlattenable(kBlenderTable, blender));
+        break;
+      }
+      case DisplayListOpType::kSetPathEffect: {
+        auto effect = static_cast<const SetPathEffectOp*>(op)->effect.get();
+        AddRecord<RefRecord>(op, AddFlattenable(kPathEffectTable, effect));
+        break;
+      }
+
+#define DL_WRITE_ATTRIBUTE_OPS(name, field, table)                             \
+  case DisplayListOpType::kSetPod##name: {                                     \
+    auto attribute = reinterpret_cast<const Dl##name*>(                        \
+        static_cast<const SetPod##name##Op*>(op) + 1);                         \
+    AddRecord<RefRecord>(                                                      \
+        op, AddFlattenable(table, attribute->skia_object().get()));            \
+    break;                                                                     \
+  }                                                                            \
+  case DisplayListOpType::kSetSk##name:                                        \
+    AddRecord<RefRecord>(                                                      \
+        op, AddFlattenable(                                                    \
+                table, static_cast<const SetSk##name##Op*>(op)->field.get())); \
+    break;
+
+        DL_WRITE_ATTRIBUTE_OPS(ColorFilter, filter, kColorFilterTable)
+        DL_WRITE_ATTRIBUTE_OPS(ColorSource, source, kColorSourceTable)
+        DL_WRITE_ATTRIBUTE_OPS(ImageFilter, filter, kImageFilterTable)
+        DL_WRITE_ATTRIBUTE_OPS(MaskFilter, filter, kMaskFilterTable)
+
+#undef DL_WRITE_ATTRIBUTE_OPS
+
+      case DisplayListOpType::kSetImageColorSource: {
+        auto source = &static_cast<const SetImageColorSourceOp*>(op)->source;
+        AddRecord<RefRecord>(
+            op, AddFlattenable(kColorSourceTable, source->skia_object().get()));
+        break;
+      }
+      case DisplayListOpType::kSetSharedImageFilter: {
+        auto filter = static_cast<const SetSharedImageFilterOp*>(op)->filter;
+        AddRecord<RefRecord>(
+            op, AddFlattenable(kImageFilterTable, filter->skia_object().get()));
+        break;
+      }
+
+      case DisplayListOpType::kClipIntersectPath: {
+        auto clip_op = static_cast<const ClipIntersectPathOp*>(op);
+        AddRecord<ClipPathRecord>(op, AddPath(clip_op->path))->is_aa =
+            clip_op->is_aa;
+        break;
+      }
+      case DisplayListOpType::kClipDifferencePath: {
+        auto clip_op = static_cast<const ClipDifferencePathOp*>(op);
+        AddRecord<ClipPathRecord>(op, AddPath(clip_op->path))->is_aa =
+            clip_op->is_aa;
+        break;
+      }
+      case DisplayListOpType::kDrawPath:
+        AddRecord<RefRecord>(
+            op, AddPath(static_cast<const DrawPathOp*>(op)->path));
+        break;
+
+      case DisplayListOpType::kDrawSkVertices:
+        Fail("SkVertices cannot be serialized");
+        break;
+
+#define DL_WRITE_IMAGE_OP(name)                                    \
+  case DisplayListOpType::k##name: {                               \
+    auto image_op = static_cast<const name##Op*>(op);              \
+    auto record =                                                  \
+        AddRecord<DrawImageRecord>(op, AddImage(image_op->image)); \
+    record->point = image_op->point;                               \
+    record->sampling = image_op->sampling;                         \
+    break;                                                         \
+  }
+        DL_WRITE_IMAGE_OP(DrawImage)
+        DL_WRITE_IMAGE_OP(DrawImageWithAttr)
+#undef DL_WRITE_IMAGE_OP
+
+      case DisplayListOpType::kDrawImageRect: {
+        auto image_op = static_cast<const DrawImageRectOp*>(op);
+        auto record =
+            AddRecord<DrawImageRectRecord>(op, AddImage(image_op->image));
+        record->src = image_op->src;
+        record->dst = image_op->dst;
+        record->sampling = image_op->sampling;
+        record->render_with_attributes = image_op->render_with_attributes;
+        record->constraint = image_op->constraint;
+        break;
+      }
+      case DisplayListOpType::kDrawImageRects: {
+        auto image_op = static_cast<const DrawImageRectsOp*>(op);
+        uint32_t index = AddImage(image_op->image);
+        auto record = AddRecord<DrawImageRectsRecord>(
+            op, index, image_op + 1, op->size - sizeof(DrawImageRectsOp));
+        record->count = image_op->count;
+        record->sampling = image_op->sampling;
+        record->render_with_attributes = image_op->render_with_attributes;
+        record->constraint = image_op->constraint;
+        break;
+      }
+
+#define DL_WRITE_IMAGE_NINE_OP(name)                                   \
+  case DisplayListOpType::k##name: {                                   \
+    auto image_op = static_cast<const name##Op*>(op);                  \
+    auto record =                                                      \
+        AddRecord<DrawImageNineRecord>(op, AddImage(image_op->image)); \
+    record->center = image_op->center;                                 \
+    record->dst = image_op->dst;                                       \
+    record->filter = image_op->filter;                                 \
+    break;                                                             \
+  }
+        DL_WRITE_IMAGE_NINE_OP(DrawImageNine)
+        DL_WRITE_IMAGE_NINE_OP(DrawImageNineWithAttr)
+#undef DL_WRITE_IMAGE_NINE_OP
+
+      case DisplayListOpType::kDrawImageLattice: {
+        auto image_op = static_cast<const DrawImageLatticeOp*>(op);
+        uint32_t index = AddImage(image_op->image);
+        auto record = AddRecord<DrawImageLatticeRecord>(
+            op, index, image_op + 1, op->size - sizeof(DrawImageLatticeOp));
+        record->with_paint = image_op->with_paint;
+        record->x_count = image_op->x_count;
+        record->y_count = image_op->y_count;
+        record->cell_count = image_op->cell_count;
+        record->filter = image_op->filter;
+        record->src = image_op->src;
+        record->dst = image_op->dst;
+        break;
+      }
+
+#define DL_WRITE_ATLAS_OP(name, culled)                                    \
+  case DisplayListOpType::k##name: {                                       \
+    auto atlas_op = static_cast<const name##Op*>(op);                      \
+    uint32_t index = AddImage(atlas_op->atlas);                            \
+    auto record = AddRecord<DrawAtlasRecord>(op, index, atlas_op + 1,      \
+                                             op->size - sizeof(name##Op)); \
+    record->count = atlas_op->count;                                       \
+    record->mode_index = atlas_op->mode_index;                             \
+    record->has_colors = atlas_op->has_colors;                             \
+    record->render_with_attributes = atlas_op->render_with_attributes;     \
+    record->sampling = atlas_op->sampling;                                 \
+    if (culled) {                                                          \
+      record->cull_rect = atlas_op->cull_rect;                             \
+    }                                                                      \
+    break;                                                                 \
+  }
+        DL_WRITE_ATLAS_OP(DrawAtlas, false)
+        DL_WRITE_ATLAS_OP(DrawAtlasCulled, true)
+#undef DL_WRITE_ATLAS_OP
+
+      case DisplayListOpType::kDrawSkPicture: {
+        auto picture_op = static_cast<const DrawSkPictureOp*>(op);
+        auto record =
+            AddRecord<DrawPictureRecord>(op, AddPicture(picture_op->picture));
+        record->render_with_attributes = picture_op->render_with_attributes;
+        break;
+      }
+      case DisplayListOpType::kDrawSkPictureMatrix: {
+        auto picture_op = static_cast<const DrawSkPictureMatrixOp*>(op);
+        auto record =
+            AddRecord<DrawPictureRecord>(op, AddPicture(picture_op->picture));
+        record->render_with_attributes = picture_op->render_with_attributes;
+        record->matrix = picture_op->matrix;
+        break;
+      }
+      case DisplayListOpType::kDrawDisplayList:
+        AddRecord<RefRecord>(
+            op, AddDisplayList(
+                    static_cast<const DrawDisplayListOp*>(op)->display_list));
+        break;
+      case DisplayListOpType::kDrawTextBlob: {
+        auto blob_op = static_cast<const DrawTextBlobOp*>(op);
+        auto record =
+            AddRecord<DrawTextBlobRecord>(op, AddTextBlob(blob_op->blob));
+        record->x = blob_op->x;
+        record->y = blob_op->y;
+        break;
+      }
+
+#define DL_WRITE_SHADOW_OP(name)                                             \
+  case DisplayListOpType::kDraw##name: {                                     \
+    auto shadow_op = static_cast<const Draw##name##Op*>(op);                 \
+    auto record = AddRecord<DrawShadowRecord>(op, AddPath(shadow_op->path)); \
+    record->color = shadow_op->color;                                        \
+    record->elevation = shadow_op->elevation;                                \
+    record->dpr = shadow_op->dpr;                                            \
+    break;                                                                   \
+  }
+        DL_WRITE_SHADOW_OP(Shadow)
+        DL_WRITE_SHADOW_OP(ShadowTransparentOccluder)
+#undef DL_WRITE_SHADOW_OP
+
+      default:
+        FML_DCHECK(GetOpStorage(op->type).verbatim);
+        ops_.insert(ops_.end(), reinterpret_cast<const uint8_t*>(op), ptr);
+        break;
+    }
+  }
+  return valid_;
+}
+
+sk_sp<SkData> DisplayListWriter::Finish(DisplayListFileHeader& header) const {
+  size_t size = AlignToFile(sizeof(DisplayListFileHeader));
+  header.op_offset = size;
+  header.op_bytes = ops_.size();
+  size = AlignToFile(size + ops_.size());
+  for (int table = 0; table < kSideTableCount; table++) {
+    header.side_tables[table].offset = size;
+    header.side_tables[table].count = entries_[table].size();
+    for (const sk_sp<SkData>& entry : entries_[table]) {
+      size += sizeof(SideTableEntryHeader) + AlignToFile(entry->size());
+    }
+  }
+
+  sk_sp<SkData> data = SkData::MakeUninitialized(size);
+  uint8_t* base = static_cast<uint8_t*>(data->writable_data());
+  memset(base, 0, size);
+  memcpy(base, &header, sizeof(header));
+  if (!ops_.empty()) {
+    memcpy(base + header.op_offset, ops_.data(), ops_.size());
+  }
+  for (int table = 0; table < kSideTableCount; table++) {
+    uint8_t* ptr = base + header.side_tables[table].offset;
+    for (const sk_sp<SkData>& entry : entries_[table]) {
+      SideTableEntryHeader entry_header = {};
+      entry_header.byte_count = entry->size();
+      memcpy(ptr, &entry_header, sizeof(entry_header));
+      ptr += sizeof(entry_header);
+      if (entry->size() > 0) {
+        memcpy(ptr, entry->data(), entry->size());
+      }
+      ptr += AlignToFile(entry->size());
+    }
+  }
+  return data;
+}
+
+// Consumes |count| elements of |element_size| bytes from the |available|
+// bytes that follow the fixed size portion of an op or record.
+static bool ConsumeArray(int64_t count,
+                         size_t element_size,
+                         size_t& available) {
+  if (count < 0 || static_cast<uint64_t>(count) > available / element_size) {
+    return false;
+  }
+  available -= count * element_size;
+  return true;
+}
+
+// Returns true if the arrays that follow the fixed size portion of |op|
+// lie within |op->size| so that they can be dispatched without reading
+// past the end of the op.
+static bool ValidateTrailingData(const DLOp* op, size_t fixed_size) {
+  size_t available = op->size - fixed_size;
+  switch (op->type) {
+    case DisplayListOpType::kDrawRects:
+      return ConsumeArray(static_cast<const DrawRectsOp*>(op)->count,
+                          sizeof(SkRect), available);
+    case DisplayListOpType::kDrawPoints:
+      return ConsumeArray(static_cast<const DrawPointsOp*>(op)->count,
+                          sizeof(SkPoint), available);
+    case DisplayListOpType::kDrawLines:
+      return ConsumeArray(static_cast<const DrawLinesOp*>(op)->count,
+                          sizeof(SkPoint), available);
+    case DisplayListOpType::kDrawPolygon:
+      return ConsumeArray(static_cast<const DrawPolygonOp*>(op)->count,
+                          sizeof(SkPoint), available);
+    case DisplayListOpType::kDrawVertices: {
+      auto vertices_op = static_cast<const DrawVerticesOp*>(op);
+      return available >= sizeof(DlVertices) &&
+             reinterpret_cast<const DlVertices*>(vertices_op + 1)
+                 ->FitsInBytes(available);
+    }
+    case DisplayListOpType::kDrawImageRects:
+      // Each entry is a pair of source and destination rects.
+      return ConsumeArray(static_cast<const DrawImageRectsRecord*>(op)->count,
+                          2 * sizeof(SkRect), available);
+    case DisplayListOpType::kDrawImageLattice: {
+      auto record = static_cast<const DrawImageLatticeRecord*>(op);
+      int64_t x_count = record->x_count;
+      int64_t y_count = record->y_count;
+      // The builder only stores colors and rect types for all cells.
+      if (record->cell_count != 0 &&
+          record->cell_count != (x_count + 1) * (y_count + 1)) {
+        return false;
+      }
+      return ConsumeArray(x_count, sizeof(int), available) &&
+             ConsumeArray(y_count, sizeof(int), available) &&
+             ConsumeArray(record->cell_count,
+                          sizeof(SkColor) +
+                              sizeof(SkCanvas::Lattice::RectType),
+                          available);
+    }
+    case DisplayListOpType::kDrawAtlas:
+    case DisplayListOpType::kDrawAtlasCulled: {
+      auto record = static_cast<const DrawAtlasRecord*>(op);
+      if (record->mode_index > static_cast<int>(DlBlendMode::kLastMode)) {
+        return false;
+      }
+      size_t element_size = sizeof(SkRSXform) + sizeof(SkRect);
+      if (record->has_colors) {
+        element_size += sizeof(DlColor);
+      }
+      return ConsumeArray(record->count, element_size, available);
+    }
+    default:
+      return true;
+  }
+}
+
+// Returns true if |value| is one of the values of an enum that ends at
+// |last|, rejecting negative values as well.
+template <typename T>
+static bool IsEnumInRange(T value, T last) {
+  return static_cast<uint32_t>(value) <= static_cast<uint32_t>(last);
+}
+
+// Returns true if |options| only has the flags that SaveLayerOptions
+// defines set.
+static bool AreSaveLayerOptionsValid(const SaveLayerOptions& options) {
+  static_assert(sizeof(SaveLayerOptions) == sizeof(uint32_t));
+  SaveLayerOptions all_options = SaveLayerOptions()
+                                     .with_renders_with_attributes()
+                                     .with_can_distribute_opacity();
+  uint32_t flags;
+  uint32_t known_flags;
+  memcpy(&flags, &options, sizeof(flags));
+  memcpy(&known_flags, &all_options, sizeof(known_flags));
+  return (flags & ~known_flags) == 0;
+}
+
+// Returns true if the enum fields of |op| hold values of their enums.
+// Verbatim ops are dispatched as they are stored, so an out of range
+// value would reach the switch statements of the dispatchers. The point
+// mode of the DrawPoints ops is stored as the op type, which is checked
+// along with the size of the op.
+static bool ValidateEnumFields(const DLOp* op) {
+  switch (op->type) {
+    case DisplayListOpType::kSetBlendMode:
+      return IsEnumInRange(static_cast<const SetBlendModeOp*>(op)->mode,
+                           DlBlendMode::kLastMode);
+    case DisplayListOpType::kSetStyle:
+      return IsEnumInRange(static_cast<const SetStyleOp*>(op)->style,
+                           DlDrawStyle::kLastStyle);
+    case DisplayListOpType::kSetStrokeCap:
+      return IsEnumInRange(static_cast<const SetStrokeCapOp*>(op)->value,
+                           DlStrokeCap::kLastCap);
+    case DisplayListOpType::kSetStrokeJoin:
+      return IsEnumInRange(static_cast<const SetStrokeJoinOp*>(op)->value,
+                           DlStrokeJoin::kLastJoin);
+    case DisplayListOpType::kDrawColor:
+      return IsEnumInRange(static_cast<const DrawColorOp*>(op)->mode,
+                           DlBlendMode::kLastMode);
+    case DisplayListOpType::kDrawVertices:
+      return IsEnumInRange(static_cast<const DrawVerticesOp*>(op)->mode,
+                           DlBlendMode::kLastMode);
+    case DisplayListOpType::kSaveLayer:
+      return AreSaveLayerOptionsValid(
+          static_cast<const SaveLayerOp*>(op)->options);
+    case DisplayListOpType::kSaveLayerBounds:
+      return AreSaveLayerOptionsValid(
+          static_cast<const SaveLayerBoundsOp*>(op)->options);
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+uint32_t DisplayListSerializer::LayoutSignature() {
+  uint32_t signature = sizeof(void*);
+#define DL_OP_LAYOUT_SIGNATURE(name) \
+  signature = signature * 31 + sizeof(name##Op);
+
+  FOR_EACH_DISPLAY_LIST_OP(DL_OP_LAYOUT_SIGNATURE)
+
+#undef DL_OP_LAYOUT_SIGNATURE
+  return signature;
+}
+
+sk_sp<SkData> DisplayListSerializer::Serialize(
+    const sk_sp<DisplayList>& display_list) {
+  if (!display_list) {
+    return nullptr;
+  }
+  TRACE_EVENT0("flutter", "DisplayListSerializer::Serialize");
+  DisplayListWriter writer;
+  uint8_t* ptr = display_list->storage_.get();
+  if (!writer.WriteOps(ptr, ptr + display_list->byte_count_)) {
+    return nullptr;
+  }
+  DisplayListFileHeader header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.layout_signature = LayoutSignature();
+  header.op_count = display_list->op_count_;
+  header.cull_rect = display_list->bounds_cull_;
+  header.bounds = display_list->bounds();
+  header.can_apply_group_opacity = display_list->can_apply_group_opacity();
+  return writer.Finish(header);
+}
+
+std::unique_ptr<DisplayListMapping> DisplayListMapping::Create(
+    std::unique_ptr<const fml::Mapping> mapping) {
+  if (!mapping || !mapping->GetMapping()) {
+    return nullptr;
+  }
+  TRACE_EVENT0("flutter", "DisplayListMapping::Create");
+  std::unique_ptr<DisplayListMapping> result(
+      new DisplayListMapping(std::move(mapping)));
+  if (!result->Decode()) {
+    return nullptr;
+  }
+  return result;
+}
+
+std::unique_ptr<DisplayListMapping> DisplayListMapping::CreateFromFile(
+    const fml::UniqueFD& base_directory,
+    const std::string& file_name) {
+  return Create(fml::FileMapping::CreateReadOnly(base_directory, file_name));
+}
+
+DisplayListMapping::DisplayListMapping(
+    std::unique_ptr<const fml::Mapping> mapping)
+    : mapping_(std::move(mapping)) {}
+
+DisplayListMapping::~DisplayListMapping() = default;
+
+bool DisplayListMapping::Decode() {
+  const uint8_t* base = mapping_->GetMapping();
+  size_t size = mapping_->GetSize();
+  // The verbatim ops are dispatched in place so the mapping must be
+  // suitably aligned for them.
+  if (reinterpret_cast<uintptr_t>(base) % kFileAlignment != 0 ||
+      size < sizeof(DisplayListFileHeader)) {
+    return false;
+  }
+  DisplayListFileHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (header.magic != DisplayListSerializer::kMagic) {
+    FML_LOG(ERROR) << "Not a DisplayList file.";
+    return false;
+  }
+  if (header.version != DisplayListSerializer::kVersion ||
+      header.layout_signature != DisplayListSerializer::LayoutSignature()) {
+    FML_LOG(ERROR) << "DisplayList file was written by an incompatible engine.";
+    return false;
+  }
+  if (header.op_offset % kFileAlignment != 0 || header.op_offset > size ||
+      header.op_bytes > size - header.op_offset) {
+    return false;
+  }
+  ops_ = base + header.op_offset;
+  ops_end_ = ops_ + header.op_bytes;
+  op_count_ = header.op_count;
+  cull_rect_ = header.cull_rect;
+  bounds_ = header.bounds;
+  can_apply_group_opacity_ = header.can_apply_group_opacity != 0;
+
+  for (uint32_t table = 0; table < kSideTableCount; table++) {
+    const SideTableLocation& location = header.side_tables[table];
+    if (location.offset % kFileAlignment != 0 || location.offset > size) {
+      return false;
+    }
+    size_t offset = location.offset;
+    for (uint32_t i = 0; i < location.count; i++) {
+      if (size - offset < sizeof(SideTableEntryHeader)) {
+        return false;
+      }
+      SideTableEntryHeader entry_header;
+      memcpy(&entry_header, base + offset, sizeof(entry_header));
+      offset += sizeof(entry_header);
+      if (size - offset < entry_header.byte_count ||
+          !DecodeSideTableEntry(table, base + offset,
+                                entry_header.byte_count)) {
+        return false;
+      }
+      offset += AlignToFile(entry_header.byte_count);
+      offset = std::min(offset, size);
+    }
+  }
+  return ValidateOps();
+}
+
+template <typename T>
+static sk_sp<T> DeserializeFlattenable(SkFlattenable::Type type,
+                                       const uint8_t* data,
+                                       size_t size,
+                                       bool* valid) {
+  if (size == 0) {
+    return nullptr;
+  }
+  sk_sp<SkFlattenable> flattenable =
+      SkFlattenable::Deserialize(type, data, size);
+  *valid = flattenable != nullptr;
+  return sk_sp<T>(static_cast<T*>(flattenable.release()));
+}
+
+bool DisplayListMapping::DecodeSideTableEntry(uint32_t table,
+                                              const uint8_t* data,
+                                              size_t size) {
+  bool valid = true;
+  switch (table) {
+    case kPathTable: {
+      SkPath path;
+      valid = path.readFromMemory(data, size) > 0;
+      paths_.push_back(std::move(path));
+      break;
+    }
+    case kImageTable: {
+      sk_sp<SkImage> image =
+          SkImage::MakeFromEncoded(SkData::MakeWithCopy(data, size));
+      valid = image != nullptr;
+      images_.push_back(DlImage::Make(std::move(image)));
+      break;
+    }
+    case kTextBlobTable: {
+      sk_sp<SkTextBlob> blob =
+          SkTextBlob::Deserialize(data, size, SkDeserialProcs());
+      valid = blob != nullptr;
+      text_blobs_.push_back(std::move(blob));
+      break;
+    }
+    case kPictureTable: {
+      sk_sp<SkPicture> picture = SkPicture::MakeFromData(data, size);
+      valid = picture != nullptr;
+      pictures_.push_back(std::move(picture));
+      break;
+    }
+    case kDisplayListTable: {
+      // Nested lists are copied into regular DisplayLists since the
+      // |drawDisplayList| method requires a DisplayList object.
+      auto nested =
+          Create(std::make_unique<fml::NonOwnedMapping>(data, size));
+      valid = nested != nullptr;
+      display_lists_.push_back(valid ? nested->Build() : nullptr);
+      break;
+    }
+    case kColorFilterTable:
+      color_filters_.push_back(
+          DlColorFilter::From(DeserializeFlattenable<SkColorFilter>(
+              SkFlattenable::kSkColorFilter_Type, data, size, &valid)));
+      break;
+    case kColorSourceTable:
+      color_sources_.push_back(
+          DlColorSource::From(DeserializeFlattenable<SkShader>(
+              SkFlattenable::kSkShader_Type, data, size, &valid)));
+      break;
+    case kImageFilterTable:
+      image_filters_.push_back(
+          DlImageFilter::From(DeserializeFlattenable<SkImageFilter>(
+              SkFlattenable::kSkImageFilter_Type, data, size, &valid)));
+      break;
+    case kMaskFilterTable:
+      mask_filters_.push_back(
+          DlMaskFilter::From(DeserializeFlattenable<SkMaskFilter>(
+              SkFlattenable::kSkMaskFilter_Type, data, size, &valid)));
+      break;
+    case kBlenderTable:
+      blenders_.push_back(DeserializeFlattenable<SkBlender>(
+          SkFlattenable::kSkBlender_Type, data, size, &valid));
+      break;
+    case kPathEffectTable:
+      path_effects_.push_back(DeserializeFlattenable<SkPathEffect>(
+          SkFlattenable::kSkPathEffect_Type, data, size, &valid));
+      break;
+    default:
+      valid = false;
+      break;
+  }
+  if (!valid) {
+    FML_LOG(ERROR) << "Could not decode entry in DisplayList side table "
+                   << table;
+  }
+  return valid;
+}
+
+size_t DisplayListMapping::SideTableSize(uint32_t table) const {
+  switch (table) {
+    case kPathTable:
+      return paths_.size();
+    case kImageTable:
+      return images_.size();
+    case kTextBlobTable:
+      return text_blobs_.size();
+    case kPictureTable:
+      return pictures_.size();
+    case kDisplayListTable:
+      return display_lists_.size();
+    case kColorFilterTable:
+      return color_filters_.size();
+    case kColorSourceTable:
+      return color_sources_.size();
+    case kImageFilterTable:
+      return image_filters_.size();
+    case kMaskFilterTable:
+      return mask_filters_.size();
+    case kBlenderTable:
+      return blenders_.size();
+    case kPathEffectTable:
+      return path_effects_.size();
+    default:
+      return 0;
+  }
+}
+
+bool DisplayListMapping::ValidateOps() const {
+  const uint8_t* ptr = ops_;
+  while (ptr < ops_end_) {
+    if (static_cast<size_t>(ops_end_ - ptr) < sizeof(DLOp)) {
+      return false;
+    }
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    if (static_cast<int>(op->type) >= kOpTypeCount || op->size == 0 ||
+        op->size % alignof(void*) != 0 ||
+        op->size > static_cast<size_t>(ops_end_ - ptr)) {
+      return false;
+    }
+    OpStorage storage = GetOpStorage(op->type);
+    if (storage.min_size == 0 || op->size < storage.min_size) {
+      return false;
+    }
+    if (storage.table != kNoSideTable &&
+        static_cast<const RefRecord*>(op)->index >=
+            SideTableSize(storage.table)) {
+      return false;
+    }
+    if (!ValidateTrailingData(op, storage.min_size) ||
+        !ValidateEnumFields(op)) {
+      return false;
+    }
+    ptr += op->size;
+  }
+  return true;
+}
+
+void DisplayListMapping::Dispatch(Dispatcher& dispatcher) const {
+  TRACE_EVENT0("flutter", "DisplayListMapping::Dispatch");
+  const uint8_t* ptr = ops_;
+  while (ptr < ops_end_) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    switch (op->type) {
+      case DisplayListOpType::kSetBlender:
+        dispatcher.setBlender(
+            blenders_[static_cast<const RefRecord*>(op)->index]);
+        break;
+      case DisplayListOpType::kSetPathEffect:
+        dispatcher.setPathEffect(
+            path_effects_[static_cast<const RefRecord*>(op)->index]);
+        break;
+      case DisplayListOpType::kSetPodColorFilter:
+      case DisplayListOpType::kSetSkColorFilter:
+        dispatcher.setColorFilter(
+            color_filters_[static_cast<const RefRecord*>(op)->index].get());
+        break;
+      case DisplayListOpType::kSetPodColorSource:
+      case DisplayListOpType::kSetSkColorSource:
+      case DisplayListOpType::kSetImageColorSource:
+        dispatcher.setColorSource(
+            color_sources_[static_cast<const RefRecord*>(op)->index].get());
+        break;
+      case DisplayListOpType::kSetPodImageFilter:
+      case DisplayListOpType::kSetSkImageFilter:
+      case DisplayListOpType::kSetSharedImageFilter:
+        dispatcher.setImageFilter(
+            image_filters_[static_cast<const RefRecord*>(op)->index].get());
+        break;
+      case DisplayListOpType::kSetPodMaskFilter:
+      case DisplayListOpType::kSetSkMaskFilter:
+        dispatcher.setMaskFilter(
+            mask_filters_[static_cast<const RefRecord*>(op)->index].get());
+        break;
+
+      case DisplayListOpType::kClipIntersectPath: {
+        auto record = static_cast<const ClipPathRecord*>(op);
+        dispatcher.clipPath(paths_[record->index], SkClipOp::kIntersect,
+                            record->is_aa);
+        break;
+      }
+      case DisplayListOpType::kClipDifferencePath: {
+        auto record = static_cast<const ClipPathRecord*>(op);
+        dispatcher.clipPath(paths_[record->index], SkClipOp::kDifference,
+                            record->is_aa);
+        break;
+      }
+      case DisplayListOpType::kDrawPath:
+        dispatcher.drawPath(paths_[static_cast<const RefRecord*>(op)->index]);
+        break;
+
+      case DisplayListOpType::kDrawImage:
+      case DisplayListOpType::kDrawImageWithAttr: {
+        auto record = static_cast<const DrawImageRecord*>(op);
+        dispatcher.drawImage(
+            images_[record->index], record->point, record->sampling,
+            op->type == DisplayListOpType::kDrawImageWithAttr);
+        break;
+      }
+      case DisplayListOpType::kDrawImageRect: {
+        auto record = static_cast<const DrawImageRectRecord*>(op);
+        dispatcher.drawImageRect(images_[record->index], record->src,
+                                 record->dst, record->sampling,
+                                 record->render_with_attributes,
+                                 record->constraint);
+        break;
+      }
+      case DisplayListOpType::kDrawImageRects: {
+        auto record = static_cast<const DrawImageRectsRecord*>(op);
+        dispatcher.drawImageRects(
+            images_[record->index], reinterpret_cast<const SkRect*>(record + 1),
+            record->count, record->sampling, record->render_with_attributes,
+            record->constraint);
+        break;
+      }
+      case DisplayListOpType::kDrawImageNine:
+      case DisplayListOpType::kDrawImageNineWithAttr: {
+        auto record = static_cast<const DrawImageNineRecord*>(op);
+        dispatcher.drawImageNine(
+            images_[record->index], record->center, record->dst,
+            record->filter,
+            op->type == DisplayListOpType::kDrawImageNineWithAttr);
+        break;
+      }
+      case DisplayListOpType::kDrawImageLattice: {
+        auto record = static_cast<const DrawImageLatticeRecord*>(op);
+        const int* x_divs = reinterpret_cast<const int*>(record + 1);
+        const int* y_divs = x_divs + record->x_count;
+        const SkColor* colors =
+            (record->cell_count == 0)
+                ? nullptr
+                : reinterpret_cast<const SkColor*>(y_divs + record->y_count);
+        const SkCanvas::Lattice::RectType* types =
+            (record->cell_count == 0)
+                ? nullptr
+                : reinterpret_cast<const SkCanvas::Lattice::RectType*>(
+                      colors + record->cell_count);
+        dispatcher.drawImageLattice(
+            images_[record->index],
+            {x_divs, y_divs, types, record->x_count, record->y_count,
+             &record->src, colors},
+            record->dst, record->filter, record->with_paint);
+        break;
+      }
+      case DisplayListOpType::kDrawAtlas:
+      case DisplayListOpType::kDrawAtlasCulled: {
+        auto record = static_cast<const DrawAtlasRecord*>(op);
+        const SkRSXform* xform = reinterpret_cast<const SkRSXform*>(record + 1);
+        const SkRect* tex =
+            reinterpret_cast<const SkRect*>(xform + record->count);
+        const DlColor* colors =
+            record->has_colors
+                ? reinterpret_cast<const DlColor*>(tex + record->count)
+                : nullptr;
+        const SkRect* cull_rect =
+            op->type == DisplayListOpType::kDrawAtlasCulled
+                ? &record->cull_rect
+                : nullptr;
+        dispatcher.drawAtlas(images_[record->index], xform, tex, colors,
+                             record->count,
+                             static_cast<DlBlendMode>(record->mode_index),
+                             record->sampling, cull_rect,
+                             record->render_with_attributes);
+        break;
+      }
+
+      case DisplayListOpType::kDrawSkPicture:
+      case DisplayListOpType::kDrawSkPictureMatrix: {
+        auto record = static_cast<const DrawPictureRecord*>(op);
+        const SkMatrix* matrix =
+            op->type == DisplayListOpType::kDrawSkPictureMatrix
+                ? &record->matrix
+                : nullptr;
+        dispatcher.drawPicture(pictures_[record->index], matrix,
+                               record->render_with_attributes);
+        break;
+      }
+      case DisplayListOpType::kDrawDisplayList:
+        dispatcher.drawDisplayList(
+            display_lists_[static_cast<const RefRecord*>(op)->index]);
+        break;
+      case DisplayListOpType::kDrawTextBlob: {
+        auto record = static_cast<const DrawTextBlobRecord*>(op);
+        dispatcher.drawTextBlob(text_blobs_[record->index], record->x,
+                                record->y);
+        break;
+      }
+      case DisplayListOpType::kDrawShadow:
+      case DisplayListOpType::kDrawShadowTransparentOccluder: {
+        auto record = static_cast<const DrawShadowRecord*>(op);
+        dispatcher.drawShadow(
+            paths_[record->index], record->color, record->elevation,
+            op->type == DisplayListOpType::kDrawShadowTransparentOccluder,
+            record->dpr);
+        break;
+      }
+
+      // All remaining ops are dispatched in place from the mapping.
+#define DL_OP_DISPATCH(name)                                \
+  case DisplayListOpType::k##name:                          \
+    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
+    break;
+
+        DL_OP_DISPATCH(SetAntiAlias)
+        DL_OP_DISPATCH(SetDither)
+        DL_OP_DISPATCH(SetInvertColors)
+        DL_OP_DISPATCH(SetStrokeCap)
+        DL_OP_DISPATCH(SetStrokeJoin)
+        DL_OP_DISPATCH(SetStyle)
+        DL_OP_DISPATCH(SetStrokeWidth)
+        DL_OP_DISPATCH(SetStrokeMiter)
+        DL_OP_DISPATCH(SetColor)
+        DL_OP_DISPATCH(SetBlendMode)
+        DL_OP_DISPATCH(ClearBlender)
+        DL_OP_DISPATCH(ClearPathEffect)
+        DL_OP_DISPATCH(ClearColorFilter)
+        DL_OP_DISPATCH(ClearColorSource)
+        DL_OP_DISPATCH(ClearImageFilter)
+        DL_OP_DISPATCH(ClearMaskFilter)
+        DL_OP_DISPATCH(Save)
+        DL_OP_DISPATCH(SaveLayer)
+        DL_OP_DISPATCH(SaveLayerBounds)
+        DL_OP_DISPATCH(Restore)
+        DL_OP_DISPATCH(Translate)
+        DL_OP_DISPATCH(Scale)
+        DL_OP_DISPATCH(Rotate)
+        DL_OP_DISPATCH(Skew)
+        DL_OP_DISPATCH(Transform2DAffine)
+        DL_OP_DISPATCH(TransformFullPerspective)
+        DL_OP_DISPATCH(TransformReset)
+        DL_OP_DISPATCH(ClipIntersectRect)
+        DL_OP_DISPATCH(ClipIntersectRRect)
+        DL_OP_DISPATCH(ClipDifferenceRect)
+        DL_OP_DISPATCH(ClipDifferenceRRect)
+        DL_OP_DISPATCH(DrawPaint)
+        DL_OP_DISPATCH(DrawColor)
+        DL_OP_DISPATCH(DrawLine)
+        DL_OP_DISPATCH(DrawRect)
+        DL_OP_DISPATCH(DrawRects)
+        DL_OP_DISPATCH(DrawOval)
+        DL_OP_DISPATCH(DrawCircle)
+        DL_OP_DISPATCH(DrawRRect)
+        DL_OP_DISPATCH(DrawDRRect)
+        DL_OP_DISPATCH(DrawArc)
+        DL_OP_DISPATCH(DrawPoints)
+        DL_OP_DISPATCH(DrawLines)
+        DL_OP_DISPATCH(DrawPolygon)
+        DL_OP_DISPATCH(DrawVertices)
+
+#undef DL_OP_DISPATCH
+
+      // Rejected by |ValidateOps|.
+      case DisplayListOpType::kDrawSkVertices:
+        FML_DCHECK(false);
+        break;
+    }
+  }
+}
+
+sk_sp<DisplayList> DisplayListMapping::Build() const {
+  DisplayListBuilder builder(cull_rect_);
+  Dispatch(builder);
+  return builder.Build();
+}
+
+}  // namespace flutter
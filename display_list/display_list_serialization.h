@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_color_filter.h"
+#include "flutter/display_list/display_list_color_source.h"
+#include "flutter/display_list/display_list_image.h"
+#include "flutter/display_list/display_list_image_filter.h"
+#include "flutter/display_list/display_list_mask_filter.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+// The DisplayList binary format stores the op stream of a DisplayList
+// so that it can be captured from a running application and replayed
+// later, for example for offline benchmarking or to warm up shaders
+// at startup.
+//
+// The format consists of a fixed size header followed by the op stream
+// and a number of side tables. All locations in the file are
+// stored as offsets from the start of the file.
+//
+// Ops that only contain numeric data (including the trailing arrays of
+// points, DlVertices, and the like) are stored verbatim in the op
+// stream so that they can be dispatched directly from a mapping of the
+// file without copying them. Ops that refer to objects (paths, images,
+// text blobs, pictures, nested DisplayLists and the various filters
+// and shaders) are stored as records that refer to those objects by
+// an index into the side table of the appropriate type. Identical
+// objects are only stored once.
+//
+// Since the verbatim ops follow the in-memory layout of the engine
+// that wrote them, a file can only be loaded by an engine with the
+// same op layout. The header records a signature of that layout and
+// files with a mismatched signature are rejected.
+
+namespace flutter {
+
+class DisplayListSerializer {
+ public:
+  static constexpr uint32_t kMagic = 0x4c444c46;  // "FLDL"
+  static constexpr uint32_t kVersion = 1;
+
+  // Returns the serialized form of |display_list| or nullptr if it
+  // contains an object that cannot be serialized, such as a texture
+  // backed image or an SkVertices object.
+  static sk_sp<SkData> Serialize(const sk_sp<DisplayList>& display_list);
+
+  // A signature of the memory layout of all DisplayList ops.
+  static uint32_t LayoutSignature();
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListSerializer);
+};
+
+// A DisplayList loaded from the binary format. The op stream is
+// dispatched directly from the underlying mapping while the objects
+// in the side tables are decoded once when the mapping is created.
+class DisplayListMapping {
+ public:
+  // Returns nullptr if the data in the mapping is not a valid
+  // DisplayList file for this engine.
+  static std::unique_ptr<DisplayListMapping> Create(
+      std::unique_ptr<const fml::Mapping> mapping);
+
+  // Maps the indicated file without reading it into memory.
+  static std::unique_ptr<DisplayListMapping> CreateFromFile(
+      const fml::UniqueFD& base_directory,
+      const std::string& file_name);
+
+  ~DisplayListMapping();
+
+  void Dispatch(Dispatcher& dispatcher) const;
+
+  // Creates a regular DisplayList holding a copy of the mapped ops.
+  sk_sp<DisplayList> Build() const;
+
+  const SkRect& bounds() const { return bounds_; }
+  const SkRect& cull_rect() const { return cull_rect_; }
+  unsigned int op_count() const { return op_count_; }
+  size_t op_bytes() const { return ops_end_ - ops_; }
+  bool can_apply_group_opacity() const { return can_apply_group_opacity_; }
+
+ private:
+  explicit DisplayListMapping(std::unique_ptr<const fml::Mapping> mapping);
+
+  bool Decode();
+  bool DecodeSideTableEntry(uint32_t table, const uint8_t* data, size_t size);
+  size_t SideTableSize(uint32_t table) const;
+  bool ValidateOps() const;
+
+  std::unique_ptr<const fml::Mapping> mapping_;
+  const uint8_t* ops_ = nullptr;
+  const uint8_t* ops_end_ = nullptr;
+  unsigned int op_count_ = 0;
+  SkRect bounds_;
+  SkRect cull_rect_;
+  bool can_apply_group_opacity_ = false;
+
+  std::vector<SkPath> paths_;
+  std::vector<sk_sp<DlImage>> images_;
+  std::vector<sk_sp<SkTextBlob>> text_blobs_;
+  std::vector<sk_sp<SkPicture>> pictures_;
+  std::vector<sk_sp<DisplayList>> display_lists_;
+  std::vector<std::shared_ptr<DlColorFilter>> color_filters_;
+  std::vector<std::shared_ptr<DlColorSource>> color_sources_;
+  std::vector<std::shared_ptr<DlImageFilter>> image_filters_;
+  std::vector<std::shared_ptr<DlMaskFilter>> mask_filters_;
+  std::vector<sk_sp<SkBlender>> blenders_;
+  std::vector<sk_sp<SkPathEffect>> path_effects_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListMapping);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
@@ -0,0 +1,161 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_storage.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+std::shared_ptr<DisplayListStoragePool> DisplayListStoragePool::GetDefault() {
+  // Intentionally leaked so that DisplayLists released during static
+  // destruction can still return their blocks safely.
+  static auto* pool = new std::shared_ptr<DisplayListStoragePool>(
+      std::make_shared<DisplayListStoragePool>());
+  return *pool;
+}
+
+DisplayListStoragePool::DisplayListStoragePool(size_t max_retained_bytes)
+    : max_retained_bytes_(max_retained_bytes) {}
+
+DisplayListStoragePool::~DisplayListStoragePool() {
+  Purge();
+}
+
+int DisplayListStoragePool::SizeClassFor(size_t min_bytes) {
+  int size_class = 0;
+  size_t block_size = kMinBlockSize;
+  while (block_size < min_bytes) {
+    block_size <<= 1;
+    size_class++;
+  }
+  return size_class;
+}
+
+uint8_t* DisplayListStoragePool::Acquire(size_t min_bytes,
+                                         size_t* block_size) {
+  if (min_bytes > kMaxPooledBlockSize) {
+    // Next greater multiple of kMinBlockSize, never retained by the pool.
+    *block_size = (min_bytes + kMinBlockSize - 1) & ~(kMinBlockSize - 1);
+  } else {
+    int size_class = SizeClassFor(min_bytes);
+    *block_size = kMinBlockSize << size_class;
+    std::scoped_lock lock(mutex_);
+    std::vector<uint8_t*>& free_blocks = free_blocks_[size_class];
+    if (!free_blocks.empty()) {
+      uint8_t* block = free_blocks.back();
+      free_blocks.pop_back();
+      retained_bytes_ -= *block_size;
+      return block;
+    }
+  }
+  heap_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+  uint8_t* block = static_cast<uint8_t*>(std::malloc(*block_size));
+  FML_CHECK(block) << "Failed to allocate " << *block_size
+                   << " bytes of DisplayList storage";
+  return block;
+}
+
+void DisplayListStoragePool::Release(uint8_t* block, size_t block_size) {
+  if (block == nullptr) {
+    return;
+  }
+  int size_class = block_size <= kMaxPooledBlockSize
+                       ? SizeClassFor(block_size)
+                       : kSizeClassCount;
+  // Blocks trimmed by |DisplayListStorage::Shrink| match no size class.
+  if (size_class < kSizeClassCount &&
+      (kMinBlockSize << size_class) == block_size) {
+    std::scoped_lock lock(mutex_);
+    if (retained_bytes_ + block_size <= max_retained_bytes_) {
+      free_blocks_[size_class].push_back(block);
+      retained_bytes_ += block_size;
+      return;
+    }
+  }
+  std::free(block);
+}
+
+void DisplayListStoragePool::Purge() {
+  std::scoped_lock lock(mutex_);
+  for (std::vector<uint8_t*>& free_blocks : free_blocks_) {
+    for (uint8_t* block : free_blocks) {
+      std::free(block);
+    }
+    free_blocks.clear();
+  }
+  retained_bytes_ = 0;
+}
+
+size_t DisplayListStoragePool::retained_bytes() const {
+  std::scoped_lock lock(mutex_);
+  return retained_bytes_;
+}
+
+DisplayListStorage::DisplayListStorage(DisplayListStorage&& other)
+    : pool_(other.pool_), ptr_(other.ptr_), capacity_(other.capacity_) {
+  other.ptr_ = nullptr;
+  other.capacity_ = 0;
+}
+
+DisplayListStorage& DisplayListStorage::operator=(DisplayListStorage&& other) {
+  if (this != &other) {
+    reset();
+    pool_ = other.pool_;
+    ptr_ = other.ptr_;
+    capacity_ = other.capacity_;
+    other.ptr_ = nullptr;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+void DisplayListStorage::Grow(size_t used, size_t min_bytes) {
+  if (min_bytes <= capacity_) {
+    return;
+  }
+  FML_DCHECK(used <= capacity_);
+  if (!pool_) {
+    pool_ = DisplayListStoragePool::GetDefault();
+  }
+  size_t new_capacity;
+  uint8_t* new_ptr = pool_->Acquire(min_bytes, &new_capacity);
+  if (used > 0) {
+    memcpy(new_ptr, ptr_, used);
+  }
+  pool_->Release(ptr_, capacity_);
+  ptr_ = new_ptr;
+  capacity_ = new_capacity;
+}
+
+void DisplayListStorage::Shrink(size_t used) {
+  FML_DCHECK(used <= capacity_);
+  if (capacity_ - used <= capacity_ / kMaxSlackDivisor) {
+    return;
+  }
+  if (used == 0) {
+    reset();
+    return;
+  }
+  // Shrinking in place keeps the contents and rarely moves the block.
+  uint8_t* new_ptr = static_cast<uint8_t*>(std::realloc(ptr_, used));
+  FML_CHECK(new_ptr) << "Failed to shrink DisplayList storage to " << used
+                     << " bytes";
+  ptr_ = new_ptr;
+  capacity_ = used;
+}
+
+void DisplayListStorage::reset() {
+  if (ptr_) {
+    FML_DCHECK(pool_);
+    pool_->Release(ptr_, capacity_);
+    ptr_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// A pool of memory blocks used to hold the op records of DisplayListBuilder
+// and DisplayList objects.
+//
+// Blocks are handed out in power of 2 size classes starting at
+// |kMinBlockSize|. When a DisplayList is disposed its block is returned
+// to the pool so that the builders recording the next frame can reuse
+// it without going to the heap. The pool retains at most the number of
+// bytes indicated in its constructor and frees any blocks released
+// beyond that limit. Blocks larger than |kMaxPooledBlockSize| and blocks
+// trimmed by |DisplayListStorage::Shrink| are never retained.
+//
+// The pool is shared across threads since DisplayLists are typically
+// recorded on the UI thread, but released on the IO or raster threads.
+class DisplayListStoragePool {
+ public:
+  static constexpr size_t kMinBlockSize = 4096;
+  static constexpr size_t kMaxPooledBlockSize = kMinBlockSize << 10;
+  static constexpr size_t kDefaultMaxRetainedBytes = 8 * 1024 * 1024;
+
+  // The pool used by all DisplayListBuilder objects unless they are
+  // given a different pool via |DisplayListBuilder::SetStoragePool|.
+  static std::shared_ptr<DisplayListStoragePool> GetDefault();
+
+  explicit DisplayListStoragePool(
+      size_t max_retained_bytes = kDefaultMaxRetainedBytes);
+
+  ~DisplayListStoragePool();
+
+  // Returns a block of at least |min_bytes| bytes and stores its actual
+  // size in |block_size|. The contents of the block are undefined.
+  uint8_t* Acquire(size_t min_bytes, size_t* block_size);
+
+  // Returns a block previously obtained from |Acquire| to the pool.
+  void Release(uint8_t* block, size_t block_size);
+
+  // Frees all of the blocks currently retained by the pool.
+  void Purge();
+
+  // The number of bytes held in free blocks awaiting reuse.
+  size_t retained_bytes() const;
+
+  // The number of blocks that had to be allocated from the heap because
+  // no suitable block was available in the pool.
+  size_t heap_allocation_count() const { return heap_allocation_count_; }
+
+ private:
+  static constexpr int kSizeClassCount = 11;
+  static_assert((kMinBlockSize << (kSizeClassCount - 1)) ==
+                kMaxPooledBlockSize);
+
+  static int SizeClassFor(size_t min_bytes);
+
+  const size_t max_retained_bytes_;
+  std::atomic<size_t> heap_allocation_count_{0};
+
+  mutable std::mutex mutex_;
+  size_t retained_bytes_ = 0;
+  std::vector<uint8_t*> free_blocks_[kSizeClassCount];
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListStoragePool);
+};
+
+// A move-only owner of a single block of op storage obtained from a
+// |DisplayListStoragePool|. The block is returned to its pool when the
+// storage is reset or destroyed.
+class DisplayListStorage {
+ public:
+  DisplayListStorage() = default;
+  explicit DisplayListStorage(std::shared_ptr<DisplayListStoragePool> pool)
+      : pool_(std::move(pool)) {}
+
+  // The source storage keeps its pool, but gives up its block.
+  DisplayListStorage(DisplayListStorage&& other);
+  DisplayListStorage& operator=(DisplayListStorage&& other);
+
+  ~DisplayListStorage() { reset(); }
+
+  uint8_t* get() const { return ptr_; }
+  size_t capacity() const { return capacity_; }
+
+  // Ensures that the block holds at least |min_bytes| bytes, moving the
+  // first |used| bytes into a new block if the current one is too small.
+  void Grow(size_t used, size_t min_bytes);
+
+  // Trims the block down to its first |used| bytes if more than
+  // 1/|kMaxSlackDivisor| of it is unused so that the memory held by a
+  // finished DisplayList stays close to the size it reports. A trimmed
+  // block no longer matches a size class and is freed instead of being
+  // returned to the pool.
+  void Shrink(size_t used);
+
+  // Returns the block to the pool.
+  void reset();
+
+  static constexpr size_t kMaxSlackDivisor = 4;
+
+ private:
+  std::shared_ptr<DisplayListStoragePool> pool_;
+  uint8_t* ptr_ = nullptr;
+  size_t capacity_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListStorage);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
@@ -0,0 +1,146 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_tiled_rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// The state shared between the thread calling |Rasterize| and the
+// worker tasks. Workers may start after all of the tiles have been
+// claimed and even after |Rasterize| has returned, so they hold a
+// reference to this state and only touch the DisplayList and the
+// pixels while they own an unfinished tile.
+class TileJob {
+ public:
+  TileJob(const sk_sp<DisplayList>& display_list,
+          const SkPixmap& pixmap,
+          const SkSurfaceProps& props,
+          std::vector<SkIRect> tiles)
+      : display_list_(display_list),
+        pixmap_(pixmap),
+        props_(props),
+        tiles_(std::move(tiles)) {}
+
+  // Renders tiles until none are left to claim.
+  void RenderTiles() {
+    size_t index;
+    while ((index = next_tile_.fetch_add(1)) < tiles_.size()) {
+      RenderTile(tiles_[index]);
+      std::scoped_lock lock(mutex_);
+      if (++tiles_done_ == tiles_.size()) {
+        done_.notify_all();
+      }
+    }
+  }
+
+  void WaitForAllTiles() {
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return tiles_done_ == tiles_.size(); });
+  }
+
+ private:
+  void RenderTile(const SkIRect& tile) {
+    TRACE_EVENT0("flutter", "DisplayListTiledRasterizer::RenderTile");
+    SkPixmap tile_pixmap;
+    if (!pixmap_.extractSubset(&tile_pixmap, tile)) {
+      return;
+    }
+    std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+        tile_pixmap.info(), tile_pixmap.writable_addr(),
+        tile_pixmap.rowBytes(), &props_);
+    if (!canvas) {
+      return;
+    }
+    canvas->translate(-tile.fLeft, -tile.fTop);
+    DisplayListCanvasDispatcher dispatcher(canvas.get());
+    display_list_->Dispatch(dispatcher, SkRect::Make(tile));
+  }
+
+  const sk_sp<DisplayList> display_list_;
+  const SkPixmap pixmap_;
+  const SkSurfaceProps props_;
+  const std::vector<SkIRect> tiles_;
+  std::atomic<size_t> next_tile_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable done_;
+  size_t tiles_done_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TileJob);
+};
+
+}  // namespace
+
+DisplayListTiledRasterizer::DisplayListTiledRasterizer(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner,
+    size_t worker_count,
+    int tile_size)
+    : task_runner_(std::move(task_runner)),
+      worker_count_(worker_count),
+      tile_size_(tile_size) {
+  FML_DCHECK(tile_size_ > 0);
+}
+
+DisplayListTiledRasterizer::~DisplayListTiledRasterizer() = default;
+
+bool DisplayListTiledRasterizer::ShouldTile(const SkISize& size) const {
+  return task_runner_ && size.area() >= kMinTiledPixelCount;
+}
+
+void DisplayListTiledRasterizer::Rasterize(
+    const sk_sp<DisplayList>& display_list,
+    const SkPixmap& pixmap,
+    const SkIRect& clip,
+    const SkSurfaceProps& props) const {
+  TRACE_EVENT0("flutter", "DisplayListTiledRasterizer::Rasterize");
+  SkIRect area = clip;
+  if (!display_list || !area.intersect(pixmap.bounds())) {
+    return;
+  }
+
+  std::vector<SkIRect> tiles;
+  if (display_list->has_image_filtered_layers()) {
+    tiles.push_back(area);
+  } else {
+    for (int top = area.fTop; top < area.fBottom; top += tile_size_) {
+      for (int left = area.fLeft; left < area.fRight; left += tile_size_) {
+        SkIRect tile = SkIRect::MakeXYWH(left, top, tile_size_, tile_size_);
+        if (tile.intersect(area)) {
+          tiles.push_back(tile);
+        }
+      }
+    }
+  }
+  if (tiles.empty()) {
+    return;
+  }
+
+  // The calling thread is one of the threads rendering tiles. A task that
+  // is posted beyond the number of workers or of tiles would only find
+  // all of the tiles claimed by the time it runs.
+  size_t thread_count = std::min(worker_count_, tiles.size());
+  size_t task_count = task_runner_ && thread_count > 0 ? thread_count - 1 : 0;
+  auto job = std::make_shared<TileJob>(display_list, pixmap, props,
+                                       std::move(tiles));
+  for (size_t i = 0; i < task_count; i++) {
+    task_runner_->PostTask([job]() { job->RenderTiles(); });
+  }
+  job->RenderTiles();
+  job->WaitForAllTiles();
+}
+
+}  // namespace flutter
@@ -0,0 +1,80 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILED_RASTERIZER_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILED_RASTERIZER_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSurfaceProps.h"
+
+namespace flutter {
+
+// Renders a DisplayList into the pixels of a raster surface on several
+// threads at once.
+//
+// The target is split into a grid of tiles, each of which is rendered
+// by its own SkCanvas that writes directly into the tile's portion of
+// the target pixels. The ops that touch each tile are found with the
+// rtree of the DisplayList, so lists that will be rendered in tiles
+// should be built with |prepare_rtree| set to true. Lists without an
+// rtree are still rendered correctly, but every op is dispatched to
+// every tile.
+//
+// The calling thread renders tiles alongside the workers of the task
+// runner and |Rasterize| returns once all of the tiles are complete.
+// Each thread claims the next tile that nobody has claimed, and no more
+// threads than |worker_count| or than there are tiles take part.
+//
+// Since each tile can only read back its own pixels, a DisplayList
+// that samples the existing contents of the target outside of the
+// area being drawn, such as a backdrop filter, must not be rendered
+// in tiles. A saveLayer with an ImageFilter similarly samples its
+// contents outside of each tile, so lists that have such layers are
+// rendered in one piece on the calling thread.
+class DisplayListTiledRasterizer {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+
+  // The target must have at least this many pixels for |ShouldTile| to
+  // recommend tiled rendering. Below this size the cost of rendering
+  // on a single thread is not worth the synchronization overhead.
+  static constexpr int64_t kMinTiledPixelCount = 1024 * 1024;
+
+  // |worker_count| is the number of threads that |task_runner| runs its
+  // tasks on.
+  DisplayListTiledRasterizer(std::shared_ptr<fml::BasicTaskRunner> task_runner,
+                             size_t worker_count,
+                             int tile_size = kDefaultTileSize);
+
+  ~DisplayListTiledRasterizer();
+
+  // Whether a target of the indicated size is large enough to benefit
+  // from being rendered in tiles.
+  bool ShouldTile(const SkISize& size) const;
+
+  // Renders |display_list| into the area of |pixmap| indicated by
+  // |clip|, which is also used to clip the rendering.
+  void Rasterize(const sk_sp<DisplayList>& display_list,
+                 const SkPixmap& pixmap,
+                 const SkIRect& clip,
+                 const SkSurfaceProps& props = SkSurfaceProps()) const;
+
+  int tile_size() const { return tile_size_; }
+
+ private:
+  std::shared_ptr<fml::BasicTaskRunner> task_runner_;
+  const size_t worker_count_;
+  const int tile_size_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListTiledRasterizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILED_RASTERIZER_H_
@@ -5,7 +5,12 @@
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_canvas_recorder.h"
+#include "flutter/display_list/display_list_optimizer.h"
+#include "flutter/display_list/display_list_serialization.h"
+#include "flutter/display_list/display_list_tiled_rasterizer.h"
 #include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/math.h"
 #include "flutter/testing/display_list_testing.h"
 #include "flutter/testing/testing.h"
@@ -448,35 +453,35 @@ std::vector<DisplayListInvocationGroup> allGroups = {
     // optimizations can allow attributes to be distributed to the children.
     // To prevent those cases we include at least one clip operation and 2 overlapping
     // rendering primitives between each save/restore pair.
-      {5, 88, 5, 88, [](DisplayListBuilder& b) {
+      {5, 80, 5, 80, [](DisplayListBuilder& b) {
         b.save();
         b.clipRect({0, 0, 25, 25}, SkClipOp::kIntersect, true);
         b.drawRect({5, 5, 15, 15});
         b.drawRect({10, 10, 20, 20});
         b.restore();
       }},
-      {5, 88, 5, 88, [](DisplayListBuilder& b) {
+      {5, 80, 5, 80, [](DisplayListBuilder& b) {
         b.saveLayer(nullptr, false);
         b.clipRect({0, 0, 25, 25}, SkClipOp::kIntersect, true);
         b.drawRect({5, 5, 15, 15});
         b.drawRect({10, 10, 20, 20});
         b.restore();
       }},
-      {5, 88, 5, 88, [](DisplayListBuilder& b) {
+      {5, 80, 5, 80, [](DisplayListBuilder& b) {
         b.saveLayer(nullptr, true);
         b.clipRect({0, 0, 25, 25}, SkClipOp::kIntersect, true);
         b.drawRect({5, 5, 15, 15});
         b.drawRect({10, 10, 20, 20});
         b.restore();
       }},
-      {5, 104, 5, 104, [](DisplayListBuilder& b) {
+      {5, 96, 5, 96, [](DisplayListBuilder& b) {
         b.saveLayer(&TestBounds, false);
         b.clipRect({0, 0, 25, 25}, SkClipOp::kIntersect, true);
         b.drawRect({5, 5, 15, 15});
         b.drawRect({10, 10, 20, 20});
         b.restore();
       }},
-      {5, 104, 5, 104, [](DisplayListBuilder& b) {
+      {5, 96, 5, 96, [](DisplayListBuilder& b) {
         b.saveLayer(&TestBounds, true);
         b.clipRect({0, 0, 25, 25}, SkClipOp::kIntersect, true);
         b.drawRect({5, 5, 15, 15});
@@ -954,11 +959,13 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
           ASSERT_EQ(listA->op_count(true), listB->op_count(true)) << desc;
           ASSERT_EQ(listA->bytes(true), listB->bytes(true)) << desc;
           ASSERT_EQ(listA->bounds(), listB->bounds()) << desc;
+          ASSERT_EQ(listA->content_hash(), listB->content_hash()) << desc;
           ASSERT_TRUE(listA->Equals(*listB)) << desc;
           ASSERT_TRUE(listB->Equals(*listA)) << desc;
         } else {
           // No assertion on op/byte counts or bounds
           // they may or may not be equal between variants
+          ASSERT_NE(listA->content_hash(), listB->content_hash()) << desc;
           ASSERT_FALSE(listA->Equals(*listB)) << desc;
           ASSERT_FALSE(listB->Equals(*listA)) << desc;
         }
@@ -967,6 +974,48 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
   }
 }
 
+TEST(DisplayList, ContentHashMatchesForEqualDeepComparedOps) {
+  auto build = [](SkScalar sigma, SkScalar extent) {
+    // Each list gets its own path, filter and nested list objects so
+    // that the hash must be computed from their contents.
+    DisplayListBuilder nested_builder;
+    nested_builder.drawRect({0, 0, extent, extent});
+    SkPath path = SkPath::Circle(50, 50, extent);
+    DlBlurImageFilter blur(sigma, sigma, DlTileMode::kClamp);
+    DlBlendColorFilter blend(SK_ColorRED, DlBlendMode::kSrcIn);
+    DlColorFilterImageFilter color_filter(blend);
+    DlComposeImageFilter compose(blur, color_filter);
+
+    DisplayListBuilder builder;
+    builder.clipPath(path, SkClipOp::kIntersect, true);
+    builder.setImageFilter(&compose);
+    builder.drawPath(path);
+    builder.drawDisplayList(nested_builder.Build());
+    return builder.Build();
+  };
+
+  auto display_list = build(5, 20);
+  auto equal_display_list = build(5, 20);
+  ASSERT_NE(display_list->unique_id(), equal_display_list->unique_id());
+  ASSERT_EQ(display_list->content_hash(), equal_display_list->content_hash());
+  ASSERT_TRUE(display_list->Equals(equal_display_list));
+
+  auto new_filter_display_list = build(6, 20);
+  ASSERT_NE(display_list->content_hash(),
+            new_filter_display_list->content_hash());
+  ASSERT_FALSE(display_list->Equals(new_filter_display_list));
+
+  auto new_path_display_list = build(5, 30);
+  ASSERT_NE(display_list->content_hash(),
+            new_path_display_list->content_hash());
+  ASSERT_FALSE(display_list->Equals(new_path_display_list));
+}
+
+TEST(DisplayList, ContentHashOfEmptyListsMatches) {
+  DisplayList empty;
+  ASSERT_EQ(empty.content_hash(), DisplayListBuilder().Build()->content_hash());
+}
+
 TEST(DisplayList, FullRotationsAreNop) {
   DisplayListBuilder builder;
   builder.rotate(0);
@@ -1931,5 +1980,1080 @@ TEST(DisplayList, FlutterSvgIssue661BoundsWereEmpty) {
   EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 304u);
 }
 
+class RectCollector : public virtual Dispatcher,
+                      public IgnoreAttributeDispatchHelper,
+                      public IgnoreClipDispatchHelper,
+                      public IgnoreTransformDispatchHelper,
+                      public IgnoreDrawDispatchHelper {
+ public:
+  void drawRect(const SkRect& rect) override { rects.push_back(rect); }
+
+  std::vector<SkRect> rects;
+};
+
+TEST(DisplayList, RTreeIsOnlyPreparedWhenRequested) {
+  DisplayListBuilder plain_builder;
+  plain_builder.drawRect({10, 10, 20, 20});
+  EXPECT_FALSE(plain_builder.Build()->has_rtree());
+
+  DisplayListBuilder rtree_builder(true);
+  rtree_builder.drawRect({10, 10, 20, 20});
+  EXPECT_TRUE(rtree_builder.Build()->has_rtree());
+}
+
+TEST(DisplayList, CulledDispatchSkipsInvisibleRenderingOps) {
+  DisplayListBuilder builder(true);
+  for (int i = 0; i < 10; i++) {
+    builder.setColor(i & 1 ? SK_ColorRED : SK_ColorBLUE);
+    builder.drawRect(SkRect::MakeXYWH(i * 100, 0, 50, 50));
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+  EXPECT_EQ(display_list->bounds(), SkRect::MakeLTRB(0, 0, 950, 50));
+
+  RectCollector all;
+  display_list->Dispatch(all);
+  EXPECT_EQ(all.rects.size(), 10u);
+
+  RectCollector culled;
+  display_list->Dispatch(culled, SkRect::MakeLTRB(210, 10, 420, 20));
+  ASSERT_EQ(culled.rects.size(), 2u);
+  EXPECT_EQ(culled.rects[0], SkRect::MakeXYWH(200, 0, 50, 50));
+  EXPECT_EQ(culled.rects[1], SkRect::MakeXYWH(400, 0, 50, 50));
+
+  RectCollector nothing;
+  display_list->Dispatch(nothing, SkRect::MakeLTRB(0, 100, 1000, 200));
+  EXPECT_EQ(nothing.rects.size(), 0u);
+}
+
+TEST(DisplayList, CulledDispatchWithoutRTreeDispatchesEverything) {
+  DisplayListBuilder builder;
+  builder.drawRect(SkRect::MakeXYWH(0, 0, 50, 50));
+  builder.drawRect(SkRect::MakeXYWH(100, 0, 50, 50));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  RectCollector collector;
+  display_list->Dispatch(collector, SkRect::MakeLTRB(0, 0, 10, 10));
+  EXPECT_EQ(collector.rects.size(), 2u);
+}
+
+TEST(DisplayList, CulledDispatchUsesTransformedAndClippedBounds) {
+  DisplayListBuilder builder(true);
+  builder.save();
+  builder.translate(500, 0);
+  builder.drawRect(SkRect::MakeXYWH(0, 0, 50, 50));
+  builder.restore();
+  builder.save();
+  builder.clipRect(SkRect::MakeLTRB(0, 0, 10, 10), SkClipOp::kIntersect,
+                   false);
+  builder.drawRect(SkRect::MakeXYWH(0, 0, 300, 300));
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  RectCollector near_origin;
+  display_list->Dispatch(near_origin, SkRect::MakeLTRB(5, 5, 20, 20));
+  ASSERT_EQ(near_origin.rects.size(), 1u);
+  EXPECT_EQ(near_origin.rects[0], SkRect::MakeXYWH(0, 0, 300, 300));
+
+  RectCollector translated;
+  display_list->Dispatch(translated, SkRect::MakeLTRB(510, 10, 520, 20));
+  ASSERT_EQ(translated.rects.size(), 1u);
+  EXPECT_EQ(translated.rects[0], SkRect::MakeXYWH(0, 0, 50, 50));
+
+  // The second rect extends into this area, but it is clipped out.
+  RectCollector clipped;
+  display_list->Dispatch(clipped, SkRect::MakeLTRB(100, 100, 200, 200));
+  EXPECT_EQ(clipped.rects.size(), 0u);
+}
+
+TEST(DisplayList, CulledDispatchKeepsOpsInsideFilteredSaveLayers) {
+  DisplayListBuilder builder(true);
+  DlMatrixImageFilter filter(SkMatrix::Translate(500, 0),
+                             DisplayList::LinearSampling);
+  DlPaint paint = DlPaint().setImageFilter(&filter);
+  builder.saveLayer(nullptr, &paint);
+  builder.drawRect(SkRect::MakeXYWH(0, 0, 50, 50));
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  // The filter moves the rect into the cull rect so it must be dispatched.
+  RectCollector collector;
+  display_list->Dispatch(collector, SkRect::MakeLTRB(510, 10, 520, 20));
+  EXPECT_EQ(collector.rects.size(), 1u);
+}
+
+TEST(DisplayList, StorageBlocksAreRecycledThroughPool) {
+  auto pool = std::make_shared<DisplayListStoragePool>();
+  auto build = [&pool]() {
+    DisplayListBuilder builder;
+    builder.SetStoragePool(pool);
+    // 1300 rects fill most of a 32k block so it is not trimmed by Build.
+    for (int i = 0; i < 1300; i++) {
+      builder.drawRect(SkRect::MakeXYWH(i, i, 10, 10));
+    }
+    return builder.Build();
+  };
+
+  sk_sp<DisplayList> first = build();
+  size_t allocations = pool->heap_allocation_count();
+  EXPECT_GT(allocations, 0u);
+
+  // The smaller blocks outgrown while recording are already back in
+  // the pool, the final block returns when the list is disposed.
+  size_t retained = pool->retained_bytes();
+  first.reset();
+  EXPECT_GT(pool->retained_bytes(), retained);
+
+  sk_sp<DisplayList> second = build();
+  sk_sp<DisplayList> third = build();
+  // The second list reuses the block of the first list, only the third
+  // list needs a new block for its final size.
+  EXPECT_LT(pool->heap_allocation_count(), allocations * 2);
+  second.reset();
+  third.reset();
+
+  for (int i = 0; i < 10; i++) {
+    allocations = pool->heap_allocation_count();
+    build().reset();
+    EXPECT_EQ(pool->heap_allocation_count(), allocations);
+  }
+
+  pool->Purge();
+  EXPECT_EQ(pool->retained_bytes(), 0u);
+}
+
+TEST(DisplayList, StorageWithLargeSlackIsShrunk) {
+  auto pool = std::make_shared<DisplayListStoragePool>();
+  DisplayListStorage storage(pool);
+  storage.Grow(0, 5000);
+  EXPECT_EQ(storage.capacity(), 8192u);
+  memset(storage.get(), 0x5a, 5000);
+  storage.Shrink(5000);
+  EXPECT_EQ(storage.capacity(), 5000u);
+  for (size_t i = 0; i < 5000; i++) {
+    ASSERT_EQ(storage.get()[i], 0x5a) << i;
+  }
+  // A trimmed block is freed rather than pooled.
+  size_t retained = pool->retained_bytes();
+  storage.reset();
+  EXPECT_EQ(pool->retained_bytes(), retained);
+
+  storage.Grow(0, 7000);
+  storage.Shrink(7000);
+  EXPECT_EQ(storage.capacity(), 8192u);
+  storage.reset();
+  EXPECT_EQ(pool->retained_bytes(), retained + 8192u);
+}
+
+TEST(DisplayList, BuildTrimsStorageWithLargeSlack) {
+  auto pool = std::make_shared<DisplayListStoragePool>();
+  DisplayListBuilder builder;
+  builder.SetStoragePool(pool);
+  // 700 rects use only a little over half of a 32k block.
+  for (int i = 0; i < 700; i++) {
+    builder.drawRect(SkRect::MakeXYWH(i, i, 10, 10));
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 700 * 24u);
+
+  // The final block was trimmed, so it does not return to the pool.
+  size_t retained = pool->retained_bytes();
+  display_list.reset();
+  EXPECT_EQ(pool->retained_bytes(), retained);
+}
+
+TEST(DisplayList, RecycledStorageDoesNotAffectEquality) {
+  auto pool = std::make_shared<DisplayListStoragePool>();
+  auto build = [&pool](bool fill_garbage) {
+    DisplayListBuilder builder;
+    builder.SetStoragePool(pool);
+    if (fill_garbage) {
+      for (int i = 0; i < 100; i++) {
+        builder.setColor(SK_ColorRED + i);
+        builder.drawCircle({i * 1.0f, i * 2.0f}, i + 0.5f);
+      }
+    } else {
+      builder.setAntiAlias(true);
+      builder.drawRect({10, 10, 20, 20});
+      builder.drawRRect(SkRRect::MakeRectXY({0, 0, 50, 50}, 5, 5));
+    }
+    return builder.Build();
+  };
+  sk_sp<DisplayList> fresh = build(false);
+  build(true).reset();
+  sk_sp<DisplayList> recycled = build(false);
+  EXPECT_TRUE(fresh->Equals(recycled));
+  EXPECT_TRUE(recycled->Equals(fresh));
+}
+
+static std::unique_ptr<DisplayListMapping> MapSerializedData(
+    const sk_sp<SkData>& data) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+  return DisplayListMapping::Create(std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>(bytes, bytes + data->size())));
+}
+
+// Images, pictures and text blobs are decoded into new instances and so
+// do not compare as equal after a round trip, but the paths, filters and
+// vertices in this DisplayList do.
+static sk_sp<DisplayList> MakeImageFreeDisplayList() {
+  DisplayListBuilder builder;
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.setColorFilter(&TestBlendColorFilter1);
+  builder.save();
+  builder.translate(10, 10);
+  builder.clipPath(TestPath1, SkClipOp::kIntersect, true);
+  builder.drawRect({0, 0, 20, 20});
+  builder.drawPath(TestPath2);
+  builder.restore();
+  builder.saveLayer(&TestBounds, true);
+  builder.drawPoints(SkCanvas::kLines_PointMode, 4, TestPoints);
+  builder.drawVertices(TestVertices1, DlBlendMode::kSrcOver);
+  builder.drawShadow(TestPath3, DlColor::kRed(), 3.0, false, 1.0);
+  builder.restore();
+  return builder.Build();
+}
+
+TEST(DisplayList, SerializedSingleOpDisplayListsRoundTrip) {
+  for (auto& group : allGroups) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      sk_sp<DisplayList> dl = group.variants[i].Build();
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) + ")";
+      sk_sp<SkData> data = DisplayListSerializer::Serialize(dl);
+      ASSERT_NE(data, nullptr) << desc;
+      auto mapping = MapSerializedData(data);
+      ASSERT_NE(mapping, nullptr) << desc;
+      EXPECT_EQ(mapping->op_count(), dl->op_count(false)) << desc;
+      EXPECT_EQ(mapping->bounds(), dl->bounds()) << desc;
+      EXPECT_EQ(mapping->can_apply_group_opacity(),
+                dl->can_apply_group_opacity())
+          << desc;
+      sk_sp<DisplayList> copy = mapping->Build();
+      EXPECT_EQ(copy->op_count(false), dl->op_count(false)) << desc;
+      EXPECT_EQ(copy->bounds(), dl->bounds()) << desc;
+    }
+  }
+}
+
+TEST(DisplayList, SerializedDisplayListWithoutImagesIsEqual) {
+  sk_sp<DisplayList> dl = MakeImageFreeDisplayList();
+  auto mapping = MapSerializedData(DisplayListSerializer::Serialize(dl));
+  ASSERT_NE(mapping, nullptr);
+  sk_sp<DisplayList> copy = mapping->Build();
+  EXPECT_TRUE(copy->Equals(*dl));
+  EXPECT_TRUE(dl->Equals(*copy));
+}
+
+TEST(DisplayList, SerializedSharedObjectsAreStoredOnce) {
+  auto make_list = [](int image_count) {
+    DisplayListBuilder builder;
+    for (int i = 0; i < image_count; i++) {
+      builder.drawImage(TestImage1, {i * 10.0f, 0}, NearestSampling, false);
+    }
+    return builder.Build();
+  };
+  sk_sp<SkData> one = DisplayListSerializer::Serialize(make_list(1));
+  sk_sp<SkData> many = DisplayListSerializer::Serialize(make_list(10));
+  ASSERT_NE(one, nullptr);
+  ASSERT_NE(many, nullptr);
+  sk_sp<SkData> encoded = TestImage1->skia_image()->encodeToData();
+  ASSERT_NE(encoded, nullptr);
+  EXPECT_LT(many->size() - one->size(), encoded->size());
+}
+
+TEST(DisplayList, SerializedDisplayListLoadsFromFile) {
+  sk_sp<DisplayList> dl = MakeImageFreeDisplayList();
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(dl);
+  ASSERT_NE(data, nullptr);
+
+  fml::ScopedTemporaryDirectory directory;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+  fml::DataMapping file_data(
+      std::vector<uint8_t>(bytes, bytes + data->size()));
+  ASSERT_TRUE(fml::WriteAtomically(directory.fd(), "frame.dl", file_data));
+
+  auto mapping =
+      DisplayListMapping::CreateFromFile(directory.fd(), "frame.dl");
+  ASSERT_NE(mapping, nullptr);
+  EXPECT_EQ(mapping->op_count(), dl->op_count(false));
+
+  DisplayListBuilder builder;
+  mapping->Dispatch(builder);
+  EXPECT_TRUE(builder.Build()->Equals(*dl));
+
+  EXPECT_EQ(DisplayListMapping::CreateFromFile(directory.fd(), "missing.dl"),
+            nullptr);
+}
+
+TEST(DisplayList, SerializedDisplayListRejectsInvalidData) {
+  sk_sp<SkData> data =
+      DisplayListSerializer::Serialize(MakeImageFreeDisplayList());
+  ASSERT_NE(data, nullptr);
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+
+  std::vector<uint8_t> bad_magic(bytes, bytes + data->size());
+  bad_magic[0] ^= 0xff;
+  EXPECT_EQ(DisplayListMapping::Create(
+                std::make_unique<fml::DataMapping>(std::move(bad_magic))),
+            nullptr);
+
+  std::vector<uint8_t> bad_layout(bytes, bytes + data->size());
+  // The layout signature follows the magic and version fields.
+  bad_layout[8] ^= 0xff;
+  EXPECT_EQ(DisplayListMapping::Create(
+                std::make_unique<fml::DataMapping>(std::move(bad_layout))),
+            nullptr);
+
+  std::vector<uint8_t> truncated(bytes, bytes + data->size() / 2);
+  EXPECT_EQ(DisplayListMapping::Create(
+                std::make_unique<fml::DataMapping>(std::move(truncated))),
+            nullptr);
+}
+
+// Replaces the first occurrence of |count| after the header of the first
+// op of the serialized form of |dl| with |corrupt_count|.
+static std::vector<uint8_t> CorruptFirstOpCount(const sk_sp<DisplayList>& dl,
+                                                int32_t count,
+                                                int32_t corrupt_count) {
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(dl);
+  if (!data) {
+    return {};
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+  std::vector<uint8_t> corrupted(bytes, bytes + data->size());
+  // The offset of the op stream follows the magic, version, layout
+  // signature and op count fields of the header.
+  uint64_t op_offset;
+  memcpy(&op_offset, corrupted.data() + 16, sizeof(op_offset));
+  // The counts are stored within the fixed size portion of the ops.
+  size_t end = std::min<size_t>(op_offset + 64, corrupted.size());
+  for (size_t i = op_offset + sizeof(uint32_t); i + sizeof(count) <= end;
+       i++) {
+    if (memcmp(corrupted.data() + i, &count, sizeof(count)) == 0) {
+      memcpy(corrupted.data() + i, &corrupt_count, sizeof(corrupt_count));
+      return corrupted;
+    }
+  }
+  return {};
+}
+
+TEST(DisplayList, SerializedDisplayListRejectsArraysLargerThanTheirOps) {
+  struct TestCase {
+    std::string name;
+    int32_t count;
+    std::function<void(DisplayListBuilder&)> build;
+  };
+  static SkRSXform xforms[] = {{1, 0, 0, 0}, {0, 1, 0, 0}};
+  static SkRect texs[] = {{10, 10, 20, 20}, {20, 20, 30, 30}};
+  static DlColor atlas_colors[] = {DlColor::kRed(), DlColor::kBlue()};
+  static SkRect rects[] = {{0, 0, 10, 10},
+                           {5, 5, 15, 15},
+                           {10, 10, 20, 20},
+                           {15, 15, 25, 25}};
+  static SkPoint vertices[] = {{0, 0}, {10, 0}, {0, 10},
+                               {10, 10}, {20, 10}, {10, 20}};
+  std::vector<TestCase> cases = {
+      {"DrawRects", 3,
+       [](DisplayListBuilder& b) { b.drawRects(rects, 3); }},
+      {"DrawPoints", 4,
+       [](DisplayListBuilder& b) {
+         b.drawPoints(SkCanvas::kPoints_PointMode, 4, TestPoints);
+       }},
+      {"DrawLines", 4,
+       [](DisplayListBuilder& b) {
+         b.drawPoints(SkCanvas::kLines_PointMode, 4, TestPoints);
+       }},
+      {"DrawPolygon", 4,
+       [](DisplayListBuilder& b) {
+         b.drawPoints(SkCanvas::kPolygon_PointMode, 4, TestPoints);
+       }},
+      {"DrawVertices", 6,
+       [](DisplayListBuilder& b) {
+         b.drawVertices(DlVertices::Make(DlVertexMode::kTriangles, 6,
+                                         vertices, nullptr, nullptr),
+                        DlBlendMode::kSrcOver);
+       }},
+      {"DrawImageRects", 2,
+       [](DisplayListBuilder& b) {
+         b.drawImageRects(TestImage1, rects, 2, NearestSampling, false,
+                          SkCanvas::kFast_SrcRectConstraint);
+       }},
+      {"DrawImageLattice", 3,
+       [](DisplayListBuilder& b) {
+         b.drawImageLattice(
+             TestImage1,
+             {TestDivs1, TestDivs1, nullptr, 3, 3, nullptr, nullptr},
+             {10, 10, 40, 40}, SkFilterMode::kNearest, false);
+       }},
+      {"DrawAtlas", 2,
+       [](DisplayListBuilder& b) {
+         b.drawAtlas(TestImage1, xforms, texs, nullptr, 2,
+                     DlBlendMode::kSrcIn, NearestSampling, nullptr, false);
+       }},
+      {"DrawAtlasWithColors", 2,
+       [](DisplayListBuilder& b) {
+         b.drawAtlas(TestImage1, xforms, texs, atlas_colors, 2,
+                     DlBlendMode::kSrcIn, NearestSampling, nullptr, false);
+       }},
+      {"DrawAtlasCulled", 2,
+       [](DisplayListBuilder& b) {
+         SkRect cull_rect = {0, 0, 100, 100};
+         b.drawAtlas(TestImage1, xforms, texs, nullptr, 2,
+                     DlBlendMode::kSrcIn, NearestSampling, &cull_rect, false);
+       }},
+  };
+  for (auto& test_case : cases) {
+    DisplayListBuilder builder;
+    test_case.build(builder);
+    sk_sp<DisplayList> dl = builder.Build();
+    ASSERT_NE(MapSerializedData(DisplayListSerializer::Serialize(dl)), nullptr)
+        << test_case.name;
+    for (int32_t corrupt_count : {1 << 20, -1}) {
+      std::vector<uint8_t> corrupted =
+          CorruptFirstOpCount(dl, test_case.count, corrupt_count);
+      ASSERT_FALSE(corrupted.empty()) << test_case.name;
+      EXPECT_EQ(DisplayListMapping::Create(
+                    std::make_unique<fml::DataMapping>(std::move(corrupted))),
+                nullptr)
+          << test_case.name << " with a count of " << corrupt_count;
+    }
+  }
+}
+
+// Returns the serialized form of |dl| with the 4 bytes at |offset| from
+// the start of its first op replaced by |value|.
+static std::vector<uint8_t> CorruptFirstOpField(const sk_sp<DisplayList>& dl,
+                                                size_t offset,
+                                                uint32_t value) {
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(dl);
+  if (!data) {
+    return {};
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+  std::vector<uint8_t> corrupted(bytes, bytes + data->size());
+  uint64_t op_offset;
+  memcpy(&op_offset, corrupted.data() + 16, sizeof(op_offset));
+  if (op_offset + offset + sizeof(value) > corrupted.size()) {
+    return {};
+  }
+  memcpy(corrupted.data() + op_offset + offset, &value, sizeof(value));
+  return corrupted;
+}
+
+TEST(DisplayList, SerializedDisplayListRejectsOutOfRangeEnums) {
+  struct TestCase {
+    std::string name;
+    // The offset of the field from the start of the first op, which
+    // begins with a 4 byte header.
+    size_t offset;
+    std::vector<uint32_t> bad_values;
+    std::function<void(DisplayListBuilder&)> build;
+  };
+  auto after_last = [](auto last) { return static_cast<uint32_t>(last) + 1; };
+  std::vector<TestCase> cases = {
+      {"SetBlendMode", 4, {after_last(DlBlendMode::kLastMode), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.setBlendMode(DlBlendMode::kSrcIn);
+         b.drawRect({0, 0, 10, 10});
+       }},
+      {"SetStyle", 4, {after_last(DlDrawStyle::kLastStyle), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.setStyle(DlDrawStyle::kStroke);
+         b.drawRect({0, 0, 10, 10});
+       }},
+      {"SetStrokeCap", 4, {after_last(DlStrokeCap::kLastCap), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.setStrokeCap(DlStrokeCap::kRound);
+         b.drawRect({0, 0, 10, 10});
+       }},
+      {"SetStrokeJoin", 4, {after_last(DlStrokeJoin::kLastJoin), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.setStrokeJoin(DlStrokeJoin::kBevel);
+         b.drawRect({0, 0, 10, 10});
+       }},
+      // The blend mode follows the color.
+      {"DrawColor", 8, {after_last(DlBlendMode::kLastMode), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.drawColor(DlColor::kRed(), DlBlendMode::kSrcIn);
+       }},
+      {"DrawVertices", 4, {after_last(DlBlendMode::kLastMode), 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.drawVertices(TestVertices1, DlBlendMode::kSrcIn);
+       }},
+      {"SaveLayer", 4, {1u << 2, 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.saveLayer(nullptr, true);
+         b.drawRect({0, 0, 10, 10});
+         b.restore();
+       }},
+      {"SaveLayerBounds", 4, {1u << 2, 0xffffffff},
+       [](DisplayListBuilder& b) {
+         b.saveLayer(&TestBounds, true);
+         b.drawRect({0, 0, 10, 10});
+         b.restore();
+       }},
+  };
+  for (auto& test_case : cases) {
+    DisplayListBuilder builder;
+    test_case.build(builder);
+    sk_sp<DisplayList> dl = builder.Build();
+    ASSERT_NE(MapSerializedData(DisplayListSerializer::Serialize(dl)), nullptr)
+        << test_case.name;
+    for (uint32_t bad_value : test_case.bad_values) {
+      std::vector<uint8_t> corrupted =
+          CorruptFirstOpField(dl, test_case.offset, bad_value);
+      ASSERT_FALSE(corrupted.empty()) << test_case.name;
+      EXPECT_EQ(DisplayListMapping::Create(
+                    std::make_unique<fml::DataMapping>(std::move(corrupted))),
+                nullptr)
+          << test_case.name << " with a value of " << bad_value;
+    }
+  }
+}
+
+TEST(DisplayList, SerializedDisplayListRejectsUnknownPointModes) {
+  DisplayListBuilder builder;
+  builder.drawPoints(SkCanvas::kLines_PointMode, 4, TestPoints);
+  sk_sp<DisplayList> dl = builder.Build();
+  sk_sp<SkData> data = DisplayListSerializer::Serialize(dl);
+  ASSERT_NE(MapSerializedData(data), nullptr);
+
+  // The point mode is stored as the type of the op, in the low byte of the
+  // header of the op.
+  const uint8_t* bytes = static_cast<const uint8_t*>(data->data());
+  std::vector<uint8_t> corrupted(bytes, bytes + data->size());
+  uint64_t op_offset;
+  memcpy(&op_offset, corrupted.data() + 16, sizeof(op_offset));
+  corrupted[op_offset] = 0xff;
+  EXPECT_EQ(DisplayListMapping::Create(
+                std::make_unique<fml::DataMapping>(std::move(corrupted))),
+            nullptr);
+}
+
+TEST(DisplayList, OptimizerRemovesOverwrittenAttributes) {
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorRED);
+  builder.setColor(SK_ColorBLUE);
+  builder.setStrokeWidth(5);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.setColor(SK_ColorGREEN);
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.setColor(SK_ColorBLUE);
+  expected.setStrokeWidth(5);
+  expected.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.attribute_ops_removed, 2);
+  EXPECT_EQ(stats.ops_removed(), 2);
+}
+
+TEST(DisplayList, OptimizerRemovesEmptySaveRestorePairs) {
+  DisplayListBuilder builder;
+  builder.save();
+  builder.translate(10, 10);
+  builder.clipRect(SkRect::MakeLTRB(0, 0, 50, 50), SkClipOp::kIntersect,
+                   true);
+  builder.restore();
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.save_restore_pairs_removed, 1);
+  EXPECT_EQ(stats.transform_ops_removed, 1);
+  EXPECT_EQ(stats.clip_ops_removed, 1);
+  EXPECT_EQ(stats.ops_removed(), 4);
+}
+
+TEST(DisplayList, OptimizerMergesConsecutiveTransforms) {
+  DisplayListBuilder builder;
+  builder.translate(10, 0);
+  builder.translate(0, 20);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.scale(5, 5);
+  builder.transformReset();
+  builder.scale(2, 3);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.translate(10, 20);
+  expected.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  expected.transformReset();
+  expected.scale(2, 3);
+  expected.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.transform_ops_removed, 2);
+  EXPECT_EQ(stats.ops_removed(), 2);
+}
+
+TEST(DisplayList, OptimizerCullsClippedOutDraws) {
+  DisplayListBuilder builder;
+  builder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), SkClipOp::kIntersect,
+                   false);
+  builder.setColor(SK_ColorRED);
+  builder.drawRect(SkRect::MakeLTRB(200, 200, 250, 250));
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.save();
+  builder.translate(500, 500);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.restore();
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), SkClipOp::kIntersect,
+                    false);
+  expected.setColor(SK_ColorBLUE);
+  expected.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.draw_ops_culled, 2);
+  EXPECT_EQ(stats.attribute_ops_removed, 1);
+  EXPECT_EQ(stats.save_restore_pairs_removed, 1);
+  EXPECT_EQ(stats.transform_ops_removed, 1);
+  EXPECT_EQ(stats.ops_removed(), 6);
+}
+
+TEST(DisplayList, OptimizerCullsDrawsOutsideCullRect) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100));
+  builder.setColor(SK_ColorRED);
+  builder.drawRect(SkRect::MakeLTRB(200, 200, 250, 250));
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect(SkRect::MakeLTRB(90, 90, 120, 120));
+  builder.translate(-100, -100);
+  builder.drawRect(SkRect::MakeLTRB(0, 0, 50, 50));
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected(SkRect::MakeLTRB(0, 0, 100, 100));
+  expected.setColor(SK_ColorBLUE);
+  expected.drawRect(SkRect::MakeLTRB(90, 90, 120, 120));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.draw_ops_culled, 2);
+  EXPECT_EQ(stats.attribute_ops_removed, 1);
+  EXPECT_EQ(stats.transform_ops_removed, 1);
+  EXPECT_EQ(stats.ops_removed(), 4);
+}
+
+TEST(DisplayList, OptimizerMergesNonAntiAliasedRectClips) {
+  DisplayListBuilder builder;
+  builder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), SkClipOp::kIntersect,
+                   false);
+  builder.clipRect(SkRect::MakeLTRB(50, 50, 200, 200), SkClipOp::kIntersect,
+                   false);
+  builder.drawRect(SkRect::MakeLTRB(60, 60, 70, 70));
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build(), &stats);
+
+  DisplayListBuilder expected;
+  expected.clipRect(SkRect::MakeLTRB(50, 50, 100, 100), SkClipOp::kIntersect,
+                    false);
+  expected.drawRect(SkRect::MakeLTRB(60, 60, 70, 70));
+  EXPECT_TRUE(optimized->Equals(expected.Build()));
+  EXPECT_EQ(stats.clip_ops_removed, 1);
+}
+
+TEST(DisplayList, OptimizerPreservesOptimalDisplayList) {
+  DisplayListBuilder builder(true);
+  builder.setColor(SK_ColorRED);
+  builder.saveLayer(nullptr, true);
+  builder.translate(10, 10);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.restore();
+  builder.save();
+  builder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), SkClipOp::kIntersect,
+                   true);
+  builder.drawOval(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+  DisplayListOptimizer::Stats stats;
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(display_list, &stats);
+
+  EXPECT_TRUE(optimized->Equals(display_list));
+  EXPECT_TRUE(optimized->has_rtree());
+  EXPECT_EQ(stats.ops_removed(), 0);
+}
+
+TEST(DisplayList, ConsecutiveRectsAreBatched) {
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorRED);
+  for (int i = 0; i < 10; i++) {
+    builder.drawRect(SkRect::MakeXYWH(i * 10, 0, 5, 5));
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  // The batched op is counted once per rect.
+  EXPECT_EQ(display_list->op_count(), 10u);
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 16u + 8u + 10 * 16u);
+  EXPECT_EQ(display_list->bounds(), SkRect::MakeLTRB(0, 0, 95, 5));
+
+  RectCollector collector;
+  display_list->Dispatch(collector);
+  ASSERT_EQ(collector.rects.size(), 10u);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(collector.rects[i], SkRect::MakeXYWH(i * 10, 0, 5, 5));
+  }
+}
+
+TEST(DisplayList, DrawRectsMatchesSeparateDrawRects) {
+  SkRect rects[] = {
+      SkRect::MakeLTRB(0, 0, 10, 10),
+      SkRect::MakeLTRB(20, 20, 30, 30),
+      SkRect::MakeLTRB(40, 40, 50, 50),
+  };
+  DisplayListBuilder batched_builder;
+  batched_builder.drawRects(rects, 3);
+  sk_sp<DisplayList> batched = batched_builder.Build();
+
+  DisplayListBuilder separate_builder;
+  for (auto& rect : rects) {
+    separate_builder.drawRect(rect);
+  }
+  sk_sp<DisplayList> separate = separate_builder.Build();
+
+  EXPECT_TRUE(batched->Equals(separate));
+  EXPECT_EQ(batched->op_count(), 3u);
+  EXPECT_FALSE(batched->can_apply_group_opacity());
+}
+
+TEST(DisplayList, RectBatchesAreBrokenByStateChanges) {
+  DisplayListBuilder builder;
+  builder.drawRect({0, 0, 10, 10});
+  builder.drawRect({10, 0, 20, 10});
+  builder.setColor(SK_ColorRED);
+  builder.drawRect({20, 0, 30, 10});
+  builder.translate(5, 5);
+  builder.drawRect({30, 0, 40, 10});
+  builder.drawOval({40, 0, 50, 10});
+  builder.drawRect({50, 0, 60, 10});
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  // A DrawRects op holding 2 rects followed by 5 separate ops.
+  EXPECT_EQ(display_list->op_count(), 7u);
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + (8u + 2 * 16u) +
+                                       16u + 24u + 16u + 24u + 24u + 24u);
+
+  RectCollector collector;
+  display_list->Dispatch(collector);
+  EXPECT_EQ(collector.rects.size(), 5u);
+}
+
+class ImageRectCollector : public virtual Dispatcher,
+                           public IgnoreAttributeDispatchHelper,
+                           public IgnoreClipDispatchHelper,
+                           public IgnoreTransformDispatchHelper,
+                           public IgnoreDrawDispatchHelper {
+ public:
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override {
+    images.push_back(image);
+    dst_rects.push_back(dst);
+  }
+
+  std::vector<sk_sp<DlImage>> images;
+  std::vector<SkRect> dst_rects;
+};
+
+TEST(DisplayList, ConsecutiveImageRectsFromSameImageAreBatched) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < 4; i++) {
+    builder.drawImageRect(TestImage1, {0, 0, 10, 10},
+                          SkRect::MakeXYWH(i * 10, 0, 10, 10),
+                          NearestSampling, false);
+  }
+  // Each of these breaks the batch.
+  builder.drawImageRect(TestImage2, {0, 0, 10, 10}, {0, 20, 10, 30},
+                        NearestSampling, false);
+  builder.drawImageRect(TestImage2, {0, 0, 10, 10}, {10, 20, 20, 30},
+                        LinearSampling, false);
+  builder.drawImageRect(TestImage2, {0, 0, 10, 10}, {20, 20, 30, 30},
+                        LinearSampling, true);
+  builder.drawImageRect(TestImage2, {0, 0, 10, 10}, {30, 20, 40, 30},
+                        LinearSampling, true,
+                        SkCanvas::SrcRectConstraint::kStrict_SrcRectConstraint);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  EXPECT_EQ(display_list->op_count(), 8u);
+  EXPECT_EQ(display_list->bytes(),
+            sizeof(DisplayList) + (48u + 4 * 2 * 16u) + 4 * 80u);
+
+  ImageRectCollector collector;
+  display_list->Dispatch(collector);
+  ASSERT_EQ(collector.images.size(), 8u);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(collector.images[i], TestImage1);
+    EXPECT_EQ(collector.dst_rects[i], SkRect::MakeXYWH(i * 10, 0, 10, 10));
+    EXPECT_EQ(collector.images[i + 4], TestImage2);
+    EXPECT_EQ(collector.dst_rects[i + 4],
+              SkRect::MakeXYWH(i * 10, 20, 10, 10));
+  }
+}
+
+TEST(DisplayList, RectsAreNotBatchedWhenPreparingRTree) {
+  SkRect rects[] = {
+      SkRect::MakeLTRB(0, 0, 10, 10),
+      SkRect::MakeLTRB(90, 0, 100, 10),
+      SkRect::MakeLTRB(0, 90, 10, 100),
+  };
+  DisplayListBuilder builder(true);
+  builder.drawRect(rects[0]);
+  builder.drawRect(rects[1]);
+  builder.drawRects(rects, 3);
+  for (int i = 0; i < 2; i++) {
+    builder.drawImageRect(TestImage1, {0, 0, 10, 10}, rects[i],
+                          NearestSampling, false);
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  // Each rect is a separate op that is culled on its own.
+  EXPECT_EQ(display_list->op_count(), 7u);
+  EXPECT_EQ(display_list->bytes(), sizeof(DisplayList) + 5 * 24u + 2 * 80u);
+
+  RectCollector collector;
+  display_list->Dispatch(collector, SkRect::MakeLTRB(80, 0, 100, 20));
+  EXPECT_EQ(collector.rects, std::vector<SkRect>({rects[1], rects[1]}));
+
+  ImageRectCollector image_collector;
+  display_list->Dispatch(image_collector, SkRect::MakeLTRB(80, 0, 100, 20));
+  EXPECT_EQ(image_collector.dst_rects, std::vector<SkRect>({rects[1]}));
+}
+
+TEST(DisplayList, SerializedBatchedDisplayListRoundTrips) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < 3; i++) {
+    builder.drawRect(SkRect::MakeXYWH(i * 10, 0, 5, 5));
+  }
+  for (int i = 0; i < 3; i++) {
+    builder.drawImageRect(TestImage1, {0, 0, 10, 10},
+                          SkRect::MakeXYWH(i * 10, 10, 10, 10),
+                          NearestSampling, true);
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 6u);
+
+  auto mapping =
+      MapSerializedData(DisplayListSerializer::Serialize(display_list));
+  ASSERT_NE(mapping, nullptr);
+  EXPECT_EQ(mapping->op_count(), 6u);
+  EXPECT_EQ(mapping->bounds(), display_list->bounds());
+
+  ImageRectCollector collector;
+  mapping->Dispatch(collector);
+  ASSERT_EQ(collector.dst_rects.size(), 3u);
+  EXPECT_EQ(collector.dst_rects[2], SkRect::MakeXYWH(20, 10, 10, 10));
+
+  sk_sp<DisplayList> copy = mapping->Build();
+  EXPECT_EQ(copy->op_count(), 6u);
+  EXPECT_EQ(copy->bytes(), display_list->bytes());
+}
+
+static sk_sp<DisplayList> MakeTiledTestDisplayList() {
+  DisplayListBuilder builder(true);
+  builder.setAntiAlias(true);
+  for (int i = 0; i < 20; i++) {
+    builder.setColor(i & 1 ? SK_ColorRED : SK_ColorBLUE);
+    builder.drawCircle({i * 13.0f + 5, i * 7.0f + 11}, 9.5f + i);
+  }
+  builder.save();
+  builder.rotate(30);
+  builder.setColor(SK_ColorGREEN);
+  builder.drawRect({40, -20, 170, 45});
+  builder.restore();
+  builder.setStyle(DlDrawStyle::kStroke);
+  builder.setStrokeWidth(3);
+  builder.setColor(SK_ColorBLACK);
+  builder.drawPath(TestPath1);
+  builder.drawOval({3, 70, 197, 130});
+  return builder.Build();
+}
+
+static void ExpectTiledRenderingMatches(const sk_sp<DisplayList>& display_list,
+                                        const SkIRect& clip,
+                                        int tile_size) {
+  auto info = SkImageInfo::MakeN32Premul(200, 150);
+  sk_sp<SkSurface> expected = SkSurface::MakeRaster(info);
+  expected->getCanvas()->clipIRect(clip);
+  display_list->RenderTo(expected->getCanvas());
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  DisplayListTiledRasterizer rasterizer(loop->GetTaskRunner(),
+                                        loop->GetWorkerCount(), tile_size);
+  sk_sp<SkSurface> tiled = SkSurface::MakeRaster(info);
+  SkPixmap tiled_pixels;
+  ASSERT_TRUE(tiled->peekPixels(&tiled_pixels));
+  rasterizer.Rasterize(display_list, tiled_pixels, clip);
+
+  SkPixmap expected_pixels;
+  ASSERT_TRUE(expected->peekPixels(&expected_pixels));
+  for (int y = 0; y < info.height(); y++) {
+    for (int x = 0; x < info.width(); x++) {
+      ASSERT_EQ(*tiled_pixels.addr32(x, y), *expected_pixels.addr32(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(DisplayList, TiledRasterizationMatchesDirectRendering) {
+  sk_sp<DisplayList> display_list = MakeTiledTestDisplayList();
+  ExpectTiledRenderingMatches(display_list, SkIRect::MakeWH(200, 150), 32);
+  ExpectTiledRenderingMatches(display_list, SkIRect::MakeWH(200, 150), 37);
+}
+
+TEST(DisplayList, TiledRasterizationOnlyTouchesClip) {
+  sk_sp<DisplayList> display_list = MakeTiledTestDisplayList();
+  ExpectTiledRenderingMatches(display_list, SkIRect::MakeLTRB(25, 30, 140, 99),
+                              32);
+}
+
+TEST(DisplayList, TiledRasterizationOfBlurredSaveLayerMatches) {
+  DlBlurImageFilter blur(6, 6, DlTileMode::kDecal);
+  DisplayListBuilder builder(true);
+  builder.setImageFilter(&blur);
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.setColor(SK_ColorBLUE);
+  // The edges of the rects are close to the edges of the tiles so that
+  // the blur spreads their colors into the neighboring tiles.
+  builder.drawRect({28, 28, 62, 62});
+  builder.drawRect({95, 60, 130, 97});
+  builder.restore();
+  sk_sp<DisplayList> display_list = builder.Build();
+  EXPECT_TRUE(display_list->has_image_filtered_layers());
+  ExpectTiledRenderingMatches(display_list, SkIRect::MakeWH(200, 150), 32);
+
+  DisplayListBuilder nesting_builder(true);
+  nesting_builder.drawDisplayList(display_list);
+  sk_sp<DisplayList> nesting_list = nesting_builder.Build();
+  EXPECT_TRUE(nesting_list->has_image_filtered_layers());
+  ExpectTiledRenderingMatches(nesting_list, SkIRect::MakeWH(200, 150), 32);
+
+  EXPECT_FALSE(MakeTiledTestDisplayList()->has_image_filtered_layers());
+}
+
+TEST(DisplayList, TiledRasterizationWithoutTaskRunnerRendersAllTiles) {
+  sk_sp<DisplayList> display_list = MakeTiledTestDisplayList();
+  auto info = SkImageInfo::MakeN32Premul(200, 150);
+  sk_sp<SkSurface> expected = SkSurface::MakeRaster(info);
+  display_list->RenderTo(expected->getCanvas());
+
+  DisplayListTiledRasterizer rasterizer(nullptr, 0, 64);
+  EXPECT_FALSE(rasterizer.ShouldTile({4096, 4096}));
+  sk_sp<SkSurface> tiled = SkSurface::MakeRaster(info);
+  SkPixmap tiled_pixels;
+  ASSERT_TRUE(tiled->peekPixels(&tiled_pixels));
+  rasterizer.Rasterize(display_list, tiled_pixels, tiled_pixels.bounds());
+
+  SkPixmap expected_pixels;
+  ASSERT_TRUE(expected->peekPixels(&expected_pixels));
+  EXPECT_EQ(memcmp(tiled_pixels.addr(), expected_pixels.addr(),
+                   expected_pixels.computeByteSize()),
+            0);
+}
+
+namespace {
+
+// Runs each task as soon as it is posted, counting the tasks.
+class CountingTaskRunner : public fml::BasicTaskRunner {
+ public:
+  void PostTask(const fml::closure& task) override {
+    task_count_++;
+    task();
+  }
+
+  size_t task_count() const { return task_count_; }
+
+ private:
+  size_t task_count_ = 0;
+};
+
+}  // namespace
+
+TEST(DisplayList, TiledRasterizationPostsATaskPerExtraThread) {
+  sk_sp<DisplayList> display_list = MakeTiledTestDisplayList();
+  auto info = SkImageInfo::MakeN32Premul(200, 150);
+  sk_sp<SkSurface> tiled = SkSurface::MakeRaster(info);
+  SkPixmap tiled_pixels;
+  ASSERT_TRUE(tiled->peekPixels(&tiled_pixels));
+
+  // 4x3 tiles of 64 pixels rendered by the caller and 2 of 3 workers.
+  auto task_runner = std::make_shared<CountingTaskRunner>();
+  DisplayListTiledRasterizer rasterizer(task_runner, 3, 64);
+  rasterizer.Rasterize(display_list, tiled_pixels, tiled_pixels.bounds());
+  EXPECT_EQ(task_runner->task_count(), 2u);
+
+  // A single tile is rendered by the caller alone.
+  auto single_tile_task_runner = std::make_shared<CountingTaskRunner>();
+  DisplayListTiledRasterizer single_tile_rasterizer(single_tile_task_runner, 3,
+                                                    256);
+  single_tile_rasterizer.Rasterize(display_list, tiled_pixels,
+                                   tiled_pixels.bounds());
+  EXPECT_EQ(single_tile_task_runner->task_count(), 0u);
+}
+
+TEST(DisplayList, MemoryUsageIncludesReferencedObjects) {
+  SkPath path =
+      SkPath().moveTo(0, 0).lineTo(100, 0).quadTo(100, 100, 0, 100).close();
+  sk_sp<DlImage> image = MakeTestImage(30, 30, 5);
+  size_t image_bytes = image->GetApproximateByteSize();
+
+  DisplayListBuilder builder;
+  builder.drawPath(path);
+  // The copies of the path share their data, which is only counted once.
+  builder.clipPath(path, SkClipOp::kIntersect, true);
+  builder.drawImage(std::move(image), {0, 0}, NearestSampling, false);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  DisplayListMemoryUsage usage = display_list->MemoryUsage();
+  EXPECT_EQ(usage.op_bytes, display_list->bytes(false));
+  EXPECT_EQ(usage.path_bytes, path.approximateBytesUsed() - sizeof(SkPath));
+  EXPECT_EQ(usage.unique_image_bytes, image_bytes);
+  EXPECT_EQ(usage.shared_image_bytes, 0u);
+  EXPECT_EQ(usage.total_bytes(),
+            usage.op_bytes + usage.path_bytes + image_bytes);
+}
+
+TEST(DisplayList, MemoryUsageCountsImagesHeldElsewhereAsShared) {
+  sk_sp<DlImage> nested_image = MakeTestImage(30, 30, 5);
+  size_t nested_image_bytes = nested_image->GetApproximateByteSize();
+  DisplayListBuilder nested_builder;
+  nested_builder.drawImage(std::move(nested_image), {0, 0}, NearestSampling,
+                           false);
+  sk_sp<DisplayList> nested = nested_builder.Build();
+
+  DisplayListBuilder builder;
+  // TestImage1 is also held by the test fixture.
+  builder.drawImage(TestImage1, {0, 0}, NearestSampling, false);
+  builder.drawImage(TestImage1, {10, 10}, NearestSampling, false);
+  builder.drawDisplayList(nested);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  // The image of the nested list is only held by that list, but the list
+  // is also held here, so the image may outlive |display_list|.
+  DisplayListMemoryUsage usage = display_list->MemoryUsage();
+  EXPECT_EQ(usage.op_bytes, display_list->bytes(false) + nested->bytes(false));
+  EXPECT_EQ(usage.unique_image_bytes, 0u);
+  EXPECT_EQ(usage.shared_image_bytes,
+            TestImage1->GetApproximateByteSize() + nested_image_bytes);
+
+  EXPECT_EQ(nested->MemoryUsage().unique_image_bytes, nested_image_bytes);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -305,6 +305,11 @@ void DisplayListBoundsCalculator::saveLayer(const SkRect* bounds,
 
     layer_infos_.emplace_back(
         std::make_unique<LayerData>(accumulator_, image_filter_));
+    if (image_filter_ && filtered_layer_op_bounds_.isEmpty()) {
+      filtered_layer_op_bounds_ =
+          has_clip() ? clip_bounds() : kUnboundedOpBounds;
+      layer_infos_.back()->set_sets_filtered_op_bounds();
+    }
   } else {
     layer_infos_.emplace_back(
         std::make_unique<LayerData>(accumulator_, nullptr));
@@ -329,6 +334,9 @@ void DisplayListBoundsCalculator::restore() {
     LayerData* layer_info = layer_infos_.back().get();
     BoundsAccumulator* outer_accumulator = layer_info->restore_accumulator();
     bool is_unbounded = layer_info->is_unbounded();
+    if (layer_info->sets_filtered_op_bounds()) {
+      filtered_layer_op_bounds_.setEmpty();
+    }
 
     // Before we pop_back we will get the current layer bounds from the
     // current accumulator and adjust ot as required based on the filter.
@@ -631,8 +639,10 @@ bool DisplayListBoundsCalculator::AdjustBoundsForPaint(
 void DisplayListBoundsCalculator::AccumulateUnbounded() {
   if (has_clip()) {
     accumulator_->accumulate(clip_bounds());
+    RecordOpBounds(clip_bounds());
   } else {
     layer_infos_.back()->set_unbounded();
+    RecordOpBounds(kUnboundedOpBounds);
   }
 }
 void DisplayListBoundsCalculator::AccumulateOpBounds(
@@ -648,6 +658,7 @@ void DisplayListBoundsCalculator::AccumulateBounds(SkRect& bounds) {
   matrix().mapRect(&bounds);
   if (!has_clip() || bounds.intersect(clip_bounds())) {
     accumulator_->accumulate(bounds);
+    RecordOpBounds(bounds);
   }
 }
 
@@ -494,10 +494,36 @@ class DisplayListBoundsCalculator final
     return accumulator_->bounds();
   }
 
+  // Clears the bounds recorded for the most recent rendering op so that
+  // the bounds of the next rendering op can be examined on their own via
+  // |op_bounds|. This is used by the DisplayList to build a spatial index
+  // of its rendering ops.
+  void ResetOpBounds() { op_bounds_.setEmpty(); }
+
+  // The bounds of the rendering ops dispatched since the last call to
+  // |ResetOpBounds|, transformed and clipped in the same manner as the
+  // overall bounds. An op that cannot compute its bounds, or that floods
+  // the surface, will report the current clip (or |kUnboundedOpBounds|
+  // if there is no clip). An op that renders into a saveLayer that has
+  // an ImageFilter reports the clip that was in effect outside of that
+  // saveLayer since the filter may move its pixels anywhere in the layer.
+  const SkRect& op_bounds() const { return op_bounds_; }
+
+  static constexpr SkRect kUnboundedOpBounds =
+      SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
+
  private:
   // current accumulator based on saveLayer history
   BoundsAccumulator* accumulator_;
 
+  // The bounds of the rendering ops since the last |ResetOpBounds|
+  SkRect op_bounds_ = SkRect::MakeEmpty();
+
+  // Non-empty only while inside a saveLayer that applies an ImageFilter,
+  // in which case it holds the clip bounds outside of the outermost such
+  // layer. See |op_bounds|.
+  SkRect filtered_layer_op_bounds_ = SkRect::MakeEmpty();
+
   // A class that remembers the information kept for a single
   // |save| or |saveLayer|.
   // Each save or saveLayer will maintain its own bounds accumulator
@@ -516,7 +542,10 @@ class DisplayListBoundsCalculator final
     // saveLayer (and all save) calls the filter will be null.
     explicit LayerData(BoundsAccumulator* outer,
                        std::shared_ptr<DlImageFilter> filter = nullptr)
-        : outer_(outer), filter_(filter), is_unbounded_(false) {}
+        : outer_(outer),
+          filter_(filter),
+          is_unbounded_(false),
+          sets_filtered_op_bounds_(false) {}
     ~LayerData() = default;
 
     // The accumulator to use while this layer is put in play by
@@ -560,11 +589,18 @@ class DisplayListBoundsCalculator final
     // the layer will have one last chance to flag an unbounded state.
     bool is_unbounded() const { return is_unbounded_; }
 
+    // Marks this layer as the outermost filtered layer which established
+    // the value of |filtered_layer_op_bounds_| so that the value can be
+    // cleared when the layer is restored.
+    void set_sets_filtered_op_bounds() { sets_filtered_op_bounds_ = true; }
+    bool sets_filtered_op_bounds() const { return sets_filtered_op_bounds_; }
+
    private:
     BoundsAccumulator layer_accumulator_;
     BoundsAccumulator* outer_;
     std::shared_ptr<DlImageFilter> filter_;
     bool is_unbounded_;
+    bool sets_filtered_op_bounds_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(LayerData);
   };
@@ -614,6 +650,14 @@ class DisplayListBoundsCalculator final
   // Records the given bounds after transforming by the current matrix
   // and clipping against the current clip.
   void AccumulateBounds(SkRect& bounds);
+
+  // Records the device bounds of the current rendering op for the
+  // |op_bounds| accessor.
+  void RecordOpBounds(const SkRect& bounds) {
+    op_bounds_.join(filtered_layer_op_bounds_.isEmpty()
+                        ? bounds
+                        : filtered_layer_op_bounds_);
+  }
 };
 
 }  // namespace flutter
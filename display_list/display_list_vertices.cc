@@ -85,6 +85,41 @@ size_t DlVertices::size() const {
                       index_count_);
 }
 
+bool DlVertices::FitsInBytes(size_t bytes) const {
+  if (bytes < sizeof(DlVertices) || vertex_count_ < 0 || index_count_ < 0 ||
+      mode_ > DlVertexMode::kTriangleFan) {
+    return false;
+  }
+  auto fits = [bytes](size_t offset, int count, size_t element_size) {
+    return offset >= sizeof(DlVertices) && offset <= bytes &&
+           static_cast<size_t>(count) <= (bytes - offset) / element_size;
+  };
+  if (vertex_count_ > 0 &&
+      !fits(vertices_offset_, vertex_count_, sizeof(SkPoint))) {
+    return false;
+  }
+  if (texture_coordinates_offset_ > 0 &&
+      !fits(texture_coordinates_offset_, vertex_count_, sizeof(SkPoint))) {
+    return false;
+  }
+  if (colors_offset_ > 0 &&
+      !fits(colors_offset_, vertex_count_, sizeof(DlColor))) {
+    return false;
+  }
+  if (index_count_ > 0) {
+    if (!fits(indices_offset_, index_count_, sizeof(uint16_t))) {
+      return false;
+    }
+    const uint16_t* indices = this->indices();
+    for (int i = 0; i < index_count_; i++) {
+      if (indices[i] >= vertex_count_) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 static SkRect compute_bounds(const SkPoint* points, int count) {
   BoundsAccumulator accumulator;
   for (int i = 0; i < count; i++) {
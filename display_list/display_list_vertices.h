@@ -195,6 +195,12 @@ class DlVertices {
   /// Returns the size of the object including all of the inlined data.
   size_t size() const;
 
+  /// Returns true if the inlined arrays described by the counts and
+  /// offsets of this object lie within its first |bytes| bytes and all
+  /// of the indices refer to a vertex, for example when validating an
+  /// object that was read from a file.
+  bool FitsInBytes(size_t bytes) const;
+
   /// Returns the bounds of the vertices.
   SkRect bounds() const { return bounds_; }
 
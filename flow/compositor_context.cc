@@ -5,6 +5,7 @@
 #include "flutter/flow/compositor_context.h"
 
 #include <optional>
+#include "flutter/display_list/display_list_canvas_recorder.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
@@ -39,6 +40,7 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
     damage_ =
         context.ComputeDamage(additional_damage_, horizontal_clip_alignment_,
                               vertical_clip_alignment_);
+    context.statistics().LogStatistics();
     return SkRect::Make(damage_->buffer_damage);
   } else {
     return std::nullopt;
@@ -54,6 +56,17 @@ CompositorContext::CompositorContext(Stopwatch::RefreshRateUpdater& updater)
 
 CompositorContext::~CompositorContext() = default;
 
+void CompositorContext::SetTiledRasterTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner,
+    size_t worker_count) {
+  if (task_runner) {
+    tiled_rasterizer_ = std::make_unique<DisplayListTiledRasterizer>(
+        std::move(task_runner), worker_count);
+  } else {
+    tiled_rasterizer_.reset();
+  }
+}
+
 void CompositorContext::BeginFrame(ScopedFrame& frame,
                                    bool enable_instrumentation) {
   if (enable_instrumentation) {
@@ -134,31 +147,72 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     return RasterStatus::kSkipAndRetry;
   }
 
-  SkAutoCanvasRestore restore(canvas(), clip_rect.has_value());
+  // Large software frames are recorded into a DisplayList and then
+  // rendered in parallel tiles into the pixels of the canvas. Frames
+  // whose recording saves a layer with an ImageFilter, for example for
+  // an ImageFilterLayer, are rendered in one piece by the rasterizer.
+  SkCanvas* target_canvas = canvas_;
+  SkPixmap tiled_pixmap;
+  sk_sp<DisplayListCanvasRecorder> tiled_recorder;
+  if (ShouldRasterizeInTiles(root_needs_readback, &tiled_pixmap)) {
+    tiled_recorder = sk_make_sp<DisplayListCanvasRecorder>(
+        SkRect::Make(tiled_pixmap.bounds()), true);
+    canvas_ = tiled_recorder.get();
+  }
 
-  // Clearing canvas after preroll reduces one render target switch when preroll
-  // paints some raster cache.
-  if (canvas()) {
-    if (clip_rect) {
-      canvas()->clipRect(*clip_rect);
-    }
+  {
+    SkAutoCanvasRestore restore(canvas(), clip_rect.has_value());
+
+    // Clearing canvas after preroll reduces one render target switch when
+    // preroll paints some raster cache.
+    if (canvas()) {
+      if (clip_rect) {
+        canvas()->clipRect(*clip_rect);
+      }
 
-    if (needs_save_layer) {
-      TRACE_EVENT0("flutter", "Canvas::saveLayer");
-      SkRect bounds = SkRect::Make(layer_tree.frame_size());
-      SkPaint paint;
-      paint.setBlendMode(SkBlendMode::kSrc);
-      canvas()->saveLayer(&bounds, &paint);
+      if (needs_save_layer) {
+        TRACE_EVENT0("flutter", "Canvas::saveLayer");
+        SkRect bounds = SkRect::Make(layer_tree.frame_size());
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        canvas()->saveLayer(&bounds, &paint);
+      }
+      canvas()->clear(SK_ColorTRANSPARENT);
+    }
+    layer_tree.Paint(*this, ignore_raster_cache);
+    if (canvas() && needs_save_layer) {
+      canvas()->restore();
     }
-    canvas()->clear(SK_ColorTRANSPARENT);
   }
-  layer_tree.Paint(*this, ignore_raster_cache);
-  if (canvas() && needs_save_layer) {
-    canvas()->restore();
+
+  if (tiled_recorder) {
+    canvas_ = target_canvas;
+    SkSurfaceProps props;
+    target_canvas->getProps(&props);
+    context_.tiled_rasterizer()->Rasterize(
+        tiled_recorder->Build(), tiled_pixmap,
+        clip_rect ? clip_rect->roundOut() : tiled_pixmap.bounds(), props);
   }
   return RasterStatus::kSuccess;
 }
 
+bool CompositorContext::ScopedFrame::ShouldRasterizeInTiles(
+    bool root_needs_readback,
+    SkPixmap* pixmap) {
+  // Tiles can only be rendered into raster surfaces and the content of
+  // a frame that reads back from the surface, such as a backdrop filter,
+  // depends on the pixels outside of the tile being read.
+  if (!context_.tiled_rasterizer() || !canvas_ || gr_context_ ||
+      view_embedder_ || display_list_builder_ || root_needs_readback) {
+    return false;
+  }
+  if (!canvas_->getTotalMatrix().isIdentity() ||
+      !canvas_->peekPixels(pixmap)) {
+    return false;
+  }
+  return context_.tiled_rasterizer()->ShouldTile(pixmap->dimensions());
+}
+
 void CompositorContext::OnGrContextCreated() {
   texture_registry_.OnGrContextCreated();
   raster_cache_.Clear();
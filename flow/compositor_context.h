@@ -9,6 +9,7 @@
 #include <string>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/display_list/display_list_tiled_rasterizer.h"
 #include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
@@ -140,6 +141,11 @@ class CompositorContext {
                                 FrameDamage* frame_damage);
 
    private:
+    // Returns true if the frame should be recorded into a DisplayList
+    // and rendered in parallel tiles, filling in |pixmap| with the
+    // pixels of the canvas that the tiles will be rendered into.
+    bool ShouldRasterizeInTiles(bool root_needs_readback, SkPixmap* pixmap);
+
     CompositorContext& context_;
     GrDirectContext* gr_context_;
     SkCanvas* canvas_;
@@ -183,12 +189,54 @@ class CompositorContext {
 
   LayerSnapshotStore& snapshot_store() { return layer_snapshot_store_; }
 
+  // Enables rendering large frames into software surfaces in parallel
+  // tiles using the |worker_count| workers of |task_runner|, or disables
+  // it if the |task_runner| is null. See |DisplayListTiledRasterizer|.
+  void SetTiledRasterTaskRunner(
+      std::shared_ptr<fml::BasicTaskRunner> task_runner,
+      size_t worker_count);
+
+  const DisplayListTiledRasterizer* tiled_rasterizer() const {
+    return tiled_rasterizer_.get();
+  }
+
+  // Enables prerolling the children of wide containers in parallel on the
+  // workers of |task_runner|, or disables it if |task_runner| is null. See
+  // |PrerollContext::preroll_task_runner|.
+  void SetPrerollTaskRunner(std::shared_ptr<fml::BasicTaskRunner> task_runner) {
+    preroll_task_runner_ = std::move(task_runner);
+  }
+
+  fml::BasicTaskRunner* preroll_task_runner() const {
+    return preroll_task_runner_.get();
+  }
+
+  // Enables reusing the Preroll and Paint of retained subtrees across
+  // frames. See |PrerollContext::reuse_retained_subtrees|.
+  void set_reuse_retained_subtrees(bool reuse) {
+    reuse_retained_subtrees_ = reuse;
+  }
+
+  bool reuse_retained_subtrees() const { return reuse_retained_subtrees_; }
+
+  // Enables reporting the memory retained by the DisplayLists of each frame
+  // to the timeline, which walks all of their ops.
+  void set_trace_display_list_memory(bool trace) {
+    trace_display_list_memory_ = trace;
+  }
+
+  bool trace_display_list_memory() const { return trace_display_list_memory_; }
+
  private:
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
   LayerSnapshotStore layer_snapshot_store_;
+  std::unique_ptr<DisplayListTiledRasterizer> tiled_rasterizer_;
+  std::shared_ptr<fml::BasicTaskRunner> preroll_task_runner_;
+  bool reuse_retained_subtrees_ = false;
+  bool trace_display_list_memory_ = false;
 
   /// Only used by default constructor of `CompositorContext`.
   FixedRefreshRateUpdater fixed_refresh_rate_updater_;
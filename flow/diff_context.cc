@@ -245,7 +245,8 @@ void DiffContext::Statistics::LogStatistics() {
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_, "ReusedSubtrees",
+                    reused_subtrees_);
 #endif  // !FLUTTER_RELEASE
 }
 
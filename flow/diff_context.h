@@ -123,6 +123,14 @@ class DiffContext {
   // Readback rect is in screen coordinates.
   void AddReadbackRegion(const SkIRect& rect);
 
+  // Returns whether the damage of the layers diffed so far intersects the
+  // rect. As layers are diffed in paint order, this tells whether the content
+  // painted below the current layer changed in that area since the last
+  // frame.
+  //
+  // Rect is in screen coordinates.
+  bool IsDamaged(const SkRect& rect) const { return damage_.intersects(rect); }
+
   // Returns the paint region for current subtree; Each rect in paint region is
   // in screen coordinates; Once a layer accumulates the paint regions of its
   // children, this PaintRegion value can be associated with the current layer
@@ -177,6 +185,11 @@ class DiffContext {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Retained layer subtree that is the same instance as in the previous
+    // frame and is not diffed. Such subtrees also reuse their Preroll and
+    // Paint results when they are prerolled with the same transform.
+    void AddReusedSubtree() { ++reused_subtrees_; }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
@@ -186,6 +199,7 @@ class DiffContext {
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int reused_subtrees_ = 0;
   };
 
   Statistics& statistics() { return statistics_; }
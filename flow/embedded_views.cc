@@ -11,35 +11,51 @@ void ExternalViewEmbedder::SubmitFrame(GrDirectContext* context,
   frame->Submit();
 };
 
+// Holds about 100 mutators.
+static constexpr size_t kMutatorsArenaBlockSize = 8 * 1024;
+
+MutatorsStack::MutatorsStack(const MutatorsStack& other)
+    : vector_(other.vector_) {}
+
+MutatorsStack& MutatorsStack::operator=(const MutatorsStack& other) {
+  vector_ = other.vector_;
+  return *this;
+}
+
 void MutatorsStack::PushClipRect(const SkRect& rect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rect);
-  vector_.push_back(element);
+  vector_.push_back(arena().MakeShared<Mutator>(rect));
 };
 
 void MutatorsStack::PushClipRRect(const SkRRect& rrect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rrect);
-  vector_.push_back(element);
+  vector_.push_back(arena().MakeShared<Mutator>(rrect));
 };
 
 void MutatorsStack::PushClipPath(const SkPath& path) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(path);
-  vector_.push_back(element);
+  vector_.push_back(arena().MakeShared<Mutator>(path));
 };
 
 void MutatorsStack::PushTransform(const SkMatrix& matrix) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(matrix);
-  vector_.push_back(element);
+  vector_.push_back(arena().MakeShared<Mutator>(matrix));
 };
 
 void MutatorsStack::PushOpacity(const int& alpha) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(alpha);
-  vector_.push_back(element);
+  vector_.push_back(arena().MakeShared<Mutator>(alpha));
 };
 
 void MutatorsStack::Pop() {
   vector_.pop_back();
+  if (vector_.empty() && arena_) {
+    arena_->Reset();
+  }
 };
 
+FrameArena& MutatorsStack::arena() {
+  if (!arena_) {
+    arena_ = fml::MakeRefCounted<FrameArena>(kMutatorsArenaBlockSize);
+  }
+  return *arena_;
+}
+
 const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator
 MutatorsStack::Top() const {
   return vector_.rend();
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "flutter/flow/frame_arena.h"
 #include "flutter/flow/surface_frame.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/raster_thread_merger.h"
@@ -124,10 +125,19 @@ class Mutator {
 // For example consider the following stack: [T1, T2, T3], where T1 is the top
 // of the stack and T3 is the bottom of the stack. Applying this mutators stack
 // to a platform view P1 will result in T1(T2(T3(P1))).
+//
+// The mutators are allocated in a |FrameArena| of the stack, whose blocks are
+// reused once the stack is empty and no copy holds their mutators.
 class MutatorsStack {
  public:
   MutatorsStack() = default;
 
+  // Copies share the mutators, but not the arena of the stack.
+  MutatorsStack(const MutatorsStack& other);
+  MutatorsStack& operator=(const MutatorsStack& other);
+  MutatorsStack(MutatorsStack&& other) = default;
+  MutatorsStack& operator=(MutatorsStack&& other) = default;
+
   void PushClipRect(const SkRect& rect);
   void PushClipRRect(const SkRRect& rrect);
   void PushClipPath(const SkPath& path);
@@ -190,7 +200,10 @@ class MutatorsStack {
   }
 
  private:
+  FrameArena& arena();
+
   std::vector<std::shared_ptr<Mutator>> vector_;
+  fml::RefPtr<FrameArena> arena_;
 };  // MutatorsStack
 
 class EmbeddedViewParams {
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_arena.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+std::atomic<size_t> g_live_block_count{0};
+
+// The room taken by the pointer to the block stored before each object.
+constexpr size_t kHeaderSize = sizeof(void*);
+
+}  // namespace
+
+FrameArena::Block::Block(size_t size)
+    : memory(new uint8_t[size]), size(size) {
+  g_live_block_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameArena::Block::~Block() {
+  g_live_block_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t FrameArena::live_block_count() {
+  return g_live_block_count.load(std::memory_order_relaxed);
+}
+
+FrameArena::FrameArena(size_t block_size) : block_size_(block_size) {}
+
+FrameArena::~FrameArena() {
+  for (Block* block : blocks_) {
+    ReleaseBlock(block);
+  }
+}
+
+void FrameArena::Reset() {
+  // Objects are only allocated by the thread that owns the arena, so a block
+  // that holds no live object at this point will not get one from elsewhere.
+  auto kept = std::remove_if(blocks_.begin(), blocks_.end(), [](Block* block) {
+    if (block->ref_count.load(std::memory_order_acquire) == 1) {
+      return false;
+    }
+    ReleaseBlock(block);
+    return true;
+  });
+  blocks_.erase(kept, blocks_.end());
+  current_block_ = 0;
+  offset_ = 0;
+  allocated_bytes_ = 0;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+  // The blocks are aligned for any fundamental type.
+  FML_DCHECK(alignment <= alignof(std::max_align_t));
+  FML_DCHECK((alignment & (alignment - 1)) == 0);
+  alignment = std::max(alignment, alignof(Block*));
+
+  while (true) {
+    if (current_block_ == blocks_.size()) {
+      // The objects are at most |alignof(std::max_align_t)| bytes into a
+      // new block.
+      size_t block_size = std::max(block_size_, size + alignof(std::max_align_t));
+      blocks_.push_back(new Block(block_size));
+    }
+    Block* block = blocks_[current_block_];
+    size_t offset = (offset_ + kHeaderSize + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= block->size) {
+      offset_ = offset + size;
+      allocated_bytes_ += size;
+      block->ref_count.fetch_add(1, std::memory_order_relaxed);
+      uint8_t* object = block->memory.get() + offset;
+      *reinterpret_cast<Block**>(object - kHeaderSize) = block;
+      return object;
+    }
+    // The blocks that were kept by |Reset| are reused before new ones are
+    // added.
+    current_block_++;
+    offset_ = 0;
+  }
+}
+
+void FrameArena::Deallocate(void* object) {
+  ReleaseBlock(
+      *reinterpret_cast<Block**>(static_cast<uint8_t*>(object) - kHeaderSize));
+}
+
+void FrameArena::ReleaseBlock(Block* block) {
+  if (block->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete block;
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,135 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_ARENA_H_
+#define FLUTTER_FLOW_FRAME_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_counted.h"
+
+namespace flutter {
+
+/// An arena for the objects of a frame that are destroyed together once the
+/// frame is retired, such as the layers built by a `SceneBuilder` or the
+/// mutators pushed during Preroll.
+///
+/// Objects are allocated by `MakeShared` in large blocks of memory, with the
+/// object and its reference count in a single allocation, and their memory is
+/// not reused when they are destroyed. Instead, each object holds a reference
+/// to the block it was allocated in, and a block is freed once the arena has
+/// let go of it and its last object is gone. An object that outlives its
+/// frame, such as a layer retained by an `EngineLayer`, only keeps its own
+/// block alive, not the blocks of the rest of the frame.
+///
+/// Objects are allocated by one thread at a time, but may be destroyed on any
+/// thread.
+class FrameArena : public fml::RefCountedThreadSafe<FrameArena> {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  /// The allocator of `std::allocate_shared` for the objects of an arena.
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(FrameArena* arena) : arena_(arena) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) { FrameArena::Deallocate(p); }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+   private:
+    template <typename U>
+    friend class Allocator;
+
+    FrameArena* arena_;
+  };
+
+  /// Creates an object in the arena.
+  template <typename T, typename... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(this),
+                                   std::forward<Args>(args)...);
+  }
+
+  /// Reuses the blocks of the arena whose objects are all gone for new
+  /// objects. The blocks that still hold live objects are handed over to
+  /// those objects and freed with the last of them.
+  void Reset();
+
+  /// The number of bytes allocated since the arena was created or reset.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  /// The number of blocks of memory held by the arena.
+  size_t block_count() const { return blocks_.size(); }
+
+  /// The number of blocks of all arenas that have not been freed yet,
+  /// including the blocks only kept alive by objects that outlived their
+  /// arena.
+  static size_t live_block_count();
+
+ private:
+  struct Block {
+    explicit Block(size_t size);
+    ~Block();
+
+    std::unique_ptr<uint8_t[]> memory;
+    size_t size;
+    // One reference for the arena while the block belongs to it, and one
+    // for each live object allocated in the block.
+    std::atomic<size_t> ref_count{1};
+  };
+
+  explicit FrameArena(size_t block_size = kDefaultBlockSize);
+
+  ~FrameArena();
+
+  // Allocates |size| bytes and adds a reference to their block. The block is
+  // recorded just before the returned memory.
+  void* Allocate(size_t size, size_t alignment);
+
+  // Releases the reference to the block of |object| added by |Allocate|.
+  static void Deallocate(void* object);
+
+  static void ReleaseBlock(Block* block);
+
+  const size_t block_size_;
+  std::vector<Block*> blocks_;
+  // The block that new objects are allocated in, and the offset of the free
+  // memory in it.
+  size_t current_block_ = 0;
+  size_t offset_ = 0;
+  size_t allocated_bytes_ = 0;
+
+  FML_FRIEND_MAKE_REF_COUNTED(FrameArena);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(FrameArena);
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FRAME_ARENA_H_
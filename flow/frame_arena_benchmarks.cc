@@ -0,0 +1,138 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_arena.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/embedded_views.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+
+namespace flutter {
+namespace {
+
+// Allocates the layers of a scene on the heap, like the scene builder did
+// before it had an arena.
+struct HeapLayerFactory {
+  template <typename T, typename... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args) {
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+};
+
+// Builds and destroys a scene of about |layer_count| layers, as the
+// framework does for each frame: a root container with rows of transform
+// layers, each of which holds an opacity layer and a container.
+template <typename Factory>
+void BuildScene(Factory& factory, int layer_count) {
+  auto root = factory.template MakeShared<ContainerLayer>();
+  for (int i = 0; i < layer_count / 3; i++) {
+    auto transform = factory.template MakeShared<TransformLayer>(
+        SkMatrix::Translate(i * 2.0f, i * 2.0f));
+    auto opacity = factory.template MakeShared<OpacityLayer>(
+        128, SkPoint::Make(1.0f, 1.0f));
+    opacity->Add(factory.template MakeShared<ContainerLayer>());
+    transform->Add(opacity);
+    root->Add(transform);
+  }
+}
+
+void BM_BuildSceneOnHeap(benchmark::State& state) {
+  HeapLayerFactory factory;
+  while (state.KeepRunning()) {
+    BuildScene(factory, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BuildSceneInFrameArena(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    // Each scene builder creates its own arena.
+    auto arena = fml::MakeRefCounted<FrameArena>();
+    BuildScene(*arena, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Pushes and pops the mutators of |layer_count| clipped transform layers
+// under a root transform, as Preroll does for each frame.
+template <typename Stack>
+void PushMutators(Stack& stack, int layer_count) {
+  stack.PushTransform(SkMatrix::Scale(2.0f, 2.0f));
+  for (int i = 0; i < layer_count; i++) {
+    stack.PushTransform(SkMatrix::Translate(i * 2.0f, i * 2.0f));
+    stack.PushClipRect(SkRect::MakeWH(100.0f, 100.0f));
+    stack.Pop();
+    stack.Pop();
+  }
+  stack.Pop();
+}
+
+// Allocates each mutator on the heap, like the mutators stack did before it
+// had an arena.
+class HeapMutatorsStack {
+ public:
+  void PushTransform(const SkMatrix& matrix) {
+    vector_.push_back(std::make_shared<Mutator>(matrix));
+  }
+
+  void PushClipRect(const SkRect& rect) {
+    vector_.push_back(std::make_shared<Mutator>(rect));
+  }
+
+  void Pop() { vector_.pop_back(); }
+
+ private:
+  std::vector<std::shared_ptr<Mutator>> vector_;
+};
+
+void BM_PushMutatorsOnHeap(benchmark::State& state) {
+  HeapMutatorsStack stack;
+  while (state.KeepRunning()) {
+    PushMutators(stack, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PushMutatorsInFrameArena(benchmark::State& state) {
+  // The stack is reused across frames, and resets its arena whenever it is
+  // empty.
+  MutatorsStack stack;
+  while (state.KeepRunning()) {
+    PushMutators(stack, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_BuildSceneOnHeap)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_BuildSceneInFrameArena)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PushMutatorsOnHeap)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PushMutatorsInFrameArena)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,139 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_arena.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Counts the instances that are alive.
+class Counted {
+ public:
+  explicit Counted(int* count) : count_(count) { (*count_)++; }
+  ~Counted() { (*count_)--; }
+
+ private:
+  int* count_;
+};
+
+}  // namespace
+
+TEST(FrameArenaTest, AllocatesObjectsInBlocks) {
+  auto arena = fml::MakeRefCounted<FrameArena>(1024);
+  int count = 0;
+  std::vector<std::shared_ptr<Counted>> objects;
+  for (int i = 0; i < 100; i++) {
+    objects.push_back(arena->MakeShared<Counted>(&count));
+  }
+  EXPECT_EQ(count, 100);
+  EXPECT_GT(arena->allocated_bytes(), 100 * sizeof(Counted));
+  EXPECT_GT(arena->block_count(), 1u);
+  EXPECT_LT(arena->block_count(), 100u);
+
+  objects.clear();
+  EXPECT_EQ(count, 0);
+}
+
+TEST(FrameArenaTest, AllocatesObjectsLargerThanBlocks) {
+  auto arena = fml::MakeRefCounted<FrameArena>(64);
+  auto small = arena->MakeShared<int64_t>(1);
+  auto large = arena->MakeShared<std::array<int64_t, 32>>();
+  EXPECT_EQ(arena->block_count(), 2u);
+  EXPECT_EQ(*small, 1);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large.get()) % alignof(int64_t), 0u);
+}
+
+TEST(FrameArenaTest, ReusesBlocksAfterReset) {
+  auto arena = fml::MakeRefCounted<FrameArena>(1024);
+  for (int i = 0; i < 100; i++) {
+    arena->MakeShared<int64_t>(i);
+  }
+  size_t block_count = arena->block_count();
+  size_t allocated_bytes = arena->allocated_bytes();
+
+  arena->Reset();
+  EXPECT_EQ(arena->allocated_bytes(), 0u);
+  for (int i = 0; i < 100; i++) {
+    arena->MakeShared<int64_t>(i);
+  }
+  EXPECT_EQ(arena->block_count(), block_count);
+  EXPECT_EQ(arena->allocated_bytes(), allocated_bytes);
+}
+
+TEST(FrameArenaTest, RetainedObjectsOutliveTheArena) {
+  int count = 0;
+  std::shared_ptr<Counted> retained;
+  {
+    auto arena = fml::MakeRefCounted<FrameArena>();
+    auto dropped = arena->MakeShared<Counted>(&count);
+    retained = arena->MakeShared<Counted>(&count);
+    EXPECT_EQ(count, 2);
+  }
+  EXPECT_EQ(count, 1);
+  retained.reset();
+  EXPECT_EQ(count, 0);
+}
+
+TEST(FrameArenaTest, ResetHandsBlocksWithLiveObjectsOver) {
+  auto arena = fml::MakeRefCounted<FrameArena>(1024);
+  int count = 0;
+  std::vector<std::shared_ptr<Counted>> objects;
+  for (int i = 0; i < 100; i++) {
+    objects.push_back(arena->MakeShared<Counted>(&count));
+  }
+  std::shared_ptr<Counted> retained = objects.back();
+  objects.clear();
+  size_t block_count = arena->block_count();
+  size_t live_block_count = FrameArena::live_block_count();
+
+  arena->Reset();
+  EXPECT_EQ(arena->block_count(), block_count - 1);
+  EXPECT_EQ(FrameArena::live_block_count(), live_block_count);
+  retained.reset();
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(FrameArena::live_block_count(), live_block_count - 1);
+}
+
+TEST(FrameArenaTest, RetainedLayerOnlyKeepsItsOwnBlock) {
+  size_t live_block_count = FrameArena::live_block_count();
+  std::shared_ptr<ContainerLayer> retained;
+  {
+    // A frame whose layers take many blocks, one of which is retained like
+    // the layer of an EngineLayer.
+    auto arena = fml::MakeRefCounted<FrameArena>(1024);
+    auto root = arena->MakeShared<ContainerLayer>();
+    for (int i = 0; i < 100; i++) {
+      auto layer = arena->MakeShared<ContainerLayer>();
+      root->Add(layer);
+      if (i == 50) {
+        retained = layer;
+      }
+    }
+    EXPECT_GT(FrameArena::live_block_count(), live_block_count + 1);
+  }
+  EXPECT_EQ(FrameArena::live_block_count(), live_block_count + 1);
+
+  // The next frame adds the retained layer to its own scene.
+  {
+    auto arena = fml::MakeRefCounted<FrameArena>(1024);
+    auto root = arena->MakeShared<ContainerLayer>();
+    root->Add(retained);
+  }
+  EXPECT_EQ(FrameArena::live_block_count(), live_block_count + 1);
+
+  retained.reset();
+  EXPECT_EQ(FrameArena::live_block_count(), live_block_count);
+}
+
+}  // namespace testing
+}  // namespace flutter
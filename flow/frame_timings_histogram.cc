@@ -0,0 +1,162 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timings_histogram.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+FrameTimingsHistogram::FrameTimingsHistogram(fml::TimeDelta window)
+    : window_(window) {
+  FML_DCHECK(window_ > fml::TimeDelta::Zero());
+  for (Slot& slot : slots_) {
+    slot.build.Clear();
+    slot.raster.Clear();
+    slot.vsync_to_present.Clear();
+  }
+}
+
+FrameTimingsHistogram::~FrameTimingsHistogram() = default;
+
+size_t FrameTimingsHistogram::BucketIndex(int64_t micros) {
+  micros = std::clamp<int64_t>(micros, 0, kMaxTrackableMicros);
+  if (micros < static_cast<int64_t>(kSubBucketCount)) {
+    return micros;
+  }
+  // Finds the power of two that puts |micros| in the upper half of the
+  // sub-buckets.
+  size_t exponent = 1;
+  while ((micros >> exponent) >= static_cast<int64_t>(kSubBucketCount)) {
+    exponent++;
+  }
+  size_t sub_bucket = micros >> exponent;
+  return exponent * kSubBucketHalfCount + sub_bucket;
+}
+
+int64_t FrameTimingsHistogram::BucketUpperBound(size_t index) {
+  FML_DCHECK(index < kBucketCount);
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  size_t exponent = index / kSubBucketHalfCount - 1;
+  int64_t sub_bucket = index % kSubBucketHalfCount + kSubBucketHalfCount;
+  return ((sub_bucket + 1) << exponent) - 1;
+}
+
+int64_t FrameTimingsHistogram::WindowIndex(fml::TimePoint time) const {
+  return time.ToEpochDelta() / window_;
+}
+
+void FrameTimingsHistogram::Distribution::Add(int64_t micros) {
+  micros = std::clamp<int64_t>(micros, 0, kMaxTrackableMicros);
+  counts[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+  // Only the recording thread writes the maximum.
+  if (micros > max.load(std::memory_order_relaxed)) {
+    max.store(micros, std::memory_order_relaxed);
+  }
+}
+
+void FrameTimingsHistogram::Distribution::Clear() {
+  for (auto& count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  max.store(0, std::memory_order_relaxed);
+}
+
+FrameTimingsHistogram::Percentiles
+FrameTimingsHistogram::Distribution::ComputePercentiles(
+    uint64_t frame_count) const {
+  Percentiles percentiles;
+  percentiles.max = max.load(std::memory_order_relaxed);
+  if (frame_count == 0) {
+    return percentiles;
+  }
+  // The number of frames at or below each percentile, rounded up.
+  const uint64_t ranks[] = {
+      (frame_count * 50 + 99) / 100,
+      (frame_count * 90 + 99) / 100,
+      (frame_count * 99 + 99) / 100,
+  };
+  int64_t* values[] = {&percentiles.p50, &percentiles.p90, &percentiles.p99};
+  size_t next = 0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount && next < std::size(ranks); i++) {
+    seen += counts[i].load(std::memory_order_relaxed);
+    while (next < std::size(ranks) && seen >= ranks[next]) {
+      *values[next++] = std::min(BucketUpperBound(i), percentiles.max);
+    }
+  }
+  // A frame being recorded may be counted in |frame_count| but not yet in
+  // its bucket.
+  while (next < std::size(ranks)) {
+    *values[next++] = percentiles.max;
+  }
+  return percentiles;
+}
+
+void FrameTimingsHistogram::Record(const FrameTiming& timing) {
+  fml::TimePoint raster_finish = timing.Get(FrameTiming::kRasterFinish);
+  int64_t index = WindowIndex(raster_finish);
+  Slot& slot = slots_[index & 1];
+
+  int64_t slot_index = slot.window_index.load(std::memory_order_relaxed);
+  if (slot_index > index) {
+    // The window of this frame has already been replaced.
+    return;
+  }
+  if (slot_index != index) {
+    // The slot held the window before the last one. Readers that see the
+    // slot being reset discard what they have read.
+    slot.window_index.store(kResettingWindow, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frame_count.store(0, std::memory_order_relaxed);
+    slot.build.Clear();
+    slot.raster.Clear();
+    slot.vsync_to_present.Clear();
+    slot.window_index.store(index, std::memory_order_release);
+  }
+
+  slot.frame_count.fetch_add(1, std::memory_order_relaxed);
+  slot.build.Add((timing.Get(FrameTiming::kBuildFinish) -
+                  timing.Get(FrameTiming::kBuildStart))
+                     .ToMicroseconds());
+  slot.raster.Add(
+      (raster_finish - timing.Get(FrameTiming::kRasterStart)).ToMicroseconds());
+  slot.vsync_to_present.Add(
+      (raster_finish - timing.Get(FrameTiming::kVsyncStart)).ToMicroseconds());
+}
+
+FrameTimingsHistogram::Summary FrameTimingsHistogram::GetLastCompleteWindow(
+    fml::TimePoint now) const {
+  int64_t index = WindowIndex(now) - 1;
+  const Slot& slot = slots_[index & 1];
+
+  Summary summary;
+  summary.window_start = fml::TimePoint::FromEpochDelta(window_ * index);
+  summary.window = window_;
+  if (slot.window_index.load(std::memory_order_acquire) != index) {
+    return summary;
+  }
+  uint64_t frame_count = slot.frame_count.load(std::memory_order_relaxed);
+  Percentiles build = slot.build.ComputePercentiles(frame_count);
+  Percentiles raster = slot.raster.ComputePercentiles(frame_count);
+  Percentiles vsync_to_present =
+      slot.vsync_to_present.ComputePercentiles(frame_count);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.window_index.load(std::memory_order_relaxed) != index) {
+    // The slot was reset for a new window while it was being read.
+    return summary;
+  }
+  summary.frame_count = frame_count;
+  summary.build = build;
+  summary.raster = raster;
+  summary.vsync_to_present = vsync_to_present;
+  return summary;
+}
+
+}  // namespace flutter
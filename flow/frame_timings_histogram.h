@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_TIMINGS_HISTOGRAM_H_
+#define FLUTTER_FLOW_FRAME_TIMINGS_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// Aggregates the `FrameTiming`s of the rasterized frames into latency
+/// distributions over fixed windows of time.
+///
+/// The durations are counted in log-linear buckets of microseconds, like an
+/// HDR histogram, so that any percentile is reported within about 3% of the
+/// recorded value. Frames are recorded by a single thread (the raster thread)
+/// without taking locks, and the summary of the last complete window can be
+/// read from any thread.
+class FrameTimingsHistogram {
+ public:
+  /// The default duration of a window.
+  static constexpr fml::TimeDelta kDefaultWindow =
+      fml::TimeDelta::FromSeconds(10);
+
+  /// Durations longer than this are counted as this value.
+  static constexpr int64_t kMaxTrackableMicros = (int64_t{1} << 26) - 1;
+
+  /// The percentiles of the durations recorded in a window, in microseconds.
+  struct Percentiles {
+    int64_t p50 = 0;
+    int64_t p90 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+  };
+
+  /// The distributions of the frames that were rasterized in a window.
+  struct Summary {
+    /// The start of the window. The window ends |window| later.
+    fml::TimePoint window_start;
+    fml::TimeDelta window;
+    uint64_t frame_count = 0;
+    /// From the start to the end of the frame build.
+    Percentiles build;
+    /// From the start to the end of the frame rasterization.
+    Percentiles raster;
+    /// From the vsync signal to the end of the frame rasterization, when the
+    /// frame is presented.
+    Percentiles vsync_to_present;
+  };
+
+  explicit FrameTimingsHistogram(fml::TimeDelta window = kDefaultWindow);
+
+  ~FrameTimingsHistogram();
+
+  /// Records a rasterized frame in the window of its raster finish time.
+  ///
+  /// Must always be called on the same thread, with frames in the order they
+  /// finished rasterizing.
+  void Record(const FrameTiming& timing);
+
+  /// Returns the summary of the last window that ended at or before |now|.
+  ///
+  /// The frame count of the summary is zero when no frame was rasterized in
+  /// that window. Can be called on any thread.
+  Summary GetLastCompleteWindow(fml::TimePoint now) const;
+
+  fml::TimeDelta window() const { return window_; }
+
+  /// Returns the index of the bucket that counts |micros|.
+  static size_t BucketIndex(int64_t micros);
+
+  /// Returns the largest duration counted by the bucket at |index|.
+  static int64_t BucketUpperBound(size_t index);
+
+ private:
+  // The number of linear sub-buckets of the first bucket. The other buckets
+  // each count the durations between two powers of two with half as many
+  // sub-buckets.
+  static constexpr size_t kSubBucketBits = 6;
+  static constexpr size_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr size_t kSubBucketHalfCount = kSubBucketCount / 2;
+  static constexpr size_t kBucketCount =
+      (26 - kSubBucketBits) * kSubBucketHalfCount + kSubBucketCount;
+
+  // Marks a slot whose counters are being cleared.
+  static constexpr int64_t kResettingWindow = -1;
+
+  struct Distribution {
+    std::array<std::atomic<uint32_t>, kBucketCount> counts;
+    std::atomic<int64_t> max;
+
+    void Add(int64_t micros);
+    void Clear();
+    Percentiles ComputePercentiles(uint64_t frame_count) const;
+  };
+
+  // Holds the distributions of one window. The window in progress and the
+  // last complete window alternate between the two slots.
+  struct Slot {
+    std::atomic<int64_t> window_index{kResettingWindow};
+    std::atomic<uint64_t> frame_count{0};
+    Distribution build;
+    Distribution raster;
+    Distribution vsync_to_present;
+  };
+
+  int64_t WindowIndex(fml::TimePoint time) const;
+
+  const fml::TimeDelta window_;
+  Slot slots_[2];
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingsHistogram);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FRAME_TIMINGS_HISTOGRAM_H_
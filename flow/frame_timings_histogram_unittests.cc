@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timings_histogram.h"
+
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+fml::TimePoint AtMillis(int64_t millis) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(millis));
+}
+
+// Makes the timing of a frame that was rasterized at |raster_finish| and
+// spent |build|, |raster| and |latency| in each phase.
+FrameTiming MakeTiming(fml::TimePoint raster_finish,
+                       fml::TimeDelta build,
+                       fml::TimeDelta raster,
+                       fml::TimeDelta latency) {
+  FrameTiming timing;
+  fml::TimePoint raster_start = raster_finish - raster;
+  timing.Set(FrameTiming::kVsyncStart, raster_finish - latency);
+  timing.Set(FrameTiming::kBuildStart, raster_start - build);
+  timing.Set(FrameTiming::kBuildFinish, raster_start);
+  timing.Set(FrameTiming::kRasterStart, raster_start);
+  timing.Set(FrameTiming::kRasterFinish, raster_finish);
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameTimingsHistogramTest, BucketsAreWithinThreePercentOfDurations) {
+  for (int64_t micros = 0;
+       micros <= FrameTimingsHistogram::kMaxTrackableMicros;
+       micros = micros * 5 / 4 + 1) {
+    int64_t upper_bound = FrameTimingsHistogram::BucketUpperBound(
+        FrameTimingsHistogram::BucketIndex(micros));
+    EXPECT_GE(upper_bound, micros);
+    EXPECT_LE(upper_bound - micros, micros / 32);
+  }
+  EXPECT_EQ(FrameTimingsHistogram::BucketUpperBound(
+                FrameTimingsHistogram::BucketIndex(
+                    FrameTimingsHistogram::kMaxTrackableMicros)),
+            FrameTimingsHistogram::kMaxTrackableMicros);
+}
+
+TEST(FrameTimingsHistogramTest, ReportsPercentilesOfLastCompleteWindow) {
+  FrameTimingsHistogram histogram(fml::TimeDelta::FromSeconds(1));
+
+  for (int64_t i = 1; i <= 100; i++) {
+    histogram.Record(MakeTiming(AtMillis(1000 + i),
+                                fml::TimeDelta::FromMilliseconds(i),
+                                fml::TimeDelta::FromMilliseconds(2 * i),
+                                fml::TimeDelta::FromMilliseconds(100 + i)));
+  }
+
+  // The window is still in progress.
+  EXPECT_EQ(histogram.GetLastCompleteWindow(AtMillis(1500)).frame_count, 0u);
+
+  auto summary = histogram.GetLastCompleteWindow(AtMillis(2500));
+  EXPECT_EQ(summary.window_start, AtMillis(1000));
+  EXPECT_EQ(summary.window, fml::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(summary.frame_count, 100u);
+
+  EXPECT_NEAR(summary.build.p50, 50000, 50000 / 32);
+  EXPECT_NEAR(summary.build.p90, 90000, 90000 / 32);
+  EXPECT_NEAR(summary.build.p99, 99000, 99000 / 32);
+  EXPECT_EQ(summary.build.max, 100000);
+
+  EXPECT_NEAR(summary.raster.p50, 100000, 100000 / 32);
+  EXPECT_EQ(summary.raster.max, 200000);
+
+  EXPECT_NEAR(summary.vsync_to_present.p90, 190000, 190000 / 32);
+  EXPECT_EQ(summary.vsync_to_present.max, 200000);
+
+  // Older windows are no longer kept.
+  EXPECT_EQ(histogram.GetLastCompleteWindow(AtMillis(3500)).frame_count, 0u);
+}
+
+TEST(FrameTimingsHistogramTest, NewWindowsDoNotCountOlderFrames) {
+  FrameTimingsHistogram histogram(fml::TimeDelta::FromSeconds(1));
+  auto long_frame = fml::TimeDelta::FromMilliseconds(500);
+  auto short_frame = fml::TimeDelta::FromMilliseconds(5);
+
+  histogram.Record(
+      MakeTiming(AtMillis(1100), long_frame, long_frame, long_frame));
+  histogram.Record(
+      MakeTiming(AtMillis(2100), short_frame, short_frame, short_frame));
+  // Reuses the slot of the first window.
+  histogram.Record(
+      MakeTiming(AtMillis(3100), short_frame, short_frame, short_frame));
+
+  auto summary = histogram.GetLastCompleteWindow(AtMillis(4000));
+  EXPECT_EQ(summary.frame_count, 1u);
+  EXPECT_EQ(summary.raster.max, 5000);
+  EXPECT_NEAR(summary.raster.p99, 5000, 5000 / 32);
+}
+
+}  // namespace testing
+}  // namespace flutter
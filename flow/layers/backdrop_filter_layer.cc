@@ -4,18 +4,60 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/display_list/display_list_comparable.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+#include "third_party/skia/include/gpu/GrDirectContext.h"
+
 namespace flutter {
 
+// Blurs are downsampled by powers of two up to |kMaxDownsampleFactor|, as
+// long as their sigma in the downsampled pixels stays at or above
+// |kMinDownsampledSigma|. The blur then removes the detail that is lost by
+// the downsampling, and the bilinear upsampling of the smooth result stays
+// within a few levels per channel of a blur at full resolution.
+static constexpr SkScalar kMinDownsampledSigma = 4.0f;
+static constexpr int kMaxDownsampleFactor = 8;
+
 BackdropFilterLayer::BackdropFilterLayer(sk_sp<SkImageFilter> filter,
                                          SkBlendMode blend_mode)
     : filter_(std::move(filter)), blend_mode_(blend_mode) {}
 
+BackdropFilterLayer::BackdropFilterLayer(
+    std::shared_ptr<const DlImageFilter> filter,
+    SkBlendMode blend_mode)
+    : filter_(filter ? filter->skia_object() : nullptr),
+      dl_filter_(std::move(filter)),
+      blend_mode_(blend_mode) {}
+
+int BackdropFilterLayer::DownsampleFactor(const SkVector& device_sigma) {
+  SkScalar sigma =
+      std::min(std::abs(device_sigma.fX), std::abs(device_sigma.fY));
+  int factor = 1;
+  while (factor < kMaxDownsampleFactor &&
+         sigma / (factor * 2) >= kMinDownsampledSigma) {
+    factor *= 2;
+  }
+  return factor;
+}
+
+bool BackdropFilterLayer::HasSameFilter(
+    const BackdropFilterLayer* other) const {
+  if (dl_filter_ || other->dl_filter_) {
+    return Equals(dl_filter_, other->dl_filter_);
+  }
+  return filter_ == other->filter_;
+}
+
 void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
   auto* prev = static_cast<const BackdropFilterLayer*>(old_layer);
   if (!context->IsSubtreeDirty()) {
     FML_DCHECK(prev);
-    if (filter_ != prev->filter_) {
+    if (!HasSameFilter(prev)) {
       context->MarkSubtreeDirty(context->GetOldLayerPaintRegion(old_layer));
     }
   }
@@ -24,6 +66,8 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
   auto paint_bounds = context->GetCullRect();
   context->AddLayerBounds(paint_bounds);
 
+  backdrop_was_diffed_ = true;
+  backdrop_is_unchanged_ = false;
   if (filter_) {
     context->GetTransform().mapRect(&paint_bounds);
     auto input_filter_bounds = paint_bounds.roundOut();
@@ -31,6 +75,15 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
         filter_->filterBounds(input_filter_bounds, context->GetTransform(),
                               SkImageFilter::kReverse_MapDirection);
     context->AddReadbackRegion(filter_bounds);
+
+    // The layers diffed so far are the ones painted behind this layer.
+    backdrop_is_unchanged_ = !context->IsSubtreeDirty() &&
+                             !context->IsDamaged(SkRect::Make(filter_bounds));
+  }
+  if (backdrop_is_unchanged_) {
+    blurred_backdrop_ = prev->blurred_backdrop_;
+  } else {
+    blurred_backdrop_.reset();
   }
 
   DiffChildren(context, prev);
@@ -40,6 +93,15 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
 
 void BackdropFilterLayer::Preroll(PrerollContext* context,
                                   const SkMatrix& matrix) {
+  // The blurred backdrop is only cached in frames that are diffed, as the
+  // next frame needs the diff to tell whether it can be reused.
+  reuse_blurred_backdrop_ =
+      backdrop_is_unchanged_ && blurred_backdrop_.has_value();
+  cache_blurred_backdrop_ = backdrop_was_diffed_;
+  backdrop_was_diffed_ = false;
+  backdrop_is_unchanged_ = false;
+  has_active_save_layer_ = context->has_active_save_layer;
+
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context, true, bool(filter_));
   SkRect child_paint_bounds = SkRect::MakeEmpty();
@@ -48,12 +110,132 @@ void BackdropFilterLayer::Preroll(PrerollContext* context,
   set_paint_bounds(child_paint_bounds);
 }
 
+std::optional<BackdropFilterLayer::BlurredBackdrop>
+BackdropFilterLayer::BlurBackdrop(const PaintContext& context,
+                                  bool downsampled_only) const {
+  const DlBlurImageFilter* blur = dl_filter_ ? dl_filter_->asBlur() : nullptr;
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  SkSurface* surface = canvas->getSurface();
+  // The backdrop is read from the surface, so the layer must be painted
+  // directly into it.
+  if (!blur || !surface || !context.surface_supports_readback ||
+      has_active_save_layer_ || context.leaf_nodes_builder) {
+    return std::nullopt;
+  }
+  SkMatrix matrix = canvas->getTotalMatrix();
+  if (!matrix.isScaleTranslate()) {
+    return std::nullopt;
+  }
+  SkVector device_sigma =
+      SkVector::Make(blur->sigma_x() * std::abs(matrix.getScaleX()),
+                     blur->sigma_y() * std::abs(matrix.getScaleY()));
+  int factor = DownsampleFactor(device_sigma);
+  if (downsampled_only && factor == 1) {
+    return std::nullopt;
+  }
+
+  SkIRect output_bounds = matrix.mapRect(paint_bounds()).roundOut();
+  if (!output_bounds.intersect(canvas->getDeviceClipBounds())) {
+    return std::nullopt;
+  }
+  // A blur reads the pixels up to three sigma away from its output.
+  SkIRect input_bounds = output_bounds.makeOutset(
+      static_cast<int32_t>(std::ceil(device_sigma.fX * 3)),
+      static_cast<int32_t>(std::ceil(device_sigma.fY * 3)));
+  if (!input_bounds.intersect(SkIRect::MakeSize(canvas->getBaseLayerSize()))) {
+    return std::nullopt;
+  }
+  sk_sp<SkImage> backdrop = surface->makeImageSnapshot(input_bounds);
+  if (!backdrop) {
+    return std::nullopt;
+  }
+
+  SkSamplingOptions sampling(SkFilterMode::kLinear);
+  SkRect clip = SkRect::Make(
+      output_bounds.makeOffset(-input_bounds.x(), -input_bounds.y()));
+  if (factor > 1) {
+    TRACE_EVENT0("flutter", "BackdropFilterLayer::Downsample");
+    SkMatrix downsample = SkMatrix::Scale(1.0f / factor, 1.0f / factor);
+    SkIRect downsampled_bounds =
+        downsample.mapRect(SkRect::Make(backdrop->bounds())).roundOut();
+    sk_sp<SkSurface> downsampled = surface->makeSurface(
+        backdrop->imageInfo().makeDimensions(downsampled_bounds.size()));
+    if (!downsampled) {
+      return std::nullopt;
+    }
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    downsampled->getCanvas()->drawImageRect(
+        backdrop, downsample.mapRect(SkRect::Make(backdrop->bounds())),
+        sampling, &paint);
+    backdrop = downsampled->makeImageSnapshot();
+    clip = downsample.mapRect(clip);
+  }
+
+  sk_sp<SkImageFilter> filter = SkImageFilters::Blur(
+      device_sigma.fX / factor, device_sigma.fY / factor,
+      ToSk(blur->tile_mode()), nullptr);
+  SkIRect blurred_subset;
+  SkIPoint offset;
+  sk_sp<SkImage> blurred = backdrop->makeWithFilter(
+      context.gr_context, filter.get(), backdrop->bounds(), clip.roundOut(),
+      &blurred_subset, &offset);
+  if (!blurred) {
+    return std::nullopt;
+  }
+
+  BlurredBackdrop result;
+  result.image = std::move(blurred);
+  result.src = SkRect::Make(blurred_subset);
+  result.dst = SkRect::MakeXYWH(
+      input_bounds.x() + offset.x() * factor,
+      input_bounds.y() + offset.y() * factor,
+      blurred_subset.width() * factor, blurred_subset.height() * factor);
+  result.matrix = matrix;
+  return result;
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting(context));
 
   SkPaint paint;
   paint.setBlendMode(blend_mode_);
+
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  SkRect device_bounds = canvas->getTotalMatrix().mapRect(paint_bounds());
+  device_bounds.intersect(SkRect::Make(canvas->getDeviceClipBounds()));
+  std::optional<BlurredBackdrop> backdrop;
+  if (reuse_blurred_backdrop_ &&
+      blurred_backdrop_->matrix == canvas->getTotalMatrix() &&
+      blurred_backdrop_->dst.contains(device_bounds)) {
+    backdrop = blurred_backdrop_;
+  } else {
+    blurred_backdrop_.reset();
+    backdrop = BlurBackdrop(context, !cache_blurred_backdrop_);
+    if (backdrop && cache_blurred_backdrop_) {
+      blurred_backdrop_ = backdrop;
+    }
+  }
+
+  if (backdrop) {
+    // Initializes the layer with the blurred backdrop, as the backdrop filter
+    // of a saveLayer would.
+    Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
+        context, paint_bounds(), &paint,
+        AutoSaveLayer::SaveMode::kLeafNodesCanvas);
+    SkPaint backdrop_paint;
+    backdrop_paint.setBlendMode(SkBlendMode::kSrc);
+    canvas->save();
+    canvas->resetMatrix();
+    canvas->drawImageRect(backdrop->image, backdrop->src, backdrop->dst,
+                          SkSamplingOptions(SkFilterMode::kLinear),
+                          &backdrop_paint, SkCanvas::kStrict_SrcRectConstraint);
+    canvas->restore();
+    PaintChildren(context);
+    return;
+  }
+
   Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
       context,
       SkCanvas::SaveLayerRec{&paint_bounds(), &paint, filter_.get(), 0},
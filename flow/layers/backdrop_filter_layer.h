@@ -5,7 +5,12 @@
 #ifndef FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 
+#include <memory>
+#include <optional>
+
+#include "flutter/display_list/display_list_image_filter.h"
 #include "flutter/flow/layers/container_layer.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
 
 namespace flutter {
@@ -14,16 +19,62 @@ class BackdropFilterLayer : public ContainerLayer {
  public:
   BackdropFilterLayer(sk_sp<SkImageFilter> filter, SkBlendMode blend_mode);
 
+  // Blurs of the backdrop are painted from a cache while the content behind
+  // the layer does not change, and blurs with a large sigma are computed at
+  // a lower resolution. This is only possible when the layer knows the blur
+  // of its filter.
+  BackdropFilterLayer(std::shared_ptr<const DlImageFilter> filter,
+                      SkBlendMode blend_mode);
+
   void Diff(DiffContext* context, const Layer* old_layer) override;
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  // Returns whether the last |Diff| found the content behind the layer to be
+  // the same as in the last frame.
+  bool backdrop_is_unchanged() const { return backdrop_is_unchanged_; }
+
+  // Returns the factor, as a power of two, by which the backdrop of a blur
+  // with |device_sigma| is downsampled before it is blurred.
+  static int DownsampleFactor(const SkVector& device_sigma);
+
  private:
+  // The blurred backdrop painted by the layer.
+  struct BlurredBackdrop {
+    sk_sp<SkImage> image;
+    // The part of |image| that is painted, and where it is painted in device
+    // coordinates.
+    SkRect src;
+    SkRect dst;
+    // The total matrix of the canvas that the backdrop was blurred for.
+    SkMatrix matrix;
+  };
+
+  bool HasSameFilter(const BackdropFilterLayer* other) const;
+
+  // Reads the backdrop of the layer from the surface and blurs it, or returns
+  // nullopt when the backdrop can't be blurred by the layer. When
+  // |downsampled_only| is true, only blurs that are downsampled are computed.
+  std::optional<BlurredBackdrop> BlurBackdrop(const PaintContext& context,
+                                              bool downsampled_only) const;
+
   sk_sp<SkImageFilter> filter_;
+  std::shared_ptr<const DlImageFilter> dl_filter_;
   SkBlendMode blend_mode_;
 
+  // Set by |Diff| and consumed by |Preroll|, as a frame may not be diffed.
+  bool backdrop_was_diffed_ = false;
+  bool backdrop_is_unchanged_ = false;
+
+  // Whether the blurred backdrop is painted from |blurred_backdrop_|, or
+  // stored there for the next frame.
+  bool reuse_blurred_backdrop_ = false;
+  bool cache_blurred_backdrop_ = false;
+  bool has_active_save_layer_ = false;
+  mutable std::optional<BlurredBackdrop> blurred_backdrop_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(BackdropFilterLayer);
 };
 
@@ -275,6 +275,31 @@ TEST_F(BackdropFilterLayerTest, Readback) {
   EXPECT_FALSE(preroll_context()->surface_needs_readback);
 }
 
+TEST_F(BackdropFilterLayerTest, ActiveSaveLayerIsRestoredAfterPreroll) {
+  auto layer = std::make_shared<BackdropFilterLayer>(
+      std::make_shared<DlBlurImageFilter>(5, 5, DlTileMode::kClamp),
+      SkBlendMode::kSrcOver);
+  auto mock_layer = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeWH(10, 10)), SkPaint());
+  layer->Add(mock_layer);
+
+  EXPECT_FALSE(preroll_context()->has_active_save_layer);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_FALSE(preroll_context()->has_active_save_layer);
+}
+
+TEST_F(BackdropFilterLayerTest, DownsampleFactorKeepsSigmaAboveMinimum) {
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({0, 0}), 1);
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({7.9f, 7.9f}), 1);
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({8, 8}), 2);
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({16, 20}), 4);
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({-16, 20}), 4);
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({100, 100}), 8);
+  // Blurs along one axis are not downsampled, as it would lose the detail
+  // along the other.
+  EXPECT_EQ(BackdropFilterLayer::DownsampleFactor({100, 0}), 1);
+}
+
 using BackdropLayerDiffTest = DiffContextTest;
 
 TEST_F(BackdropLayerDiffTest, BackdropLayer) {
@@ -357,5 +382,55 @@ TEST_F(BackdropLayerDiffTest, BackdropLayerInvalidTransform) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeWH(15, 15));
 }
 
+TEST_F(BackdropLayerDiffTest, BackdropIsUnchangedWithoutDamageBehindIt) {
+  auto behind = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(0, 0, 50, 50)));
+  auto clip_rect = SkRect::MakeLTRB(20, 20, 60, 60);
+
+  MockLayerTree l1(SkISize::Make(100, 100));
+  l1.root()->Add(behind);
+  auto clip1 = std::make_shared<ClipRectLayer>(clip_rect, Clip::hardEdge);
+  auto backdrop1 = std::make_shared<BackdropFilterLayer>(
+      std::make_shared<DlBlurImageFilter>(5, 5, DlTileMode::kClamp),
+      SkBlendMode::kSrcOver);
+  clip1->Add(backdrop1);
+  l1.root()->Add(clip1);
+  DiffLayerTree(l1, MockLayerTree(SkISize::Make(100, 100)));
+  EXPECT_FALSE(backdrop1->backdrop_is_unchanged());
+
+  // New layers with an equal filter over the same content.
+  MockLayerTree l2(SkISize::Make(100, 100));
+  l2.root()->Add(behind);
+  auto clip2 = std::make_shared<ClipRectLayer>(clip_rect, Clip::hardEdge);
+  clip2->AssignOldLayer(clip1.get());
+  auto backdrop2 = std::make_shared<BackdropFilterLayer>(
+      std::make_shared<DlBlurImageFilter>(5, 5, DlTileMode::kClamp),
+      SkBlendMode::kSrcOver);
+  backdrop2->AssignOldLayer(backdrop1.get());
+  clip2->Add(backdrop2);
+  l2.root()->Add(clip2);
+  auto damage = DiffLayerTree(l2, l1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+  EXPECT_TRUE(backdrop2->backdrop_is_unchanged());
+
+  // Content that changed outside of the readback region.
+  MockLayerTree l3(SkISize::Make(100, 100));
+  l3.root()->Add(behind);
+  l3.root()->Add(std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(90, 90, 95, 95))));
+  l3.root()->Add(clip2);
+  DiffLayerTree(l3, l2);
+  EXPECT_TRUE(backdrop2->backdrop_is_unchanged());
+
+  // Content that changed inside of the readback region.
+  MockLayerTree l4(SkISize::Make(100, 100));
+  l4.root()->Add(behind);
+  l4.root()->Add(std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(60, 60, 65, 65))));
+  l4.root()->Add(clip2);
+  DiffLayerTree(l4, l3);
+  EXPECT_FALSE(backdrop2->backdrop_is_unchanged());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,17 +4,43 @@
 
 #include "flutter/flow/layers/color_filter_layer.h"
 
+#include <functional>
+#include <string_view>
+
+#include "third_party/skia/include/core/SkData.h"
+
 namespace flutter {
 
+static sk_sp<SkData> SerializeFilter(const sk_sp<SkColorFilter>& filter) {
+  return filter ? filter->serialize() : nullptr;
+}
+
+static uint64_t ComputeFilterContentId(const sk_sp<SkData>& data) {
+  if (!data) {
+    return 0;
+  }
+  std::string_view bytes(static_cast<const char*>(data->data()),
+                         data->size());
+  uint64_t id = std::hash<std::string_view>{}(bytes);
+  // Zero means that the filter cannot be identified.
+  return id == 0 ? 1 : id;
+}
+
 ColorFilterLayer::ColorFilterLayer(sk_sp<SkColorFilter> filter)
-    : filter_(std::move(filter)), render_count_(1) {}
+    : filter_(std::move(filter)),
+      filter_data_(SerializeFilter(filter_)),
+      filter_content_id_(ComputeFilterContentId(filter_data_)) {}
 
 void ColorFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
   auto* prev = static_cast<const ColorFilterLayer*>(old_layer);
   if (!context->IsSubtreeDirty()) {
     FML_DCHECK(prev);
-    if (filter_ != prev->filter_) {
+    bool same_filter = filter_ == prev->filter_ ||
+                       (filter_content_id_ != 0 &&
+                        filter_content_id_ == prev->filter_content_id_ &&
+                        filter_data_->equals(prev->filter_data_.get()));
+    if (!same_filter) {
       context->MarkSubtreeDirty(context->GetOldLayerPaintRegion(old_layer));
     }
   }
@@ -34,11 +60,16 @@ void ColorFilterLayer::Preroll(PrerollContext* context,
   // can always apply opacity in those cases.
   context->subtree_can_inherit_opacity = true;
 
-  if (render_count_ >= kMinimumRendersBeforeCachingFilterLayer) {
-    TryToPrepareRasterCache(context, this, matrix,
-                            RasterCacheLayerStrategy::kLayer);
-  } else {
-    render_count_++;
+  // The filtered children are cached by the contents of the children and of
+  // the filter, so that a layer rebuilt in each frame with a static filter,
+  // such as one under an animated opacity, is drawn from a single image.
+  // Until the filtered children have been drawn for a few frames, only the
+  // children are cached, and they are drawn with the filter.
+  TryToPrepareRasterCache(context, this, matrix,
+                          RasterCacheLayerStrategy::kFilteredChildren);
+  if (!context->raster_cache ||
+      !context->raster_cache->HasImage(
+          this, matrix, RasterCacheLayerStrategy::kFilteredChildren)) {
     TryToPrepareRasterCache(context, this, matrix,
                             RasterCacheLayerStrategy::kLayerChildren);
   }
@@ -51,8 +82,9 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   AutoCachePaint cache_paint(context);
 
   if (context.raster_cache) {
+    // The inherited opacity is folded into the draw of the filtered image.
     if (context.raster_cache->Draw(this, *context.leaf_nodes_canvas,
-                                   RasterCacheLayerStrategy::kLayer,
+                                   RasterCacheLayerStrategy::kFilteredChildren,
                                    cache_paint.paint())) {
       return;
     }
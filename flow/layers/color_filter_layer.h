@@ -7,6 +7,7 @@
 
 #include "flutter/flow/layers/container_layer.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
+#include "third_party/skia/include/core/SkData.h"
 
 namespace flutter {
 
@@ -20,11 +21,15 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  uint64_t filter_content_id() const override { return filter_content_id_; }
+
+  SkData* filter_data() const override { return filter_data_.get(); }
+
  private:
   sk_sp<SkColorFilter> filter_;
-
-  static constexpr int kMinimumRendersBeforeCachingFilterLayer = 3;
-  int render_count_;
+  // The serialized filter, and a hash of it.
+  sk_sp<SkData> filter_data_;
+  uint64_t filter_content_id_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ColorFilterLayer);
 };
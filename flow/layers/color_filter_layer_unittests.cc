@@ -4,7 +4,9 @@
 
 #include "flutter/flow/layers/color_filter_layer.h"
 
+#include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_color_filter.h"
+#include "flutter/flow/layers/display_list_layer.h"
 #include "flutter/flow/layers/opacity_layer.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
@@ -254,7 +256,12 @@ TEST_F(ColorFilterLayerTest, CacheChild) {
 
   layer->Preroll(preroll_context(), initial_transform);
 
-  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)1);
+  // The filtered children are not cached in the first frame, but their
+  // access is counted in an entry.
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)2);
+  EXPECT_FALSE(
+      raster_cache()->Draw(layer.get(), cache_canvas,
+                           RasterCacheLayerStrategy::kFilteredChildren));
   EXPECT_FALSE(raster_cache()->Draw(mock_layer.get(), other_canvas));
   EXPECT_FALSE(raster_cache()->Draw(mock_layer.get(), cache_canvas));
   EXPECT_FALSE(raster_cache()->Draw(layer.get(), other_canvas,
@@ -304,7 +311,12 @@ TEST_F(ColorFilterLayerTest, CacheChildren) {
 
   layer->Preroll(preroll_context(), initial_transform);
 
-  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)1);
+  // The filtered children are not cached in the first frame, but their
+  // access is counted in an entry.
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)2);
+  EXPECT_FALSE(
+      raster_cache()->Draw(layer.get(), cache_canvas,
+                           RasterCacheLayerStrategy::kFilteredChildren));
   EXPECT_FALSE(raster_cache()->Draw(mock_layer1.get(), other_canvas));
   EXPECT_FALSE(raster_cache()->Draw(mock_layer1.get(), cache_canvas));
   EXPECT_FALSE(raster_cache()->Draw(mock_layer2.get(), other_canvas));
@@ -319,6 +331,86 @@ TEST_F(ColorFilterLayerTest, CacheChildren) {
                                    RasterCacheLayerStrategy::kLayerChildren));
 }
 
+TEST_F(ColorFilterLayerTest, CacheFilteredChildrenOfRebuiltLayers) {
+  auto initial_transform = SkMatrix::Translate(50.0, 25.5);
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+
+  SkCanvas cache_canvas;
+  cache_canvas.setMatrix(initial_transform);
+
+  use_mock_raster_cache();
+
+  // Each frame rebuilds the layer with an equal filter over the same child.
+  std::shared_ptr<ColorFilterLayer> layer;
+  for (int i = 0; i < raster_cache()->access_threshold(); i++) {
+    if (layer) {
+      EXPECT_FALSE(raster_cache()->HasImage(
+          layer.get(), initial_transform,
+          RasterCacheLayerStrategy::kFilteredChildren));
+    }
+    layer = std::make_shared<ColorFilterLayer>(
+        SkColorMatrixFilter::MakeLightingFilter(SK_ColorGREEN,
+                                                SK_ColorYELLOW));
+    layer->Add(mock_layer);
+    layer->Preroll(preroll_context(), initial_transform);
+  }
+
+  EXPECT_TRUE(raster_cache()->HasImage(
+      layer.get(), initial_transform,
+      RasterCacheLayerStrategy::kFilteredChildren));
+  EXPECT_TRUE(
+      raster_cache()->Draw(layer.get(), cache_canvas,
+                           RasterCacheLayerStrategy::kFilteredChildren));
+
+  // A layer with another filter does not share the image.
+  auto other_layer = std::make_shared<ColorFilterLayer>(
+      SkColorMatrixFilter::MakeLightingFilter(SK_ColorRED, SK_ColorYELLOW));
+  other_layer->Add(mock_layer);
+  EXPECT_FALSE(
+      raster_cache()->Draw(other_layer.get(), cache_canvas,
+                           RasterCacheLayerStrategy::kFilteredChildren));
+}
+
+TEST_F(ColorFilterLayerTest, CacheFilteredChildrenOfRebuiltChildren) {
+  auto initial_transform = SkMatrix::Translate(50.0, 25.5);
+  auto make_layer = [](const SkRect& child_rect) {
+    DisplayListBuilder builder;
+    builder.drawRect(child_rect);
+    auto layer = std::make_shared<ColorFilterLayer>(
+        SkColorMatrixFilter::MakeLightingFilter(SK_ColorGREEN,
+                                                SK_ColorYELLOW));
+    layer->Add(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(1.0f, 2.0f),
+        SkiaGPUObject<DisplayList>(builder.Build(), nullptr), false, false));
+    return layer;
+  };
+
+  use_mock_raster_cache();
+
+  // Each frame rebuilds the layer and its child with equal contents.
+  std::shared_ptr<ColorFilterLayer> layer;
+  for (int i = 0; i < raster_cache()->access_threshold(); i++) {
+    if (layer) {
+      EXPECT_FALSE(raster_cache()->HasImage(
+          layer.get(), initial_transform,
+          RasterCacheLayerStrategy::kFilteredChildren));
+    }
+    layer = make_layer(SkRect::MakeWH(5.0f, 5.0f));
+    layer->Preroll(preroll_context(), initial_transform);
+  }
+
+  EXPECT_TRUE(raster_cache()->HasImage(
+      layer.get(), initial_transform,
+      RasterCacheLayerStrategy::kFilteredChildren));
+
+  // A child with other contents does not share the image.
+  auto other_layer = make_layer(SkRect::MakeWH(6.0f, 6.0f));
+  EXPECT_FALSE(raster_cache()->HasImage(
+      other_layer.get(), initial_transform,
+      RasterCacheLayerStrategy::kFilteredChildren));
+}
+
 TEST_F(ColorFilterLayerTest, OpacityInheritance) {
   // clang-format off
   float matrix[20] = {
@@ -4,10 +4,58 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <optional>
 
 namespace flutter {
 
+namespace {
+
+// Hands out chunks of children to the calling thread and to worker tasks.
+// Workers may start after all of the chunks have been claimed and even after
+// the preroll has finished, so they hold a reference to this state and only
+// run the chunks that they claim.
+class ParallelPrerollJob {
+ public:
+  ParallelPrerollJob(size_t chunk_count,
+                     std::function<void(size_t)> preroll_chunk)
+      : chunk_count_(chunk_count), preroll_chunk_(std::move(preroll_chunk)) {}
+
+  // Prerolls chunks until none are left to claim.
+  void PrerollChunks() {
+    size_t index;
+    while ((index = next_chunk_.fetch_add(1)) < chunk_count_) {
+      preroll_chunk_(index);
+      std::scoped_lock lock(mutex_);
+      if (++chunks_done_ == chunk_count_) {
+        done_.notify_all();
+      }
+    }
+  }
+
+  void WaitForAllChunks() {
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return chunks_done_ == chunk_count_; });
+  }
+
+ private:
+  const size_t chunk_count_;
+  const std::function<void(size_t)> preroll_chunk_;
+  std::atomic<size_t> next_chunk_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable done_;
+  size_t chunks_done_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParallelPrerollJob);
+};
+
+}  // namespace
+
 ContainerLayer::ContainerLayer() : child_paint_bounds_(SkRect::MakeEmpty()) {}
 
 void ContainerLayer::Diff(DiffContext* context, const Layer* old_layer) {
@@ -86,6 +134,7 @@ void ContainerLayer::DiffChildren(DiffContext* context,
         // subtree. Layers that do readback must be able to register readback
         // inside Diff
         context->AddExistingPaintRegion(paint_region);
+        context->statistics().AddReusedSubtree();
 
         // While we don't need to diff retained layers, we still need to
         // associate their paint region with current layer tree so that we can
@@ -136,18 +185,40 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   FML_DCHECK(!context->has_platform_view);
   bool child_has_platform_view = false;
   bool child_has_texture_layer = false;
+  bool child_has_volatile_layer = false;
   bool subtree_can_inherit_opacity = context->subtree_can_inherit_opacity;
 
-  for (auto& layer : layers_) {
-    // Reset context->has_platform_view to false so that layers aren't treated
-    // as if they have a platform view based on one being previously found in a
-    // sibling tree.
-    context->has_platform_view = false;
-    // Initialize the "inherit opacity" flag to false and allow the layer to
-    // override the answer during its |Preroll|
-    context->subtree_can_inherit_opacity = false;
+  std::vector<ChildPrerollResult> parallel_results;
+  if (context->preroll_task_runner &&
+      layers_.size() >= kMinParallelPrerollChildren) {
+    parallel_results.resize(layers_.size());
+    if (PrerollChildrenInParallel(context, child_matrix, parallel_results)) {
+      context->surface_needs_readback = true;
+    }
+  }
+
+  for (size_t i = 0; i < layers_.size(); i++) {
+    auto& layer = layers_[i];
+    if (parallel_results.empty()) {
+      // Reset context->has_platform_view to false so that layers aren't
+      // treated as if they have a platform view based on one being previously
+      // found in a sibling tree.
+      context->has_platform_view = false;
+      // Initialize the "inherit opacity" flag to false and allow the layer to
+      // override the answer during its |Preroll|
+      context->subtree_can_inherit_opacity = false;
 
-    layer->Preroll(context, child_matrix);
+      layer->PrerollOrReuse(context, child_matrix);
+    } else {
+      // Merge the results in order, as if the child had just been prerolled.
+      const ChildPrerollResult& result = parallel_results[i];
+      context->has_platform_view = result.has_platform_view;
+      context->has_texture_layer =
+          context->has_texture_layer || result.has_texture_layer;
+      context->has_volatile_layer =
+          context->has_volatile_layer || result.has_volatile_layer;
+      context->subtree_can_inherit_opacity = result.subtree_can_inherit_opacity;
+    }
 
     subtree_can_inherit_opacity =
         subtree_can_inherit_opacity && context->subtree_can_inherit_opacity;
@@ -164,15 +235,97 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
         child_has_platform_view || context->has_platform_view;
     child_has_texture_layer =
         child_has_texture_layer || context->has_texture_layer;
+    child_has_volatile_layer =
+        child_has_volatile_layer || context->has_volatile_layer;
   }
 
   context->has_platform_view = child_has_platform_view;
   context->has_texture_layer = child_has_texture_layer;
+  context->has_volatile_layer = child_has_volatile_layer;
   context->subtree_can_inherit_opacity = subtree_can_inherit_opacity;
   set_subtree_has_platform_view(child_has_platform_view);
   child_paint_bounds_ = *child_paint_bounds;
 }
 
+bool ContainerLayer::PrerollChildrenInParallel(
+    PrerollContext* context,
+    const SkMatrix& child_matrix,
+    std::vector<ChildPrerollResult>& results) {
+  TRACE_EVENT0("flutter", "ContainerLayer::PrerollChildrenInParallel");
+  size_t chunk_count = (layers_.size() + kParallelPrerollChunkSize - 1) /
+                       kParallelPrerollChunkSize;
+  // Not a std::vector<bool>, whose elements can't be written concurrently.
+  std::vector<char> chunk_needs_readback(chunk_count, false);
+  std::vector<char> chunk_has_pending_entries(chunk_count, false);
+  // The keys of the raster cache entries that each chunk prepared, which
+  // are added to the keys of the context in order once all are done.
+  std::vector<std::vector<RasterCacheKey>> chunk_raster_cache_keys(
+      context->raster_cache_keys ? chunk_count : 0);
+
+  auto job = std::make_shared<ParallelPrerollJob>(
+      chunk_count, [&, this](size_t chunk) {
+        // Each chunk gets its own copy of the state that layers change and
+        // restore while they preroll their children.
+        MutatorsStack mutators_stack = context->mutators_stack;
+        PrerollContext chunk_context = {
+            .raster_cache = context->raster_cache,
+            .gr_context = context->gr_context,
+            .view_embedder = context->view_embedder,
+            .mutators_stack = mutators_stack,
+            .dst_color_space = context->dst_color_space,
+            .cull_rect = context->cull_rect,
+            .surface_needs_readback = false,
+            .raster_time = context->raster_time,
+            .ui_time = context->ui_time,
+            .texture_registry = context->texture_registry,
+            .checkerboard_offscreen_layers =
+                context->checkerboard_offscreen_layers,
+            .frame_device_pixel_ratio = context->frame_device_pixel_ratio,
+            .has_texture_layer = context->has_texture_layer,
+            .has_volatile_layer = context->has_volatile_layer,
+            .reuse_retained_subtrees = context->reuse_retained_subtrees,
+            .raster_cache_keys = context->raster_cache_keys
+                                     ? &chunk_raster_cache_keys[chunk]
+                                     : nullptr,
+            .has_active_save_layer = context->has_active_save_layer,
+        };
+        size_t end = std::min(layers_.size(),
+                              (chunk + 1) * kParallelPrerollChunkSize);
+        for (size_t i = chunk * kParallelPrerollChunkSize; i < end; i++) {
+          chunk_context.has_platform_view = false;
+          chunk_context.subtree_can_inherit_opacity = false;
+          layers_[i]->PrerollOrReuse(&chunk_context, child_matrix);
+          results[i] = {
+              .has_platform_view = chunk_context.has_platform_view,
+              .has_texture_layer = chunk_context.has_texture_layer,
+              .has_volatile_layer = chunk_context.has_volatile_layer,
+              .subtree_can_inherit_opacity =
+                  chunk_context.subtree_can_inherit_opacity,
+          };
+        }
+        chunk_needs_readback[chunk] = chunk_context.surface_needs_readback;
+        chunk_has_pending_entries[chunk] =
+            chunk_context.raster_cache_entries_pending;
+      });
+  for (size_t i = 1; i < chunk_count; i++) {
+    context->preroll_task_runner->PostTask([job]() { job->PrerollChunks(); });
+  }
+  job->PrerollChunks();
+  job->WaitForAllChunks();
+
+  for (size_t i = 0; i < chunk_count; i++) {
+    context->raster_cache_entries_pending =
+        context->raster_cache_entries_pending || chunk_has_pending_entries[i];
+  }
+  for (auto& keys : chunk_raster_cache_keys) {
+    context->raster_cache_keys->insert(context->raster_cache_keys->end(),
+                                       keys.begin(), keys.end());
+  }
+
+  return std::any_of(chunk_needs_readback.begin(), chunk_needs_readback.end(),
+                     [](char needs_readback) { return needs_readback; });
+}
+
 void ContainerLayer::PaintChildren(PaintContext& context) const {
   // We can no longer call FML_DCHECK here on the needs_painting(context)
   // condition as that test is only valid for the PaintContext that
@@ -184,7 +337,7 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
     if (layer->needs_painting(context)) {
-      layer->Paint(context);
+      layer->PaintOrReplay(context);
     }
   }
 }
@@ -200,7 +353,7 @@ void ContainerLayer::TryToPrepareRasterCache(
     context->raster_cache->Prepare(context, layer, matrix, strategy);
   } else if (context->raster_cache) {
     // Don't evict raster cache entry during partial repaint
-    context->raster_cache->Touch(layer, matrix, strategy);
+    context->raster_cache->Touch(context, layer, matrix, strategy);
   }
 }
 
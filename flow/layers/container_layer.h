@@ -32,7 +32,28 @@ class ContainerLayer : public Layer {
 
   const SkRect& child_paint_bounds() const { return child_paint_bounds_; }
 
+  // Identifies the contents of the filter that this layer applies to its
+  // children, so that the children drawn with an equal filter by another
+  // layer share the same cached rendering. Zero if the layer does not apply
+  // a filter, or its filter cannot be identified by its contents.
+  virtual uint64_t filter_content_id() const { return 0; }
+
+  // The serialized filter that |filter_content_id| was computed from, which
+  // confirms that equal ids are for equal filters. Null if the id is zero.
+  virtual SkData* filter_data() const { return nullptr; }
+
+  // The number of children prerolled by each task in a parallel preroll.
+  static constexpr size_t kParallelPrerollChunkSize = 32;
+  static constexpr size_t kMinParallelPrerollChildren =
+      2 * kParallelPrerollChunkSize;
+
  protected:
+  // Prerolls the children and merges what they report through the context.
+  //
+  // If the context has a |preroll_task_runner| and there are at least
+  // |kMinParallelPrerollChildren| children, chunks of the children are
+  // prerolled in parallel on its workers and on the calling thread. Their
+  // own children are then prerolled serially.
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
@@ -53,6 +74,20 @@ class ContainerLayer : public Layer {
                                       RasterCacheLayerStrategy strategy);
 
  private:
+  // What a child reported through the context in its Preroll.
+  struct ChildPrerollResult {
+    bool has_platform_view = false;
+    bool has_texture_layer = false;
+    bool has_volatile_layer = false;
+    bool subtree_can_inherit_opacity = false;
+  };
+
+  // Prerolls the children into |results| in parallel, and returns whether
+  // any of them needs to read back from the surface.
+  bool PrerollChildrenInParallel(PrerollContext* context,
+                                 const SkMatrix& child_matrix,
+                                 std::vector<ChildPrerollResult>& results);
+
   std::vector<std::shared_ptr<Layer>> layers_;
   SkRect child_paint_bounds_;
 
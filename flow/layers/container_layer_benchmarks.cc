@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/container_layer.h"
+
+#include <memory>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/texture.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
+
+namespace flutter {
+namespace {
+
+// The number of leaf layers under each transform layer of the synthetic
+// layer trees.
+constexpr int kLeavesPerTransform = 8;
+
+// Builds a layer tree of about |layer_count| layers: a root container
+// with a row of transform layers, each of which holds a small subtree of
+// leaf layers.
+std::shared_ptr<ContainerLayer> MakeWideLayerTree(int layer_count) {
+  auto root = std::make_shared<ContainerLayer>();
+  int transform_count = layer_count / (kLeavesPerTransform + 1);
+  for (int i = 0; i < transform_count; i++) {
+    auto transform = std::make_shared<TransformLayer>(
+        SkMatrix::Translate((i % 100) * 20.0f, (i / 100) * 20.0f));
+    for (int j = 0; j < kLeavesPerTransform; j++) {
+      auto path = SkPath().addRect(SkRect::MakeXYWH(j * 2, j * 2, 10, 10));
+      transform->Add(testing::MockLayer::Make(path));
+    }
+    root->Add(transform);
+  }
+  return root;
+}
+
+void BM_PrerollWideLayerTree(benchmark::State& state, bool parallel) {
+  auto root = MakeWideLayerTree(static_cast<int>(state.range(0)));
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  if (parallel) {
+    loop = fml::ConcurrentMessageLoop::Create();
+  }
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner =
+      loop ? loop->GetTaskRunner() : nullptr;
+
+  MutatorsStack mutators_stack;
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  TextureRegistry texture_registry;
+
+  while (state.KeepRunning()) {
+    PrerollContext context = {
+        // clang-format off
+        .raster_cache                  = nullptr,
+        .gr_context                    = nullptr,
+        .view_embedder                 = nullptr,
+        .mutators_stack                = mutators_stack,
+        .dst_color_space               = nullptr,
+        .cull_rect                     = kGiantRect,
+        .surface_needs_readback        = false,
+        .raster_time                   = raster_time,
+        .ui_time                       = ui_time,
+        .texture_registry              = texture_registry,
+        .checkerboard_offscreen_layers = false,
+        .frame_device_pixel_ratio      = 1.0f,
+        .preroll_task_runner           = task_runner.get(),
+        // clang-format on
+    };
+    root->Preroll(&context, SkMatrix::I());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_PrerollWideLayerTree, Serial, false)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_PrerollWideLayerTree, Parallel, true)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -4,11 +4,17 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/performance_overlay_layer.h"
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
 
 namespace flutter {
 namespace testing {
@@ -247,6 +253,304 @@ TEST_F(ContainerLayerTest, OpacityInheritance) {
   EXPECT_FALSE(context->subtree_can_inherit_opacity);
 }
 
+TEST_F(ContainerLayerTest, ParallelPrerollMatchesSerialPreroll) {
+  const size_t child_count = 4 * ContainerLayer::kParallelPrerollChunkSize;
+  SkMatrix initial_transform = SkMatrix::Translate(-0.5f, -0.5f);
+
+  auto layer = std::make_shared<ContainerLayer>();
+  std::vector<std::shared_ptr<MockLayer>> mock_layers;
+  SkRect expected_bounds = SkRect::MakeEmpty();
+  for (size_t i = 0; i < child_count; i++) {
+    auto path = SkPath().addRect(SkRect::MakeXYWH(i * 10.0f, 0, 5, 5));
+    auto mock_layer = MockLayer::MakeOpacityCompatible(path);
+    layer->Add(mock_layer);
+    mock_layers.push_back(mock_layer);
+    expected_bounds.join(path.getBounds());
+  }
+
+  PrerollContext* context = preroll_context();
+  context->subtree_can_inherit_opacity = true;
+  layer->Preroll(context, initial_transform);
+  EXPECT_FALSE(context->has_platform_view);
+  EXPECT_TRUE(context->subtree_can_inherit_opacity);
+  EXPECT_EQ(layer->paint_bounds(), expected_bounds);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  context->preroll_task_runner = loop->GetTaskRunner().get();
+  for (auto& mock_layer : mock_layers) {
+    mock_layer->set_paint_bounds(SkRect::MakeEmpty());
+  }
+  layer->set_paint_bounds(SkRect::MakeEmpty());
+  context->subtree_can_inherit_opacity = true;
+  layer->Preroll(context, initial_transform);
+  context->preroll_task_runner = nullptr;
+
+  EXPECT_FALSE(context->has_platform_view);
+  EXPECT_TRUE(context->subtree_can_inherit_opacity);
+  EXPECT_EQ(layer->paint_bounds(), expected_bounds);
+  EXPECT_EQ(layer->child_paint_bounds(), expected_bounds);
+  for (auto& mock_layer : mock_layers) {
+    EXPECT_EQ(mock_layer->parent_matrix(), initial_transform);
+    EXPECT_EQ(mock_layer->parent_cull_rect(), kGiantRect);
+    EXPECT_FALSE(mock_layer->paint_bounds().isEmpty());
+  }
+}
+
+TEST_F(ContainerLayerTest, ParallelPrerollKeepsActiveSaveLayer) {
+  const size_t child_count = 4 * ContainerLayer::kParallelPrerollChunkSize;
+  auto layer = std::make_shared<ContainerLayer>();
+  std::vector<std::shared_ptr<MockLayer>> mock_layers;
+  for (size_t i = 0; i < child_count; i++) {
+    if (i % ContainerLayer::kParallelPrerollChunkSize == 0) {
+      // The backdrop layers must know that they are painted into the
+      // saveLayer of the opacity layer rather than into the surface.
+      layer->Add(std::make_shared<BackdropFilterLayer>(
+          SkImageFilters::Blur(5, 5, SkTileMode::kClamp),
+          SkBlendMode::kSrcOver));
+    }
+    auto path = SkPath().addRect(SkRect::MakeXYWH(i * 10.0f, 0, 5, 5));
+    auto mock_layer = MockLayer::Make(path);
+    layer->Add(mock_layer);
+    mock_layers.push_back(mock_layer);
+  }
+  auto opacity_layer =
+      std::make_shared<OpacityLayer>(SK_AlphaOPAQUE / 2, SkPoint::Make(0, 0));
+  opacity_layer->Add(layer);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  PrerollContext* context = preroll_context();
+  context->preroll_task_runner = loop->GetTaskRunner().get();
+  opacity_layer->Preroll(context, SkMatrix::I());
+  context->preroll_task_runner = nullptr;
+
+  EXPECT_FALSE(context->has_active_save_layer);
+  for (auto& mock_layer : mock_layers) {
+    EXPECT_TRUE(mock_layer->parent_has_active_save_layer());
+  }
+}
+
+TEST_F(ContainerLayerTest, RetainedChildReusesPrerollWithSameMatrix) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkMatrix initial_transform = SkMatrix::Translate(-0.5f, -0.5f);
+  SkMatrix other_transform = SkMatrix::Translate(1.0f, 1.0f);
+  SkRect cull_rect1 = SkRect::MakeLTRB(0, 0, 50, 50);
+  SkRect cull_rect2 = SkRect::MakeLTRB(0, 0, 40, 40);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  preroll_context()->reuse_retained_subtrees = true;
+  preroll_context()->cull_rect = cull_rect1;
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect1);
+
+  // The retained subtree is not visited again for a different cull rect.
+  preroll_context()->cull_rect = cull_rect2;
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect1);
+  EXPECT_EQ(retained_layer->paint_bounds(), child_path.getBounds());
+  EXPECT_EQ(layer->paint_bounds(), child_path.getBounds());
+
+  layer->Preroll(preroll_context(), other_transform);
+  EXPECT_EQ(mock_layer->parent_matrix(), other_transform);
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect2);
+}
+
+TEST_F(ContainerLayerTest, RetainedChildIsPrerolledAgainInANewSaveLayer) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  preroll_context()->reuse_retained_subtrees = true;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_FALSE(mock_layer->parent_has_active_save_layer());
+
+  preroll_context()->has_active_save_layer = true;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_TRUE(mock_layer->parent_has_active_save_layer());
+}
+
+TEST_F(ContainerLayerTest, RetainedChildWithPlatformViewIsAlwaysPrerolled) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkRect cull_rect1 = SkRect::MakeLTRB(0, 0, 50, 50);
+  SkRect cull_rect2 = SkRect::MakeLTRB(0, 0, 40, 40);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path, SkPaint(), true);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  preroll_context()->reuse_retained_subtrees = true;
+  preroll_context()->cull_rect = cull_rect1;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect1);
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+
+  preroll_context()->has_platform_view = false;
+  preroll_context()->cull_rect = cull_rect2;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect2);
+  EXPECT_TRUE(preroll_context()->has_platform_view);
+}
+
+TEST_F(ContainerLayerTest, RetainedChildWithPerformanceOverlayIsPrerolled) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkRect cull_rect1 = SkRect::MakeLTRB(0, 0, 50, 50);
+  SkRect cull_rect2 = SkRect::MakeLTRB(0, 0, 40, 40);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  retained_layer->Add(std::make_shared<PerformanceOverlayLayer>(
+      kDisplayRasterizerStatistics));
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  preroll_context()->reuse_retained_subtrees = true;
+  preroll_context()->cull_rect = cull_rect1;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect1);
+  EXPECT_TRUE(preroll_context()->has_volatile_layer);
+
+  // The overlay paints new timings in every frame, so its subtree is
+  // prerolled and painted again.
+  preroll_context()->has_volatile_layer = false;
+  preroll_context()->cull_rect = cull_rect2;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(mock_layer->parent_cull_rect(), cull_rect2);
+  EXPECT_TRUE(preroll_context()->has_volatile_layer);
+}
+
+TEST_F(ContainerLayerTest, RetainedChildIsPrerolledUntilItsEntriesAreCached) {
+  DisplayListBuilder builder;
+  builder.drawRect(SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f));
+  sk_sp<DisplayList> display_list = builder.Build();
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(std::make_shared<DisplayListLayer>(
+      SkPoint::Make(0, 0), SkiaGPUObject<DisplayList>(display_list, nullptr),
+      true, false));
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  use_mock_raster_cache();
+  preroll_context()->reuse_retained_subtrees = true;
+  // The display list is cached once it has been drawn in a few frames,
+  // which requires it to be prepared again after that.
+  for (int i = 0; i <= raster_cache()->access_threshold(); i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    EXPECT_EQ(preroll_context()->raster_cache_entries_pending,
+              i < raster_cache()->access_threshold());
+    preroll_context()->raster_cache_entries_pending = false;
+    layer->Paint(paint_context());
+    raster_cache()->CleanupAfterFrame();
+  }
+  EXPECT_TRUE(raster_cache()->Draw(*display_list, mock_canvas()));
+
+  // Once the subtree is reused, its entry is kept in the cache without
+  // being prepared or drawn.
+  for (size_t i = 0; i <= raster_cache()->max_idle_frames() + 1; i++) {
+    preroll_context()->cull_rect = SkRect::MakeEmpty();
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    raster_cache()->CleanupAfterFrame();
+  }
+  EXPECT_TRUE(raster_cache()->Draw(*display_list, mock_canvas()));
+}
+
+TEST_F(ContainerLayerTest, RetainedChildReplaysItsPaintAfterReusedPreroll) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkPaint child_paint(SkColors::kGreen);
+
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  preroll_context()->reuse_retained_subtrees = true;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+
+  // The first paint after a reused Preroll records the subtree, and the
+  // next one replays the recording.
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  layer->Paint(paint_context());
+  size_t recorded_end = mock_canvas().draw_calls().size();
+  layer->Paint(paint_context());
+
+  const auto& draw_calls = mock_canvas().draw_calls();
+  std::vector<MockCanvas::DrawCall> recorded(draw_calls.begin() + 1,
+                                             draw_calls.begin() + recorded_end);
+  std::vector<MockCanvas::DrawCall> replayed(draw_calls.begin() + recorded_end,
+                                             draw_calls.end());
+  EXPECT_EQ(recorded, replayed);
+  MockCanvas::DrawCall expected_draw_call = {
+      1, MockCanvas::DrawPathData{child_path, child_paint}};
+  EXPECT_NE(std::find(replayed.begin(), replayed.end(), expected_draw_call),
+            replayed.end());
+}
+
+TEST_F(ContainerLayerTest, RetainedChildDropsItsPaintWithTheCachedImages) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto draws_child_path = [&child_path](const MockCanvas::DrawCall& call) {
+    auto data = std::get_if<MockCanvas::DrawPathData>(&call.data);
+    return data && data->path == child_path;
+  };
+
+  // The children of the opacity layer are drawn from the raster cache.
+  auto opacity_layer =
+      std::make_shared<OpacityLayer>(SK_AlphaOPAQUE / 2, SkPoint::Make(0, 0));
+  opacity_layer->Add(MockLayer::Make(child_path));
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(opacity_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(retained_layer);
+
+  use_mock_raster_cache();
+  preroll_context()->reuse_retained_subtrees = true;
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 1u);
+
+  // The recording of the retained subtree draws the cached children, which
+  // must not be evicted as idle while the recording is replayed.
+  for (size_t i = 0; i <= raster_cache()->max_idle_frames() + 1; i++) {
+    layer->Preroll(preroll_context(), SkMatrix::I());
+    layer->Paint(paint_context());
+    raster_cache()->CleanupAfterFrame();
+  }
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 1u);
+  EXPECT_TRUE(std::none_of(mock_canvas().draw_calls().begin(),
+                           mock_canvas().draw_calls().end(),
+                           draws_child_path));
+
+  // Once the cache lets go of the image, so does the recording, and the
+  // subtree is prerolled again so that its children are cached anew.
+  raster_cache()->Clear();
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 0u);
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), 1u);
+  size_t painted_calls = mock_canvas().draw_calls().size();
+  layer->Paint(paint_context());
+  EXPECT_TRUE(std::none_of(mock_canvas().draw_calls().begin() + painted_calls,
+                           mock_canvas().draw_calls().end(), draws_child_path));
+}
+
 using ContainerLayerDiffTest = DiffContextTest;
 
 // Insert PictureLayer amongst container layers
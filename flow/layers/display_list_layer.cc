@@ -69,11 +69,14 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
     return false;
   }
 
-  if (op_bytes_1 > kMaxBytesToCompare) {
-    statistics.AddPictureTooComplexToCompare();
+  if (dl1->content_hash() != dl2->content_hash()) {
+    statistics.AddNewPicture();
     return false;
   }
 
+  // The hashes cover the addresses of the images and filters of the lists,
+  // so matching hashes are always confirmed with a deep comparison, which
+  // is rarely wasted at this point whatever the size of the lists.
   statistics.AddDeepComparePicture();
 
   auto res = dl1->Equals(*dl2);
@@ -106,7 +109,8 @@ void DisplayListLayer::Preroll(PrerollContext* context,
       }
     } else {
       // Don't evict raster cache entry during partial repaint
-      cache->Touch(disp_list, matrix);
+      cache->Touch(context, disp_list, is_complex_, will_change_, matrix,
+                   offset_);
     }
   }
   set_paint_bounds(bounds);
@@ -13,13 +13,13 @@ namespace flutter {
 
 class DisplayListLayer : public Layer {
  public:
-  static constexpr size_t kMaxBytesToCompare = 10000;
-
   DisplayListLayer(const SkPoint& offset,
                    SkiaGPUObject<DisplayList> display_list,
                    bool is_complex,
                    bool will_change);
 
+  const SkPoint& offset() const { return offset_; }
+
   DisplayList* display_list() const {
     return display_list_.skia_object().get();
   }
@@ -7,6 +7,8 @@
 #include "flutter/flow/layers/display_list_layer.h"
 
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/skia_gpu_object_layer_test.h"
 #include "flutter/fml/macros.h"
@@ -412,6 +414,32 @@ TEST_F(DisplayListLayerDiffTest, DisplayListCompare) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(20, 20, 70, 70));
 }
 
+TEST_F(DisplayListLayerDiffTest, LargeDisplayListCompare) {
+  auto create_display_list = []() {
+    DisplayListBuilder builder;
+    for (int i = 0; i < 1000; i++) {
+      builder.drawRect(SkRect::MakeXYWH(10 + i % 50, 10, 10, 10));
+    }
+    return builder.Build();
+  };
+
+  MockLayerTree tree1;
+  auto display_list1 = create_display_list();
+  ASSERT_GT(display_list1->bytes(), 10000u);
+  tree1.root()->Add(CreateDisplayListLayer(display_list1));
+
+  auto damage = DiffLayerTree(tree1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 69, 20));
+
+  // Equal lists are found equal however large they are.
+  MockLayerTree tree2;
+  auto display_list2 = create_display_list();
+  tree2.root()->Add(CreateDisplayListLayer(display_list2));
+
+  damage = DiffLayerTree(tree2, tree1);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeEmpty());
+}
+
 TEST_F(DisplayListLayerTest, LayerTreeSnapshotsWhenEnabled) {
   const SkPoint layer_offset = SkPoint::Make(1.5f, -0.5f);
   const SkRect picture_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
@@ -447,5 +475,25 @@ TEST_F(DisplayListLayerTest, NoLayerTreeSnapshotsWhenDisabledByDefault) {
   EXPECT_EQ(0u, snapshot_store.Size());
 }
 
+TEST_F(DisplayListLayerTest, LayerTreeCountsSharedDisplayListsOnce) {
+  DisplayListBuilder builder;
+  builder.drawPath(
+      SkPath().moveTo(0, 0).lineTo(100, 0).quadTo(100, 100, 0, 100).close());
+  auto display_list = builder.Build();
+  auto root = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < 2; i++) {
+    root->Add(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(i * 10.0f, 0.0f),
+        SkiaGPUObject<DisplayList>(display_list, unref_queue()), false,
+        false));
+  }
+  LayerTree layer_tree(SkISize::Make(100, 100), 1.0f);
+  layer_tree.set_root_layer(root);
+
+  DisplayListMemoryUsage usage = layer_tree.CollectDisplayListMemoryUsage();
+  EXPECT_EQ(usage.op_bytes, display_list->bytes(false));
+  EXPECT_EQ(usage.total_bytes(), display_list->MemoryUsage().total_bytes());
+}
+
 }  // namespace testing
 }  // namespace flutter
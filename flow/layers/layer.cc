@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/display_list/display_list_canvas_recorder.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -28,6 +29,172 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+bool Layer::RetainedPreroll::Matches(const PrerollContext& context,
+                                     const SkMatrix& matrix) const {
+  // The cull rect is not compared, because it only decides whether layers
+  // prepare or merely touch their raster cache entries, and it changes
+  // from frame to frame with partial repaint.
+  return this->matrix == matrix && raster_cache == context.raster_cache &&
+         gr_context == context.gr_context &&
+         dst_color_space == context.dst_color_space &&
+         frame_device_pixel_ratio == context.frame_device_pixel_ratio &&
+         checkerboard_offscreen_layers ==
+             context.checkerboard_offscreen_layers &&
+         has_active_save_layer == context.has_active_save_layer;
+}
+
+void Layer::PrerollOrReuse(PrerollContext* context, const SkMatrix& matrix) {
+  if (!context->reuse_retained_subtrees || !as_container_layer()) {
+    Preroll(context, matrix);
+    return;
+  }
+
+  // The raster cache entries of the subtree are touched as if it had been
+  // prerolled, and it is prerolled again if any of them lost its image.
+  if (retained_preroll_ && retained_preroll_->Matches(*context, matrix) &&
+      (!context->raster_cache ||
+       context->raster_cache->TouchPrerolledEntries(
+           retained_preroll_->raster_cache_keys))) {
+    context->subtree_can_inherit_opacity =
+        retained_preroll_->subtree_can_inherit_opacity;
+    if (context->raster_cache_keys) {
+      context->raster_cache_keys->insert(
+          context->raster_cache_keys->end(),
+          retained_preroll_->raster_cache_keys.begin(),
+          retained_preroll_->raster_cache_keys.end());
+    }
+    preroll_was_reused_ = true;
+    // Release the images that the raster cache has let go of even if the
+    // layer is not painted in this frame.
+    if (!RetainedPaintIsCurrent(context->raster_cache)) {
+      retained_paint_ = nullptr;
+    }
+    return;
+  }
+
+  // The texture and volatile layer flags are not reset between siblings,
+  // so a subtree is only known to have no such layers if none were found
+  // before it.
+  bool had_texture_layer = context->has_texture_layer;
+  bool had_volatile_layer = context->has_volatile_layer;
+  bool surface_needed_readback = context->surface_needs_readback;
+  bool raster_cache_entries_were_pending =
+      context->raster_cache_entries_pending;
+  std::vector<RasterCacheKey>* ancestor_raster_cache_keys =
+      context->raster_cache_keys;
+  std::vector<RasterCacheKey> raster_cache_keys;
+  context->surface_needs_readback = false;
+  context->raster_cache_entries_pending = false;
+  context->raster_cache_keys = &raster_cache_keys;
+
+  Preroll(context, matrix);
+
+  bool can_reuse = !context->has_platform_view && !had_texture_layer &&
+                   !context->has_texture_layer && !had_volatile_layer &&
+                   !context->has_volatile_layer &&
+                   !context->surface_needs_readback &&
+                   !context->raster_cache_entries_pending;
+  context->surface_needs_readback =
+      context->surface_needs_readback || surface_needed_readback;
+  context->raster_cache_entries_pending =
+      context->raster_cache_entries_pending ||
+      raster_cache_entries_were_pending;
+  context->raster_cache_keys = ancestor_raster_cache_keys;
+  if (ancestor_raster_cache_keys) {
+    ancestor_raster_cache_keys->insert(ancestor_raster_cache_keys->end(),
+                                       raster_cache_keys.begin(),
+                                       raster_cache_keys.end());
+  }
+
+  preroll_was_reused_ = false;
+  retained_paint_ = nullptr;
+  if (can_reuse) {
+    retained_preroll_ = {
+        .matrix = matrix,
+        .raster_cache = context->raster_cache,
+        .gr_context = context->gr_context,
+        .dst_color_space = context->dst_color_space,
+        .frame_device_pixel_ratio = context->frame_device_pixel_ratio,
+        .checkerboard_offscreen_layers = context->checkerboard_offscreen_layers,
+        .has_active_save_layer = context->has_active_save_layer,
+        .subtree_can_inherit_opacity = context->subtree_can_inherit_opacity,
+        .raster_cache_keys = std::move(raster_cache_keys),
+    };
+  } else {
+    retained_preroll_ = std::nullopt;
+  }
+}
+
+void Layer::PaintOrReplay(PaintContext& context) const {
+  // Inherited opacity and leaf layer tracing are applied by the leaves of
+  // the subtree, and the layers that paint into a DisplayListBuilder do not
+  // use the canvases.
+  if (!preroll_was_reused_ || context.inherited_opacity < SK_Scalar1 ||
+      context.enable_leaf_layer_tracing || context.leaf_nodes_builder) {
+    Paint(context);
+    return;
+  }
+
+  if (context.is_recording_retained_paint) {
+    // The subtree is painted into the recording of a retained ancestor,
+    // which would otherwise hold a copy of this layer's recording.
+    retained_paint_ = nullptr;
+    Paint(context);
+    return;
+  }
+
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  const SkMatrix& matrix = canvas->getTotalMatrix();
+  if (retained_paint_ && !RetainedPaintIsCurrent(context.raster_cache)) {
+    retained_paint_ = nullptr;
+  }
+  if (!retained_paint_) {
+    TRACE_EVENT0("flutter", "Layer::RecordRetainedPaint");
+    // The whole canvas is recorded rather than just the current clip,
+    // which changes from frame to frame with partial repaint. The layers
+    // may set absolute transforms, so the recording is made in the device
+    // space of the canvas and can only be replayed with the same transform.
+    SkISize canvas_size = canvas->getBaseLayerSize();
+    DisplayListCanvasRecorder recorder(SkRect::Make(canvas_size));
+    recorder.setMatrix(matrix);
+    SkNWayCanvas internal_nodes_canvas(canvas_size.width(),
+                                       canvas_size.height());
+    internal_nodes_canvas.setMatrix(matrix);
+    internal_nodes_canvas.addCanvas(&recorder);
+
+    PaintContext recording_context = context;
+    recording_context.internal_nodes_canvas = &internal_nodes_canvas;
+    recording_context.leaf_nodes_canvas = &recorder;
+    recording_context.view_embedder = nullptr;
+    recording_context.is_recording_retained_paint = true;
+    std::vector<RasterCacheKey> drawn_keys;
+    if (context.raster_cache) {
+      context.raster_cache->CollectDrawnKeys(&drawn_keys);
+    }
+    if (needs_painting(recording_context)) {
+      Paint(recording_context);
+    }
+    if (context.raster_cache) {
+      context.raster_cache->CollectDrawnKeys(nullptr);
+      retained_paint_image_generation_ =
+          context.raster_cache->image_generation();
+    }
+    retained_paint_ = recorder.Build();
+    retained_paint_matrix_ = matrix;
+    retained_paint_cache_keys_ = std::move(drawn_keys);
+  } else if (matrix != retained_paint_matrix_) {
+    Paint(context);
+    return;
+  } else if (context.raster_cache) {
+    // The replay draws the images of the entries without going through
+    // the cache, which would otherwise evict them as idle.
+    context.raster_cache->MarkDrawn(retained_paint_cache_keys_);
+  }
+
+  SkAutoCanvasRestore save(canvas, true);
+  retained_paint_->RenderTo(canvas);
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
@@ -37,7 +204,9 @@ Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
       layer_itself_performs_readback_(layer_itself_performs_readback) {
   if (save_layer_is_active_) {
     prev_surface_needs_readback_ = preroll_context_->surface_needs_readback;
+    prev_has_active_save_layer_ = preroll_context_->has_active_save_layer;
     preroll_context_->surface_needs_readback = false;
+    preroll_context_->has_active_save_layer = true;
   }
 }
 
@@ -53,6 +222,7 @@ Layer::AutoPrerollSaveLayerState::~AutoPrerollSaveLayerState() {
   if (save_layer_is_active_) {
     preroll_context_->surface_needs_readback =
         (prev_surface_needs_readback_ || layer_itself_performs_readback_);
+    preroll_context_->has_active_save_layer = prev_has_active_save_layer_;
   }
 }
 
@@ -6,9 +6,11 @@
 #define FLUTTER_FLOW_LAYERS_LAYER_H_
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/display_list/display_list.h"
 #include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
@@ -18,6 +20,7 @@
 #include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -62,6 +65,10 @@ struct PrerollContext {
   // These allow us to track properties like elevation, opacity, and the
   // prescence of a texture layer during Preroll.
   bool has_texture_layer = false;
+  // Whether the subtree has a layer that paints something new in every
+  // frame without being replaced, such as the performance overlay. Like
+  // |has_texture_layer|, it is not reset between siblings.
+  bool has_volatile_layer = false;
 
   // This field indicates whether the subtree rooted at this layer can
   // inherit an opacity value and modulate its visibility accordingly.
@@ -99,6 +106,33 @@ struct PrerollContext {
   //    from your Preroll method. (eg. layers that always apply a
   //    saveLayer when rendering anyway can apply the opacity there)
   bool subtree_can_inherit_opacity = false;
+
+  // If set, containers with many children preroll them in parallel on the
+  // workers of this task runner. See |ContainerLayer::PrerollChildren|.
+  //
+  // Layers prerolled on a worker get their own copy of the context, so
+  // anything else that they share through it must be thread safe.
+  fml::BasicTaskRunner* preroll_task_runner = nullptr;
+
+  // Whether child containers that are prerolled in the same conditions as
+  // the last time reuse the results of their last Preroll and Paint. See
+  // |Layer::PrerollOrReuse|.
+  bool reuse_retained_subtrees = false;
+
+  // Set by the raster cache when a layer prepares or touches an entry that
+  // has no image yet but may be rasterized in a later frame, in which case
+  // the subtree must be prerolled again to get it rasterized.
+  bool raster_cache_entries_pending = false;
+
+  // If not null, the raster cache adds the keys of the entries that layers
+  // prepare or touch to this list, so that a subtree whose Preroll is
+  // reused can keep its entries in the cache. See |Layer::PrerollOrReuse|.
+  std::vector<RasterCacheKey>* raster_cache_keys = nullptr;
+
+  // Whether an ancestor of the layer paints into a saveLayer, in which case
+  // the layer is not painted directly into the surface. Maintained by
+  // |Layer::AutoPrerollSaveLayerState|.
+  bool has_active_save_layer = false;
 };
 
 class ContainerLayer;
@@ -139,6 +173,19 @@ class Layer {
 
   virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
 
+  // Prerolls the layer, unless it is a container that was last prerolled
+  // with the same matrix and frame state, in which case the results of that
+  // Preroll are reported again without visiting its subtree.
+  //
+  // A layer can't change once it is part of a layer tree, so a subtree that
+  // is retained across frames and prerolled in the same way produces the
+  // same results. Subtrees with platform views, textures, volatile layers
+  // or layers that read back from the surface are always prerolled, as are
+  // subtrees with raster cache entries that are not rasterized yet or have
+  // been evicted. The entries of a reused subtree are touched as if it had
+  // been prerolled again.
+  void PrerollOrReuse(PrerollContext* context, const SkMatrix& matrix);
+
   // Used during Preroll by layers that employ a saveLayer to manage the
   // PrerollContext settings with values affected by the saveLayer mechanism.
   // This object must be created before calling Preroll on the children to
@@ -163,6 +210,7 @@ class Layer {
     bool layer_itself_performs_readback_;
 
     bool prev_surface_needs_readback_;
+    bool prev_has_active_save_layer_;
   };
 
   struct PaintContext {
@@ -200,6 +248,15 @@ class Layer {
     // a |kSrcOver| blend mode.
     SkScalar inherited_opacity = SK_Scalar1;
     DisplayListBuilder* leaf_nodes_builder = nullptr;
+
+    // Whether the pixels of the surface of |leaf_nodes_canvas| can be read
+    // while the frame is painted.
+    bool surface_supports_readback = false;
+
+    // Set while a layer records the paint of its retained subtree, see
+    // |Layer::PaintOrReplay|. Retained subtrees nested within it are
+    // painted into that recording rather than keeping their own.
+    bool is_recording_retained_paint = false;
   };
 
   class AutoCachePaint {
@@ -300,6 +357,14 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Paints the layer. If its last Preroll was reused, its subtree is
+  // recorded into a DisplayList the first time it is painted, and the
+  // DisplayList is replayed for as long as the layer keeps being reused and
+  // is painted with the same transform. The recording is dropped as soon
+  // as the raster cache removes any of its images, see
+  // |RasterCache::image_generation|.
+  void PaintOrReplay(PaintContext& context) const;
+
   bool subtree_has_platform_view() const { return subtree_has_platform_view_; }
   void set_subtree_has_platform_view(bool value) {
     subtree_has_platform_view_ = value;
@@ -371,11 +436,47 @@ class Layer {
   virtual const testing::MockLayer* as_mock_layer() const { return nullptr; }
 
  private:
+  // The state of the frame that a container was last prerolled in, and the
+  // result of that Preroll that is not stored in the layer itself.
+  struct RetainedPreroll {
+    SkMatrix matrix;
+    const RasterCache* raster_cache;
+    GrDirectContext* gr_context;
+    SkColorSpace* dst_color_space;
+    float frame_device_pixel_ratio;
+    bool checkerboard_offscreen_layers;
+    bool has_active_save_layer;
+    bool subtree_can_inherit_opacity;
+    // The raster cache entries prepared or touched by the subtree.
+    std::vector<RasterCacheKey> raster_cache_keys;
+
+    bool Matches(const PrerollContext& context, const SkMatrix& matrix) const;
+  };
+
   SkRect paint_bounds_;
   uint64_t unique_id_;
   uint64_t original_layer_id_;
   bool subtree_has_platform_view_;
 
+  std::optional<RetainedPreroll> retained_preroll_;
+  bool preroll_was_reused_ = false;
+  // The subtree as painted with |retained_paint_matrix_| after its Preroll
+  // was first reused.
+  mutable sk_sp<DisplayList> retained_paint_;
+  mutable SkMatrix retained_paint_matrix_;
+  // The raster cache entries that |retained_paint_| draws, which are marked
+  // as used whenever it is replayed, and the image generation of the cache
+  // when it was recorded.
+  mutable std::vector<RasterCacheKey> retained_paint_cache_keys_;
+  mutable uint64_t retained_paint_image_generation_ = 0;
+
+  // Whether |retained_paint_| only draws images that are still held by
+  // |raster_cache|.
+  bool RetainedPaintIsCurrent(const RasterCache* raster_cache) const {
+    return !raster_cache || raster_cache->image_generation() ==
+                                retained_paint_image_generation_;
+  }
+
   static uint64_t NextUniqueID();
 
   FML_DISALLOW_COPY_AND_ASSIGN(Layer);
@@ -4,8 +4,12 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include "flutter/common/constants.h"
+#include "flutter/display_list/display_list.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/flow/layer_snapshot_store.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
@@ -40,6 +44,15 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
   MutatorsStack stack;
   RasterCache* cache =
       ignore_raster_cache ? nullptr : &frame.context().raster_cache();
+  // Layers are only prerolled in parallel for software frames without an
+  // external view embedder. Rasterizing into the raster cache with a
+  // GrContext and compositing platform views both have to happen on the
+  // raster thread.
+  fml::BasicTaskRunner* preroll_task_runner =
+      frame.gr_context() || frame.view_embedder()
+          ? nullptr
+          : frame.context().preroll_task_runner();
+  bool reuse_retained_subtrees = frame.context().reuse_retained_subtrees();
   PrerollContext context = {
       // clang-format off
       .raster_cache                  = cache,
@@ -54,13 +67,63 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       .texture_registry              = frame.context().texture_registry(),
       .checkerboard_offscreen_layers = checkerboard_offscreen_layers_,
       .frame_device_pixel_ratio      = device_pixel_ratio_,
+      .preroll_task_runner           = preroll_task_runner,
+      .reuse_retained_subtrees       = reuse_retained_subtrees,
       // clang-format on
   };
 
   root_layer_->Preroll(&context, frame.root_surface_transformation());
+  if (frame.context().trace_display_list_memory()) {
+    TraceDisplayListMemoryUsageToTimeline();
+  }
   return context.surface_needs_readback;
 }
 
+static void AccountDisplayListLayers(const Layer* layer,
+                                     DisplayListMemoryAccountant& accountant) {
+  if (auto display_list_layer = layer->as_display_list_layer()) {
+    if (auto display_list = display_list_layer->display_list()) {
+      accountant.AddDisplayList(display_list);
+    }
+  } else if (auto container = layer->as_container_layer()) {
+    for (auto& child : container->layers()) {
+      AccountDisplayListLayers(child.get(), accountant);
+    }
+  }
+}
+
+DisplayListMemoryUsage LayerTree::CollectDisplayListMemoryUsage() const {
+  DisplayListMemoryAccountant accountant;
+  if (root_layer_) {
+    AccountDisplayListLayers(root_layer_.get(), accountant);
+  }
+  return accountant.usage();
+}
+
+void LayerTree::TraceDisplayListMemoryUsageToTimeline() const {
+#if !FLUTTER_RELEASE
+  // Even when asked for, collecting the usage is only worth it if the
+  // counter will be recorded.
+  if (!FML_TRACE_EVENT_ENABLED("flutter", "DisplayListMemory")) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "LayerTree::TraceDisplayListMemoryUsage");
+  DisplayListMemoryUsage usage = CollectDisplayListMemoryUsage();
+  // Layer trees only live for a frame, so all of them report to the same
+  // counter.
+  auto mbytes = [](size_t bytes) { return bytes / kMegaByteSizeInBytes; };
+  FML_TRACE_COUNTER("flutter", "DisplayListMemory", 0,                     //
+                    "OpMBytes", mbytes(usage.op_bytes),                    //
+                    "PathMBytes", mbytes(usage.path_bytes),                //
+                    "VerticesMBytes", mbytes(usage.vertices_bytes),        //
+                    "TextBlobMBytes", mbytes(usage.text_blob_bytes),       //
+                    "FilterMBytes", mbytes(usage.filter_bytes),            //
+                    "PictureMBytes", mbytes(usage.picture_bytes),          //
+                    "UniqueImageMBytes", mbytes(usage.unique_image_bytes),
+                    "SharedImageMBytes", mbytes(usage.shared_image_bytes));
+#endif  // !FLUTTER_RELEASE
+}
+
 void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
                       bool ignore_raster_cache) const {
   TRACE_EVENT0("flutter", "LayerTree::Paint");
@@ -105,6 +168,7 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       .enable_leaf_layer_tracing     = enable_leaf_layer_tracing_,
       .inherited_opacity             = SK_Scalar1,
       .leaf_nodes_builder            = frame.display_list_builder(),
+      .surface_supports_readback     = frame.surface_supports_readback(),
       // clang-format on
   };
 
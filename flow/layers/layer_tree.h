@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "flutter/display_list/display_list_memory_usage.h"
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/macros.h"
@@ -37,6 +38,11 @@ class LayerTree {
 
   sk_sp<SkPicture> Flatten(const SkRect& bounds);
 
+  // Totals the memory retained by the DisplayLists of the layers in this
+  // tree, see |DisplayList::MemoryUsage|. Objects that are shared between
+  // the lists are only counted once.
+  DisplayListMemoryUsage CollectDisplayListMemoryUsage() const;
+
   Layer* root_layer() const { return root_layer_.get(); }
 
   void set_root_layer(std::shared_ptr<Layer> root_layer) {
@@ -81,6 +87,8 @@ class LayerTree {
   }
 
  private:
+  void TraceDisplayListMemoryUsageToTimeline() const;
+
   std::shared_ptr<Layer> root_layer_;
   SkISize frame_size_ = SkISize::MakeEmpty();  // Physical pixels.
   const float device_pixel_ratio_;  // Logical / Physical pixels ratio.
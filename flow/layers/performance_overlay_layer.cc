@@ -86,6 +86,12 @@ void PerformanceOverlayLayer::Diff(DiffContext* context,
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
+void PerformanceOverlayLayer::Preroll(PrerollContext* context,
+                                      const SkMatrix& matrix) {
+  // The overlay paints the latest timings of every frame.
+  context->has_volatile_layer = true;
+}
+
 void PerformanceOverlayLayer::Paint(PaintContext& context) const {
   const int padding = 8;
 
@@ -123,7 +123,8 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
       }
     } else {
       // Don't evict raster cache entry during partial repaint
-      cache->Touch(sk_picture, matrix);
+      cache->Touch(context, sk_picture, is_complex_, will_change_, matrix,
+                   offset_);
     }
   }
 
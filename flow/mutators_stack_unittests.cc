@@ -23,6 +23,26 @@ TEST(MutatorsStack, CopyConstructor) {
   ASSERT_TRUE(copy == stack);
 }
 
+TEST(MutatorsStack, CopyOutlivesTheStack) {
+  auto rect = SkRect::MakeEmpty();
+  MutatorsStack copy;
+  {
+    MutatorsStack stack;
+    stack.PushClipRect(rect);
+    stack.PushOpacity(128);
+    copy = stack;
+    stack.Pop();
+    stack.Pop();
+    stack.PushTransform(SkMatrix::Scale(2, 2));
+  }
+  auto iter = copy.Bottom();
+  ASSERT_TRUE(iter->get()->GetType() == MutatorType::opacity);
+  ASSERT_TRUE(iter->get()->GetAlpha() == 128);
+  ++iter;
+  ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rect);
+  ASSERT_TRUE(iter->get()->GetRect() == rect);
+}
+
 TEST(MutatorsStack, CopyAndUpdateTheCopy) {
   MutatorsStack stack;
   auto rrect = SkRRect::MakeEmpty();
@@ -4,12 +4,16 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "flutter/common/constants.h"
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -41,10 +45,14 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_and_display_list_cache_limit_per_frame)
+                         size_t picture_and_display_list_cache_limit_per_frame,
+                         size_t max_cache_bytes,
+                         size_t max_idle_frames)
     : access_threshold_(access_threshold),
       picture_and_display_list_cache_limit_per_frame_(
           picture_and_display_list_cache_limit_per_frame),
+      max_cache_bytes_(max_cache_bytes),
+      max_idle_frames_(max_idle_frames),
       checkerboard_images_(false) {}
 
 static bool CanRasterizeRect(const SkRect& cull_rect) {
@@ -115,6 +123,14 @@ static bool IsDisplayListWorthRasterizing(
   return complexity_calculator->ShouldBeCached(complexity_score);
 }
 
+// The size of the image that |Rasterize| allocates for |logical_rect|.
+static size_t EstimateRasterizedByteSize(const SkRect& logical_rect,
+                                         const SkMatrix& ctm) {
+  SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
+  return SkImageInfo::MakeN32Premul(cache_rect.width(), cache_rect.height())
+      .computeMinByteSize();
+}
+
 /// @note Procedure doesn't copy all closures.
 static std::unique_ptr<RasterCacheResult> Rasterize(
     GrDirectContext* context,
@@ -184,13 +200,43 @@ void RasterCache::Prepare(PrerollContext* context,
   if (!cache_key_optional) {
     return;
   }
-  Entry& entry = cache_[cache_key_optional.value()];
+  std::scoped_lock lock(preroll_mutex_);
+  const RasterCacheKey& cache_key = cache_key_optional.value();
+  Entry& entry = cache_[cache_key];
+  if (strategy == RasterCacheLayerStrategy::kFilteredChildren &&
+      !MatchFilteredChildren(entry, layer)) {
+    // The entry is new, or the keys of different contents collided, in
+    // which case the entry is replaced.
+    if (entry.image) {
+      image_generation_++;
+    }
+    entry = Entry();
+    RetainFilteredChildren(entry, layer);
+  }
   entry.access_count++;
   entry.used_this_frame = true;
-  if (!entry.image) {
-    entry.image =
-        RasterizeLayer(context, layer, strategy, ctm, checkerboard_images_);
+  // Like pictures, filtered children are only rasterized once they have
+  // been drawn with the same filter a few times, so that an animated filter
+  // is not rasterized anew in each frame.
+  if (!entry.image &&
+      (strategy != RasterCacheLayerStrategy::kFilteredChildren ||
+       entry.access_count >= access_threshold_)) {
+    size_t bytes = EstimateRasterizedByteSize(
+        GetPaintBoundsFromLayer(layer, strategy), ctm);
+    if (MakeRoomFor(bytes, entry.cost)) {
+      entry.image =
+          RasterizeLayer(context, layer, strategy, ctm, checkerboard_images_);
+    }
   }
+  RecordPrerolledEntry(context, cache_key, entry);
+}
+
+// Packs the bits of the coordinates of |offset| into an id.
+static uint64_t OffsetId(const SkPoint& offset) {
+  uint32_t x, y;
+  std::memcpy(&x, &offset.fX, sizeof(x));
+  std::memcpy(&y, &offset.fY, sizeof(y));
+  return (static_cast<uint64_t>(x) << 32) | y;
 }
 
 std::optional<RasterCacheKey> RasterCache::TryToMakeRasterCacheKeyForLayer(
@@ -202,19 +248,43 @@ std::optional<RasterCacheKey> RasterCache::TryToMakeRasterCacheKeyForLayer(
       return RasterCacheKey(layer->unique_id(), RasterCacheKeyType::kLayer,
                             ctm);
     case RasterCacheLayerStrategy::kLayerChildren:
+    case RasterCacheLayerStrategy::kFilteredChildren:
       FML_DCHECK(layer->as_container_layer());
-      auto& children_layers = layer->as_container_layer()->layers();
+      const ContainerLayer* container_layer = layer->as_container_layer();
+      auto& children_layers = container_layer->layers();
       auto children_count = children_layers.size();
       if (children_count == 0) {
         return std::nullopt;
       }
       std::vector<uint64_t> ids;
-      std::transform(children_layers.begin(), children_layers.end(),
-                     std::back_inserter(ids), [](auto& layer) -> uint64_t {
-                       return layer->unique_id();
-                     });
+      if (strategy == RasterCacheLayerStrategy::kLayerChildren) {
+        std::transform(children_layers.begin(), children_layers.end(),
+                       std::back_inserter(ids), [](auto& layer) -> uint64_t {
+                         return layer->unique_id();
+                       });
+        return RasterCacheKey(RasterCacheKeyID(std::move(ids)),
+                              RasterCacheKeyType::kLayerChildren, ctm);
+      }
+      uint64_t filter_id = container_layer->filter_content_id();
+      if (filter_id == 0) {
+        return std::nullopt;
+      }
+      // Each child is tagged with how it is identified, so that the ids of
+      // different kinds of children can't form the same key.
+      for (auto& child : children_layers) {
+        if (const DisplayListLayer* display_list_layer =
+                child->as_display_list_layer()) {
+          ids.push_back(1);
+          ids.push_back(display_list_layer->display_list()->content_hash());
+          ids.push_back(OffsetId(display_list_layer->offset()));
+        } else {
+          ids.push_back(0);
+          ids.push_back(child->unique_id());
+        }
+      }
+      ids.push_back(filter_id);
       return RasterCacheKey(RasterCacheKeyID(std::move(ids)),
-                            RasterCacheKeyType::kLayerChildren, ctm);
+                            RasterCacheKeyType::kFilteredLayerChildren, ctm);
   }
 }
 
@@ -249,6 +319,7 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizeLayer(
             context->frame_device_pixel_ratio};
         switch (strategy) {
           case RasterCacheLayerStrategy::kLayer:
+          case RasterCacheLayerStrategy::kFilteredChildren:
             if (layer->needs_painting(paintContext)) {
               layer->Paint(paintContext);
             }
@@ -266,6 +337,7 @@ const SkRect& RasterCache::GetPaintBoundsFromLayer(
     RasterCacheLayerStrategy strategy) const {
   switch (strategy) {
     case RasterCacheLayerStrategy::kLayer:
+    case RasterCacheLayerStrategy::kFilteredChildren:
       return layer->paint_bounds();
     case RasterCacheLayerStrategy::kLayerChildren:
       FML_DCHECK(layer->as_container_layer());
@@ -279,7 +351,10 @@ bool RasterCache::Prepare(PrerollContext* context,
                           bool will_change,
                           const SkMatrix& untranslated_matrix,
                           const SkPoint& offset) {
+  std::scoped_lock lock(preroll_mutex_);
   if (!GenerateNewCacheInThisFrame()) {
+    // The picture may be cached in a later frame, unless caching is off.
+    context->raster_cache_entries_pending |= access_threshold_ != 0;
     return false;
   }
 
@@ -301,11 +376,19 @@ bool RasterCache::Prepare(PrerollContext* context,
 
   // Creates an entry, if not present prior.
   Entry& entry = cache_[cache_key];
+  fml::ScopedCleanupClosure record_entry(
+      [&]() { RecordPrerolledEntry(context, cache_key, entry); });
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
+  CollectPendingImage(entry);
+  if (entry.pending) {
+    // The picture is drawn directly until the worker has finished.
+    return false;
+  }
+
   if (!entry.image) {
     // GetIntegralTransCTM effect for matrix which only contains scale,
     // translate, so it won't affect result of matrix decomposition and cache
@@ -313,11 +396,31 @@ bool RasterCache::Prepare(PrerollContext* context,
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     transformation_matrix = GetIntegralTransCTM(transformation_matrix);
 #endif
+    size_t bytes =
+        EstimateRasterizedByteSize(picture->cullRect(), transformation_matrix);
+    if (!MakeRoomFor(bytes, entry.cost)) {
+      return false;
+    }
+    picture_cached_this_frame_++;
+    if (ShouldRasterizeOnWorker(context)) {
+      entry.pending = RasterizeOnWorker(
+          bytes, [picture = sk_ref_sp(picture), transformation_matrix,
+                  color_space = sk_ref_sp(context->dst_color_space),
+                  checkerboard = checkerboard_images_]() {
+            return Rasterize(
+                nullptr, transformation_matrix, color_space.get(),
+                checkerboard, picture->cullRect(), "RasterCacheFlow::SkPicture",
+                [&](SkCanvas* canvas) { canvas->drawPicture(picture); });
+          });
+      return false;
+    }
     entry.image =
         RasterizePicture(picture, context->gr_context, transformation_matrix,
                          context->dst_color_space, checkerboard_images_);
-    picture_cached_this_frame_++;
   }
+  // The image will be drawn in this frame, so it must not be evicted to make
+  // room for other entries before then.
+  entry.used_this_frame = true;
   return true;
 }
 
@@ -327,7 +430,10 @@ bool RasterCache::Prepare(PrerollContext* context,
                           bool will_change,
                           const SkMatrix& untranslated_matrix,
                           const SkPoint& offset) {
+  std::scoped_lock lock(preroll_mutex_);
   if (!GenerateNewCacheInThisFrame()) {
+    // The display list may be cached in a later frame, unless caching is off.
+    context->raster_cache_entries_pending |= access_threshold_ != 0;
     return false;
   }
 
@@ -350,17 +456,37 @@ bool RasterCache::Prepare(PrerollContext* context,
     return false;
   }
 
-  RasterCacheKey cache_key(display_list->unique_id(),
+  // Display lists are keyed by their contents so that a list which is
+  // rebuilt each frame with the same ops reuses the cached image.
+  RasterCacheKey cache_key(display_list->content_hash(),
                            RasterCacheKeyType::kDisplayList,
                            transformation_matrix);
 
   // Creates an entry, if not present prior.
   Entry& entry = cache_[cache_key];
+  fml::ScopedCleanupClosure record_entry(
+      [&]() { RecordPrerolledEntry(context, cache_key, entry); });
+  if (!entry.display_list) {
+    entry.display_list = sk_ref_sp(display_list);
+  } else if (!MatchDisplayList(entry.display_list, *display_list)) {
+    // The hashes of different lists collided, the entry is replaced.
+    if (entry.image) {
+      image_generation_++;
+    }
+    entry = Entry();
+    entry.display_list = sk_ref_sp(display_list);
+  }
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
+  CollectPendingImage(entry);
+  if (entry.pending) {
+    // The display list is drawn directly until the worker has finished.
+    return false;
+  }
+
   if (!entry.image) {
     // GetIntegralTransCTM effect for matrix which only contains scale,
     // translate, so it won't affect result of matrix decomposition and cache
@@ -368,15 +494,70 @@ bool RasterCache::Prepare(PrerollContext* context,
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     transformation_matrix = GetIntegralTransCTM(transformation_matrix);
 #endif
+    entry.cost = complexity_calculator->Compute(display_list);
+    size_t bytes = EstimateRasterizedByteSize(display_list->bounds(),
+                                              transformation_matrix);
+    if (!MakeRoomFor(bytes, entry.cost)) {
+      return false;
+    }
+    display_list_cached_this_frame_++;
+    if (ShouldRasterizeOnWorker(context)) {
+      entry.pending = RasterizeOnWorker(
+          bytes, [display_list = sk_ref_sp(display_list), transformation_matrix,
+                  color_space = sk_ref_sp(context->dst_color_space),
+                  checkerboard = checkerboard_images_]() {
+            return Rasterize(
+                nullptr, transformation_matrix, color_space.get(),
+                checkerboard, display_list->bounds(),
+                "RasterCacheFlow::DisplayList",
+                [&](SkCanvas* canvas) { display_list->RenderTo(canvas); });
+          });
+      return false;
+    }
     entry.image = RasterizeDisplayList(
         display_list, context->gr_context, transformation_matrix,
         context->dst_color_space, checkerboard_images_);
-    display_list_cached_this_frame_++;
   }
+  // The image will be drawn in this frame, so it must not be evicted to make
+  // room for other entries before then.
+  entry.used_this_frame = true;
   return true;
 }
 
-void RasterCache::Touch(Layer* layer,
+bool RasterCache::ShouldRasterizeOnWorker(
+    const PrerollContext* context) const {
+  return rasterization_task_runner_ && !context->gr_context;
+}
+
+std::shared_ptr<RasterCache::PendingImage> RasterCache::RasterizeOnWorker(
+    size_t bytes,
+    std::function<std::unique_ptr<RasterCacheResult>()> rasterize) {
+  auto pending = std::make_shared<PendingImage>(bytes);
+  rasterization_task_runner_->PostTask([pending, rasterize]() {
+    auto image = rasterize();
+    std::scoped_lock lock(pending->mutex);
+    pending->image = std::move(image);
+    pending->done = true;
+  });
+  return pending;
+}
+
+void RasterCache::CollectPendingImage(Entry& entry) {
+  if (!entry.pending) {
+    return;
+  }
+  {
+    std::scoped_lock lock(entry.pending->mutex);
+    if (!entry.pending->done) {
+      return;
+    }
+    entry.image = std::move(entry.pending->image);
+  }
+  entry.pending.reset();
+}
+
+void RasterCache::Touch(PrerollContext* context,
+                        Layer* layer,
                         const SkMatrix& ctm,
                         RasterCacheLayerStrategy strategey) {
   auto cache_key_optional =
@@ -384,30 +565,194 @@ void RasterCache::Touch(Layer* layer,
   if (!cache_key_optional) {
     return;
   }
-  Touch(cache_key_optional.value());
+  std::scoped_lock lock(preroll_mutex_);
+  const RasterCacheKey& cache_key = cache_key_optional.value();
+  Entry* entry = FindLayerEntry(cache_key, layer, strategey);
+  if (!entry) {
+    // Layers only ask to be cached when they are worth caching, so the
+    // layer will be rasterized once it is prepared.
+    context->raster_cache_entries_pending = true;
+    return;
+  }
+  entry->used_this_frame = true;
+  entry->access_count++;
+  RecordPrerolledEntry(context, cache_key, *entry);
 }
 
-void RasterCache::Touch(SkPicture* picture,
-                        const SkMatrix& transformation_matrix) {
+void RasterCache::Touch(PrerollContext* context,
+                        SkPicture* picture,
+                        bool is_complex,
+                        bool will_change,
+                        const SkMatrix& untranslated_matrix,
+                        const SkPoint& offset) {
+  SkMatrix transformation_matrix = untranslated_matrix;
+  transformation_matrix.preTranslate(offset.x(), offset.y());
   RasterCacheKey cache_key(picture->uniqueID(), RasterCacheKeyType::kPicture,
                            transformation_matrix);
-  Touch(cache_key);
+  std::scoped_lock lock(preroll_mutex_);
+  auto it = cache_.find(cache_key);
+  if (it == cache_.end()) {
+    context->raster_cache_entries_pending |=
+        access_threshold_ != 0 &&
+        IsPictureWorthRasterizing(picture, will_change, is_complex) &&
+        transformation_matrix.invert(nullptr);
+    return;
+  }
+  it->second.used_this_frame = true;
+  it->second.access_count++;
+  RecordPrerolledEntry(context, cache_key, it->second);
 }
 
-void RasterCache::Touch(DisplayList* display_list,
-                        const SkMatrix& transformation_matrix) {
-  RasterCacheKey cache_key(display_list->unique_id(),
+void RasterCache::Touch(PrerollContext* context,
+                        DisplayList* display_list,
+                        bool is_complex,
+                        bool will_change,
+                        const SkMatrix& untranslated_matrix,
+                        const SkPoint& offset) {
+  SkMatrix transformation_matrix = untranslated_matrix;
+  transformation_matrix.preTranslate(offset.x(), offset.y());
+  RasterCacheKey cache_key(display_list->content_hash(),
                            RasterCacheKeyType::kDisplayList,
                            transformation_matrix);
-  Touch(cache_key);
+  std::scoped_lock lock(preroll_mutex_);
+  Entry* entry = FindDisplayListEntry(cache_key, *display_list);
+  if (!entry) {
+    DisplayListComplexityCalculator* complexity_calculator =
+        context->gr_context ? DisplayListComplexityCalculator::GetForBackend(
+                                  context->gr_context->backend())
+                            : DisplayListComplexityCalculator::GetForSoftware();
+    context->raster_cache_entries_pending |=
+        access_threshold_ != 0 &&
+        IsDisplayListWorthRasterizing(display_list, will_change, is_complex,
+                                      complexity_calculator) &&
+        transformation_matrix.invert(nullptr);
+    return;
+  }
+  entry->used_this_frame = true;
+  entry->access_count++;
+  RecordPrerolledEntry(context, cache_key, *entry);
 }
 
-void RasterCache::Touch(const RasterCacheKey& cache_key) {
+bool RasterCache::TouchPrerolledEntries(
+    const std::vector<RasterCacheKey>& keys) {
+  std::scoped_lock lock(preroll_mutex_);
+  bool all_have_images = true;
+  for (const RasterCacheKey& key : keys) {
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      all_have_images = false;
+      continue;
+    }
+    Entry& entry = it->second;
+    entry.used_this_frame = true;
+    entry.access_count++;
+    CollectPendingImage(entry);
+    all_have_images = all_have_images && entry.image;
+  }
+  return all_have_images;
+}
+
+void RasterCache::RecordPrerolledEntry(PrerollContext* context,
+                                       const RasterCacheKey& cache_key,
+                                       const Entry& entry) {
+  if (context->raster_cache_keys) {
+    context->raster_cache_keys->push_back(cache_key);
+  }
+  if (!entry.image) {
+    context->raster_cache_entries_pending = true;
+  }
+}
+
+RasterCache::Entry* RasterCache::FindDisplayListEntry(
+    const RasterCacheKey& cache_key,
+    const DisplayList& display_list) const {
   auto it = cache_.find(cache_key);
-  if (it != cache_.end()) {
-    it->second.used_this_frame = true;
-    it->second.access_count++;
+  if (it == cache_.end()) {
+    return nullptr;
   }
+  Entry& entry = it->second;
+  if (!MatchDisplayList(entry.display_list, display_list)) {
+    return nullptr;
+  }
+  return &entry;
+}
+
+RasterCache::Entry* RasterCache::FindLayerEntry(
+    const RasterCacheKey& cache_key,
+    const Layer* layer,
+    RasterCacheLayerStrategy strategy) const {
+  auto it = cache_.find(cache_key);
+  if (it == cache_.end()) {
+    return nullptr;
+  }
+  Entry& entry = it->second;
+  if (strategy == RasterCacheLayerStrategy::kFilteredChildren &&
+      !MatchFilteredChildren(entry, layer)) {
+    return nullptr;
+  }
+  return &entry;
+}
+
+bool RasterCache::MatchDisplayList(sk_sp<DisplayList>& retained,
+                                   const DisplayList& display_list) {
+  if (retained.get() == &display_list) {
+    return true;
+  }
+  if (!retained || !retained->Equals(display_list)) {
+    return false;
+  }
+  retained = sk_ref_sp(&display_list);
+  return true;
+}
+
+bool RasterCache::MatchFilteredChildren(Entry& entry, const Layer* layer) {
+  const ContainerLayer* container_layer = layer->as_container_layer();
+  if (!entry.filter_data ||
+      !entry.filter_data->equals(container_layer->filter_data())) {
+    return false;
+  }
+  size_t index = 0;
+  for (auto& child : container_layer->layers()) {
+    const DisplayListLayer* display_list_layer =
+        child->as_display_list_layer();
+    if (!display_list_layer) {
+      continue;
+    }
+    if (index == entry.child_display_lists.size() ||
+        !MatchDisplayList(entry.child_display_lists[index],
+                          *display_list_layer->display_list())) {
+      return false;
+    }
+    index++;
+  }
+  return index == entry.child_display_lists.size();
+}
+
+void RasterCache::RetainFilteredChildren(Entry& entry, const Layer* layer) {
+  const ContainerLayer* container_layer = layer->as_container_layer();
+  entry.filter_data = sk_ref_sp(container_layer->filter_data());
+  entry.child_display_lists.clear();
+  for (auto& child : container_layer->layers()) {
+    if (const DisplayListLayer* display_list_layer =
+            child->as_display_list_layer()) {
+      entry.child_display_lists.push_back(
+          sk_ref_sp(display_list_layer->display_list()));
+    }
+  }
+}
+
+size_t RasterCache::RetainedBytes(const Entry& entry) {
+  size_t bytes = entry.image ? entry.image->image_bytes() : 0;
+  if (entry.display_list) {
+    bytes += entry.display_list->bytes();
+  }
+  if (entry.filter_data) {
+    bytes += entry.filter_data->size();
+  }
+  for (const auto& display_list : entry.child_display_lists) {
+    bytes += display_list->bytes();
+  }
+  return bytes;
 }
 
 bool RasterCache::Draw(const SkPicture& picture,
@@ -421,19 +766,36 @@ bool RasterCache::Draw(const SkPicture& picture,
 bool RasterCache::Draw(const DisplayList& display_list,
                        SkCanvas& canvas,
                        const SkPaint* paint) const {
-  RasterCacheKey cache_key(display_list.unique_id(),
+  RasterCacheKey cache_key(display_list.content_hash(),
                            RasterCacheKeyType::kDisplayList,
                            canvas.getTotalMatrix());
+  if (!FindDisplayListEntry(cache_key, display_list)) {
+    return false;
+  }
   return Draw(cache_key, canvas, paint);
 }
 
+bool RasterCache::HasImage(const Layer* layer,
+                           const SkMatrix& ctm,
+                           RasterCacheLayerStrategy strategy) const {
+  auto cache_key_optional =
+      TryToMakeRasterCacheKeyForLayer(layer, strategy, ctm);
+  if (!cache_key_optional) {
+    return false;
+  }
+  std::scoped_lock lock(preroll_mutex_);
+  Entry* entry = FindLayerEntry(cache_key_optional.value(), layer, strategy);
+  return entry && entry->image;
+}
+
 bool RasterCache::Draw(const Layer* layer,
                        SkCanvas& canvas,
                        RasterCacheLayerStrategy strategy,
                        const SkPaint* paint) const {
   auto cache_key_optional =
       TryToMakeRasterCacheKeyForLayer(layer, strategy, canvas.getTotalMatrix());
-  if (!cache_key_optional) {
+  if (!cache_key_optional ||
+      !FindLayerEntry(cache_key_optional.value(), layer, strategy)) {
     return false;
   }
   return Draw(cache_key_optional.value(), canvas, paint);
@@ -453,12 +815,99 @@ bool RasterCache::Draw(const RasterCacheKey& cache_key,
 
   if (entry.image) {
     entry.image->draw(canvas, paint);
+    if (drawn_keys_) {
+      drawn_keys_->push_back(cache_key);
+    }
     return true;
   }
 
   return false;
 }
 
+void RasterCache::CollectDrawnKeys(std::vector<RasterCacheKey>* keys) const {
+  drawn_keys_ = keys;
+}
+
+void RasterCache::MarkDrawn(const std::vector<RasterCacheKey>& keys) const {
+  for (const RasterCacheKey& key : keys) {
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      it->second.access_count++;
+      it->second.used_this_frame = true;
+    }
+  }
+}
+
+bool RasterCache::MakeRoomFor(size_t bytes, unsigned int cost) {
+  if (bytes > max_cache_bytes_) {
+    return false;
+  }
+
+  size_t cached_bytes = 0;
+  std::vector<RasterCacheKey::Map<Entry>::iterator> candidates;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    cached_bytes += RetainedBytes(entry);
+    if (!entry.image) {
+      if (entry.pending) {
+        cached_bytes += entry.pending->bytes;
+      }
+      continue;
+    }
+    if (!entry.used_this_frame && RetentionValue(entry) < cost) {
+      candidates.push_back(it);
+    }
+  }
+
+  if (cached_bytes + bytes <= max_cache_bytes_) {
+    return true;
+  }
+
+  // Evict the least valuable entries first, and only if evicting all of the
+  // entries that are worth less than the new one frees enough room.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) {
+              return RetentionValue(a->second) < RetentionValue(b->second);
+            });
+  size_t freeable_bytes = 0;
+  size_t victim_count = 0;
+  while (victim_count < candidates.size() &&
+         cached_bytes - freeable_bytes + bytes > max_cache_bytes_) {
+    freeable_bytes += RetainedBytes(candidates[victim_count]->second);
+    victim_count++;
+  }
+  if (cached_bytes - freeable_bytes + bytes > max_cache_bytes_) {
+    return false;
+  }
+
+  for (size_t i = 0; i < victim_count; i++) {
+    RecordEviction(candidates[i]->first, candidates[i]->second,
+                   pending_picture_evictions_, pending_layer_evictions_);
+    cache_.erase(candidates[i]);
+  }
+  return true;
+}
+
+void RasterCache::RecordEviction(const RasterCacheKey& key,
+                                 const Entry& entry,
+                                 RasterCacheMetrics& picture_metrics,
+                                 RasterCacheMetrics& layer_metrics) {
+  if (!entry.image) {
+    return;
+  }
+  image_generation_++;
+  switch (key.kind()) {
+    case RasterCacheKeyKind::kPictureMetrics:
+      picture_metrics.eviction_count++;
+      picture_metrics.eviction_bytes += RetainedBytes(entry);
+      break;
+    case RasterCacheKeyKind::kLayerMetrics:
+      layer_metrics.eviction_count++;
+      layer_metrics.eviction_bytes += RetainedBytes(entry);
+      break;
+  }
+}
+
 void RasterCache::PrepareNewFrame() {
   picture_cached_this_frame_ = 0;
   display_list_cached_this_frame_ = 0;
@@ -472,53 +921,60 @@ void RasterCache::SweepOneCacheAfterFrame(RasterCacheKey::Map<Entry>& cache,
   for (auto it = cache.begin(); it != cache.end(); ++it) {
     Entry& entry = it->second;
 
-    if (!entry.used_this_frame) {
+    if (entry.used_this_frame) {
+      entry.idle_frames = 0;
+    } else {
+      entry.idle_frames++;
+    }
+
+    // Entries without an image only hold the access count, which is
+    // meaningless once the content has not been seen for a frame.
+    if (!entry.image) {
+      if (entry.idle_frames > 0) {
+        dead.push_back(it);
+      }
+    } else if (entry.idle_frames > max_idle_frames_) {
       dead.push_back(it);
-    } else if (entry.image) {
-      RasterCacheKeyKind kind = it->first.kind();
-      switch (kind) {
-        case RasterCacheKeyKind::kPictureMetrics:
-          picture_metrics.in_use_count++;
-          picture_metrics.in_use_bytes += entry.image->image_bytes();
-          break;
-        case RasterCacheKeyKind::kLayerMetrics:
-          layer_metrics.in_use_count++;
-          layer_metrics.in_use_bytes += entry.image->image_bytes();
-          break;
+    } else {
+      RasterCacheMetrics& metrics =
+          it->first.kind() == RasterCacheKeyKind::kPictureMetrics
+              ? picture_metrics
+              : layer_metrics;
+      if (entry.used_this_frame) {
+        metrics.in_use_count++;
+        metrics.in_use_bytes += RetainedBytes(entry);
+      } else {
+        metrics.retained_count++;
+        metrics.retained_bytes += RetainedBytes(entry);
       }
     }
     entry.used_this_frame = false;
   }
 
   for (auto it : dead) {
-    if (it->second.image) {
-      RasterCacheKeyKind kind = it->first.kind();
-      switch (kind) {
-        case RasterCacheKeyKind::kPictureMetrics:
-          picture_metrics.eviction_count++;
-          picture_metrics.eviction_bytes += it->second.image->image_bytes();
-          break;
-        case RasterCacheKeyKind::kLayerMetrics:
-          layer_metrics.eviction_count++;
-          layer_metrics.eviction_bytes += it->second.image->image_bytes();
-          break;
-      }
-    }
+    RecordEviction(it->first, it->second, picture_metrics, layer_metrics);
     cache.erase(it);
   }
 }
 
 void RasterCache::CleanupAfterFrame() {
-  picture_metrics_ = {};
-  layer_metrics_ = {};
+  picture_metrics_ = pending_picture_evictions_;
+  layer_metrics_ = pending_layer_evictions_;
+  pending_picture_evictions_ = {};
+  pending_layer_evictions_ = {};
   SweepOneCacheAfterFrame(cache_, picture_metrics_, layer_metrics_);
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
+  if (!cache_.empty()) {
+    image_generation_++;
+  }
   cache_.clear();
   picture_metrics_ = {};
   layer_metrics_ = {};
+  pending_picture_evictions_ = {};
+  pending_layer_evictions_ = {};
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -557,6 +1013,11 @@ void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   Clear();
 }
 
+void RasterCache::SetRasterizationTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner) {
+  rasterization_task_runner_ = std::move(task_runner);
+}
+
 void RasterCache::TraceStatsToTimeline() const {
 #if !FLUTTER_RELEASE
   FML_TRACE_COUNTER(
@@ -586,7 +1047,7 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
   for (const auto& item : cache_) {
     if (item.first.kind() == RasterCacheKeyKind::kPictureMetrics &&
         item.second.image) {
-      picture_cache_bytes += item.second.image->image_bytes();
+      picture_cache_bytes += RetainedBytes(item.second);
     }
   }
   return picture_cache_bytes;
@@ -5,15 +5,21 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_complexity.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
 #include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -21,7 +27,19 @@ class SkColorSpace;
 
 namespace flutter {
 
-enum class RasterCacheLayerStrategy { kLayer, kLayerChildren };
+// How a layer is rendered into a raster cache entry.
+//
+// |kFilteredChildren| renders the layer like |kLayer|, but the entry is
+// keyed by the contents of the children of the layer and of its filter (see
+// |ContainerLayer::filter_content_id|) instead of the layer itself, so that
+// the entry survives a rebuilt layer with the same filter over rebuilt
+// children with the same display lists. Children other than
+// |DisplayListLayer|s are identified by their unique ids.
+enum class RasterCacheLayerStrategy {
+  kLayer,
+  kLayerChildren,
+  kFilteredChildren
+};
 
 class RasterCacheResult {
  public:
@@ -50,6 +68,8 @@ class RasterCacheResult {
 class Layer;
 struct PrerollContext;
 
+// The byte counts include the display lists that the entries retain along
+// with their images.
 struct RasterCacheMetrics {
   /**
    * The number of cache entries with images evicted in this frame.
@@ -71,19 +91,34 @@ struct RasterCacheMetrics {
    */
   size_t in_use_bytes = 0;
 
+  /**
+   * The number of cache entries with images that were not used in this
+   * frame but are retained in case they are used again in a later frame.
+   */
+  size_t retained_count = 0;
+
+  /**
+   * The size of all of the images retained without being used in this frame.
+   */
+  size_t retained_bytes = 0;
+
   /**
    * The total cache entries that had images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, retained for later frames, or held memory
+   * during the frame and then were evicted.
    */
-  size_t total_count() const { return in_use_count + eviction_count; }
+  size_t total_count() const {
+    return in_use_count + retained_count + eviction_count;
+  }
 
   /**
    * The size of all of the cached images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, retained for later frames, or held memory
+   * during the frame and then were evicted.
    */
-  size_t total_bytes() const { return in_use_bytes + eviction_bytes; }
+  size_t total_bytes() const {
+    return in_use_bytes + retained_bytes + eviction_bytes;
+  }
 };
 
 class RasterCache {
@@ -94,9 +129,20 @@ class RasterCache {
   // the work across multiple frames.
   static constexpr int kDefaultPictureAndDispLayListCacheLimitPerFrame = 3;
 
+  // The default limit on the total size of the cached images. Entries are
+  // not admitted to the cache if they would take it over this limit.
+  static constexpr size_t kDefaultMaxCacheBytes = 64 * 1024 * 1024;
+
+  // The default number of consecutive frames in which a cached image may go
+  // unused before it is evicted. Retaining images for a few frames avoids
+  // rasterizing them again when content briefly goes out of view.
+  static constexpr size_t kDefaultMaxIdleFrames = 3;
+
   explicit RasterCache(size_t access_threshold = 3,
                        size_t picture_and_display_list_cache_limit_per_frame =
-                           kDefaultPictureAndDispLayListCacheLimitPerFrame);
+                           kDefaultPictureAndDispLayListCacheLimitPerFrame,
+                       size_t max_cache_bytes = kDefaultMaxCacheBytes,
+                       size_t max_idle_frames = kDefaultMaxIdleFrames);
 
   virtual ~RasterCache() = default;
 
@@ -186,6 +232,9 @@ class RasterCache {
   // 2. The picture is not worth rasterizing
   // 3. The matrix is singular
   // 4. The picture is accessed too few times
+  // 5. There is no room for the picture in the cache, see |MakeRoomFor|
+  // 6. The picture is being rasterized on a worker thread, see
+  //    |SetRasterizationTaskRunner|
   bool Prepare(PrerollContext* context,
                SkPicture* picture,
                bool is_complex,
@@ -203,19 +252,47 @@ class RasterCache {
   // used for this frame in order to not get evicted. This is needed during
   // partial repaint for layers that are outside of current clip and are culled
   // away.
-  void Touch(SkPicture* picture, const SkMatrix& transformation_matrix);
-  void Touch(DisplayList* display_list, const SkMatrix& transformation_matrix);
+  //
+  // Pictures and display lists take the same arguments as in |Prepare| so
+  // that |context| can be told whether they would be cached once they are
+  // prepared, see |PrerollContext::raster_cache_entries_pending|.
+  void Touch(PrerollContext* context,
+             SkPicture* picture,
+             bool is_complex,
+             bool will_change,
+             const SkMatrix& untranslated_matrix,
+             const SkPoint& offset = SkPoint());
+  void Touch(PrerollContext* context,
+             DisplayList* display_list,
+             bool is_complex,
+             bool will_change,
+             const SkMatrix& untranslated_matrix,
+             const SkPoint& offset = SkPoint());
   void Touch(
+      PrerollContext* context,
       Layer* layer,
       const SkMatrix& ctm,
       RasterCacheLayerStrategy strategey = RasterCacheLayerStrategy::kLayer);
 
+  // Marks the entries of |keys|, which were collected while a subtree was
+  // prerolled (see |PrerollContext::raster_cache_keys|), as used in this
+  // frame when the Preroll of the subtree is reused. Returns false if any
+  // of them no longer has an image, in which case the subtree should be
+  // prerolled again.
+  bool TouchPrerolledEntries(const std::vector<RasterCacheKey>& keys);
+
   void Prepare(
       PrerollContext* context,
       Layer* layer,
       const SkMatrix& ctm,
       RasterCacheLayerStrategy strategey = RasterCacheLayerStrategy::kLayer);
 
+  // Whether the layer has a rasterized image in the cache for |ctm|, so that
+  // it will be drawn from the cache in this frame.
+  bool HasImage(const Layer* layer,
+                const SkMatrix& ctm,
+                RasterCacheLayerStrategy strategy) const;
+
   // Find the raster cache for the picture and draw it to the canvas.
   //
   // Return true if it's found and drawn.
@@ -242,6 +319,20 @@ class RasterCache {
       RasterCacheLayerStrategy strategey = RasterCacheLayerStrategy::kLayer,
       const SkPaint* paint = nullptr) const;
 
+  // Incremented whenever an image is removed from the cache. Recordings
+  // that draw cached images, such as the retained paint of a layer, are
+  // only replayed while the generation is unchanged so that they never
+  // keep images alive after the cache has let go of them.
+  uint64_t image_generation() const { return image_generation_; }
+
+  // Collects the keys of the entries that |Draw| draws from the cache into
+  // |keys| until it is called again with null.
+  void CollectDrawnKeys(std::vector<RasterCacheKey>* keys) const;
+
+  // Marks the entries of |keys| as used in this frame, as if they were
+  // drawn again, when a recording that drew them is replayed.
+  void MarkDrawn(const std::vector<RasterCacheKey>& keys) const;
+
   void PrepareNewFrame();
   void CleanupAfterFrame();
 
@@ -249,6 +340,17 @@ class RasterCache {
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  // Moves the rasterization of pictures and display lists for software
+  // frames to the workers of |task_runner|, or back to the raster thread if
+  // |task_runner| is null.
+  //
+  // The frame in which a picture or display list is first cached does not
+  // wait for it to be rasterized. It is drawn directly until a later frame
+  // finds that the image is ready. Layers are always rasterized during
+  // preroll as they can only be painted while their layer tree is alive.
+  void SetRasterizationTaskRunner(
+      std::shared_ptr<fml::BasicTaskRunner> task_runner);
+
   const RasterCacheMetrics& picture_metrics() const { return picture_metrics_; }
   const RasterCacheMetrics& layer_metrics() const { return layer_metrics_; }
 
@@ -272,9 +374,10 @@ class RasterCache {
    * bytes, including cache entries in the SkPicture cache and the DisplayList
    * cache.
    *
-   * Only SkImage's memory usage is counted as other objects are often much
-   * smaller compared to SkImage. SkImageInfo::computeMinByteSize is used to
-   * estimate the SkImage memory usage.
+   * The SkImage's memory usage is estimated with
+   * SkImageInfo::computeMinByteSize. The DisplayLists that the entries retain
+   * to verify content hash matches are counted as well, other objects are
+   * often much smaller compared to SkImage.
    */
   size_t EstimatePictureCacheByteSize() const;
 
@@ -298,14 +401,119 @@ class RasterCache {
    */
   int access_threshold() const { return access_threshold_; }
 
+  size_t max_cache_bytes() const { return max_cache_bytes_; }
+
+  size_t max_idle_frames() const { return max_idle_frames_; }
+
  private:
+  // An image that is being rasterized on a worker thread. It is shared with
+  // the worker task so that the entry may be evicted, or the cache
+  // destroyed, before the task finishes.
+  struct PendingImage {
+    explicit PendingImage(size_t bytes) : bytes(bytes) {}
+
+    // The estimated size of the image, which is reserved in the cache
+    // while it is being rasterized.
+    const size_t bytes;
+
+    std::mutex mutex;
+    bool done = false;
+    std::unique_ptr<RasterCacheResult> image;
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The number of consecutive frames, up to the last one, in which the
+    // entry was not used.
+    size_t idle_frames = 0;
+    // The complexity score of the content, as an estimate of the cost of
+    // rasterizing it again, or 0 if there is no estimate.
+    unsigned int cost = 0;
     std::unique_ptr<RasterCacheResult> image;
+    // Set while the image is being rasterized on a worker thread.
+    std::shared_ptr<PendingImage> pending;
+    // The display list of an entry keyed by content hash. The hash covers
+    // the addresses of the images and filters the list references, which
+    // this reference keeps alive so that other objects can't reuse them.
+    sk_sp<DisplayList> display_list;
+    // The contents that the key of a |kFilteredLayerChildren| entry was
+    // computed from, which confirm that a matching key was computed from
+    // equal contents: the serialized filter and the display lists of the
+    // |DisplayListLayer| children, in order.
+    sk_sp<SkData> filter_data;
+    std::vector<sk_sp<DisplayList>> child_display_lists;
   };
 
-  void Touch(const RasterCacheKey& cache_key);
+  // Returns the entry of |cache_key| if it was created for a display list
+  // equal to |display_list|, since different lists may have the same
+  // content hash.
+  Entry* FindDisplayListEntry(const RasterCacheKey& cache_key,
+                              const DisplayList& display_list) const;
+
+  // Returns the entry of |cache_key| if it was created for |layer|. The
+  // contents of an entry of filtered children are compared with those of
+  // |layer|, since different contents may have the same key.
+  Entry* FindLayerEntry(const RasterCacheKey& cache_key,
+                        const Layer* layer,
+                        RasterCacheLayerStrategy strategy) const;
+
+  // Returns true if the display list |retained| by an entry is equal to
+  // |display_list|. An equal list of another instance replaces |retained|, so
+  // the lists are compared once per frame rather than on each of the
+  // Prepare, Touch and Draw calls of a list that is rebuilt every frame.
+  static bool MatchDisplayList(sk_sp<DisplayList>& retained,
+                               const DisplayList& display_list);
+
+  // Returns true if the filter and the display list children of |layer| are
+  // equal to those retained by |entry|, see |MatchDisplayList|.
+  static bool MatchFilteredChildren(Entry& entry, const Layer* layer);
+
+  // Retains the filter and the display list children of |layer| in |entry|.
+  static void RetainFilteredChildren(Entry& entry, const Layer* layer);
+
+  // The memory held by |entry|, which is the size of its image plus the size
+  // of the contents it retains.
+  static size_t RetainedBytes(const Entry& entry);
+
+  // Moves the image of the entry out of its |pending| rasterization if the
+  // rasterization has finished.
+  static void CollectPendingImage(Entry& entry);
+
+  // Whether images for the frame of |context| are rasterized on workers.
+  // Images for GPU surfaces must be created on the thread that owns the
+  // GrDirectContext.
+  bool ShouldRasterizeOnWorker(const PrerollContext* context) const;
+
+  // Runs |rasterize| on the rasterization task runner and returns the
+  // state that receives its result.
+  std::shared_ptr<PendingImage> RasterizeOnWorker(
+      size_t bytes,
+      std::function<std::unique_ptr<RasterCacheResult>()> rasterize);
+
+  // How much is lost by evicting an idle entry. Expensive entries are
+  // kept longer, but the value of every entry decays while it is unused.
+  static double RetentionValue(const Entry& entry) {
+    return static_cast<double>(entry.cost) / (entry.idle_frames + 1);
+  }
+
+  // Returns true if an image of |bytes| fits in the cache, evicting idle
+  // entries whose retention value is lower than |cost| to make room for it
+  // if necessary. Entries that were used in the current frame are never
+  // evicted to make room, and nothing is evicted if the image would not
+  // fit anyway.
+  bool MakeRoomFor(size_t bytes, unsigned int cost);
+
+  void RecordEviction(const RasterCacheKey& key,
+                      const Entry& entry,
+                      RasterCacheMetrics& picture_metrics,
+                      RasterCacheMetrics& layer_metrics);
+
+  // Adds |cache_key| to |PrerollContext::raster_cache_keys| and sets
+  // |PrerollContext::raster_cache_entries_pending| if |entry| has no image.
+  static void RecordPrerolledEntry(PrerollContext* context,
+                                   const RasterCacheKey& cache_key,
+                                   const Entry& entry);
 
   bool Draw(const RasterCacheKey& cache_key,
             SkCanvas& canvas,
@@ -333,12 +541,25 @@ class RasterCache {
 
   const size_t access_threshold_;
   const size_t picture_and_display_list_cache_limit_per_frame_;
+  const size_t max_cache_bytes_;
+  const size_t max_idle_frames_;
   size_t picture_cached_this_frame_ = 0;
   size_t display_list_cached_this_frame_ = 0;
   RasterCacheMetrics layer_metrics_;
   RasterCacheMetrics picture_metrics_;
+  // The entries evicted by |MakeRoomFor| during the current frame, which
+  // are added to the metrics of the frame when it ends.
+  RasterCacheMetrics pending_layer_evictions_;
+  RasterCacheMetrics pending_picture_evictions_;
+  // Serializes Prepare, Touch and HasImage, which may be called concurrently
+  // when layers are prerolled in parallel, see |PrerollContext|.
+  mutable std::mutex preroll_mutex_;
   mutable RasterCacheKey::Map<Entry> cache_;
+  // Read concurrently when layers are prerolled in parallel.
+  std::atomic<uint64_t> image_generation_{0};
+  mutable std::vector<RasterCacheKey>* drawn_keys_ = nullptr;
   bool checkerboard_images_;
+  std::shared_ptr<fml::BasicTaskRunner> rasterization_task_runner_;
 
   void TraceStatsToTimeline() const;
 
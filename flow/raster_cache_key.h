@@ -45,7 +45,8 @@ enum class RasterCacheKeyType {
   kLayer,
   kPicture,
   kDisplayList,
-  kLayerChildren
+  kLayerChildren,
+  kFilteredLayerChildren
 };
 
 enum class RasterCacheKeyKind { kLayerMetrics, kPictureMetrics };
@@ -74,6 +75,7 @@ class RasterCacheKey {
         return RasterCacheKeyKind::kPictureMetrics;
       case RasterCacheKeyType::kLayer:
       case RasterCacheKeyType::kLayerChildren:
+      case RasterCacheKeyType::kFilteredLayerChildren:
         return RasterCacheKeyKind::kLayerMetrics;
     }
   }
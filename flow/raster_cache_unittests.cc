@@ -2,16 +2,20 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_test_utils.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/testing/mock_raster_cache.h"
+#include "flutter/fml/task_runner.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 namespace testing {
@@ -141,6 +145,122 @@ TEST(RasterCache, ThresholdIsRespectedForDisplayList) {
   ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
 }
 
+TEST(RasterCache, EqualDisplayListsShareCacheEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+  auto equal_display_list = GetSampleDisplayList();
+  ASSERT_NE(display_list->unique_id(), equal_display_list->unique_id());
+  ASSERT_EQ(display_list->content_hash(), equal_display_list->content_hash());
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  // The equal list finds the entry created by the first list.
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            equal_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*equal_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, EqualDisplayListReplacesTheListOfTheEntry) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+  auto equal_display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  ASSERT_FALSE(display_list->unique());
+  cache.CleanupAfterFrame();
+
+  // Once the equal list has been compared in Prepare, the entry holds it so
+  // that the Draw of the frame finds the entry without comparing the lists.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            equal_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(display_list->unique());
+  ASSERT_FALSE(equal_display_list->unique());
+  ASSERT_TRUE(cache.Draw(*equal_display_list, dummy_canvas));
+}
+
+TEST(RasterCache, MetricsCountTheRetainedDisplayLists) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // 150w * 100h * 4bpp, plus the list itself.
+  size_t expected_bytes = 60000u + display_list->bytes();
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), expected_bytes);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), expected_bytes);
+}
+
+TEST(RasterCache, DisplayListEntriesKeepTheImagesOfTheirListsAlive) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto surface = SkSurface::MakeRasterN32Premul(10, 10);
+  auto image = DlImage::Make(surface->makeImageSnapshot());
+  DisplayListBuilder builder;
+  builder.drawImage(image, SkPoint::Make(0, 0), SkSamplingOptions(), false);
+  auto display_list = builder.Build();
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));
+
+  // The content hash covers the address of the image, which must not be
+  // reused by another image while the entry exists.
+  display_list.reset();
+  ASSERT_FALSE(image->unique());
+
+  cache.Clear();
+  ASSERT_TRUE(image->unique());
+}
+
 TEST(RasterCache, AccessThresholdOfZeroDisablesCachingForSkPicture) {
   size_t threshold = 0;
   flutter::RasterCache cache(threshold);
@@ -248,8 +368,11 @@ TEST(RasterCache, SweepsRemoveUnusedSkPictures) {
 
   cache.CleanupAfterFrame();
 
-  cache.PrepareNewFrame();
-  cache.CleanupAfterFrame();  // Extra frame without a Get image access.
+  // Extra frames without a Get image access.
+  for (size_t i = 0; i <= RasterCache::kDefaultMaxIdleFrames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
 
   cache.PrepareNewFrame();
 
@@ -283,9 +406,299 @@ TEST(RasterCache, SweepsRemoveUnusedDisplayLists) {
 
   cache.CleanupAfterFrame();
 
+  // Extra frames without a Get image access.
+  for (size_t i = 0; i <= RasterCache::kDefaultMaxIdleFrames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
+
   cache.PrepareNewFrame();
-  cache.CleanupAfterFrame();  // Extra frame without a Get image access.
 
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, SweepsRetainIdleDisplayListsForMaxIdleFrames) {
+  size_t threshold = 1;
+  size_t max_idle_frames = 2;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      RasterCache::kDefaultMaxCacheBytes, max_idle_frames);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 1
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));  // 2
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 0u);
+
+  // Frames without a Get image access.
+  for (size_t i = 0; i < max_idle_frames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+    ASSERT_EQ(cache.picture_metrics().in_use_count, 0u);
+    ASSERT_EQ(cache.picture_metrics().retained_count, 1u);
+    ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+  }
+
+  // The image is still cached.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  for (size_t i = 0; i <= max_idle_frames; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().retained_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, DisplayListLargerThanMaxCacheBytesIsNotCached) {
+  size_t threshold = 1;
+  // The sample display list rasterizes to a 150x100 N32 image.
+  size_t max_cache_bytes = 150 * 100 * 4 - 1;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      max_cache_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList(10);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 1
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 2
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, ExpensiveDisplayListEvictsIdleCheapDisplayList) {
+  size_t threshold = 1;
+  // Room for only one of the 150x100 sample display lists.
+  size_t max_cache_bytes = 100000;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      max_cache_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto cheap_display_list = GetSampleDisplayList(1);
+  auto expensive_display_list = GetSampleDisplayList(100);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             cheap_display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*cheap_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            cheap_display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*cheap_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             expensive_display_list.get(), true, false,
+                             matrix));
+  ASSERT_FALSE(cache.Draw(*expensive_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  // The cheap display list is idle and is evicted to make room.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            expensive_display_list.get(), true, false,
+                            matrix));
+  ASSERT_TRUE(cache.Draw(*expensive_display_list, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*cheap_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+}
+
+TEST(RasterCache, CheapDisplayListDoesNotEvictIdleExpensiveDisplayList) {
+  size_t threshold = 1;
+  // Room for only one of the 150x100 sample display lists.
+  size_t max_cache_bytes = 100000;
+  flutter::RasterCache cache(
+      threshold, RasterCache::kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      max_cache_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto cheap_display_list = GetSampleDisplayList(1);
+  auto expensive_display_list = GetSampleDisplayList(100);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             expensive_display_list.get(), true, false,
+                             matrix));
+  ASSERT_FALSE(cache.Draw(*expensive_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            expensive_display_list.get(), true, false,
+                            matrix));
+  ASSERT_TRUE(cache.Draw(*expensive_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             cheap_display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*cheap_display_list, dummy_canvas));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             cheap_display_list.get(), true, false, matrix));
+  ASSERT_FALSE(cache.Draw(*cheap_display_list, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*expensive_display_list, dummy_canvas));
+}
+
+namespace {
+
+// Holds the posted tasks until the test runs them.
+class ManualTaskRunner : public fml::BasicTaskRunner {
+ public:
+  void PostTask(const fml::closure& task) override { tasks_.push_back(task); }
+
+  size_t task_count() const { return tasks_.size(); }
+
+  void RunTasks() {
+    auto tasks = std::move(tasks_);
+    tasks_.clear();
+    for (auto& task : tasks) {
+      task();
+    }
+  }
+
+ private:
+  std::vector<fml::closure> tasks_;
+};
+
+}  // namespace
+
+TEST(RasterCache, DisplayListIsRasterizedOnWorkerWhenTaskRunnerIsSet) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto task_runner = std::make_shared<ManualTaskRunner>();
+  cache.SetRasterizationTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 1
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  ASSERT_EQ(task_runner->task_count(), 0u);
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  // The frame does not wait for the image.
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 2
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  ASSERT_EQ(task_runner->task_count(), 1u);
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  // Still being rasterized.
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 3
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+  ASSERT_EQ(task_runner->task_count(), 1u);
+
+  cache.CleanupAfterFrame();
+  task_runner->RunTasks();
+  cache.PrepareNewFrame();
+
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));  // 4
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+  ASSERT_EQ(task_runner->task_count(), 0u);
+}
+
+TEST(RasterCache, WorkerRasterizationOutlivesEvictedEntry) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto task_runner = std::make_shared<ManualTaskRunner>();
+  cache.SetRasterizationTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 1
+  ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                             display_list.get(), true, false, matrix));  // 2
+  ASSERT_EQ(task_runner->task_count(), 1u);
+
+  // The display list is not drawn, so the entry is evicted.
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.GetCachedEntriesCount(), 0u);
+
+  task_runner->RunTasks();
   cache.PrepareNewFrame();
 
   ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
@@ -4,85 +4,193 @@
 
 #include "rtree.h"
 
-#include <list>
+#include <algorithm>
+#include <cmath>
 
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
 
 namespace flutter {
 
-RTree::RTree() : bbh_{SkRTreeFactory{}()}, all_ops_count_(0) {}
+// Each level of the tree has at most 1/8th of the nodes of the level below,
+// so 12 levels are enough for the 2^31 operations that can be inserted.
+static constexpr size_t kMaxDepth = 12;
+
+RTree::RTree() : all_ops_count_(0) {}
 
 void RTree::insert(const SkRect boundsArray[],
                    const SkBBoxHierarchy::Metadata metadata[],
                    int N) {
   FML_DCHECK(0 == all_ops_count_);
-  bbh_->insert(boundsArray, metadata, N);
+  draw_op_bounds_.assign(N, SkRect::MakeEmpty());
+  std::vector<Item> items;
+  items.reserve(N);
   for (int i = 0; i < N; i++) {
+    SkRect bounds = boundsArray[i];
+    bounds.sort();
+    // Like SkRTree, operations with empty bounds are never found.
+    if (bounds.isEmpty()) {
+      continue;
+    }
+    items.push_back({bounds, static_cast<uint32_t>(i)});
     if (metadata != nullptr && metadata[i].isDraw) {
-      draw_op_[i] = boundsArray[i];
+      draw_op_bounds_[i] = bounds;
     }
   }
+
   all_ops_count_ = N;
+  if (items.empty()) {
+    return;
+  }
+
+  nodes_.reserve(items.size() / (kMaxChildren - 1) + kMaxDepth);
+  bool is_leaf = true;
+  do {
+    PackLevel(items, is_leaf);
+    is_leaf = false;
+  } while (items.size() > 1);
 }
 
 void RTree::insert(const SkRect boundsArray[], int N) {
   insert(boundsArray, nullptr, N);
 }
 
-void RTree::search(const SkRect& query, std::vector<int>* results) const {
-  bbh_->search(query, results);
+void RTree::PackLevel(std::vector<Item>& items, bool is_leaf) {
+  // Sort-Tile-Recursive: the items are sorted into vertical slices of
+  // |slice_size| items by their centers, and the items of each slice are
+  // sorted from top to bottom, so that consecutive items are close to each
+  // other.
+  size_t node_count = (items.size() + kMaxChildren - 1) / kMaxChildren;
+  size_t slice_count = std::ceil(std::sqrt(node_count));
+  size_t slice_size = slice_count * kMaxChildren;
+  std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+    return a.bounds.centerX() < b.bounds.centerX();
+  });
+  for (size_t start = 0; start < items.size(); start += slice_size) {
+    auto end = items.begin() + std::min(start + slice_size, items.size());
+    std::sort(items.begin() + start, end, [](const Item& a, const Item& b) {
+      return a.bounds.centerY() < b.bounds.centerY();
+    });
+  }
+
+  std::vector<Item> parents;
+  parents.reserve(node_count);
+  for (size_t start = 0; start < items.size(); start += kMaxChildren) {
+    Node node;
+    node.is_leaf = is_leaf;
+    SkRect bounds = items[start].bounds;
+    for (size_t i = 0; i < kMaxChildren; i++) {
+      if (start + i < items.size()) {
+        const Item& item = items[start + i];
+        node.left[i] = item.bounds.fLeft;
+        node.top[i] = item.bounds.fTop;
+        node.right[i] = item.bounds.fRight;
+        node.bottom[i] = item.bounds.fBottom;
+        node.children[i] = item.index;
+        bounds.join(item.bounds);
+      } else {
+        // Empty slots have bounds that never intersect a query.
+        node.left[i] = node.top[i] = SK_ScalarInfinity;
+        node.right[i] = node.bottom[i] = SK_ScalarNegativeInfinity;
+        node.children[i] = 0;
+      }
+    }
+    parents.push_back({bounds, static_cast<uint32_t>(nodes_.size())});
+    nodes_.push_back(node);
+  }
+  items = std::move(parents);
 }
 
-std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
-    const SkRect& query) const {
-  // Get the indexes for the operations that intersect with the query rect.
-  std::vector<int> intermediary_results;
-  search(query, &intermediary_results);
+template <typename Visitor>
+void RTree::Visit(const SkRect& query, Visitor&& visitor) const {
+  if (nodes_.empty() || query.isEmpty()) {
+    return;
+  }
 
-  std::list<SkRect> final_results;
-  for (int index : intermediary_results) {
-    auto draw_op = draw_op_.find(index);
-    // Ignore records that don't draw anything.
-    if (draw_op == draw_op_.end()) {
-      continue;
+  // Each node that is visited adds at most kMaxChildren - 1 nodes to the
+  // stack.
+  uint32_t stack[kMaxChildren * kMaxDepth];
+  size_t stack_size = 0;
+  stack[stack_size++] = nodes_.size() - 1;
+  while (stack_size > 0) {
+    const Node& node = nodes_[stack[--stack_size]];
+    // Without branches, so that the compiler tests all of the children at
+    // once with SIMD instructions.
+    unsigned int hits = 0;
+    for (size_t i = 0; i < kMaxChildren; i++) {
+      unsigned int hit = (query.fLeft < node.right[i]) &
+                         (node.left[i] < query.fRight) &
+                         (query.fTop < node.bottom[i]) &
+                         (node.top[i] < query.fBottom);
+      hits |= hit << i;
     }
-    auto current_record_rect = draw_op->second;
-    auto replaced_existing_rect = false;
-    // // If the current record rect intersects with any of the rects in the
-    // // result list, then join them, and update the rect in final_results.
-    std::list<SkRect>::iterator curr_rect_itr = final_results.begin();
-    std::list<SkRect>::iterator first_intersecting_rect_itr;
-    while (!replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, current_record_rect)) {
-        replaced_existing_rect = true;
-        first_intersecting_rect_itr = curr_rect_itr;
-        curr_rect_itr->join(current_record_rect);
+    for (size_t i = 0; hits != 0; i++, hits >>= 1) {
+      if ((hits & 1) == 0) {
+        continue;
       }
-      curr_rect_itr++;
-    }
-    // It's possible that the result contains duplicated rects at this point.
-    // For example, consider a result list that contains rects A, B. If a
-    // new rect C is a superset of A and B, then A and B are the same set after
-    // the merge. As a result, find such cases and remove them from the result
-    // list.
-    while (replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, *first_intersecting_rect_itr)) {
-        first_intersecting_rect_itr->join(*curr_rect_itr);
-        curr_rect_itr = final_results.erase(curr_rect_itr);
+      if (node.is_leaf) {
+        visitor(node.children[i]);
       } else {
-        curr_rect_itr++;
+        FML_DCHECK(stack_size < kMaxChildren * kMaxDepth);
+        stack[stack_size++] = node.children[i];
       }
     }
-    if (!replaced_existing_rect) {
-      final_results.push_back(current_record_rect);
-    }
   }
-  return final_results;
+}
+
+void RTree::search(const SkRect& query, std::vector<int>* results) const {
+  size_t first_result = results->size();
+  Visit(query, [results](uint32_t index) { results->push_back(index); });
+
+  // The tree is not in draw order, but SkPicture playback draws the
+  // operations in the order they are found.
+  std::sort(results->begin() + first_result, results->end());
+}
+
+void RTree::searchNonOverlappingDrawnRects(
+    const SkRect& query,
+    std::vector<SkRect>* results) const {
+  results->clear();
+
+  Visit(query, [this, results](uint32_t index) {
+    SkRect joined = draw_op_bounds_[index];
+    // Ignore records that don't draw anything.
+    if (joined.isEmpty()) {
+      return;
+    }
+    // The rects in |results| don't intersect with each other. The rects
+    // that intersect with the current record rect are joined with it and
+    // removed, until the joined rect, which may have grown into other
+    // rects, intersects with none of the remaining ones.
+    bool joined_any;
+    do {
+      joined_any = false;
+      auto kept = results->begin();
+      for (auto it = results->begin(); it != results->end(); ++it) {
+        if (SkRect::Intersects(*it, joined)) {
+          joined.join(*it);
+          joined_any = true;
+        } else {
+          *kept++ = *it;
+        }
+      }
+      results->erase(kept, results->end());
+    } while (joined_any);
+    results->push_back(joined);
+  });
+
+  // The joined rects don't depend on the order in which the tree is
+  // visited, but the order of the list does, so it is sorted from top to
+  // bottom and left to right.
+  std::sort(results->begin(), results->end(),
+            [](const SkRect& a, const SkRect& b) {
+              return a.fTop < b.fTop || (a.fTop == b.fTop && a.fLeft < b.fLeft);
+            });
 }
 
 size_t RTree::bytesUsed() const {
-  return bbh_->bytesUsed();
+  return sizeof(*this) + nodes_.capacity() * sizeof(Node) +
+         draw_op_bounds_.capacity() * sizeof(SkRect);
 }
 
 RTreeFactory::RTreeFactory() {
@@ -5,15 +5,20 @@
 #ifndef FLUTTER_FLOW_RTREE_H_
 #define FLUTTER_FLOW_RTREE_H_
 
-#include <list>
-#include <map>
+#include <cstdint>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
 namespace flutter {
 /**
- * An R-Tree implementation that forwards calls to an SkRTree.
+ * A packed R-Tree of the operations recorded in an SkPicture.
+ *
+ * The tree is bulk loaded with the Sort-Tile-Recursive algorithm when the
+ * picture is finished, and stored in a single array of nodes. Each node
+ * stores the bounds of its children by coordinate, so that a query is
+ * tested against all of them at once.
  *
  * This implementation provides a searchNonOverlappingDrawnRects method,
  * which can be used to query the rects for the operations recorded in the tree.
@@ -30,21 +35,52 @@ class RTree : public SkBBoxHierarchy {
   size_t bytesUsed() const override;
 
   // Finds the rects in the tree that represent drawing operations and intersect
-  // with the query rect.
+  // with the query rect, and replaces the contents of |results| with them.
   //
   // When two rects intersect with each other, they are joined into a single
   // rect which also intersects with the query rect. In other words, the bounds
-  // of each rect in the result list are mutually exclusive.
-  std::list<SkRect> searchNonOverlappingDrawnRects(const SkRect& query) const;
+  // of each rect in the result list are mutually exclusive. The rects are
+  // sorted from top to bottom, then from left to right.
+  void searchNonOverlappingDrawnRects(const SkRect& query,
+                                      std::vector<SkRect>* results) const;
 
   // Insertion count (not overall node count, which may be greater).
   int getCount() const { return all_ops_count_; }
 
  private:
-  // A map containing the draw operation rects keyed off the operation index
-  // in the insert call.
-  std::map<int, SkRect> draw_op_;
-  sk_sp<SkBBoxHierarchy> bbh_;
+  static constexpr size_t kMaxChildren = 8;
+
+  struct Node {
+    float left[kMaxChildren];
+    float top[kMaxChildren];
+    float right[kMaxChildren];
+    float bottom[kMaxChildren];
+    // The indices of the child nodes, or of the operations if this is a
+    // leaf node.
+    uint32_t children[kMaxChildren];
+    bool is_leaf;
+  };
+
+  // An operation or node to be packed into the next level of the tree.
+  struct Item {
+    SkRect bounds;
+    uint32_t index;
+  };
+
+  // Calls |visitor| with the index of each operation whose bounds intersect
+  // with |query|, in the order of the tree.
+  template <typename Visitor>
+  void Visit(const SkRect& query, Visitor&& visitor) const;
+
+  // Packs |items| into leaf nodes, or into nodes of the nodes they index,
+  // and replaces them with the new nodes.
+  void PackLevel(std::vector<Item>& items, bool is_leaf);
+
+  // The bounds of the draw operations keyed off the operation index in the
+  // insert call. The bounds of the other operations are empty.
+  std::vector<SkRect> draw_op_bounds_;
+  // The nodes of the tree, with the root last.
+  std::vector<Node> nodes_;
   int all_ops_count_;
 };
 
@@ -26,8 +26,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsNoIntersection) {
   recording_canvas->drawRect(SkRect::MakeLTRB(20, 20, 40, 40), rect_paint);
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(40, 40, 80, 80));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(40, 40, 80, 80), &hits);
   ASSERT_TRUE(hits.empty());
 }
 
@@ -47,8 +48,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsSingleRectIntersection) {
 
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(140, 140, 150, 150));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(140, 140, 150, 150), &hits);
   ASSERT_EQ(1UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(120, 120, 160, 160));
 }
@@ -75,8 +77,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsIgnoresNonDrawingRecords) {
   // The rtree has a translate, a clip and a rect record.
   ASSERT_EQ(3, rtree_factory.getInstance()->getCount());
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(0, 0, 1000, 1000));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1000), &hits);
   ASSERT_EQ(1UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(120, 120, 180, 180));
 }
@@ -105,8 +108,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsMultipleRectIntersection) {
 
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(0, 0, 1000, 1050));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1050), &hits);
   ASSERT_EQ(2UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(100, 100, 200, 200));
   ASSERT_EQ(*std::next(hits.begin(), 1), SkRect::MakeLTRB(300, 100, 400, 200));
@@ -140,8 +144,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase1) {
 
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeXYWH(120, 120, 126, 126));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeXYWH(120, 120, 126, 126), &hits);
   ASSERT_EQ(1UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(100, 100, 175, 175));
 }
@@ -181,8 +186,9 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase2) {
 
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(30, 30, 550, 270));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(30, 30, 550, 270), &hits);
   ASSERT_EQ(1UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 500, 250));
 }
@@ -225,11 +231,96 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase3) {
 
   recorder->finishRecordingAsPicture();
 
-  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
-      SkRect::MakeLTRB(30, 30, 550, 270));
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(30, 30, 550, 270), &hits);
   ASSERT_EQ(1UL, hits.size());
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 620, 300));
 }
 
+TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase4) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Given the A, B, and C rects, where C only intersects with B, but the
+  // union of B and C intersects with A, the result list contains the rect
+  // resulting from the union of A, B, and C.
+  //
+  // +-----+         +-----+
+  // |  A  |         |     |
+  // |     |         |  B  |
+  // +-----+         |     |
+  //     +-----------|--+  |
+  //     |     C     |  |  |
+  //     +-----------|--+  |
+  //                 +-----+
+
+  // A
+  recording_canvas->drawRect(SkRect::MakeLTRB(0, 0, 50, 50), rect_paint);
+  // B
+  recording_canvas->drawRect(SkRect::MakeLTRB(100, 0, 150, 150), rect_paint);
+  // C
+  recording_canvas->drawRect(SkRect::MakeLTRB(40, 60, 110, 110), rect_paint);
+
+  recorder->finishRecordingAsPicture();
+
+  std::vector<SkRect> hits;
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1000), &hits);
+  ASSERT_EQ(1UL, hits.size());
+  ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(0, 0, 150, 150));
+}
+
+TEST(RTree, searchReturnsAllIntersectingOperationsInDrawOrder) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Enough rects for several levels of nodes, drawn in an order that is
+  // not spatially sorted.
+  std::vector<SkRect> rects;
+  for (int i = 0; i < 1000; i++) {
+    // Visits the cells of a 40x25 grid in a scattered order.
+    int cell = (i * 37) % 1000;
+    int x = cell % 40;
+    int y = cell / 40;
+    rects.push_back(SkRect::MakeXYWH(x * 10, y * 10, 15, 15));
+    recording_canvas->drawRect(rects.back(), rect_paint);
+  }
+
+  recorder->finishRecordingAsPicture();
+
+  auto query = SkRect::MakeLTRB(200, 100, 420, 190);
+  std::vector<int> expected;
+  for (size_t i = 0; i < rects.size(); i++) {
+    if (SkRect::Intersects(rects[i], query)) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  std::vector<int> hits;
+  rtree_factory.getInstance()->search(query, &hits);
+  ASSERT_EQ(hits, expected);
+
+  // The drawn rects are all joined, and any previous results are replaced.
+  std::vector<SkRect> rect_hits = {SkRect::MakeLTRB(0, 0, 1, 1)};
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(query,
+                                                              &rect_hits);
+  ASSERT_EQ(1UL, rect_hits.size());
+  ASSERT_EQ(rect_hits[0], SkRect::MakeLTRB(190, 90, 405, 195));
+}
+
 }  // namespace testing
 }  // namespace flutter
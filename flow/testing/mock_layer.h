@@ -38,6 +38,7 @@ class MockLayer : public Layer {
   const SkMatrix& parent_matrix() { return parent_matrix_; }
   const SkRect& parent_cull_rect() { return parent_cull_rect_; }
   bool parent_has_platform_view() { return parent_has_platform_view_; }
+  bool parent_has_active_save_layer() { return parent_has_active_save_layer_; }
 
   bool IsReplacing(DiffContext* context, const Layer* layer) const override;
   void Diff(DiffContext* context, const Layer* old_layer) override;
@@ -50,6 +51,7 @@ class MockLayer : public Layer {
   SkPath fake_paint_path_;
   SkPaint fake_paint_;
   bool parent_has_platform_view_ = false;
+  bool parent_has_active_save_layer_ = false;
   bool fake_has_platform_view_ = false;
   bool fake_reads_surface_ = false;
   bool fake_opacity_compatible_ = false;
@@ -52,9 +52,13 @@ class MockRasterCache : public RasterCache {
   explicit MockRasterCache(
       size_t access_threshold = 3,
       size_t picture_and_display_list_cache_limit_per_frame =
-          kDefaultPictureAndDispLayListCacheLimitPerFrame)
+          kDefaultPictureAndDispLayListCacheLimitPerFrame,
+      size_t max_cache_bytes = kDefaultMaxCacheBytes,
+      size_t max_idle_frames = kDefaultMaxIdleFrames)
       : RasterCache(access_threshold,
-                    picture_and_display_list_cache_limit_per_frame) {}
+                    picture_and_display_list_cache_limit_per_frame,
+                    max_cache_bytes,
+                    max_idle_frames) {}
 
   std::unique_ptr<RasterCacheResult> RasterizePicture(
       SkPicture* picture,
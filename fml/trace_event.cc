@@ -56,6 +56,10 @@ bool TraceHasTimelineEventHandler() {
       gTimelineEventHandler.load(std::memory_order_relaxed));
 }
 
+bool TraceEventEnabled(TraceArg category_group, TraceArg name) {
+  return TraceHasTimelineEventHandler() && gAllowlist.Query(name);
+}
+
 int64_t TraceGetTimelineMicros() {
   return gTimelineMicrosSource.load()();
 }
@@ -320,6 +324,10 @@ bool TraceHasTimelineEventHandler() {
   return false;
 }
 
+bool TraceEventEnabled(TraceArg category_group, TraceArg name) {
+  return false;
+}
+
 int64_t TraceGetTimelineMicros() {
   return -1;
 }
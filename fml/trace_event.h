@@ -22,6 +22,8 @@
 
 #define FML_TRACE_EVENT(a, b, args...) TRACE_DURATION(a, b)
 
+#define FML_TRACE_EVENT_ENABLED(a, b) TRACE_CATEGORY_ENABLED(a)
+
 #define TRACE_EVENT0(a, b) TRACE_DURATION(a, b)
 #define TRACE_EVENT1(a, b, c, d) TRACE_DURATION(a, b, c, d)
 #define TRACE_EVENT2(a, b, c, d, e, f) TRACE_DURATION(a, b, c, d, e, f)
@@ -70,6 +72,11 @@
   ::fml::tracing::TraceCounter((category_group), (name), (counter_id), (arg1), \
                                __VA_ARGS__);
 
+// Whether events named |name| would currently reach the timeline. Use it
+// to skip work that only computes the arguments of a trace event.
+#define FML_TRACE_EVENT_ENABLED(category_group, name) \
+  ::fml::tracing::TraceEventEnabled((category_group), (name))
+
 // Avoid using the same `name` and `argX_name` for nested traces, which can
 // lead to double free errors. E.g. the following code should be avoided:
 //
@@ -161,6 +168,8 @@ void TraceSetTimelineEventHandler(TimelineEventHandler handler);
 
 bool TraceHasTimelineEventHandler();
 
+bool TraceEventEnabled(TraceArg category_group, TraceArg name);
+
 void TraceSetTimelineMicrosSource(TimelineMicrosSource source);
 
 int64_t TraceGetTimelineMicros();
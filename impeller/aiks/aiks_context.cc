@@ -33,6 +33,10 @@ bool AiksContext::Render(const Picture& picture, RenderPass& parent_pass) {
     return false;
   }
 
+  // A picture is rendered per frame. The glyphs of the frames that are no
+  // longer in flight can be evicted from the glyph atlas.
+  content_context_->GetTextRenderContext().BeginFrame();
+
   if (picture.pass) {
     return picture.pass->Render(*content_context_, parent_pass);
   }
@@ -161,6 +161,7 @@ void DisplayListDispatcher::setColorSource(
 // |flutter::Dispatcher|
 void DisplayListDispatcher::setColorFilter(
     const flutter::DlColorFilter* filter) {
+  has_color_filter_ = filter != nullptr;
   // Needs https://github.com/flutter/flutter/issues/95434
   if (filter == nullptr) {
     // Reset everything
@@ -290,6 +291,7 @@ void DisplayListDispatcher::setMaskFilter(const flutter::DlMaskFilter* filter) {
 // |flutter::Dispatcher|
 void DisplayListDispatcher::setImageFilter(
     const flutter::DlImageFilter* filter) {
+  has_image_filter_ = filter != nullptr;
   UNIMPLEMENTED;
 }
 
@@ -530,6 +532,28 @@ void DisplayListDispatcher::drawRect(const SkRect& rect) {
   canvas_.DrawPath(std::move(path), paint_);
 }
 
+// |flutter::Dispatcher|
+void DisplayListDispatcher::drawRects(const SkRect rects[], uint32_t count) {
+  // Opaque solid fills produce the same pixels whether the rects are drawn
+  // one at a time or as a single path, so they are drawn as one path. A
+  // filter applies to each draw on its own, so it prevents the merge.
+  if (paint_.style == Paint::Style::kFill && paint_.color.alpha == 1.0 &&
+      !paint_.contents && !paint_.mask_blur.has_value() &&
+      paint_.blend_mode == Entity::BlendMode::kSourceOver &&
+      !has_color_filter_ && !has_image_filter_) {
+    PathBuilder builder;
+    for (uint32_t i = 0; i < count; i++) {
+      builder.AddRect(ToRect(rects[i]));
+    }
+    canvas_.DrawPath(builder.TakePath(), paint_);
+    return;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    canvas_.DrawPath(PathBuilder{}.AddRect(ToRect(rects[i])).TakePath(),
+                     paint_);
+  }
+}
+
 // |flutter::Dispatcher|
 void DisplayListDispatcher::drawOval(const SkRect& bounds) {
   auto path = PathBuilder{}.AddOval(ToRect(bounds)).TakePath();
@@ -657,6 +681,23 @@ void DisplayListDispatcher::drawImageRect(
   );
 }
 
+// |flutter::Dispatcher|
+void DisplayListDispatcher::drawImageRects(
+    const sk_sp<flutter::DlImage> image,
+    const SkRect rects[],
+    uint32_t count,
+    const SkSamplingOptions& sampling,
+    bool render_with_attributes,
+    SkCanvas::SrcRectConstraint constraint) {
+  // The image and sampler are shared by all of the draws in the batch.
+  auto impeller_image = std::make_shared<Image>(image->impeller_texture());
+  auto sampler = ToSamplerDescriptor(sampling);
+  for (uint32_t i = 0; i < count; i++) {
+    canvas_.DrawImageRect(impeller_image, ToRect(rects[i * 2]),
+                          ToRect(rects[i * 2 + 1]), paint_, sampler);
+  }
+}
+
 // |flutter::Dispatcher|
 void DisplayListDispatcher::drawImageNine(const sk_sp<flutter::DlImage> image,
                                           const SkIRect& center,
@@ -141,6 +141,9 @@ class DisplayListDispatcher final : public flutter::Dispatcher {
   // |flutter::Dispatcher|
   void drawRect(const SkRect& rect) override;
 
+  // |flutter::Dispatcher|
+  void drawRects(const SkRect rects[], uint32_t count) override;
+
   // |flutter::Dispatcher|
   void drawOval(const SkRect& bounds) override;
 
@@ -189,6 +192,14 @@ class DisplayListDispatcher final : public flutter::Dispatcher {
                      bool render_with_attributes,
                      SkCanvas::SrcRectConstraint constraint) override;
 
+  // |flutter::Dispatcher|
+  void drawImageRects(const sk_sp<flutter::DlImage> image,
+                      const SkRect rects[],
+                      uint32_t count,
+                      const SkSamplingOptions& sampling,
+                      bool render_with_attributes,
+                      SkCanvas::SrcRectConstraint constraint) override;
+
   // |flutter::Dispatcher|
   void drawImageNine(const sk_sp<flutter::DlImage> image,
                      const SkIRect& center,
@@ -237,6 +248,10 @@ class DisplayListDispatcher final : public flutter::Dispatcher {
  private:
   Paint paint_;
   Canvas canvas_;
+  // The filters are not applied to |paint_| yet, but they still decide
+  // whether draws may be merged.
+  bool has_color_filter_ = false;
+  bool has_image_filter_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(DisplayListDispatcher);
 };
@@ -8,9 +8,11 @@
 #include "third_party/skia/include/core/SkPathBuilder.h"
 
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_image_filter.h"
 #include "flutter/display_list/display_list_mask_filter.h"
 #include "flutter/display_list/types.h"
 #include "flutter/testing/testing.h"
+#include "impeller/display_list/display_list_dispatcher.h"
 #include "impeller/display_list/display_list_image_impeller.h"
 #include "impeller/display_list/display_list_playground.h"
 #include "impeller/geometry/point.h"
@@ -29,6 +31,35 @@ TEST_P(DisplayListTest, CanDrawRect) {
   ASSERT_TRUE(OpenPlaygroundHere(builder.Build()));
 }
 
+TEST_P(DisplayListTest, RectsWithAnImageFilterAreNotMerged) {
+  auto count_entities = [](const sk_sp<flutter::DisplayList>& list) {
+    DisplayListDispatcher dispatcher;
+    list->Dispatch(dispatcher);
+    auto picture = dispatcher.EndRecordingAsPicture();
+    size_t count = 0;
+    picture.pass->IterateAllEntities([&count](Entity&) {
+      count++;
+      return true;
+    });
+    return count;
+  };
+  SkRect rects[] = {SkRect::MakeXYWH(10, 10, 100, 100),
+                    SkRect::MakeXYWH(50, 50, 100, 100),
+                    SkRect::MakeXYWH(90, 90, 100, 100)};
+
+  flutter::DisplayListBuilder builder;
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRects(rects, 3);
+  ASSERT_EQ(count_entities(builder.Build()), 1u);
+
+  flutter::DisplayListBuilder filtered_builder;
+  flutter::DlBlurImageFilter filter(5, 5, flutter::DlTileMode::kDecal);
+  filtered_builder.setColor(SK_ColorBLUE);
+  filtered_builder.setImageFilter(&filter);
+  filtered_builder.drawRects(rects, 3);
+  ASSERT_EQ(count_entities(filtered_builder.Build()), 3u);
+}
+
 TEST_P(DisplayListTest, CanDrawTextBlob) {
   flutter::DisplayListBuilder builder;
   builder.setColor(SK_ColorBLUE);
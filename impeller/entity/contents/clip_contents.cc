@@ -86,7 +86,8 @@ bool ClipContents::Render(const ContentContext& renderer,
 
   cmd.pipeline = renderer.GetClipPipeline(options);
   cmd.BindVertices(SolidColorContents::CreateSolidFillVertices(
-      path_, pass.GetTransientsBuffer()));
+      renderer, path_, entity.GetTransformation().GetMaxBasisLength(),
+      pass.GetTransientsBuffer()));
 
   info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize()) *
              entity.GetTransformation();
@@ -13,7 +13,8 @@
 namespace impeller {
 
 ContentContext::ContentContext(std::shared_ptr<Context> context)
-    : context_(std::move(context)) {
+    : context_(std::move(context)),
+      text_render_context_(TextRenderContext::Create(context_)) {
   if (!context_ || !context_->IsValid()) {
     return;
   }
@@ -11,6 +11,7 @@
 #include "flutter/fml/macros.h"
 #include "fml/logging.h"
 #include "impeller/base/validation.h"
+#include "impeller/entity/contents/tessellation_cache.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/mtl/border_mask_blur.frag.h"
 #include "impeller/entity/mtl/border_mask_blur.vert.h"
@@ -31,6 +32,8 @@
 #include "impeller/entity/mtl/texture_fill.frag.h"
 #include "impeller/entity/mtl/texture_fill.vert.h"
 #include "impeller/renderer/formats.h"
+#include "impeller/tessellator/tessellator.h"
+#include "impeller/typographer/text_render_context.h"
 
 namespace impeller {
 
@@ -139,6 +142,22 @@ class ContentContext {
 
   std::shared_ptr<Context> GetContext() const;
 
+  /// @brief  The vertices of the paths drawn by the contents, which are kept
+  ///         across frames.
+  TessellationCache& GetTessellationCache() const {
+    return tessellation_cache_;
+  }
+
+  /// @brief  The tessellator of the fills, which keeps its memory across
+  ///         tessellations.
+  Tessellator& GetTessellator() const { return tessellator_; }
+
+  /// @brief  The context that keeps the glyph atlas of the text contents
+  ///         across frames.
+  TextRenderContext& GetTextRenderContext() const {
+    return *text_render_context_;
+  }
+
   using SubpassCallback =
       std::function<bool(const ContentContext&, RenderPass&)>;
 
@@ -149,6 +168,9 @@ class ContentContext {
 
  private:
   std::shared_ptr<Context> context_;
+  mutable TessellationCache tessellation_cache_;
+  mutable Tessellator tessellator_;
+  std::unique_ptr<TextRenderContext> text_render_context_;
 
   template <class T>
   using Variants = std::unordered_map<ContentContextOptions,
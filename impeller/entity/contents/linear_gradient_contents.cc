@@ -7,6 +7,7 @@
 #include "flutter/fml/logging.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/entity.h"
+#include "impeller/renderer/context.h"
 #include "impeller/renderer/render_pass.h"
 #include "impeller/tessellator/tessellator.h"
 
@@ -50,22 +51,30 @@ bool LinearGradientContents::Render(const ContentContext& renderer,
   using VS = GradientFillPipeline::VertexShader;
   using FS = GradientFillPipeline::FragmentShader;
 
-  auto vertices_builder = VertexBufferBuilder<VS::PerVertexData>();
-  {
-    auto result =
-        Tessellator{}.Tessellate(path_.GetFillType(), path_.CreatePolyline(),
-                                 [&vertices_builder](Point point) {
-                                   VS::PerVertexData vtx;
-                                   vtx.vertices = point;
-                                   vertices_builder.AppendVertex(vtx);
-                                 });
-
-    if (result == Tessellator::Result::kInputError) {
-      return true;
-    }
-    if (result == Tessellator::Result::kTessellationError) {
-      return false;
-    }
+  const Scalar scale = entity.GetTransformation().GetMaxBasisLength();
+  TessellationCache::Key key;
+  key.type = TessellationCache::Key::Type::kGradientFill;
+  key.scale = scale;
+  auto vertices =
+      renderer.GetTessellationCache().GetOrCreate<VS::PerVertexData>(
+          key, path_, *renderer.GetContext()->GetPermanentsAllocator(),
+          pass.GetTransientsBuffer(),
+          [this, &renderer,
+           scale](VertexBufferBuilder<VS::PerVertexData>& vertices_builder) {
+            auto result = renderer.GetTessellator().Tessellate(
+                path_, scale, [&vertices_builder](Point point) {
+                  VS::PerVertexData vtx;
+                  vtx.vertices = point;
+                  vertices_builder.AppendVertex(vtx);
+                });
+            // Input errors leave the builder empty, so nothing is drawn.
+            return result != Tessellator::Result::kTessellationError;
+          });
+  if (!vertices.has_value()) {
+    return false;
+  }
+  if (vertices->index_count == 0) {
+    return true;
   }
 
   VS::FrameInfo frame_info;
@@ -83,8 +92,7 @@ bool LinearGradientContents::Render(const ContentContext& renderer,
   cmd.pipeline =
       renderer.GetGradientFillPipeline(OptionsFromPassAndEntity(pass, entity));
   cmd.stencil_reference = entity.GetStencilDepth();
-  cmd.BindVertices(
-      vertices_builder.CreateVertexBuffer(pass.GetTransientsBuffer()));
+  cmd.BindVertices(vertices.value());
   cmd.primitive_type = PrimitiveType::kTriangle;
   FS::BindGradientInfo(
       cmd, pass.GetTransientsBuffer().EmplaceUniform(gradient_info));
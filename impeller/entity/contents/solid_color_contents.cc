@@ -8,6 +8,7 @@
 #include "impeller/entity/entity.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
+#include "impeller/renderer/context.h"
 #include "impeller/renderer/render_pass.h"
 #include "impeller/tessellator/tessellator.h"
 
@@ -38,23 +39,30 @@ std::optional<Rect> SolidColorContents::GetCoverage(
   return path_.GetTransformedBoundingBox(entity.GetTransformation());
 };
 
-VertexBuffer SolidColorContents::CreateSolidFillVertices(const Path& path,
-                                                         HostBuffer& buffer) {
+VertexBuffer SolidColorContents::CreateSolidFillVertices(
+    const ContentContext& renderer,
+    const Path& path,
+    Scalar scale,
+    HostBuffer& buffer) {
   using VS = SolidFillPipeline::VertexShader;
 
-  VertexBufferBuilder<VS::PerVertexData> vtx_builder;
-
-  auto tesselation_result = Tessellator{}.Tessellate(
-      path.GetFillType(), path.CreatePolyline(), [&vtx_builder](auto point) {
-        VS::PerVertexData vtx;
-        vtx.vertices = point;
-        vtx_builder.AppendVertex(vtx);
-      });
-  if (tesselation_result != Tessellator::Result::kSuccess) {
-    return {};
-  }
-
-  return vtx_builder.CreateVertexBuffer(buffer);
+  TessellationCache::Key key;
+  key.type = TessellationCache::Key::Type::kSolidFill;
+  key.scale = scale;
+  auto vertices =
+      renderer.GetTessellationCache().GetOrCreate<VS::PerVertexData>(
+          key, path, *renderer.GetContext()->GetPermanentsAllocator(), buffer,
+          [&renderer, &path,
+           scale](VertexBufferBuilder<VS::PerVertexData>& vtx_builder) {
+            auto tesselation_result = renderer.GetTessellator().Tessellate(
+                path, scale, [&vtx_builder](auto point) {
+                  VS::PerVertexData vtx;
+                  vtx.vertices = point;
+                  vtx_builder.AppendVertex(vtx);
+                });
+            return tesselation_result == Tessellator::Result::kSuccess;
+          });
+  return vertices.value_or(VertexBuffer{});
 }
 
 bool SolidColorContents::Render(const ContentContext& renderer,
@@ -73,9 +81,11 @@ bool SolidColorContents::Render(const ContentContext& renderer,
   cmd.stencil_reference = entity.GetStencilDepth();
 
   cmd.BindVertices(CreateSolidFillVertices(
+      renderer,
       cover_
           ? PathBuilder{}.AddRect(Size(pass.GetRenderTargetSize())).TakePath()
           : path_,
+      entity.GetTransformation().GetMaxBasisLength(),
       pass.GetTransientsBuffer()));
 
   VS::FrameInfo frame_info;
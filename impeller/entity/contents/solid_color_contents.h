@@ -27,7 +27,11 @@ class SolidColorContents final : public Contents {
 
   static std::unique_ptr<SolidColorContents> Make(Path path, Color color);
 
-  static VertexBuffer CreateSolidFillVertices(const Path& path,
+  /// Fills the path with triangles, whose curves are flattened for a
+  /// transform that scales it by |scale|.
+  static VertexBuffer CreateSolidFillVertices(const ContentContext& renderer,
+                                              const Path& path,
+                                              Scalar scale,
                                               HostBuffer& buffer);
 
   void SetPath(Path path);
@@ -10,6 +10,7 @@
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/entity.h"
 #include "impeller/geometry/path_builder.h"
+#include "impeller/renderer/context.h"
 #include "impeller/renderer/render_pass.h"
 
 namespace impeller {
@@ -56,20 +57,22 @@ std::optional<Rect> SolidStrokeContents::GetCoverage(
                    path_coverage.size.height + max_radius_xy.y * 2));
 }
 
-static VertexBuffer CreateSolidStrokeVertices(
+static bool CreateSolidStrokeVertices(
+    VertexBufferBuilder<SolidStrokeVertexShader::PerVertexData>& vtx_builder,
     const Path& path,
-    HostBuffer& buffer,
     const SolidStrokeContents::CapProc& cap_proc,
     const SolidStrokeContents::JoinProc& join_proc,
     Scalar miter_limit,
-    const SmoothingApproximation& smoothing) {
+    Scalar scale,
+    Scalar stroke_size) {
   using VS = SolidStrokeVertexShader;
 
-  VertexBufferBuilder<VS::PerVertexData> vtx_builder;
-  auto polyline = path.CreatePolyline();
+  auto polyline = path.CreatePolyline(scale);
+  // The vertex shader scales the normals by half the stroke size.
+  const Scalar normal_scale = scale * stroke_size * 0.5;
 
   if (polyline.points.size() < 2) {
-    return {};  // Nothing to render.
+    return false;  // Nothing to render.
   }
 
   VS::PerVertexData vtx;
@@ -127,7 +130,7 @@ static VertexBuffer CreateSolidStrokeVertices(
     // Generate start cap.
     if (!polyline.contours[contour_i].is_closed) {
       cap_proc(vtx_builder, polyline.points[contour_start_point_i], -normal,
-               smoothing);
+               normal_scale);
     }
 
     // Generate contour geometry.
@@ -152,7 +155,7 @@ static VertexBuffer CreateSolidStrokeVertices(
 
           // Generate join from the current line to the next line.
           join_proc(vtx_builder, polyline.points[point_i], previous_normal,
-                    normal, miter_limit, smoothing);
+                    normal, miter_limit, normal_scale);
         }
       }
     }
@@ -160,14 +163,14 @@ static VertexBuffer CreateSolidStrokeVertices(
     // Generate end cap or join.
     if (!polyline.contours[contour_i].is_closed) {
       cap_proc(vtx_builder, polyline.points[contour_end_point_i - 1], normal,
-               smoothing);
+               normal_scale);
     } else {
       join_proc(vtx_builder, polyline.points[contour_start_point_i], normal,
-                contour_first_normal, miter_limit, smoothing);
+                contour_first_normal, miter_limit, normal_scale);
     }
   }
 
-  return vtx_builder.CreateVertexBuffer(buffer);
+  return true;
 }
 
 bool SolidStrokeContents::Render(const ContentContext& renderer,
@@ -198,12 +201,24 @@ bool SolidStrokeContents::Render(const ContentContext& renderer,
   cmd.pipeline = renderer.GetSolidStrokePipeline(options);
   cmd.stencil_reference = entity.GetStencilDepth();
 
-  auto smoothing = SmoothingApproximation(
-      5.0 / (stroke_size_ * entity.GetTransformation().GetMaxBasisLength()),
-      0.0, 0.0);
-  cmd.BindVertices(CreateSolidStrokeVertices(path_, pass.GetTransientsBuffer(),
-                                             cap_proc_, join_proc_,
-                                             miter_limit_, smoothing));
+  const Scalar scale = entity.GetTransformation().GetMaxBasisLength();
+  TessellationCache::Key key;
+  key.type = TessellationCache::Key::Type::kStroke;
+  key.scale = scale;
+  key.stroke_size = stroke_size_;
+  key.cap = static_cast<int>(cap_);
+  key.join = static_cast<int>(join_);
+  key.miter_limit = miter_limit_;
+  auto vertices =
+      renderer.GetTessellationCache().GetOrCreate<VS::PerVertexData>(
+          key, path_, *renderer.GetContext()->GetPermanentsAllocator(),
+          pass.GetTransientsBuffer(),
+          [&](VertexBufferBuilder<VS::PerVertexData>& vtx_builder) {
+            return CreateSolidStrokeVertices(vtx_builder, path_, cap_proc_,
+                                             join_proc_, miter_limit_, scale,
+                                             stroke_size_);
+          });
+  cmd.BindVertices(vertices.value_or(VertexBuffer{}));
   VS::BindFrameInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frame_info));
   VS::BindStrokeInfo(cmd,
                      pass.GetTransientsBuffer().EmplaceUniform(stroke_info));
@@ -244,23 +259,22 @@ void SolidStrokeContents::SetStrokeCap(Cap cap) {
     case Cap::kButt:
       cap_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
                      const Point& position, const Point& normal,
-                     const SmoothingApproximation& smoothing) {};
+                     Scalar scale) {};
       break;
     case Cap::kRound:
       cap_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                     const Point& position, const Point& normal,
-                     const SmoothingApproximation& smoothing) {
+                     const Point& position, const Point& normal, Scalar scale) {
         SolidStrokeVertexShader::PerVertexData vtx;
         vtx.vertex_position = position;
         vtx.pen_down = 1.0;
 
         Point forward(normal.y, -normal.x);
 
-        auto arc_points =
-            CubicPathComponent(
-                normal, normal + forward * PathBuilder::kArcApproximationMagic,
-                forward + normal * PathBuilder::kArcApproximationMagic, forward)
-                .CreatePolyline(smoothing);
+        std::vector<Point> arc_points;
+        CubicPathComponent(
+            normal, normal + forward * PathBuilder::kArcApproximationMagic,
+            forward + normal * PathBuilder::kArcApproximationMagic, forward)
+            .AppendPolylinePoints(scale, arc_points);
 
         vtx.vertex_normal = normal;
         vtx_builder.AppendVertex(vtx);
@@ -276,8 +290,7 @@ void SolidStrokeContents::SetStrokeCap(Cap cap) {
       break;
     case Cap::kSquare:
       cap_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                     const Point& position, const Point& normal,
-                     const SmoothingApproximation& smoothing) {
+                     const Point& position, const Point& normal, Scalar scale) {
         SolidStrokeVertexShader::PerVertexData vtx;
         vtx.vertex_position = position;
         vtx.pen_down = 1.0;
@@ -330,7 +343,7 @@ void SolidStrokeContents::SetStrokeJoin(Join join) {
       join_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
                       const Point& position, const Point& start_normal,
                       const Point& end_normal, Scalar miter_limit,
-                      const SmoothingApproximation& smoothing) {
+                      Scalar scale) {
         CreateBevelAndGetDirection(vtx_builder, position, start_normal,
                                    end_normal);
       };
@@ -339,7 +352,7 @@ void SolidStrokeContents::SetStrokeJoin(Join join) {
       join_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
                       const Point& position, const Point& start_normal,
                       const Point& end_normal, Scalar miter_limit,
-                      const SmoothingApproximation& smoothing) {
+                      Scalar scale) {
         // 1 for no joint (straight line), 0 for max joint (180 degrees).
         Scalar alignment = (start_normal.Dot(end_normal) + 1) / 2;
         if (ScalarNearlyEqual(alignment, 1)) {
@@ -367,7 +380,7 @@ void SolidStrokeContents::SetStrokeJoin(Join join) {
       join_proc_ = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
                       const Point& position, const Point& start_normal,
                       const Point& end_normal, Scalar miter_limit,
-                      const SmoothingApproximation& smoothing) {
+                      Scalar scale) {
         // 0 for no joint (straight line), 1 for max joint (180 degrees).
         Scalar alignment = 1 - (start_normal.Dot(end_normal) + 1) / 2;
         if (ScalarNearlyEqual(alignment, 0)) {
@@ -386,9 +399,9 @@ void SolidStrokeContents::SetStrokeJoin(Join join) {
                                PathBuilder::kArcApproximationMagic * alignment *
                                dir;
 
-        auto arc_points = CubicPathComponent(start_normal, start_handle,
-                                             middle_handle, middle)
-                              .CreatePolyline(smoothing);
+        std::vector<Point> arc_points;
+        CubicPathComponent(start_normal, start_handle, middle_handle, middle)
+            .AppendPolylinePoints(scale, arc_points);
 
         SolidStrokeVertexShader::PerVertexData vtx;
         vtx.vertex_position = position;
@@ -31,18 +31,20 @@ class SolidStrokeContents final : public Contents {
     kBevel,
   };
 
+  /// Caps and joins are made of unit normals, and their curves are flattened
+  /// for a transform that scales the normals by |scale|.
   using CapProc = std::function<void(
       VertexBufferBuilder<SolidStrokeVertexShader::PerVertexData>& vtx_builder,
       const Point& position,
       const Point& normal,
-      const SmoothingApproximation& smoothing)>;
+      Scalar scale)>;
   using JoinProc = std::function<void(
       VertexBufferBuilder<SolidStrokeVertexShader::PerVertexData>& vtx_builder,
       const Point& position,
       const Point& start_normal,
       const Point& end_normal,
       Scalar miter_limit,
-      const SmoothingApproximation& smoothing)>;
+      Scalar scale)>;
 
   SolidStrokeContents();
 
@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/tessellation_cache.h"
+
+#include "flutter/fml/hash_combine.h"
+
+namespace impeller {
+
+// Bounds the hashes of the vertices that were requested once. Paths that
+// change every frame would otherwise grow the set forever.
+static constexpr size_t kMaxRequestedOnce = 4096;
+
+std::size_t TessellationCache::Key::GetHash() const {
+  return fml::HashCombine(static_cast<int>(type), scale, stroke_size, cap,
+                          join, miter_limit);
+}
+
+bool TessellationCache::Key::operator==(const Key& other) const {
+  return type == other.type && scale == other.scale &&
+         stroke_size == other.stroke_size && cap == other.cap &&
+         join == other.join && miter_limit == other.miter_limit;
+}
+
+TessellationCache::TessellationCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+TessellationCache::~TessellationCache() = default;
+
+std::size_t TessellationCache::ComputeHash(const Key& key, const Path& path) {
+  return fml::HashCombine(key.GetHash(), path.GetHash());
+}
+
+std::optional<VertexBuffer> TessellationCache::Lookup(std::size_t hash,
+                                                      const Key& key,
+                                                      const Path& path) {
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto& entry = *it->second;
+    if (entry.key == key && entry.path == path) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return entry.vertices;
+    }
+  }
+  return std::nullopt;
+}
+
+bool TessellationCache::ShouldCache(std::size_t hash, size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  if (requested_once_.erase(hash) > 0) {
+    return true;
+  }
+  if (requested_once_.size() >= kMaxRequestedOnce) {
+    requested_once_.clear();
+  }
+  requested_once_.insert(hash);
+  return false;
+}
+
+void TessellationCache::Insert(std::size_t hash,
+                               const Key& key,
+                               const Path& path,
+                               const VertexBuffer& vertices,
+                               size_t bytes) {
+  while (!entries_.empty() && bytes_ + bytes > max_bytes_) {
+    auto& lru = entries_.back();
+    auto range = index_.equal_range(lru.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (&*it->second == &lru) {
+        index_.erase(it);
+        break;
+      }
+    }
+    bytes_ -= lru.bytes;
+    entries_.pop_back();
+  }
+  entries_.push_front({hash, key, path, vertices, bytes});
+  index_.emplace(hash, entries_.begin());
+  bytes_ += bytes;
+}
+
+}  // namespace impeller
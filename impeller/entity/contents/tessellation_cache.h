@@ -0,0 +1,154 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/renderer/allocator.h"
+#include "impeller/renderer/host_buffer.h"
+#include "impeller/renderer/vertex_buffer.h"
+#include "impeller/renderer/vertex_buffer_builder.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A bounded cache of the vertices generated from paths, so that
+///             the static paths of a scene are not tessellated again every
+///             frame.
+///
+///             Vertices are cached in device buffers the second time they are
+///             requested, so that paths that are only drawn once keep using
+///             the transients buffer of the pass. Once the cache exceeds its
+///             budget, the least recently used vertices are evicted.
+///
+class TessellationCache {
+ public:
+  /// The default budget of the vertices and indices held by the cache.
+  static constexpr size_t kDefaultMaxBytes = 8 * 1024 * 1024;
+
+  /// Describes how vertices are generated from a path.
+  struct Key {
+    enum class Type {
+      kSolidFill,
+      kGradientFill,
+      kStroke,
+    };
+
+    Type type = Type::kSolidFill;
+    /// The scale of the transform the curves are flattened for. See
+    /// |Path::CreatePolyline|.
+    Scalar scale = 1.0;
+    /// The size, cap, join and miter limit of strokes.
+    Scalar stroke_size = 0.0;
+    int cap = 0;
+    int join = 0;
+    Scalar miter_limit = 0.0;
+
+    std::size_t GetHash() const;
+
+    bool operator==(const Key& other) const;
+  };
+
+  template <class VertexType>
+  using Generator = std::function<bool(VertexBufferBuilder<VertexType>&)>;
+
+  explicit TessellationCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~TessellationCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the vertices generated from the path, either from the
+  ///             cache or by calling the generator.
+  ///
+  /// @param[in]  key         How the vertices are generated from the path.
+  /// @param[in]  path        The path.
+  /// @param[in]  allocator   The allocator of the device buffers of cached
+  ///                         vertices.
+  /// @param[in]  transients  The buffer of vertices that aren't cached.
+  /// @param[in]  generator   Appends the vertices of the path to a builder,
+  ///                         and returns false if they can't be generated.
+  ///
+  /// @return     The vertices, or std::nullopt if the generator failed.
+  ///
+  template <class VertexType>
+  std::optional<VertexBuffer> GetOrCreate(
+      const Key& key,
+      const Path& path,
+      Allocator& allocator,
+      HostBuffer& transients,
+      const Generator<VertexType>& generator) {
+    auto hash = ComputeHash(key, path);
+    if (auto vertices = Lookup(hash, key, path)) {
+      return vertices;
+    }
+
+    VertexBufferBuilder<VertexType> builder;
+    if (!generator(builder)) {
+      return std::nullopt;
+    }
+    // The builder emits one 32-bit index per vertex.
+    auto bytes =
+        builder.GetVertexCount() * (sizeof(VertexType) + sizeof(uint32_t));
+    if (!builder.HasVertices() || !ShouldCache(hash, bytes)) {
+      return builder.CreateVertexBuffer(transients);
+    }
+    builder.SetLabel("Tessellation Cache");
+    auto vertices = builder.CreateVertexBuffer(allocator);
+    if (!vertices) {
+      return builder.CreateVertexBuffer(transients);
+    }
+    Insert(hash, key, path, vertices, bytes);
+    return vertices;
+  }
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  size_t GetByteCount() const { return bytes_; }
+
+ private:
+  struct Entry {
+    std::size_t hash;
+    Key key;
+    Path path;
+    VertexBuffer vertices;
+    size_t bytes;
+  };
+
+  static std::size_t ComputeHash(const Key& key, const Path& path);
+
+  std::optional<VertexBuffer> Lookup(std::size_t hash,
+                                     const Key& key,
+                                     const Path& path);
+
+  // Returns whether vertices of this size with this hash were already
+  // requested, and notes that they were requested otherwise.
+  bool ShouldCache(std::size_t hash, size_t bytes);
+
+  void Insert(std::size_t hash,
+              const Key& key,
+              const Path& path,
+              const VertexBuffer& vertices,
+              size_t bytes);
+
+  const size_t max_bytes_;
+  size_t bytes_ = 0;
+  // The most recently used entries are at the front.
+  std::list<Entry> entries_;
+  std::unordered_multimap<std::size_t, std::list<Entry>::iterator> index_;
+  // The hashes of the vertices that were requested once, but not cached yet.
+  std::unordered_set<std::size_t> requested_once_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TessellationCache);
+};
+
+}  // namespace impeller
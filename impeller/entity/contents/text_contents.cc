@@ -34,9 +34,9 @@ void TextContents::SetGlyphAtlas(std::shared_ptr<LazyGlyphAtlas> atlas) {
 }
 
 std::shared_ptr<GlyphAtlas> TextContents::ResolveAtlas(
-    std::shared_ptr<Context> context) const {
+    TextRenderContext& text_context) const {
   if (auto lazy_atlas = std::get_if<std::shared_ptr<LazyGlyphAtlas>>(&atlas_)) {
-    return lazy_atlas->get()->CreateOrGetGlyphAtlas(context);
+    return lazy_atlas->get()->CreateOrGetGlyphAtlas(text_context);
   }
 
   if (auto atlas = std::get_if<std::shared_ptr<GlyphAtlas>>(&atlas_)) {
@@ -65,7 +65,7 @@ bool TextContents::Render(const ContentContext& renderer,
     return true;
   }
 
-  auto atlas = ResolveAtlas(renderer.GetContext());
+  auto atlas = ResolveAtlas(renderer.GetTextRenderContext());
 
   if (!atlas || !atlas->IsValid()) {
     VALIDATION_LOG << "Cannot render glyphs without prepared atlas.";
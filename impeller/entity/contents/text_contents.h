@@ -18,7 +18,7 @@ namespace impeller {
 
 class GlyphAtlas;
 class LazyGlyphAtlas;
-class Context;
+class TextRenderContext;
 
 class TextContents final : public Contents {
  public:
@@ -50,7 +50,7 @@ class TextContents final : public Contents {
       atlas_;
 
   std::shared_ptr<GlyphAtlas> ResolveAtlas(
-      std::shared_ptr<Context> context) const;
+      TextRenderContext& text_context) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TextContents);
 };
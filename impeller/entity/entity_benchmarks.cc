@@ -0,0 +1,181 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "impeller/entity/contents/tessellation_cache.h"
+#include "impeller/entity/mtl/solid_fill.vert.h"
+#include "impeller/geometry/path_builder.h"
+#include "impeller/renderer/allocator.h"
+#include "impeller/renderer/device_buffer.h"
+#include "impeller/renderer/host_buffer.h"
+#include "impeller/renderer/vertex_buffer_builder.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+namespace {
+
+using VS = SolidFillVertexShader;
+
+// A device buffer in host memory, so that the cost of the cache can be
+// measured without a GPU.
+class HostDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit HostDeviceBuffer(size_t length) : memory_(length) {}
+
+  // |DeviceBuffer|
+  bool CopyHostBuffer(const uint8_t* source,
+                      Range source_range,
+                      size_t offset) override {
+    if (offset + source_range.length > memory_.size()) {
+      return false;
+    }
+    std::memcpy(memory_.data() + offset, source + source_range.offset,
+                source_range.length);
+    return true;
+  }
+
+  // |DeviceBuffer|
+  std::shared_ptr<Texture> MakeTexture(TextureDescriptor desc,
+                                       size_t offset) const override {
+    return nullptr;
+  }
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label) override { return true; }
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  // |DeviceBuffer|
+  BufferView AsBufferView() const override {
+    BufferView view;
+    view.buffer = shared_from_this();
+    view.range = {0u, memory_.size()};
+    return view;
+  }
+
+  // |Buffer|
+  std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
+      Allocator& allocator) const override {
+    return shared_from_this();
+  }
+
+ private:
+  std::vector<uint8_t> memory_;
+};
+
+class HostAllocator final : public Allocator {
+ public:
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> CreateBuffer(StorageMode mode,
+                                             size_t length) override {
+    return std::make_shared<HostDeviceBuffer>(length);
+  }
+
+  // |Allocator|
+  std::shared_ptr<Texture> CreateTexture(
+      StorageMode mode,
+      const TextureDescriptor& desc) override {
+    return nullptr;
+  }
+
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> CreateBufferWithCopy(const uint8_t* buffer,
+                                                     size_t length) override {
+    auto device_buffer = CreateBuffer(StorageMode::kHostVisible, length);
+    if (!device_buffer->CopyHostBuffer(buffer, Range{0, length})) {
+      return nullptr;
+    }
+    return device_buffer;
+  }
+
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> CreateBufferWithCopy(
+      const fml::Mapping& mapping) override {
+    return CreateBufferWithCopy(mapping.GetMapping(), mapping.GetSize());
+  }
+};
+
+// A static scene of |path_count| rounded rectangles with a circle in each.
+std::vector<Path> MakeStaticScene(size_t path_count) {
+  std::vector<Path> scene;
+  scene.reserve(path_count);
+  for (size_t i = 0; i < path_count; i++) {
+    Scalar x = (i % 40) * 25;
+    Scalar y = (i / 40) * 25;
+    scene.push_back(PathBuilder{}
+                        .AddRoundedRect(Rect::MakeXYWH(x, y, 20, 20), 5)
+                        .AddCircle({x + 10, y + 10}, 4)
+                        .TakePath());
+  }
+  return scene;
+}
+
+bool TessellateSolidFill(const Path& path,
+                         VertexBufferBuilder<VS::PerVertexData>& builder) {
+  return Tessellator{}.Tessellate(path.GetFillType(), path.CreatePolyline(),
+                                  [&builder](Point vertex) {
+                                    builder.AppendVertex({vertex});
+                                  }) == Tessellator::Result::kSuccess;
+}
+
+// Generates the vertices of every path of the scene each frame, as the solid
+// fills did before the tessellation cache.
+void BM_TessellateStaticScene(benchmark::State& state) {
+  auto scene = MakeStaticScene(static_cast<size_t>(state.range(0)));
+  while (state.KeepRunning()) {
+    auto transients = HostBuffer::Create();
+    for (const auto& path : scene) {
+      VertexBufferBuilder<VS::PerVertexData> builder;
+      TessellateSolidFill(path, builder);
+      benchmark::DoNotOptimize(builder.CreateVertexBuffer(*transients));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Requests the vertices of every path of the scene from a tessellation cache
+// each frame, once the paths are cached.
+void BM_TessellateStaticSceneWithCache(benchmark::State& state) {
+  auto scene = MakeStaticScene(static_cast<size_t>(state.range(0)));
+  HostAllocator allocator;
+  TessellationCache cache;
+  auto draw_frame = [&]() {
+    auto transients = HostBuffer::Create();
+    for (const auto& path : scene) {
+      benchmark::DoNotOptimize(cache.GetOrCreate<VS::PerVertexData>(
+          TessellationCache::Key{}, path, allocator, *transients,
+          [&path](VertexBufferBuilder<VS::PerVertexData>& builder) {
+            return TessellateSolidFill(path, builder);
+          }));
+    }
+  };
+  // Paths are cached the second time they are requested.
+  draw_frame();
+  draw_frame();
+  while (state.KeepRunning()) {
+    draw_frame();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_TessellateStaticScene)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_TessellateStaticSceneWithCache)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace impeller
@@ -10,6 +10,7 @@
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
 #include "impeller/entity/contents/solid_color_contents.h"
 #include "impeller/entity/contents/solid_stroke_contents.h"
+#include "impeller/entity/contents/tessellation_cache.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/entity_pass.h"
 #include "impeller/entity/entity_pass_delegate.h"
@@ -18,6 +19,8 @@
 #include "impeller/geometry/path_builder.h"
 #include "impeller/playground/playground.h"
 #include "impeller/playground/widgets.h"
+#include "impeller/renderer/context.h"
+#include "impeller/renderer/host_buffer.h"
 #include "impeller/renderer/render_pass.h"
 #include "impeller/renderer/vertex_buffer_builder.h"
 #include "impeller/tessellator/tessellator.h"
@@ -952,5 +955,178 @@ TEST_P(EntityTest, BorderMaskBlurCoverageIsCorrect) {
   }
 }
 
+static bool TessellateSolidFill(
+    const Path& path,
+    VertexBufferBuilder<SolidFillVertexShader::PerVertexData>& builder) {
+  return Tessellator{}.Tessellate(path.GetFillType(), path.CreatePolyline(),
+                                  [&builder](Point vertex) {
+                                    builder.AppendVertex({vertex});
+                                  }) == Tessellator::Result::kSuccess;
+}
+
+TEST_P(EntityTest, TessellationCacheCachesPathsRequestedTwice) {
+  using VS = SolidFillVertexShader;
+  TessellationCache cache;
+  auto allocator = GetContext()->GetPermanentsAllocator();
+  auto transients = HostBuffer::Create();
+  TessellationCache::Key key;
+  size_t generated = 0;
+  auto generator = [&generated](const Path& path) {
+    return [&generated, &path](VertexBufferBuilder<VS::PerVertexData>& b) {
+      generated++;
+      return TessellateSolidFill(path, b);
+    };
+  };
+
+  auto path = PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+  auto first = cache.GetOrCreate<VS::PerVertexData>(
+      key, path, *allocator, *transients, generator(path));
+  ASSERT_TRUE(first.has_value());
+  ASSERT_EQ(first->vertex_buffer.buffer, transients);
+  ASSERT_EQ(cache.GetEntryCount(), 0u);
+
+  auto second = cache.GetOrCreate<VS::PerVertexData>(
+      key, path, *allocator, *transients, generator(path));
+  ASSERT_TRUE(second.has_value());
+  ASSERT_EQ(second->index_count, first->index_count);
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+  ASSERT_GT(cache.GetByteCount(), 0u);
+  ASSERT_EQ(generated, 2u);
+
+  // An equal path built separately is found in the cache.
+  auto same_path = PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+  ASSERT_EQ(same_path.GetHash(), path.GetHash());
+  auto third = cache.GetOrCreate<VS::PerVertexData>(
+      key, same_path, *allocator, *transients, generator(same_path));
+  ASSERT_TRUE(third.has_value());
+  ASSERT_EQ(third->vertex_buffer.buffer, second->vertex_buffer.buffer);
+  ASSERT_EQ(generated, 2u);
+}
+
+TEST_P(EntityTest, TessellationCacheMissesForOtherPathsAndScales) {
+  using VS = SolidFillVertexShader;
+  TessellationCache cache;
+  auto allocator = GetContext()->GetPermanentsAllocator();
+  auto transients = HostBuffer::Create();
+  size_t generated = 0;
+  auto request = [&](const TessellationCache::Key& key, const Path& path) {
+    return cache.GetOrCreate<VS::PerVertexData>(
+        key, path, *allocator, *transients,
+        [&](VertexBufferBuilder<VS::PerVertexData>& builder) {
+          generated++;
+          return TessellateSolidFill(path, builder);
+        });
+  };
+
+  auto path = PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+  TessellationCache::Key key;
+  request(key, path);
+  request(key, path);
+  ASSERT_EQ(generated, 2u);
+
+  TessellationCache::Key scaled_key;
+  scaled_key.scale = 2.0;
+  request(scaled_key, path);
+  ASSERT_EQ(generated, 3u);
+
+  auto other_path = PathBuilder{}.AddCircle({100, 100}, 51).TakePath();
+  ASSERT_NE(other_path, path);
+  request(key, other_path);
+  ASSERT_EQ(generated, 4u);
+
+  request(key, path);
+  ASSERT_EQ(generated, 4u);
+}
+
+TEST_P(EntityTest, TessellationCacheEvictsLeastRecentlyUsedPaths) {
+  using VS = SolidFillVertexShader;
+  auto rect_path = [](Scalar x) {
+    return PathBuilder{}.AddRect(Rect::MakeXYWH(x, 0, 10, 10)).TakePath();
+  };
+  // Each rectangle is tessellated into two triangles.
+  const size_t rect_bytes = 6 * (sizeof(VS::PerVertexData) + sizeof(uint32_t));
+  TessellationCache cache(2 * rect_bytes);
+  auto allocator = GetContext()->GetPermanentsAllocator();
+  auto transients = HostBuffer::Create();
+  size_t generated = 0;
+  auto request = [&](const Path& path) {
+    TessellationCache::Key key;
+    return cache.GetOrCreate<VS::PerVertexData>(
+        key, path, *allocator, *transients,
+        [&](VertexBufferBuilder<VS::PerVertexData>& builder) {
+          generated++;
+          return TessellateSolidFill(path, builder);
+        });
+  };
+
+  auto a = rect_path(0);
+  auto b = rect_path(20);
+  auto c = rect_path(40);
+  for (const auto* path : {&a, &a, &b, &b}) {
+    request(*path);
+  }
+  ASSERT_EQ(cache.GetEntryCount(), 2u);
+  ASSERT_EQ(cache.GetByteCount(), 2 * rect_bytes);
+
+  // Touches |a| so that |b| is the least recently used.
+  request(a);
+  request(c);
+  request(c);
+  ASSERT_EQ(cache.GetEntryCount(), 2u);
+  ASSERT_LE(cache.GetByteCount(), 2 * rect_bytes);
+  ASSERT_EQ(generated, 6u);
+
+  request(a);
+  ASSERT_EQ(generated, 6u);
+  request(b);
+  ASSERT_EQ(generated, 7u);
+}
+
+TEST_P(EntityTest, TessellationCacheServesStaticSceneFromCache) {
+  using VS = SolidFillVertexShader;
+  constexpr size_t kPathCount = 1000;
+
+  std::vector<Path> scene;
+  scene.reserve(kPathCount);
+  for (size_t i = 0; i < kPathCount; i++) {
+    Scalar x = (i % 40) * 25;
+    Scalar y = (i / 40) * 25;
+    scene.push_back(PathBuilder{}
+                        .AddRoundedRect(Rect::MakeXYWH(x, y, 20, 20), 5)
+                        .AddCircle({x + 10, y + 10}, 4)
+                        .TakePath());
+  }
+
+  TessellationCache cache;
+  auto allocator = GetContext()->GetPermanentsAllocator();
+  size_t generated = 0;
+  auto draw_frame = [&]() {
+    auto transients = HostBuffer::Create();
+    for (const auto& path : scene) {
+      auto vertices = cache.GetOrCreate<VS::PerVertexData>(
+          TessellationCache::Key{}, path, *allocator, *transients,
+          [&](VertexBufferBuilder<VS::PerVertexData>& builder) {
+            generated++;
+            return TessellateSolidFill(path, builder);
+          });
+      ASSERT_TRUE(vertices.has_value());
+    }
+  };
+
+  // The paths are tessellated in the first two frames, and cached in the
+  // second one.
+  draw_frame();
+  ASSERT_EQ(cache.GetEntryCount(), 0u);
+  draw_frame();
+  ASSERT_EQ(cache.GetEntryCount(), kPathCount);
+  ASSERT_EQ(generated, 2 * kPathCount);
+
+  // The following frames are served from the cache.
+  draw_frame();
+  draw_frame();
+  ASSERT_EQ(cache.GetEntryCount(), kPathCount);
+  ASSERT_EQ(generated, 2 * kPathCount);
+}
+
 }  // namespace testing
 }  // namespace impeller
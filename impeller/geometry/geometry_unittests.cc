@@ -352,6 +352,59 @@ TEST(GeometryTest, PathGetBoundingBoxForCubicWithNoDerivativeRootsIsCorrect) {
   ASSERT_RECT_NEAR(actual.value(), expected);
 }
 
+TEST(GeometryTest, PathBoundingBoxIncludesCurveExtremaButNotControlPoints) {
+  Path path;
+  path.AddLinearComponent({0, 0}, {100, 0})
+      .AddQuadraticComponent({100, 0}, {150, 100}, {200, 0})
+      .AddCubicComponent({200, 0}, {210, -10}, {220, -10}, {230, 0});
+  auto actual = path.GetBoundingBox();
+  auto expected = Rect::MakeLTRB(0, -7.5, 230, 50);
+  ASSERT_TRUE(actual.has_value());
+  ASSERT_RECT_NEAR(actual.value(), expected);
+}
+
+TEST(GeometryTest, PathTransformedBoundingBoxBoundsTheTransformedPoints) {
+  auto path = PathBuilder{}
+                  .MoveTo({50, 0})
+                  .LineTo({100, 50})
+                  .LineTo({50, 100})
+                  .LineTo({0, 50})
+                  .Close()
+                  .TakePath();
+  // The diamond becomes a square, whose bounds are tighter than the rotated
+  // bounds of the diamond.
+  auto rotation = Matrix::MakeRotationZ(Radians{kPiOver4});
+  auto actual = path.GetTransformedBoundingBox(rotation);
+  auto expected = Rect::MakeLTRB(-35.3553, 35.3553, 35.3553, 106.066);
+  ASSERT_TRUE(actual.has_value());
+  ASSERT_RECT_NEAR(actual.value(), expected);
+
+  Matrix perspective;
+  perspective.m[3] = 0.001;
+  actual = path.GetTransformedBoundingBox(perspective);
+  ASSERT_TRUE(actual.has_value());
+  ASSERT_RECT_NEAR(actual.value(), path.GetBoundingBox()->TransformBounds(
+                                       perspective));
+}
+
+TEST(GeometryTest, PathTransformMovesAllThePoints) {
+  auto path = PathBuilder{}
+                  .MoveTo({10, 10})
+                  .QuadraticCurveTo({20, 30}, {40, 10})
+                  .TakePath();
+  path.Transform(Matrix::MakeTranslation({100, 200}) *
+                 Matrix::MakeScale({2, 2, 1}));
+
+  ContourComponent contour;
+  ASSERT_TRUE(path.GetContourComponentAtIndex(0, contour));
+  ASSERT_POINT_NEAR(contour.destination, Point(120, 220));
+  QuadraticPathComponent quad;
+  ASSERT_TRUE(path.GetQuadraticComponentAtIndex(1, quad));
+  ASSERT_POINT_NEAR(quad.p1, Point(120, 220));
+  ASSERT_POINT_NEAR(quad.cp, Point(140, 260));
+  ASSERT_POINT_NEAR(quad.p2, Point(180, 220));
+}
+
 TEST(GeometryTest, CanGenerateMipCounts) {
   ASSERT_EQ((Size{128, 128}.MipCount()), 7u);
   ASSERT_EQ((Size{128, 256}.MipCount()), 8u);
@@ -912,14 +965,57 @@ TEST(GeometryTest, RectMakePointBounds) {
 
 TEST(GeometryTest, CubicPathComponentPolylineDoesNotIncludePointOne) {
   CubicPathComponent component({10, 10}, {20, 35}, {35, 20}, {40, 40});
-  SmoothingApproximation approximation;
-  auto polyline = component.CreatePolyline(approximation);
+  std::vector<Point> polyline;
+  component.AppendPolylinePoints(1.0, polyline);
   ASSERT_NE(polyline.front().x, 10);
   ASSERT_NE(polyline.front().y, 10);
   ASSERT_EQ(polyline.back().x, 40);
   ASSERT_EQ(polyline.back().y, 40);
 }
 
+TEST(GeometryTest, CurveSegmentCountsFollowTheTransformScale) {
+  CubicPathComponent cubic({0, 0}, {0, 100}, {100, 100}, {100, 0});
+  // The second differences of the control points are 100 * sqrt(2) long, so
+  // sqrt(6 / 8 * 100 * sqrt(2) / kDefaultCurveTolerance) segments are needed.
+  ASSERT_EQ(cubic.GetSegmentCount(1.0), 33u);
+  // Twice as many segments are needed for four times the scale.
+  ASSERT_EQ(cubic.GetSegmentCount(4.0), 66u);
+  ASSERT_EQ(cubic.GetSegmentCount(0.01), 4u);
+  ASSERT_EQ(cubic.GetSegmentCount(0.0), 1u);
+
+  QuadraticPathComponent quad({0, 0}, {50, 100}, {100, 0});
+  ASSERT_EQ(quad.GetSegmentCount(1.0), 23u);
+
+  // Straight curves are a single segment at any scale.
+  QuadraticPathComponent straight({0, 0}, {50, 50}, {100, 100});
+  ASSERT_EQ(straight.GetSegmentCount(1000.0), 1u);
+
+  std::vector<Point> points;
+  cubic.AppendPolylinePoints(4.0, points);
+  ASSERT_EQ(points.size(), 66u);
+  ASSERT_EQ(points.back(), Point(100, 0));
+  for (size_t i = 0; i < points.size(); i++) {
+    ASSERT_POINT_NEAR(points[i], cubic.Solve((i + 1) / 66.0));
+  }
+}
+
+TEST(GeometryTest, PathCreatePolylineReusesThePolyline) {
+  auto circle = PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+  auto line = PathBuilder{}.AddLine({0, 0}, {10, 10}).TakePath();
+
+  Path::Polyline polyline;
+  circle.CreatePolyline(2.0, polyline);
+  auto circle_point_count = polyline.points.size();
+  ASSERT_GT(circle_point_count, circle.CreatePolyline(1.0).points.size());
+  ASSERT_EQ(polyline.convexity, Path::Convexity::kConvex);
+
+  line.CreatePolyline(2.0, polyline);
+  ASSERT_EQ(polyline.points.size(), 2u);
+  ASSERT_EQ(polyline.contours.size(), 1u);
+  ASSERT_EQ(polyline.convexity, Path::Convexity::kUnknown);
+  ASSERT_GE(polyline.points.capacity(), circle_point_count);
+}
+
 TEST(GeometryTest, PathCreatePolyLineDoesNotDuplicatePoints) {
   Path path;
   path.AddContourComponent({10, 10});
@@ -1086,5 +1182,48 @@ TEST(GeometryTest, PathPolylineDuplicatesAreRemovedForSameContour) {
   ASSERT_EQ(polyline.points[6], Point(0, 100));
 }
 
+TEST(GeometryTest, PathsWithEqualComponentsAreEqual) {
+  auto make_path = [](Scalar radius, FillType fill_type) {
+    auto path = PathBuilder{}
+                    .AddCircle({100, 100}, radius)
+                    .AddRect(Rect::MakeXYWH(0, 0, 10, 10))
+                    .TakePath();
+    path.SetFillType(fill_type);
+    return path;
+  };
+  auto path = make_path(50, FillType::kNonZero);
+  auto same_path = make_path(50, FillType::kNonZero);
+  ASSERT_TRUE(path == same_path);
+  ASSERT_EQ(path.GetHash(), same_path.GetHash());
+
+  ASSERT_TRUE(path != make_path(51, FillType::kNonZero));
+  ASSERT_NE(path.GetHash(), make_path(51, FillType::kNonZero).GetHash());
+  ASSERT_TRUE(path != make_path(50, FillType::kOdd));
+  ASSERT_NE(path.GetHash(), make_path(50, FillType::kOdd).GetHash());
+}
+
+TEST(GeometryTest, PathBuilderMarksSingleShapesAsConvex) {
+  auto rect = Rect::MakeXYWH(0, 0, 100, 50);
+  ASSERT_EQ(PathBuilder{}.AddRect(rect).TakePath().GetConvexity(),
+            Path::Convexity::kConvex);
+  ASSERT_EQ(PathBuilder{}.AddOval(rect).TakePath().GetConvexity(),
+            Path::Convexity::kConvex);
+  ASSERT_EQ(PathBuilder{}.AddRoundedRect(rect, 10).TakePath().GetConvexity(),
+            Path::Convexity::kConvex);
+
+  // The corners overlap.
+  ASSERT_EQ(PathBuilder{}.AddRoundedRect(rect, 30).TakePath().GetConvexity(),
+            Path::Convexity::kUnknown);
+  ASSERT_EQ(
+      PathBuilder{}.AddRect(rect).AddOval(rect).TakePath().GetConvexity(),
+      Path::Convexity::kUnknown);
+  ASSERT_EQ(
+      PathBuilder{}.AddRect(rect).LineTo({0, 0}).TakePath().GetConvexity(),
+      Path::Convexity::kUnknown);
+  ASSERT_EQ(
+      PathBuilder{}.LineTo({10, 0}).AddRect(rect).TakePath().GetConvexity(),
+      Path::Convexity::kUnknown);
+}
+
 }  // namespace testing
 }  // namespace impeller
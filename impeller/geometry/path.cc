@@ -4,8 +4,11 @@
 
 #include "impeller/geometry/path.h"
 
+#include <algorithm>
 #include <optional>
+#include <type_traits>
 
+#include "flutter/fml/hash_combine.h"
 #include "impeller/geometry/path_component.h"
 
 namespace impeller {
@@ -40,25 +43,45 @@ FillType Path::GetFillType() const {
   return fill_;
 }
 
+void Path::SetConvexity(Convexity convexity) {
+  convexity_ = convexity;
+}
+
+Path::Convexity Path::GetConvexity() const {
+  return convexity_;
+}
+
 Path& Path::AddLinearComponent(Point p1, Point p2) {
-  linears_.emplace_back(p1, p2);
-  components_.emplace_back(ComponentType::kLinear, linears_.size() - 1);
+  components_.emplace_back(ComponentType::kLinear, points_.size());
+  points_.push_back(p1);
+  points_.push_back(p2);
+  convexity_ = Convexity::kUnknown;
   return *this;
 }
 
 Path& Path::AddQuadraticComponent(Point p1, Point cp, Point p2) {
-  quads_.emplace_back(p1, cp, p2);
-  components_.emplace_back(ComponentType::kQuadratic, quads_.size() - 1);
+  components_.emplace_back(ComponentType::kQuadratic, points_.size());
+  points_.push_back(p1);
+  points_.push_back(cp);
+  points_.push_back(p2);
+  curve_count_++;
+  convexity_ = Convexity::kUnknown;
   return *this;
 }
 
 Path& Path::AddCubicComponent(Point p1, Point cp1, Point cp2, Point p2) {
-  cubics_.emplace_back(p1, cp1, cp2, p2);
-  components_.emplace_back(ComponentType::kCubic, cubics_.size() - 1);
+  components_.emplace_back(ComponentType::kCubic, points_.size());
+  points_.push_back(p1);
+  points_.push_back(cp1);
+  points_.push_back(cp2);
+  points_.push_back(p2);
+  curve_count_++;
+  convexity_ = Convexity::kUnknown;
   return *this;
 }
 
 Path& Path::AddContourComponent(Point destination, bool is_closed) {
+  convexity_ = Convexity::kUnknown;
   if (components_.size() > 0 &&
       components_.back().type == ComponentType::kContour) {
     // Never insert contiguous contours.
@@ -79,32 +102,26 @@ void Path::EnumerateComponents(
     Applier<QuadraticPathComponent> quad_applier,
     Applier<CubicPathComponent> cubic_applier,
     Applier<ContourComponent> contour_applier) const {
-  size_t currentIndex = 0;
-  for (const auto& component : components_) {
-    switch (component.type) {
-      case ComponentType::kLinear:
-        if (linear_applier) {
-          linear_applier(currentIndex, linears_[component.index]);
-        }
-        break;
-      case ComponentType::kQuadratic:
-        if (quad_applier) {
-          quad_applier(currentIndex, quads_[component.index]);
-        }
-        break;
-      case ComponentType::kCubic:
-        if (cubic_applier) {
-          cubic_applier(currentIndex, cubics_[component.index]);
-        }
-        break;
-      case ComponentType::kContour:
-        if (contour_applier) {
-          contour_applier(currentIndex, contours_[component.index]);
-        }
-        break;
+  VisitComponents([&](size_t index, const auto& component) {
+    using Component = std::decay_t<decltype(component)>;
+    if constexpr (std::is_same_v<Component, LinearPathComponent>) {
+      if (linear_applier) {
+        linear_applier(index, component);
+      }
+    } else if constexpr (std::is_same_v<Component, QuadraticPathComponent>) {
+      if (quad_applier) {
+        quad_applier(index, component);
+      }
+    } else if constexpr (std::is_same_v<Component, CubicPathComponent>) {
+      if (cubic_applier) {
+        cubic_applier(index, component);
+      }
+    } else {
+      if (contour_applier) {
+        contour_applier(index, component);
+      }
     }
-    currentIndex++;
-  }
+  });
 }
 
 bool Path::GetLinearComponentAtIndex(size_t index,
@@ -117,7 +134,8 @@ bool Path::GetLinearComponentAtIndex(size_t index,
     return false;
   }
 
-  linear = linears_[components_[index].index];
+  const Point* p = points_.data() + components_[index].index;
+  linear = LinearPathComponent(p[0], p[1]);
   return true;
 }
 
@@ -132,7 +150,8 @@ bool Path::GetQuadraticComponentAtIndex(
     return false;
   }
 
-  quadratic = quads_[components_[index].index];
+  const Point* p = points_.data() + components_[index].index;
+  quadratic = QuadraticPathComponent(p[0], p[1], p[2]);
   return true;
 }
 
@@ -146,7 +165,8 @@ bool Path::GetCubicComponentAtIndex(size_t index,
     return false;
   }
 
-  cubic = cubics_[components_[index].index];
+  const Point* p = points_.data() + components_[index].index;
+  cubic = CubicPathComponent(p[0], p[1], p[2], p[3]);
   return true;
 }
 
@@ -174,7 +194,10 @@ bool Path::UpdateLinearComponentAtIndex(size_t index,
     return false;
   }
 
-  linears_[components_[index].index] = linear;
+  Point* p = points_.data() + components_[index].index;
+  p[0] = linear.p1;
+  p[1] = linear.p2;
+  convexity_ = Convexity::kUnknown;
   return true;
 }
 
@@ -189,7 +212,11 @@ bool Path::UpdateQuadraticComponentAtIndex(
     return false;
   }
 
-  quads_[components_[index].index] = quadratic;
+  Point* p = points_.data() + components_[index].index;
+  p[0] = quadratic.p1;
+  p[1] = quadratic.cp;
+  p[2] = quadratic.p2;
+  convexity_ = Convexity::kUnknown;
   return true;
 }
 
@@ -203,7 +230,12 @@ bool Path::UpdateCubicComponentAtIndex(size_t index,
     return false;
   }
 
-  cubics_[components_[index].index] = cubic;
+  Point* p = points_.data() + components_[index].index;
+  p[0] = cubic.p1;
+  p[1] = cubic.cp1;
+  p[2] = cubic.cp2;
+  p[3] = cubic.p2;
+  convexity_ = Convexity::kUnknown;
   return true;
 }
 
@@ -218,61 +250,150 @@ bool Path::UpdateContourComponentAtIndex(size_t index,
   }
 
   contours_[components_[index].index] = move;
+  convexity_ = Convexity::kUnknown;
   return true;
 }
 
-Path::Polyline Path::CreatePolyline(
-    const SmoothingApproximation& approximation) const {
+Path::Polyline Path::CreatePolyline(Scalar scale) const {
   Polyline polyline;
+  CreatePolyline(scale, polyline);
+  return polyline;
+}
 
-  std::optional<Point> previous_contour_point;
-  auto collect_points = [&polyline, &previous_contour_point](
-                            const std::vector<Point>& collection) {
-    if (collection.empty()) {
-      return;
+void Path::CreatePolyline(Scalar scale, Polyline& polyline) const {
+  polyline.points.clear();
+  polyline.contours.clear();
+  polyline.convexity = convexity_;
+
+  VisitComponents([&](size_t index, const auto& component) {
+    using Component = std::decay_t<decltype(component)>;
+    if constexpr (std::is_same_v<Component, LinearPathComponent>) {
+      component.AppendPolylinePoints(polyline.points);
+    } else if constexpr (std::is_same_v<Component, ContourComponent>) {
+      if (index == components_.size() - 1) {
+        // If the last component is a contour, that means it's an empty
+        // contour, so skip it.
+        return;
+      }
+      polyline.contours.push_back({.start_index = polyline.points.size(),
+                                   .is_closed = component.is_closed});
+      // Contours always start with their own point, even if it repeats the
+      // last point of the previous contour.
+      polyline.points.push_back(component.destination);
+    } else {
+      component.AppendPolylinePoints(scale, polyline.points);
     }
+  });
+}
 
-    polyline.points.reserve(polyline.points.size() + collection.size());
+// Grows |min| and |max| to the points mapped by |mapping|. The coordinates
+// are kept in lanes of four scalars, the x and y of two points, which
+// compilers turn into SIMD min and max instructions.
+template <class Mapping>
+static void AccumulateMinMax(const Point* points,
+                             size_t count,
+                             const Mapping& mapping,
+                             Point& min,
+                             Point& max) {
+  Scalar min_lanes[4] = {min.x, min.y, min.x, min.y};
+  Scalar max_lanes[4] = {max.x, max.y, max.x, max.y};
+  size_t i = 0;
+  for (; i + 1 < count; i += 2) {
+    const Point a = mapping(points[i]);
+    const Point b = mapping(points[i + 1]);
+    const Scalar lanes[4] = {a.x, a.y, b.x, b.y};
+    for (size_t lane = 0; lane < 4; lane++) {
+      min_lanes[lane] = std::min(min_lanes[lane], lanes[lane]);
+      max_lanes[lane] = std::max(max_lanes[lane], lanes[lane]);
+    }
+  }
+  if (i < count) {
+    const Point a = mapping(points[i]);
+    min_lanes[0] = std::min(min_lanes[0], a.x);
+    min_lanes[1] = std::min(min_lanes[1], a.y);
+    max_lanes[0] = std::max(max_lanes[0], a.x);
+    max_lanes[1] = std::max(max_lanes[1], a.y);
+  }
+  min = {std::min(min_lanes[0], min_lanes[2]),
+         std::min(min_lanes[1], min_lanes[3])};
+  max = {std::max(max_lanes[0], max_lanes[2]),
+         std::max(max_lanes[1], max_lanes[3])};
+}
 
-    for (const auto& point : collection) {
-      if (previous_contour_point.has_value() &&
-          previous_contour_point.value() == point) {
-        // Slip over duplicate points in the same contour.
-        continue;
-      }
-      previous_contour_point = point;
-      polyline.points.push_back(point);
+template <class Mapping>
+std::optional<std::pair<Point, Point>> Path::ComputeMinMax(
+    const Mapping& mapping) const {
+  if (points_.empty()) {
+    return std::nullopt;
+  }
+
+  Point min = mapping(points_.front());
+  Point max = min;
+
+  // Without curves, the segments are bounded by their points.
+  if (curve_count_ == 0) {
+    AccumulateMinMax(points_.data(), points_.size(), mapping, min, max);
+    return std::make_pair(min, max);
+  }
+
+  // Curves are within the hull of their points, but only bounded by their
+  // end points and extrema. The end points are bounded first, and the
+  // extrema of a curve are only needed if one of its control points is out
+  // of these bounds.
+  auto contains = [&min, &max](Point point) {
+    return point.x >= min.x && point.y >= min.y && point.x <= max.x &&
+           point.y <= max.y;
+  };
+  auto clamp = [&min, &max](const std::vector<Point>& extrema) {
+    for (const auto& extremum : extrema) {
+      min = {std::min(min.x, extremum.x), std::min(min.y, extremum.y)};
+      max = {std::max(max.x, extremum.x), std::max(max.y, extremum.y)};
     }
   };
-
-  for (size_t component_i = 0; component_i < components_.size();
-       component_i++) {
-    const auto& component = components_[component_i];
+  for (const auto& component : components_) {
+    const Point* p = points_.data() + component.index;
     switch (component.type) {
       case ComponentType::kLinear:
-        collect_points(linears_[component.index].CreatePolyline());
+        AccumulateMinMax(p, 2, mapping, min, max);
         break;
       case ComponentType::kQuadratic:
-        collect_points(quads_[component.index].CreatePolyline(approximation));
+        AccumulateMinMax(p, 1, mapping, min, max);
+        AccumulateMinMax(p + 2, 1, mapping, min, max);
         break;
       case ComponentType::kCubic:
-        collect_points(cubics_[component.index].CreatePolyline(approximation));
+        AccumulateMinMax(p, 1, mapping, min, max);
+        AccumulateMinMax(p + 3, 1, mapping, min, max);
         break;
       case ComponentType::kContour:
-        if (component_i == components_.size() - 1) {
-          // If the last component is a contour, that means it's an empty
-          // contour, so skip it.
-          continue;
+        break;
+    }
+  }
+  for (const auto& component : components_) {
+    const Point* p = points_.data() + component.index;
+    switch (component.type) {
+      case ComponentType::kQuadratic: {
+        const Point cp = mapping(p[1]);
+        if (!contains(cp)) {
+          clamp(QuadraticPathComponent(mapping(p[0]), cp, mapping(p[2]))
+                    .Extrema());
         }
-        const auto& contour = contours_[component.index];
-        polyline.contours.push_back({.start_index = polyline.points.size(),
-                                     .is_closed = contour.is_closed});
-        previous_contour_point = std::nullopt;
-        collect_points({contour.destination});
+        break;
+      }
+      case ComponentType::kCubic: {
+        const Point cp1 = mapping(p[1]);
+        const Point cp2 = mapping(p[2]);
+        if (!contains(cp1) || !contains(cp2)) {
+          clamp(CubicPathComponent(mapping(p[0]), cp1, cp2, mapping(p[3]))
+                    .Extrema());
+        }
+        break;
+      }
+      case ComponentType::kLinear:
+      case ComponentType::kContour:
         break;
     }
   }
-  return polyline;
+  return std::make_pair(min, max);
 }
 
 std::optional<Rect> Path::GetBoundingBox() const {
@@ -288,54 +409,72 @@ std::optional<Rect> Path::GetBoundingBox() const {
 
 std::optional<Rect> Path::GetTransformedBoundingBox(
     const Matrix& transform) const {
-  auto bounds = GetBoundingBox();
-  if (!bounds.has_value()) {
+  if (!transform.IsAffine()) {
+    auto bounds = GetBoundingBox();
+    if (!bounds.has_value()) {
+      return std::nullopt;
+    }
+    return bounds->TransformBounds(transform);
+  }
+  auto min_max =
+      ComputeMinMax([&transform](Point point) { return transform * point; });
+  if (!min_max.has_value()) {
     return std::nullopt;
   }
-  return bounds->TransformBounds(transform);
+  auto min = min_max->first;
+  auto max = min_max->second;
+  const auto difference = max - min;
+  return Rect{min.x, min.y, difference.x, difference.y};
 }
 
 std::optional<std::pair<Point, Point>> Path::GetMinMaxCoveragePoints() const {
-  if (linears_.empty() && quads_.empty() && cubics_.empty()) {
-    return std::nullopt;
-  }
-
-  std::optional<Point> min, max;
-
-  auto clamp = [&min, &max](const std::vector<Point>& extrema) {
-    for (const auto& extremum : extrema) {
-      if (!min.has_value()) {
-        min = extremum;
-      }
-
-      if (!max.has_value()) {
-        max = extremum;
-      }
-
-      min->x = std::min(min->x, extremum.x);
-      min->y = std::min(min->y, extremum.y);
-      max->x = std::max(max->x, extremum.x);
-      max->y = std::max(max->y, extremum.y);
-    }
-  };
+  return ComputeMinMax([](Point point) { return point; });
+}
 
-  for (const auto& linear : linears_) {
-    clamp(linear.Extrema());
+void Path::Transform(const Matrix& transform) {
+  // The points are transformed in a single loop over the contiguous points,
+  // which compilers vectorize.
+  const Scalar m0 = transform.m[0], m1 = transform.m[1];
+  const Scalar m4 = transform.m[4], m5 = transform.m[5];
+  const Scalar m12 = transform.m[12], m13 = transform.m[13];
+  Point* points = points_.data();
+  const size_t count = points_.size();
+  for (size_t i = 0; i < count; i++) {
+    const Point p = points[i];
+    points[i] = {p.x * m0 + p.y * m4 + m12, p.x * m1 + p.y * m5 + m13};
   }
-
-  for (const auto& quad : quads_) {
-    clamp(quad.Extrema());
+  for (auto& contour : contours_) {
+    contour.destination = transform * contour.destination;
   }
+}
 
-  for (const auto& cubic : cubics_) {
-    clamp(cubic.Extrema());
+std::size_t Path::GetHash() const {
+  std::size_t hash = fml::HashCombine(static_cast<int>(fill_));
+  for (const auto& component : components_) {
+    fml::HashCombineSeed(hash, static_cast<int>(component.type),
+                         component.index);
   }
-
-  if (!min.has_value() || !max.has_value()) {
-    return std::nullopt;
+  for (const auto& point : points_) {
+    fml::HashCombineSeed(hash, point.x, point.y);
+  }
+  for (const auto& contour : contours_) {
+    fml::HashCombineSeed(hash, contour.destination.x, contour.destination.y,
+                         contour.is_closed);
   }
+  return hash;
+}
 
-  return std::make_pair(min.value(), max.value());
+bool Path::operator==(const Path& other) const {
+  if (fill_ != other.fill_ || components_.size() != other.components_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < components_.size(); i++) {
+    if (components_[i].type != other.components_[i].type ||
+        components_[i].index != other.components_[i].index) {
+      return false;
+    }
+  }
+  return points_ == other.points_ && contours_ == other.contours_;
 }
 
 }  // namespace impeller
@@ -43,6 +43,14 @@ class Path {
     kContour,
   };
 
+  enum class Convexity {
+    /// The path may be concave or have several contours.
+    kUnknown,
+    /// The path is a single convex contour, such as a rectangle, a rounded
+    /// rectangle or an oval.
+    kConvex,
+  };
+
   struct PolylineContour {
     /// Index that denotes the first point of this contour.
     size_t start_index;
@@ -58,6 +66,8 @@ class Path {
     /// by indices in |breaks|.
     std::vector<Point> points;
     std::vector<PolylineContour> contours;
+    /// The convexity of the path the polyline was created from.
+    Convexity convexity = Convexity::kUnknown;
 
     /// Convenience method to compute the start (inclusive) and end (exclusive)
     /// point of the given contour index.
@@ -77,6 +87,15 @@ class Path {
 
   FillType GetFillType() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Marks the path as known to be convex, so that it can be
+  ///             filled without a general purpose tessellator. Adding or
+  ///             updating components resets it to |Convexity::kUnknown|.
+  ///
+  void SetConvexity(Convexity convexity);
+
+  Convexity GetConvexity() const;
+
   Path& AddLinearComponent(Point p1, Point p2);
 
   Path& AddQuadraticComponent(Point p1, Point cp, Point p2);
@@ -94,6 +113,37 @@ class Path {
                            Applier<CubicPathComponent> cubic_applier,
                            Applier<ContourComponent> contour_applier) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Calls |visitor| with the index and the value of each
+  ///             component of the path, in order. The |visitor| must be
+  ///             callable with a |LinearPathComponent|, a
+  ///             |QuadraticPathComponent|, a |CubicPathComponent| and a
+  ///             |ContourComponent|, such as a generic lambda.
+  ///
+  ///             Unlike |EnumerateComponents|, the calls can be inlined.
+  ///
+  template <class Visitor>
+  void VisitComponents(Visitor&& visitor) const {
+    for (size_t i = 0; i < components_.size(); i++) {
+      const auto& component = components_[i];
+      const Point* p = points_.data() + component.index;
+      switch (component.type) {
+        case ComponentType::kLinear:
+          visitor(i, LinearPathComponent(p[0], p[1]));
+          break;
+        case ComponentType::kQuadratic:
+          visitor(i, QuadraticPathComponent(p[0], p[1], p[2]));
+          break;
+        case ComponentType::kCubic:
+          visitor(i, CubicPathComponent(p[0], p[1], p[2], p[3]));
+          break;
+        case ComponentType::kContour:
+          visitor(i, contours_[component.index]);
+          break;
+      }
+    }
+  }
+
   bool GetLinearComponentAtIndex(size_t index,
                                  LinearPathComponent& linear) const;
 
@@ -116,18 +166,54 @@ class Path {
   bool UpdateContourComponentAtIndex(size_t index,
                                      const ContourComponent& contour);
 
-  Polyline CreatePolyline(
-      const SmoothingApproximation& approximation = {}) const;
+  //----------------------------------------------------------------------------
+  /// @brief      Approximates the curves of the path with line segments that
+  ///             stay within |kDefaultCurveTolerance| pixels of them, when
+  ///             the path is drawn with a transform that scales it by |scale|.
+  ///
+  Polyline CreatePolyline(Scalar scale = 1.0) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like |CreatePolyline|, but reuses the memory of |polyline|,
+  ///             whose previous points and contours are discarded.
+  ///
+  void CreatePolyline(Scalar scale, Polyline& polyline) const;
 
   std::optional<Rect> GetBoundingBox() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Computes the bounds of the path drawn with |transform|.
+  ///
+  ///             The points of the path are transformed before they are
+  ///             bounded, so the bounds stay tight under rotations and skews.
+  ///             Transforms with a perspective bound the transformed bounding
+  ///             box of the path instead.
+  ///
   std::optional<Rect> GetTransformedBoundingBox(const Matrix& transform) const;
 
   std::optional<std::pair<Point, Point>> GetMinMaxCoveragePoints() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Computes a hash of the fill type and components of the path.
+  ///             Paths that are equal have the same hash.
+  ///
+  std::size_t GetHash() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Applies the affine part of |transform| to all the points of
+  ///             the path.
+  ///
+  void Transform(const Matrix& transform);
+
+  bool operator==(const Path& other) const;
+
+  bool operator!=(const Path& other) const { return !(*this == other); }
+
  private:
   struct ComponentIndexPair {
     ComponentType type = ComponentType::kLinear;
+    /// The index of the first point of the segments in |points_|, or the
+    /// index of the contours in |contours_|.
     size_t index = 0;
 
     ComponentIndexPair() {}
@@ -137,11 +223,17 @@ class Path {
   };
 
   FillType fill_ = FillType::kNonZero;
+  Convexity convexity_ = Convexity::kUnknown;
   std::vector<ComponentIndexPair> components_;
-  std::vector<LinearPathComponent> linears_;
-  std::vector<QuadraticPathComponent> quads_;
-  std::vector<CubicPathComponent> cubics_;
+  // The points of the segments, back to back: two for lines, three for
+  // quadratic curves and four for cubic curves.
+  std::vector<Point> points_;
   std::vector<ContourComponent> contours_;
+  size_t curve_count_ = 0;
+
+  template <class Mapping>
+  std::optional<std::pair<Point, Point>> ComputeMinMax(
+      const Mapping& mapping) const;
 };
 
 }  // namespace impeller
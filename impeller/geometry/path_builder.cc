@@ -5,6 +5,7 @@
 #include "path_builder.h"
 
 #include <cmath>
+#include <type_traits>
 
 namespace impeller {
 
@@ -169,6 +170,7 @@ PathBuilder& PathBuilder::AddCubicCurve(Point p1,
 }
 
 PathBuilder& PathBuilder::AddRect(Rect rect) {
+  const bool is_first_contour = prototype_.GetComponentCount() <= 1;
   current_ = rect.origin;
 
   auto tl = rect.origin;
@@ -182,6 +184,9 @@ PathBuilder& PathBuilder::AddRect(Rect rect) {
       .AddLinearComponent(br, bl);
   Close();
 
+  if (is_first_contour) {
+    prototype_.SetConvexity(Path::Convexity::kConvex);
+  }
   return *this;
 }
 
@@ -194,11 +199,28 @@ PathBuilder& PathBuilder::AddRoundedRect(Rect rect, Scalar radius) {
                        : AddRoundedRect(rect, {radius, radius, radius, radius});
 }
 
+// Whether the corners of a rounded rectangle don't overlap, which would make
+// its outline cross itself.
+static bool RadiiFitInRect(const Rect& rect,
+                           const PathBuilder::RoundingRadii& radii) {
+  for (const auto& radius : {radii.top_left, radii.bottom_left,
+                             radii.top_right, radii.bottom_right}) {
+    if (radius.x < 0 || radius.y < 0) {
+      return false;
+    }
+  }
+  return radii.top_left.x + radii.top_right.x <= rect.size.width &&
+         radii.bottom_left.x + radii.bottom_right.x <= rect.size.width &&
+         radii.top_left.y + radii.bottom_left.y <= rect.size.height &&
+         radii.top_right.y + radii.bottom_right.y <= rect.size.height;
+}
+
 PathBuilder& PathBuilder::AddRoundedRect(Rect rect, RoundingRadii radii) {
   if (radii.AreAllZero()) {
     return AddRect(rect);
   }
 
+  const bool is_first_contour = prototype_.GetComponentCount() <= 1;
   current_ = rect.origin + Point{radii.top_left.x, 0.0};
 
   const auto magic_top_right = radii.top_right * kArcApproximationMagic;
@@ -286,6 +308,9 @@ PathBuilder& PathBuilder::AddRoundedRect(Rect rect, RoundingRadii radii) {
 
   Close();
 
+  if (is_first_contour && RadiiFitInRect(rect, radii)) {
+    prototype_.SetConvexity(Path::Convexity::kConvex);
+  }
   return *this;
 }
 
@@ -350,6 +375,7 @@ PathBuilder& PathBuilder::AddArc(const Rect& oval_bounds,
 }
 
 PathBuilder& PathBuilder::AddOval(const Rect& container) {
+  const bool is_first_contour = prototype_.GetComponentCount() <= 1;
   const Point r = {container.size.width * 0.5f, container.size.height * 0.5f};
   const Point c = {container.origin.x + r.x, container.origin.y + r.y};
   const Point m = {kArcApproximationMagic * r.x, kArcApproximationMagic * r.y};
@@ -394,6 +420,9 @@ PathBuilder& PathBuilder::AddOval(const Rect& container) {
 
   Close();
 
+  if (is_first_contour) {
+    prototype_.SetConvexity(Path::Convexity::kConvex);
+  }
   return *this;
 }
 
@@ -408,19 +437,20 @@ const Path& PathBuilder::GetCurrentPath() const {
 }
 
 PathBuilder& PathBuilder::AddPath(const Path& path) {
-  auto linear = [&](size_t index, const LinearPathComponent& l) {
-    prototype_.AddLinearComponent(l.p1, l.p2);
-  };
-  auto quadratic = [&](size_t index, const QuadraticPathComponent& q) {
-    prototype_.AddQuadraticComponent(q.p1, q.cp, q.p2);
-  };
-  auto cubic = [&](size_t index, const CubicPathComponent& c) {
-    prototype_.AddCubicComponent(c.p1, c.cp1, c.cp2, c.p2);
-  };
-  auto move = [&](size_t index, const ContourComponent& m) {
-    prototype_.AddContourComponent(m.destination);
-  };
-  path.EnumerateComponents(linear, quadratic, cubic, move);
+  path.VisitComponents([&](size_t index, const auto& component) {
+    using Component = std::decay_t<decltype(component)>;
+    if constexpr (std::is_same_v<Component, LinearPathComponent>) {
+      prototype_.AddLinearComponent(component.p1, component.p2);
+    } else if constexpr (std::is_same_v<Component, QuadraticPathComponent>) {
+      prototype_.AddQuadraticComponent(component.p1, component.cp,
+                                       component.p2);
+    } else if constexpr (std::is_same_v<Component, CubicPathComponent>) {
+      prototype_.AddCubicComponent(component.p1, component.cp1, component.cp2,
+                                   component.p2);
+    } else {
+      prototype_.AddContourComponent(component.destination);
+    }
+  });
   return *this;
 }
 
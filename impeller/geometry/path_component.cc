@@ -4,13 +4,14 @@
 
 #include "path_component.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace impeller {
 
-static const size_t kRecursionLimit = 32;
-static const Scalar kCurveCollinearityEpsilon = 1e-30;
-static const Scalar kCurveAngleToleranceEpsilon = 0.01;
+// Bounds the number of points of a single curve, such as one that is scaled
+// by an enormous transform.
+static constexpr size_t kMaxSegmentCount = 1 << 10;
 
 /*
  *  Based on: https://en.wikipedia.org/wiki/B%C3%A9zier_curve#Specific_cases
@@ -63,8 +64,16 @@ Point LinearPathComponent::Solve(Scalar time) const {
   };
 }
 
-std::vector<Point> LinearPathComponent::CreatePolyline() const {
-  return {p2};
+// Skips the points that repeat the last point, which don't add segments.
+static inline void AppendPoint(std::vector<Point>& points, Point point) {
+  if (points.empty() || points.back() != point) {
+    points.push_back(point);
+  }
+}
+
+void LinearPathComponent::AppendPolylinePoints(
+    std::vector<Point>& points) const {
+  AppendPoint(points, p2);
 }
 
 std::vector<Point> LinearPathComponent::Extrema() const {
@@ -85,10 +94,41 @@ Point QuadraticPathComponent::SolveDerivative(Scalar time) const {
   };
 }
 
-std::vector<Point> QuadraticPathComponent::CreatePolyline(
-    const SmoothingApproximation& approximation) const {
-  CubicPathComponent elevated(*this);
-  return elevated.CreatePolyline(approximation);
+/*
+ *  Wang's formula bounds the distance between a Bézier curve of degree n and
+ *  the polyline through N + 1 evenly spaced points on it by
+ *  n * (n - 1) / (8 * N^2) * M, where M is the largest second difference of its
+ *  control points. The curve stays within the tolerance when
+ *  N = sqrt(n * (n - 1) / 8 * M / tolerance).
+ */
+static size_t WangsFormulaSegmentCount(Scalar degree_factor,
+                                       Scalar second_difference,
+                                       Scalar scale) {
+  const Scalar segments = std::ceil(std::sqrt(
+      degree_factor * second_difference * scale / kDefaultCurveTolerance));
+  if (!(segments >= 1)) {
+    // Also catches NaNs.
+    return 1;
+  }
+  if (segments >= kMaxSegmentCount) {
+    return kMaxSegmentCount;
+  }
+  return static_cast<size_t>(segments);
+}
+
+size_t QuadraticPathComponent::GetSegmentCount(Scalar scale) const {
+  return WangsFormulaSegmentCount(2.0 / 8.0, (p1 - cp * 2 + p2).GetLength(),
+                                  scale);
+}
+
+void QuadraticPathComponent::AppendPolylinePoints(
+    Scalar scale,
+    std::vector<Point>& points) const {
+  const size_t count = GetSegmentCount(scale);
+  for (size_t i = 1; i < count; i++) {
+    AppendPoint(points, Solve(static_cast<Scalar>(i) / count));
+  }
+  AppendPoint(points, p2);
 }
 
 std::vector<Point> QuadraticPathComponent::Extrema() const {
@@ -110,238 +150,21 @@ Point CubicPathComponent::SolveDerivative(Scalar time) const {
   };
 }
 
-/*
- *  Paul de Casteljau's subdivision with modifications as described in
- *  http://agg.sourceforge.net/antigrain.com/research/adaptive_bezier/index.html.
- *  Refer to the diagram on that page for a description of the points.
- */
-static void CubicPathSmoothenRecursive(const SmoothingApproximation& approx,
-                                       std::vector<Point>& points,
-                                       Point p1,
-                                       Point p2,
-                                       Point p3,
-                                       Point p4,
-                                       size_t level) {
-  if (level >= kRecursionLimit) {
-    return;
-  }
-
-  /*
-   *  Find all midpoints.
-   */
-  auto p12 = (p1 + p2) / 2.0;
-  auto p23 = (p2 + p3) / 2.0;
-  auto p34 = (p3 + p4) / 2.0;
-
-  auto p123 = (p12 + p23) / 2.0;
-  auto p234 = (p23 + p34) / 2.0;
-
-  auto p1234 = (p123 + p234) / 2.0;
-
-  /*
-   *  Attempt approximation using single straight line.
-   */
-  auto d = p4 - p1;
-  Scalar d2 = fabs(((p2.x - p4.x) * d.y - (p2.y - p4.y) * d.x));
-  Scalar d3 = fabs(((p3.x - p4.x) * d.y - (p3.y - p4.y) * d.x));
-
-  Scalar da1 = 0;
-  Scalar da2 = 0;
-  Scalar k = 0;
-
-  switch ((static_cast<int>(d2 > kCurveCollinearityEpsilon) << 1) +
-          static_cast<int>(d3 > kCurveCollinearityEpsilon)) {
-    case 0:
-      /*
-       *  All collinear OR p1 == p4.
-       */
-      k = d.x * d.x + d.y * d.y;
-      if (k == 0) {
-        d2 = p1.GetDistanceSquared(p2);
-        d3 = p4.GetDistanceSquared(p3);
-      } else {
-        k = 1.0 / k;
-        da1 = p2.x - p1.x;
-        da2 = p2.y - p1.y;
-        d2 = k * (da1 * d.x + da2 * d.y);
-        da1 = p3.x - p1.x;
-        da2 = p3.y - p1.y;
-        d3 = k * (da1 * d.x + da2 * d.y);
-
-        if (d2 > 0 && d2 < 1 && d3 > 0 && d3 < 1) {
-          /*
-           *  Simple collinear case, 1---2---3---4. Leave just two endpoints.
-           */
-          return;
-        }
-
-        if (d2 <= 0) {
-          d2 = p2.GetDistanceSquared(p1);
-        } else if (d2 >= 1) {
-          d2 = p2.GetDistanceSquared(p4);
-        } else {
-          d2 = p2.GetDistanceSquared({p1.x + d2 * d.x, p1.y + d2 * d.y});
-        }
-
-        if (d3 <= 0) {
-          d3 = p3.GetDistanceSquared(p1);
-        } else if (d3 >= 1) {
-          d3 = p3.GetDistanceSquared(p4);
-        } else {
-          d3 = p3.GetDistanceSquared({p1.x + d3 * d.x, p1.y + d3 * d.y});
-        }
-      }
-
-      if (d2 > d3) {
-        if (d2 < approx.distance_tolerance_square) {
-          points.emplace_back(p2);
-          return;
-        }
-      } else {
-        if (d3 < approx.distance_tolerance_square) {
-          points.emplace_back(p3);
-          return;
-        }
-      }
-      break;
-    case 1:
-      /*
-       *  p1, p2, p4 are collinear, p3 is significant.
-       */
-      if (d3 * d3 <=
-          approx.distance_tolerance_square * (d.x * d.x + d.y * d.y)) {
-        if (approx.angle_tolerance < kCurveAngleToleranceEpsilon) {
-          points.emplace_back(p23);
-          return;
-        }
-
-        /*
-         *  Angle Condition.
-         */
-        da1 = ::fabs(::atan2(p4.y - p3.y, p4.x - p3.x) -
-                     ::atan2(p3.y - p2.y, p3.x - p2.x));
-
-        if (da1 >= M_PI) {
-          da1 = 2.0 * M_PI - da1;
-        }
-
-        if (da1 < approx.angle_tolerance) {
-          points.emplace_back(p2);
-          points.emplace_back(p3);
-          return;
-        }
-
-        if (approx.cusp_limit != 0.0) {
-          if (da1 > approx.cusp_limit) {
-            points.emplace_back(p3);
-            return;
-          }
-        }
-      }
-      break;
-
-    case 2:
-      /*
-       *  p1,p3,p4 are collinear, p2 is significant.
-       */
-      if (d2 * d2 <=
-          approx.distance_tolerance_square * (d.x * d.x + d.y * d.y)) {
-        if (approx.angle_tolerance < kCurveAngleToleranceEpsilon) {
-          points.emplace_back(p23);
-          return;
-        }
-
-        /*
-         *  Angle Condition.
-         */
-        da1 = ::fabs(::atan2(p3.y - p2.y, p3.x - p2.x) -
-                     ::atan2(p2.y - p1.y, p2.x - p1.x));
-
-        if (da1 >= M_PI) {
-          da1 = 2.0 * M_PI - da1;
-        }
-
-        if (da1 < approx.angle_tolerance) {
-          points.emplace_back(p2);
-          points.emplace_back(p3);
-          return;
-        }
-
-        if (approx.cusp_limit != 0.0) {
-          if (da1 > approx.cusp_limit) {
-            points.emplace_back(p2);
-            return;
-          }
-        }
-      }
-      break;
-
-    case 3:
-      /*
-       *  Regular case.
-       */
-      if ((d2 + d3) * (d2 + d3) <=
-          approx.distance_tolerance_square * (d.x * d.x + d.y * d.y)) {
-        /*
-         *  If the curvature doesn't exceed the distance_tolerance value
-         *  we tend to finish subdivisions.
-         */
-        if (approx.angle_tolerance < kCurveAngleToleranceEpsilon) {
-          points.emplace_back(p23);
-          return;
-        }
-
-        /*
-         *  Angle & Cusp Condition.
-         */
-        k = ::atan2(p3.y - p2.y, p3.x - p2.x);
-        da1 = ::fabs(k - ::atan2(p2.y - p1.y, p2.x - p1.x));
-        da2 = ::fabs(::atan2(p4.y - p3.y, p4.x - p3.x) - k);
-
-        if (da1 >= M_PI) {
-          da1 = 2.0 * M_PI - da1;
-        }
-
-        if (da2 >= M_PI) {
-          da2 = 2.0 * M_PI - da2;
-        }
-
-        if (da1 + da2 < approx.angle_tolerance) {
-          /*
-           *  Finally we can stop the recursion.
-           */
-          points.emplace_back(p23);
-          return;
-        }
-
-        if (approx.cusp_limit != 0.0) {
-          if (da1 > approx.cusp_limit) {
-            points.emplace_back(p2);
-            return;
-          }
-
-          if (da2 > approx.cusp_limit) {
-            points.emplace_back(p3);
-            return;
-          }
-        }
-      }
-      break;
-  }
-
-  /*
-   *  Continue subdivision.
-   */
-  CubicPathSmoothenRecursive(approx, points, p1, p12, p123, p1234, level + 1);
-  CubicPathSmoothenRecursive(approx, points, p1234, p234, p34, p4, level + 1);
+size_t CubicPathComponent::GetSegmentCount(Scalar scale) const {
+  const Scalar second_difference =
+      std::max((p1 - cp1 * 2 + cp2).GetLength(),
+               (cp1 - cp2 * 2 + p2).GetLength());
+  return WangsFormulaSegmentCount(6.0 / 8.0, second_difference, scale);
 }
 
-std::vector<Point> CubicPathComponent::CreatePolyline(
-    const SmoothingApproximation& approximation) const {
-  std::vector<Point> points;
-  CubicPathSmoothenRecursive(approximation, points, p1, cp1, cp2, p2, 0);
-  points.emplace_back(p2);
-  return points;
+void CubicPathComponent::AppendPolylinePoints(
+    Scalar scale,
+    std::vector<Point>& points) const {
+  const size_t count = GetSegmentCount(scale);
+  for (size_t i = 1; i < count; i++) {
+    AppendPoint(points, Solve(static_cast<Scalar>(i) / count));
+  }
+  AppendPoint(points, p2);
 }
 
 static inline bool NearEqual(Scalar a, Scalar b, Scalar epsilon) {
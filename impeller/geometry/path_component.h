@@ -12,46 +12,9 @@
 
 namespace impeller {
 
-/// Information about how to approximate points on a curved path segment.
-///
-/// In particular, the values in this object control how many vertices to
-/// generate when approximating curves, and what tolerances to use when
-/// calculating the sharpness of curves.
-struct SmoothingApproximation {
-  /// The scaling coefficient to use when translating to screen coordinates.
-  ///
-  /// Values approaching 0.0 will generate smoother looking curves with a
-  /// greater number of vertices, and will be more expensive to calculate.
-  Scalar scale;
-
-  /// The tolerance value in radians for calculating sharp angles.
-  ///
-  /// Values approaching 0.0 will provide more accurate approximation of sharp
-  /// turns. A 0.0 value means angle conditions are not considered at all.
-  Scalar angle_tolerance;
-
-  /// An angle in radians at which to introduce bevel cuts.
-  ///
-  /// Values greater than zero will restirct the sharpness of bevel cuts on
-  /// turns.
-  Scalar cusp_limit;
-
-  /// Used to more quickly detect colinear cases.
-  Scalar distance_tolerance_square;
-
-  SmoothingApproximation(/* default */)
-      : SmoothingApproximation(1.0 /* scale */,
-                               0.0 /* angle tolerance */,
-                               0.0 /* cusp limit */) {}
-
-  SmoothingApproximation(Scalar p_scale,
-                         Scalar p_angle_tolerance,
-                         Scalar p_cusp_limit)
-      : scale(p_scale),
-        angle_tolerance(p_angle_tolerance),
-        cusp_limit(p_cusp_limit),
-        distance_tolerance_square(0.5 * p_scale * 0.5 * p_scale) {}
-};
+/// The maximum distance, in device pixels, between a curve and the line
+/// segments that approximate it.
+static constexpr Scalar kDefaultCurveTolerance = 0.1f;
 
 struct LinearPathComponent {
   Point p1;
@@ -63,7 +26,7 @@ struct LinearPathComponent {
 
   Point Solve(Scalar time) const;
 
-  std::vector<Point> CreatePolyline() const;
+  void AppendPolylinePoints(std::vector<Point>& points) const;
 
   std::vector<Point> Extrema() const;
 
@@ -86,8 +49,21 @@ struct QuadraticPathComponent {
 
   Point SolveDerivative(Scalar time) const;
 
-  std::vector<Point> CreatePolyline(
-      const SmoothingApproximation& approximation) const;
+  //----------------------------------------------------------------------------
+  /// @brief      Appends the points of the line segments that approximate the
+  ///             curve, except its first point, to |points|.
+  ///
+  ///             The number of segments is given by Wang's formula, so that
+  ///             they stay within |kDefaultCurveTolerance| pixels of the curve
+  ///             when it is drawn with a transform that scales it by |scale|.
+  ///
+  void AppendPolylinePoints(Scalar scale, std::vector<Point>& points) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of line segments that approximate the curve when
+  ///             it is scaled by |scale|.
+  ///
+  size_t GetSegmentCount(Scalar scale) const;
 
   std::vector<Point> Extrema() const;
 
@@ -117,8 +93,10 @@ struct CubicPathComponent {
 
   Point SolveDerivative(Scalar time) const;
 
-  std::vector<Point> CreatePolyline(
-      const SmoothingApproximation& approximation) const;
+  /// See |QuadraticPathComponent::AppendPolylinePoints|.
+  void AppendPolylinePoints(Scalar scale, std::vector<Point>& points) const;
+
+  size_t GetSegmentCount(Scalar scale) const;
 
   std::vector<Point> Extrema() const;
 
@@ -26,6 +26,11 @@ class TextureMTL final : public Texture,
   // |Texture|
   bool SetContents(const uint8_t* contents, size_t length) override;
 
+  // |Texture|
+  bool SetRegionContents(const uint8_t* contents,
+                         size_t bytes_per_row,
+                         IRect region) override;
+
   // |Texture|
   bool IsValid() const override;
 
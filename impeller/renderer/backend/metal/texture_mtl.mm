@@ -57,6 +57,35 @@ bool TextureMTL::SetContents(const uint8_t* contents, size_t length) {
   return true;
 }
 
+bool TextureMTL::SetRegionContents(const uint8_t* contents,
+                                   size_t bytes_per_row,
+                                   IRect region) {
+  if (!IsValid() || !contents || region.IsEmpty()) {
+    return false;
+  }
+
+  const auto& desc = GetTextureDescriptor();
+
+  // Out of bounds access.
+  if (region.origin.x < 0 || region.origin.y < 0 ||
+      !IRect::MakeSize(desc.size).Contains(region) ||
+      bytes_per_row <
+          region.size.width * BytesPerPixelForPixelFormat(desc.format)) {
+    return false;
+  }
+
+  const auto mtl_region =
+      MTLRegionMake2D(region.origin.x, region.origin.y, region.size.width,
+                      region.size.height);
+  [texture_ replaceRegion:mtl_region     //
+              mipmapLevel:0u             //
+                withBytes:contents       //
+              bytesPerRow:bytes_per_row  //
+  ];
+
+  return true;
+}
+
 ISize TextureMTL::GetSize() const {
   return {static_cast<ISize::Type>(texture_.width),
           static_cast<ISize::Type>(texture_.height)};
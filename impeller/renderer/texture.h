@@ -7,6 +7,7 @@
 #include <string_view>
 
 #include "flutter/fml/macros.h"
+#include "impeller/geometry/rect.h"
 #include "impeller/geometry/size.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/texture_descriptor.h"
@@ -22,6 +23,20 @@ class Texture {
   [[nodiscard]] virtual bool SetContents(const uint8_t* contents,
                                          size_t length) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replaces the contents of a region of the base mip level,
+  ///             leaving the rest of the texture untouched.
+  ///
+  /// @param[in]  contents       The first pixel of the region.
+  /// @param[in]  bytes_per_row  The distance between the rows of |contents|.
+  /// @param[in]  region         The region of the texture to replace.
+  ///
+  /// @return     If the region is within the texture and was replaced.
+  ///
+  [[nodiscard]] virtual bool SetRegionContents(const uint8_t* contents,
+                                               size_t bytes_per_row,
+                                               IRect region) = 0;
+
   virtual bool IsValid() const = 0;
 
   virtual ISize GetSize() const = 0;
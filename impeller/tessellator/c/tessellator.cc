@@ -43,8 +43,10 @@ struct Vertices* Tessellate(PathBuilder* builder,
                             Scalar angle_tolerance,
                             Scalar cusp_limit) {
   auto path = builder->CopyPath(static_cast<FillType>(fill_type));
-  auto smoothing = SmoothingApproximation(scale, angle_tolerance, cusp_limit);
-  auto polyline = path.CreatePolyline(smoothing);
+  // Smaller |scale|s approximate curves more finely, so |scale| is the inverse
+  // of the scale of the transform the curves are flattened for. The angle
+  // tolerance and the cusp limit are no longer used.
+  auto polyline = path.CreatePolyline(scale > 0 ? 1.0 / scale : 1.0);
 
   std::vector<float> points;
   if (Tessellator{}.Tessellate(path.GetFillType(), polyline,
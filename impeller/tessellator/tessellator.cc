@@ -4,11 +4,119 @@
 
 #include "impeller/tessellator/tessellator.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <tuple>
+#include <utility>
+
 #include "third_party/libtess2/Include/tesselator.h"
 
 namespace impeller {
 
-Tessellator::Tessellator() = default;
+//------------------------------------------------------------------------------
+/// The allocator of libtess2. Memory is bumped out of blocks that are only
+/// reclaimed all at once by |Reset|, after the tessellation.
+///
+class Tessellator::Arena {
+ public:
+  Arena() {
+    allocator_.memalloc = &Arena::Alloc;
+    allocator_.memrealloc = &Arena::Realloc;
+    allocator_.memfree = &Arena::Free;
+    allocator_.userData = this;
+  }
+
+  TESSalloc* GetAllocator() { return &allocator_; }
+
+  void Reset() {
+    current_block_ = 0;
+    offset_ = 0;
+    // Releases the blocks of unusually large tessellations.
+    size_t retained_bytes = 0;
+    for (size_t i = 0; i < blocks_.size(); i++) {
+      retained_bytes += blocks_[i].size;
+      if (retained_bytes > kMaxRetainedBytes) {
+        blocks_.resize(i);
+        break;
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+  static constexpr size_t kMaxRetainedBytes = 1024 * 1024;
+  // Each allocation is preceded by its size, which |Realloc| needs to copy
+  // it.
+  static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+  struct Block {
+    std::unique_ptr<uint8_t[]> memory;
+    size_t size;
+  };
+
+  TESSalloc allocator_ = {};
+  std::vector<Block> blocks_;
+  size_t current_block_ = 0;
+  size_t offset_ = 0;
+
+  void* Allocate(size_t size) {
+    const size_t aligned_size =
+        (kHeaderSize + size + kHeaderSize - 1) & ~(kHeaderSize - 1);
+    uint8_t* allocation = nullptr;
+    while (current_block_ < blocks_.size()) {
+      if (offset_ + aligned_size <= blocks_[current_block_].size) {
+        allocation = blocks_[current_block_].memory.get() + offset_;
+        offset_ += aligned_size;
+        break;
+      }
+      current_block_++;
+      offset_ = 0;
+    }
+    if (allocation == nullptr) {
+      const size_t block_size = std::max(kBlockSize, aligned_size);
+      blocks_.push_back(
+          {std::unique_ptr<uint8_t[]>(new uint8_t[block_size]), block_size});
+      current_block_ = blocks_.size() - 1;
+      allocation = blocks_.back().memory.get();
+      offset_ = aligned_size;
+    }
+    std::memcpy(allocation, &size, sizeof(size));
+    return allocation + kHeaderSize;
+  }
+
+  static size_t GetSize(void* ptr) {
+    size_t size;
+    std::memcpy(&size, static_cast<uint8_t*>(ptr) - kHeaderSize, sizeof(size));
+    return size;
+  }
+
+  static void* Alloc(void* user_data, unsigned int size) {
+    return static_cast<Arena*>(user_data)->Allocate(size);
+  }
+
+  static void* Realloc(void* user_data, void* ptr, unsigned int size) {
+    if (ptr == nullptr) {
+      return Alloc(user_data, size);
+    }
+    const size_t old_size = GetSize(ptr);
+    if (size <= old_size) {
+      return ptr;
+    }
+    void* allocation = Alloc(user_data, size);
+    std::memcpy(allocation, ptr, old_size);
+    return allocation;
+  }
+
+  static void Free(void* user_data, void* ptr) {
+    // Reclaimed by |Reset|.
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Arena);
+};
+
+Tessellator::Tessellator() : arena_(std::make_unique<Arena>()) {}
 
 Tessellator::~Tessellator() = default;
 
@@ -34,9 +142,65 @@ static void DestroyTessellator(TESStesselator* tessellator) {
   }
 }
 
+bool Tessellator::IsConvex(const Point* points, size_t count) {
+  if (count < 3) {
+    return true;
+  }
+  // The turns between the edges must all be on the same side, and the edges
+  // may only change their horizontal and vertical directions twice, or the
+  // contour winds around more than once.
+  int turn_sign = 0;
+  int x_sign = 0;
+  int y_sign = 0;
+  int x_changes = 0;
+  int y_changes = 0;
+  std::optional<Point> previous_edge;
+  auto count_changes = [](Scalar delta, int& sign, int& changes) {
+    if (delta == 0) {
+      return;
+    }
+    const int delta_sign = delta > 0 ? 1 : -1;
+    if (sign != 0 && delta_sign != sign) {
+      changes++;
+    }
+    sign = delta_sign;
+  };
+  // Goes around the contour twice, so that the direction changes are counted
+  // once all the way around during the second lap.
+  for (size_t i = 0; i < 2 * count; i++) {
+    if (i == count) {
+      x_changes = 0;
+      y_changes = 0;
+    }
+    const Point edge = points[(i + 1) % count] - points[i % count];
+    if (edge.IsZero()) {
+      continue;
+    }
+    if (previous_edge.has_value()) {
+      const Scalar cross = previous_edge->Cross(edge);
+      if (cross == 0) {
+        if (previous_edge->Dot(edge) < 0) {
+          // The contour turns back on itself.
+          return false;
+        }
+      } else {
+        const int sign = cross > 0 ? 1 : -1;
+        if (turn_sign != 0 && sign != turn_sign) {
+          return false;
+        }
+        turn_sign = sign;
+      }
+    }
+    previous_edge = edge;
+    count_changes(edge.x, x_sign, x_changes);
+    count_changes(edge.y, y_sign, y_changes);
+  }
+  return x_changes <= 2 && y_changes <= 2;
+}
+
 Tessellator::Result Tessellator::Tessellate(FillType fill_type,
                                             const Path::Polyline& polyline,
-                                            VertexCallback callback) const {
+                                            VertexCallback callback) {
   if (!callback) {
     return Result::kInputError;
   }
@@ -45,14 +209,42 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
     return Result::kInputError;
   }
 
+  //----------------------------------------------------------------------------
+  /// Fill single convex contours with a fan of triangles. Every point inside
+  /// them has a winding of one, so this only holds for the fill types that
+  /// fill all the points with an odd or a non-zero winding.
+  ///
+  if (polyline.contours.size() == 1 &&
+      (fill_type == FillType::kNonZero || fill_type == FillType::kOdd)) {
+    size_t start_point_index, end_point_index;
+    std::tie(start_point_index, end_point_index) =
+        polyline.GetContourPointBounds(0);
+    const Point* points = polyline.points.data() + start_point_index;
+    size_t count = end_point_index - start_point_index;
+    // Contours are filled as if they were closed, so the point that closes
+    // the contour isn't needed.
+    if (count > 1 && points[0] == points[count - 1]) {
+      count--;
+    }
+    if (polyline.convexity == Path::Convexity::kConvex ||
+        IsConvex(points, count)) {
+      for (size_t i = 1; i + 1 < count; i++) {
+        callback(points[0]);
+        callback(points[i]);
+        callback(points[i + 1]);
+      }
+      return Result::kSuccess;
+    }
+  }
+
   using CTessellator =
       std::unique_ptr<TESStesselator, decltype(&DestroyTessellator)>;
 
-  CTessellator tessellator(
-      ::tessNewTess(nullptr /* the default ::malloc based allocator */),
-      DestroyTessellator);
+  CTessellator tessellator(::tessNewTess(arena_->GetAllocator()),
+                           DestroyTessellator);
 
   if (!tessellator) {
+    arena_->Reset();
     return Result::kTessellationError;
   }
 
@@ -89,31 +281,31 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
   );
 
   if (result != 1) {
+    tessellator.reset();
+    arena_->Reset();
     return Result::kTessellationError;
   }
 
-  // TODO(csg): This copy can be elided entirely for the current use case.
-  std::vector<Point> points;
-  std::vector<uint32_t> indices;
-
-  int vertexItemCount = tessGetVertexCount(tessellator.get()) * kVertexSize;
   auto vertices = tessGetVertices(tessellator.get());
-  for (int i = 0; i < vertexItemCount; i += 2) {
-    points.emplace_back(vertices[i], vertices[i + 1]);
-  }
-
   int elementItemCount = tessGetElementCount(tessellator.get()) * kPolygonSize;
   auto elements = tessGetElements(tessellator.get());
   for (int i = 0; i < elementItemCount; i++) {
-    indices.emplace_back(elements[i]);
+    auto vertex = vertices + elements[i] * kVertexSize;
+    callback({vertex[0], vertex[1]});
   }
 
-  for (auto index : indices) {
-    auto vtx = points[index];
-    callback(vtx);
-  }
+  // The memory of the tessellator is reclaimed all at once.
+  tessellator.reset();
+  arena_->Reset();
 
   return Result::kSuccess;
 }
 
+Tessellator::Result Tessellator::Tessellate(const Path& path,
+                                            Scalar scale,
+                                            VertexCallback callback) {
+  path.CreatePolyline(scale, polyline_);
+  return Tessellate(path.GetFillType(), polyline_, std::move(callback));
+}
+
 }  // namespace impeller
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -22,6 +23,13 @@ enum class WindingOrder {
 /// @brief      A utility that generates triangles of the specified fill type
 ///             given a polyline. This happens on the CPU.
 ///
+///             Polylines made of a single convex contour, such as rectangles,
+///             rounded rectangles and ovals, are split into a fan of
+///             triangles directly. Other polylines are tessellated by libtess2,
+///             whose allocations come from blocks of memory that the
+///             tessellator keeps between calls. Reuse a tessellator to avoid
+///             allocating those blocks again.
+///
 /// @bug        This should just be called a triangulator.
 ///
 class Tessellator {
@@ -49,9 +57,30 @@ class Tessellator {
   ///
   Tessellator::Result Tessellate(FillType fill_type,
                                  const Path::Polyline& polyline,
-                                 VertexCallback callback) const;
+                                 VertexCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Generates filled triangles from a path, whose curves are
+  ///             flattened for a transform that scales it by |scale|.
+  ///
+  ///             The memory of the polyline is kept for the next paths.
+  ///
+  Tessellator::Result Tessellate(const Path& path,
+                                 Scalar scale,
+                                 VertexCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the contour with the given points is convex and
+  ///             doesn't cross itself.
+  ///
+  static bool IsConvex(const Point* points, size_t count);
 
  private:
+  class Arena;
+
+  std::unique_ptr<Arena> arena_;
+  Path::Polyline polyline_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(Tessellator);
 };
 
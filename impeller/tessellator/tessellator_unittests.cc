@@ -46,5 +46,67 @@ TEST(TessellatorTest, TessellatorReturnsCorrectResultStatus) {
   }
 }
 
+TEST(TessellatorTest, ConvexContoursAreFilledWithFans) {
+  // A rectangle is split into two triangles.
+  {
+    Tessellator t;
+    auto polyline = PathBuilder{}
+                        .AddRect(Rect::MakeXYWH(0, 0, 10, 20))
+                        .TakePath()
+                        .CreatePolyline();
+    std::vector<Point> vertices;
+    Tessellator::Result result =
+        t.Tessellate(FillType::kNonZero, polyline,
+                     [&vertices](Point point) { vertices.push_back(point); });
+
+    ASSERT_EQ(polyline.convexity, Path::Convexity::kConvex);
+    ASSERT_EQ(result, Tessellator::Result::kSuccess);
+    std::vector<Point> expected = {{0, 0}, {10, 0},  {10, 20},
+                                   {0, 0}, {10, 20}, {0, 20}};
+    ASSERT_EQ(vertices, expected);
+  }
+
+  // Any other convex contour is split into a fan around its first point.
+  {
+    Tessellator t;
+    auto polyline = PathBuilder{}
+                        .MoveTo({0, 0})
+                        .LineTo({10, 0})
+                        .LineTo({15, 10})
+                        .LineTo({5, 15})
+                        .Close()
+                        .TakePath()
+                        .CreatePolyline();
+    std::vector<Point> vertices;
+    Tessellator::Result result =
+        t.Tessellate(FillType::kOdd, polyline,
+                     [&vertices](Point point) { vertices.push_back(point); });
+
+    ASSERT_EQ(polyline.convexity, Path::Convexity::kUnknown);
+    ASSERT_EQ(result, Tessellator::Result::kSuccess);
+    std::vector<Point> expected = {{0, 0}, {10, 0},  {15, 10},
+                                   {0, 0}, {15, 10}, {5, 15}};
+    ASSERT_EQ(vertices, expected);
+  }
+}
+
+TEST(TessellatorTest, IsConvex) {
+  std::vector<Point> square = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+  ASSERT_TRUE(Tessellator::IsConvex(square.data(), square.size()));
+
+  std::vector<Point> collinear = {{0, 0}, {5, 0}, {10, 0}, {10, 10}, {0, 10}};
+  ASSERT_TRUE(Tessellator::IsConvex(collinear.data(), collinear.size()));
+
+  std::vector<Point> concave = {{0, 0}, {10, 0}, {10, 10}, {5, 5}, {0, 10}};
+  ASSERT_FALSE(Tessellator::IsConvex(concave.data(), concave.size()));
+
+  // Always turns the same way, but winds around twice.
+  std::vector<Point> star = {{0, -10}, {6, 8}, {-9, -3}, {9, -3}, {-6, 8}};
+  ASSERT_FALSE(Tessellator::IsConvex(star.data(), star.size()));
+
+  std::vector<Point> spike = {{0, 0}, {10, 0}, {20, 0}, {10, 0}, {10, 10}};
+  ASSERT_FALSE(Tessellator::IsConvex(spike.data(), spike.size()));
+}
+
 }  // namespace testing
 }  // namespace impeller
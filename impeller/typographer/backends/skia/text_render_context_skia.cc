@@ -4,9 +4,14 @@
 
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 
+#include <utility>
+#include <vector>
+
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
+#include "impeller/base/validation.h"
 #include "impeller/renderer/allocator.h"
+#include "impeller/renderer/renderer.h"
 #include "impeller/typographer/backends/skia/typeface_skia.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -19,6 +24,21 @@
 
 namespace impeller {
 
+// The persistent atlas is divided in square plots of this size. Glyphs are
+// packed in the plots, and evicted a plot at a time.
+static constexpr int64_t kPlotSize = 256;
+static constexpr int64_t kMinPersistentAtlasSize = 512;
+static constexpr int64_t kMaxPersistentAtlasSize = 2048;
+
+struct TextRenderContextSkia::Plot {
+  IPoint origin;
+  std::unique_ptr<GrRectanizer> rect_packer;
+  FontGlyphPair::Vector pairs;
+  uint64_t last_used_frame = 0;
+  // The region of the plot that was drawn to since the last upload.
+  std::optional<IRect> dirty_region;
+};
+
 TextRenderContextSkia::TextRenderContextSkia(std::shared_ptr<Context> context)
     : TextRenderContext(std::move(context)) {}
 
@@ -50,6 +70,11 @@ static FontGlyphPair::Vector CollectUniqueFontGlyphPairs(
   return vector;
 }
 
+static ISize GetGlyphSize(const FontGlyphPair& pair) {
+  return ISize::Ceil(pair.font.GetMetrics().GetBoundingBox().size *
+                     pair.font.GetMetrics().scale);
+}
+
 static bool PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
                                   size_t atlas_size,
                                   std::vector<Rect>& glyph_positions) {
@@ -64,9 +89,7 @@ static bool PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
   glyph_positions.reserve(pairs.size());
 
   for (const auto& pair : pairs) {
-    const auto glyph_size =
-        ISize::Ceil(pair.font.GetMetrics().GetBoundingBox().size *
-                    pair.font.GetMetrics().scale);
+    const auto glyph_size = GetGlyphSize(pair);
     SkIPoint16 location_in_atlas;
     if (!rect_packer->addRect(glyph_size.width,   //
                               glyph_size.height,  //
@@ -102,6 +125,41 @@ static size_t OptimumAtlasSizeForFontGlyphPairs(
   return 0u;
 }
 
+static void DrawGlyph(SkCanvas* canvas,
+                      const FontGlyphPair& font_glyph,
+                      const Rect& location) {
+  const auto position = SkPoint::Make(location.origin.x, location.origin.y);
+  SkGlyphID glyph_id = font_glyph.glyph.index;
+
+  SkFont sk_font(
+      TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
+      font_glyph.font.GetMetrics().point_size *
+          font_glyph.font.GetMetrics().scale);
+
+  const auto& metrics = font_glyph.font.GetMetrics();
+
+  auto glyph_color = SK_ColorWHITE;
+
+  SkPaint glyph_paint;
+  glyph_paint.setColor(glyph_color);
+  // Glyphs must not spill over their neighbors, which may have been uploaded
+  // already.
+  canvas->save();
+  canvas->clipRect(SkRect::MakeXYWH(location.origin.x, location.origin.y,
+                                    location.size.width,
+                                    location.size.height));
+  canvas->drawGlyphs(
+      1u,         // count
+      &glyph_id,  // glyphs
+      &position,  // positions
+      SkPoint::Make(-metrics.min_extent.x * metrics.scale,
+                    -metrics.ascent * metrics.scale),  // origin
+      sk_font,                                         // font
+      glyph_paint                                      // paint
+  );
+  canvas->restore();
+}
+
 static std::optional<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
                                                  size_t atlas_size) {
   TRACE_EVENT0("impeller", __FUNCTION__);
@@ -121,29 +179,7 @@ static std::optional<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
 
   atlas.IterateGlyphs([canvas](const FontGlyphPair& font_glyph,
                                const Rect& location) -> bool {
-    const auto position = SkPoint::Make(location.origin.x, location.origin.y);
-    SkGlyphID glyph_id = font_glyph.glyph.index;
-
-    SkFont sk_font(
-        TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
-        font_glyph.font.GetMetrics().point_size *
-            font_glyph.font.GetMetrics().scale);
-
-    const auto& metrics = font_glyph.font.GetMetrics();
-
-    auto glyph_color = SK_ColorWHITE;
-
-    SkPaint glyph_paint;
-    glyph_paint.setColor(glyph_color);
-    canvas->drawGlyphs(
-        1u,         // count
-        &glyph_id,  // glyphs
-        &position,  // positions
-        SkPoint::Make(-metrics.min_extent.x * metrics.scale,
-                      -metrics.ascent * metrics.scale),  // origin
-        sk_font,                                         // font
-        glyph_paint                                      // paint
-    );
+    DrawGlyph(canvas, font_glyph, location);
     return true;
   });
 
@@ -184,20 +220,10 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
   return texture;
 }
 
-std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
-    FrameIterator frame_iterator) const {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!IsValid()) {
-    return nullptr;
-  }
-
+static std::shared_ptr<GlyphAtlas> CreateGlyphAtlasForPairs(
+    const Context& context,
+    const FontGlyphPair::Vector& font_glyph_pairs) {
   auto glyph_atlas = std::make_shared<GlyphAtlas>();
-
-  // ---------------------------------------------------------------------------
-  // Step 1: Collect unique font-glyph pairs in the frame.
-  // ---------------------------------------------------------------------------
-
-  auto font_glyph_pairs = CollectUniqueFontGlyphPairs(frame_iterator);
   if (font_glyph_pairs.empty()) {
     return glyph_atlas;
   }
@@ -241,7 +267,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   // ---------------------------------------------------------------------------
   // Step 6: Upload the atlas as a texture.
   // ---------------------------------------------------------------------------
-  auto texture = UploadGlyphTextureAtlas(GetContext()->GetTransientsAllocator(),
+  auto texture = UploadGlyphTextureAtlas(context.GetTransientsAllocator(),
                                          bitmap.value(), atlas_size);
   if (!texture) {
     return nullptr;
@@ -255,4 +281,244 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   return glyph_atlas;
 }
 
+std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
+    FrameIterator frame_iterator) const {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 1: Collect unique font-glyph pairs in the frame.
+  // ---------------------------------------------------------------------------
+  auto font_glyph_pairs = CollectUniqueFontGlyphPairs(frame_iterator);
+
+  return CreateGlyphAtlasForPairs(*GetContext(), font_glyph_pairs);
+}
+
+std::shared_ptr<GlyphAtlas> TextRenderContextSkia::UpdateGlyphAtlas(
+    FrameIterator frame_iterator) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  if (!atlas_) {
+    atlas_ = std::make_shared<GlyphAtlas>();
+    if (!GrowAtlas()) {
+      atlas_.reset();
+      return nullptr;
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 1: Collect the font-glyph pairs that aren't in the atlas yet, and
+  // mark the plots of the others as used by this frame.
+  // ---------------------------------------------------------------------------
+  auto font_glyph_pairs = CollectUniqueFontGlyphPairs(frame_iterator);
+  FontGlyphPair::Vector new_pairs;
+  for (const auto& pair : font_glyph_pairs) {
+    auto found = glyph_plots_.find(pair);
+    if (found != glyph_plots_.end()) {
+      plots_[found->second]->last_used_frame = GetFrameCount();
+      continue;
+    }
+    const auto glyph_size = GetGlyphSize(pair);
+    if (glyph_size.width > kPlotSize || glyph_size.height > kPlotSize) {
+      // Glyphs this large are rare enough to be drawn in their own atlas.
+      return CreateGlyphAtlasForPairs(*GetContext(), font_glyph_pairs);
+    }
+    new_pairs.push_back(pair);
+  }
+  if (new_pairs.empty()) {
+    return atlas_;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 2: Find free regions of the atlas for the new font-glyph pairs.
+  // ---------------------------------------------------------------------------
+  std::vector<std::pair<FontGlyphPair, IRect>> placed_pairs;
+  placed_pairs.reserve(new_pairs.size());
+  bool all_pairs_placed = true;
+  for (const auto& pair : new_pairs) {
+    auto location = PlaceGlyph(pair, GetGlyphSize(pair));
+    if (!location.has_value()) {
+      // Every plot is sampled by the frames in flight.
+      all_pairs_placed = false;
+      break;
+    }
+    placed_pairs.emplace_back(pair, location.value());
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 3: Draw the new font-glyph pairs in their regions.
+  // ---------------------------------------------------------------------------
+  auto surface = SkSurface::MakeRasterDirect(bitmap_->pixmap());
+  if (!surface) {
+    return nullptr;
+  }
+  for (const auto& [pair, location] : placed_pairs) {
+    bitmap_->erase(SK_ColorTRANSPARENT,
+                   SkIRect::MakeXYWH(location.origin.x, location.origin.y,
+                                     location.size.width,
+                                     location.size.height));
+    DrawGlyph(surface->getCanvas(), pair,
+              Rect::MakeXYWH(location.origin.x, location.origin.y,
+                             location.size.width, location.size.height));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 4: Upload the regions of the atlas that were drawn to.
+  // ---------------------------------------------------------------------------
+  if (!UploadDirtyRegions()) {
+    return nullptr;
+  }
+
+  if (!all_pairs_placed) {
+    // The glyphs that were placed are kept for later frames.
+    return CreateGlyphAtlasForPairs(*GetContext(), font_glyph_pairs);
+  }
+
+  return atlas_;
+}
+
+bool TextRenderContextSkia::GrowAtlas() {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const int64_t old_size = atlas_size_;
+  const int64_t new_size =
+      old_size == 0 ? kMinPersistentAtlasSize : old_size * 2;
+  if (new_size > kMaxPersistentAtlasSize) {
+    return false;
+  }
+
+  auto bitmap = std::make_unique<SkBitmap>();
+  if (!bitmap->tryAllocPixels(SkImageInfo::MakeA8(new_size, new_size))) {
+    return false;
+  }
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
+  if (bitmap_ && !bitmap->writePixels(bitmap_->pixmap(), 0, 0)) {
+    return false;
+  }
+
+  // The texture of the previous size is kept by the commands that already
+  // sample it, and the glyphs keep their positions in the new one.
+  auto texture = UploadGlyphTextureAtlas(GetContext()->GetPermanentsAllocator(),
+                                         *bitmap, new_size);
+  if (!texture) {
+    return false;
+  }
+
+  for (int64_t y = 0; y < new_size; y += kPlotSize) {
+    for (int64_t x = 0; x < new_size; x += kPlotSize) {
+      if (x < old_size && y < old_size) {
+        continue;
+      }
+      auto plot = std::make_unique<Plot>();
+      plot->origin = {x, y};
+      plot->rect_packer = std::unique_ptr<GrRectanizer>(
+          GrRectanizer::Factory(kPlotSize, kPlotSize));
+      plots_.emplace_back(std::move(plot));
+    }
+  }
+  bitmap_ = std::move(bitmap);
+  atlas_size_ = new_size;
+  atlas_->SetTexture(std::move(texture));
+  return true;
+}
+
+std::optional<IRect> TextRenderContextSkia::PlaceGlyph(
+    const FontGlyphPair& pair,
+    ISize size) {
+  auto place_in_plot = [&](size_t plot_index) -> std::optional<IRect> {
+    auto& plot = *plots_[plot_index];
+    SkIPoint16 location_in_plot;
+    if (!plot.rect_packer->addRect(size.width, size.height,
+                                   &location_in_plot)) {
+      return std::nullopt;
+    }
+    const auto location =
+        IRect::MakeXYWH(plot.origin.x + location_in_plot.x(),
+                        plot.origin.y + location_in_plot.y(), size.width,
+                        size.height);
+    plot.pairs.push_back(pair);
+    plot.last_used_frame = GetFrameCount();
+    plot.dirty_region = plot.dirty_region.has_value()
+                            ? plot.dirty_region->Union(location)
+                            : location;
+    glyph_plots_[pair] = plot_index;
+    atlas_->AddTypefaceGlyphPosition(
+        pair, Rect::MakeXYWH(location.origin.x, location.origin.y,
+                             location.size.width, location.size.height));
+    return location;
+  };
+
+  for (size_t i = 0; i < plots_.size(); i++) {
+    if (auto location = place_in_plot(i)) {
+      return location;
+    }
+  }
+
+  // Grows the atlas before evicting glyphs that may be used again.
+  const size_t plot_count = plots_.size();
+  if (GrowAtlas()) {
+    for (size_t i = plot_count; i < plots_.size(); i++) {
+      if (auto location = place_in_plot(i)) {
+        return location;
+      }
+    }
+  }
+
+  // Evicts the least recently used plot, unless a frame that may still be in
+  // flight samples it.
+  std::optional<size_t> lru_plot_index;
+  for (size_t i = 0; i < plots_.size(); i++) {
+    const auto& plot = *plots_[i];
+    if (plot.last_used_frame + Renderer::kDefaultMaxFramesInFlight >=
+        GetFrameCount()) {
+      continue;
+    }
+    if (!lru_plot_index.has_value() ||
+        plot.last_used_frame < plots_[*lru_plot_index]->last_used_frame) {
+      lru_plot_index = i;
+    }
+  }
+  if (!lru_plot_index.has_value()) {
+    return std::nullopt;
+  }
+  EvictPlot(*plots_[*lru_plot_index]);
+  return place_in_plot(*lru_plot_index);
+}
+
+void TextRenderContextSkia::EvictPlot(Plot& plot) {
+  for (const auto& pair : plot.pairs) {
+    glyph_plots_.erase(pair);
+    atlas_->RemoveTypefaceGlyphPosition(pair);
+  }
+  plot.pairs.clear();
+  plot.rect_packer->reset();
+}
+
+bool TextRenderContextSkia::UploadDirtyRegions() {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const auto& pixmap = bitmap_->pixmap();
+  for (auto& plot : plots_) {
+    if (!plot->dirty_region.has_value()) {
+      continue;
+    }
+    const auto region = plot->dirty_region.value();
+    plot->dirty_region.reset();
+    if (region.IsEmpty()) {
+      continue;
+    }
+    if (!atlas_->GetTexture()->SetRegionContents(
+            static_cast<const uint8_t*>(
+                pixmap.addr(region.origin.x, region.origin.y)),
+            pixmap.rowBytes(), region)) {
+      VALIDATION_LOG << "Could not upload glyphs to the atlas.";
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace impeller
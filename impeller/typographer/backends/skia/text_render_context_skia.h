@@ -4,9 +4,17 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "impeller/typographer/text_render_context.h"
 
+class SkBitmap;
+
 namespace impeller {
 
 class TextRenderContextSkia : public TextRenderContext {
@@ -19,7 +27,37 @@ class TextRenderContextSkia : public TextRenderContext {
   std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(
       FrameIterator iterator) const override;
 
+  // |TextRenderContext|
+  std::shared_ptr<GlyphAtlas> UpdateGlyphAtlas(
+      FrameIterator iterator) override;
+
  private:
+  struct Plot;
+
+  std::shared_ptr<GlyphAtlas> atlas_;
+  // The pixels of the atlas. New glyphs are drawn here before the regions
+  // they were drawn to are uploaded to the texture of the atlas.
+  std::unique_ptr<SkBitmap> bitmap_;
+  int64_t atlas_size_ = 0;
+  std::vector<std::unique_ptr<Plot>> plots_;
+  // The index of the plot of each glyph in the atlas.
+  std::unordered_map<FontGlyphPair,
+                     size_t,
+                     FontGlyphPair::Hash,
+                     FontGlyphPair::Equal>
+      glyph_plots_;
+
+  // Doubles the size of the atlas, keeping the glyphs where they are.
+  bool GrowAtlas();
+
+  // Finds a free region for the glyph, growing the atlas or evicting the
+  // least recently used plot if there is none, and records its position.
+  std::optional<IRect> PlaceGlyph(const FontGlyphPair& pair, ISize size);
+
+  void EvictPlot(Plot& plot);
+
+  bool UploadDirtyRegions();
+
   FML_DISALLOW_COPY_AND_ASSIGN(TextRenderContextSkia);
 };
 
@@ -26,6 +26,10 @@ void GlyphAtlas::AddTypefaceGlyphPosition(FontGlyphPair pair, Rect rect) {
   positions_[pair] = rect;
 }
 
+void GlyphAtlas::RemoveTypefaceGlyphPosition(const FontGlyphPair& pair) {
+  positions_.erase(pair);
+}
+
 std::optional<Rect> GlyphAtlas::FindFontGlyphPosition(
     const FontGlyphPair& pair) const {
   auto found = positions_.find(pair);
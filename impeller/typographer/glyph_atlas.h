@@ -55,6 +55,14 @@ class GlyphAtlas {
   ///
   void AddTypefaceGlyphPosition(FontGlyphPair pair, Rect rect);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the location of a font-glyph pair whose region of the
+  ///             atlas is about to be reused.
+  ///
+  /// @param[in]  pair  The font-glyph pair
+  ///
+  void RemoveTypefaceGlyphPosition(const FontGlyphPair& pair);
+
   //----------------------------------------------------------------------------
   /// @brief      Get the number of unique font-glyph pairs in this atlas.
   ///
@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "flutter/fml/macros.h"
-#include "impeller/renderer/context.h"
 #include "impeller/typographer/glyph_atlas.h"
 #include "impeller/typographer/text_frame.h"
+#include "impeller/typographer/text_render_context.h"
 
 namespace impeller {
 
@@ -19,12 +21,21 @@ class LazyGlyphAtlas {
 
   void AddTextFrame(TextFrame frame);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the glyphs of the text frames to the glyph atlas of the
+  ///             text render context, once per frame, and returns it.
+  ///
   std::shared_ptr<GlyphAtlas> CreateOrGetGlyphAtlas(
-      std::shared_ptr<Context> context) const;
+      TextRenderContext& text_context) const;
 
  private:
   std::vector<TextFrame> frames_;
   mutable std::shared_ptr<GlyphAtlas> atlas_;
+  // The glyphs may be evicted from the atlas in later frames, or by other
+  // contexts, so the atlas is only reused within the frame it was updated
+  // in.
+  mutable const TextRenderContext* atlas_context_ = nullptr;
+  mutable uint64_t atlas_frame_ = 0;
 
   FML_DISALLOW_COPY_AND_ASSIGN(LazyGlyphAtlas);
 };
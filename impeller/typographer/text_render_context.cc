@@ -45,4 +45,25 @@ std::shared_ptr<GlyphAtlas> TextRenderContext::CreateGlyphAtlas(
   return CreateGlyphAtlas(iterator);
 }
 
+std::shared_ptr<GlyphAtlas> TextRenderContext::UpdateGlyphAtlas(
+    const TextFrame& frame) {
+  size_t count = 0;
+  FrameIterator iterator = [&]() -> const TextFrame* {
+    count++;
+    if (count == 1) {
+      return &frame;
+    }
+    return nullptr;
+  };
+  return UpdateGlyphAtlas(iterator);
+}
+
+void TextRenderContext::BeginFrame() {
+  frame_count_++;
+}
+
+uint64_t TextRenderContext::GetFrameCount() const {
+  return frame_count_;
+}
+
 }  // namespace impeller
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -43,6 +44,40 @@ class TextRenderContext {
 
   std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(const TextFrame& frame) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the glyphs of the frames to the glyph atlas that this
+  ///             context keeps across frames, and returns that atlas.
+  ///
+  ///             Only the glyphs that aren't in the atlas yet are rasterized,
+  ///             and only the regions of the texture they are drawn to are
+  ///             uploaded. When the atlas is full, the glyphs that were least
+  ///             recently used are evicted, except for the ones used by the
+  ///             frames that may still be in flight.
+  ///
+  ///             The positions of glyphs already in the atlas never change,
+  ///             so the atlas stays valid for the glyphs of earlier updates
+  ///             in the same frame.
+  ///
+  /// @return     The atlas, or a new atlas for these frames only if their
+  ///             glyphs don't fit in it.
+  ///
+  virtual std::shared_ptr<GlyphAtlas> UpdateGlyphAtlas(
+      FrameIterator iterator) = 0;
+
+  std::shared_ptr<GlyphAtlas> UpdateGlyphAtlas(const TextFrame& frame);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notes that a new frame is being rendered, so that the glyphs
+  ///             that were only used by frames that are no longer in flight
+  ///             can be evicted from the glyph atlas.
+  ///
+  void BeginFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of calls to |BeginFrame|.
+  ///
+  uint64_t GetFrameCount() const;
+
  protected:
   //----------------------------------------------------------------------------
   /// @brief      Create a new context to render text that talks to an
@@ -55,6 +90,7 @@ class TextRenderContext {
  private:
   std::shared_ptr<Context> context_;
   bool is_valid_ = false;
+  uint64_t frame_count_ = 0;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TextRenderContext);
 };
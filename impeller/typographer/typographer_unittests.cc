@@ -43,5 +43,52 @@ TEST_P(TypographerTest, CanCreateGlyphAtlas) {
   OpenPlaygroundHere([](auto&) { return true; });
 }
 
+TEST_P(TypographerTest, GlyphAtlasIsKeptAcrossUpdates) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto hello =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("hello", sk_font));
+  auto atlas = context->UpdateGlyphAtlas(hello);
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_TRUE(atlas->IsValid());
+  ASSERT_EQ(atlas->GetGlyphCount(), 4u);
+  auto texture = atlas->GetTexture();
+
+  // Only the new glyphs are added, and the others keep their positions.
+  FontGlyphPair h_pair{hello.GetRuns()[0].GetFont(),
+                       hello.GetRuns()[0].GetGlyphPositions()[0].glyph};
+  auto h_position = atlas->FindFontGlyphPosition(h_pair);
+  ASSERT_TRUE(h_position.has_value());
+  context->BeginFrame();
+  auto world =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("world", sk_font));
+  ASSERT_EQ(context->UpdateGlyphAtlas(world), atlas);
+  ASSERT_EQ(atlas->GetGlyphCount(), 7u);
+  ASSERT_EQ(atlas->GetTexture(), texture);
+  ASSERT_EQ(atlas->FindFontGlyphPosition(h_pair), h_position);
+}
+
+TEST_P(TypographerTest, GlyphAtlasPlacesLargeGlyphsInTheirOwnAtlas) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont small_font;
+  auto small_frame =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("a", small_font));
+  auto atlas = context->UpdateGlyphAtlas(small_frame);
+  ASSERT_NE(atlas, nullptr);
+
+  SkFont large_font;
+  large_font.setSize(500);
+  auto large_frame =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("a", large_font));
+  auto large_atlas = context->UpdateGlyphAtlas(large_frame);
+  ASSERT_NE(large_atlas, nullptr);
+  ASSERT_TRUE(large_atlas->IsValid());
+  ASSERT_NE(large_atlas, atlas);
+  ASSERT_EQ(large_atlas->GetGlyphCount(), 1u);
+  ASSERT_EQ(atlas->GetGlyphCount(), 1u);
+}
+
 }  // namespace testing
 }  // namespace impeller
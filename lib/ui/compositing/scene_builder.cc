@@ -35,10 +35,10 @@ namespace flutter {
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, SceneBuilder);
 
-SceneBuilder::SceneBuilder() {
+SceneBuilder::SceneBuilder() : arena_(fml::MakeRefCounted<FrameArena>()) {
   // Add a ContainerLayer as the root layer, so that AddLayer operations are
   // always valid.
-  PushLayer(std::make_shared<flutter::ContainerLayer>());
+  PushLayer(arena_->MakeShared<flutter::ContainerLayer>());
 }
 
 SceneBuilder::~SceneBuilder() = default;
@@ -47,7 +47,7 @@ void SceneBuilder::pushTransform(Dart_Handle layer_handle,
                                  tonic::Float64List& matrix4,
                                  fml::RefPtr<EngineLayer> oldLayer) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_->MakeShared<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
@@ -63,7 +63,7 @@ void SceneBuilder::pushOffset(Dart_Handle layer_handle,
                               double dy,
                               fml::RefPtr<EngineLayer> oldLayer) {
   SkMatrix sk_matrix = SkMatrix::Translate(dx, dy);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_->MakeShared<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -82,7 +82,7 @@ void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
   SkRect clipRect = SkRect::MakeLTRB(left, top, right, bottom);
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   auto layer =
-      std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
+      arena_->MakeShared<flutter::ClipRectLayer>(clipRect, clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -96,8 +96,8 @@ void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
                                  int clipBehavior,
                                  fml::RefPtr<EngineLayer> oldLayer) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
+  auto layer = arena_->MakeShared<flutter::ClipRRectLayer>(rrect.sk_rrect,
+                                                           clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -113,7 +113,7 @@ void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   FML_DCHECK(clip_behavior != flutter::Clip::none);
   auto layer =
-      std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
+      arena_->MakeShared<flutter::ClipPathLayer>(path->path(), clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -128,7 +128,7 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
                                double dy,
                                fml::RefPtr<EngineLayer> oldLayer) {
   auto layer =
-      std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
+      arena_->MakeShared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -140,7 +140,7 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
 void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
                                    const ColorFilter* color_filter,
                                    fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::ColorFilterLayer>(
+  auto layer = arena_->MakeShared<flutter::ColorFilterLayer>(
       color_filter->filter()->skia_object());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
@@ -153,7 +153,7 @@ void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
 void SceneBuilder::pushImageFilter(Dart_Handle layer_handle,
                                    const ImageFilter* image_filter,
                                    fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::ImageFilterLayer>(
+  auto layer = arena_->MakeShared<flutter::ImageFilterLayer>(
       image_filter->filter()->skia_object());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
@@ -167,8 +167,8 @@ void SceneBuilder::pushBackdropFilter(Dart_Handle layer_handle,
                                       ImageFilter* filter,
                                       int blendMode,
                                       fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::BackdropFilterLayer>(
-      filter->filter()->skia_object(), static_cast<SkBlendMode>(blendMode));
+  auto layer = arena_->MakeShared<flutter::BackdropFilterLayer>(
+      filter->filter(), static_cast<SkBlendMode>(blendMode));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 
@@ -189,7 +189,7 @@ void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
   SkRect rect = SkRect::MakeLTRB(maskRectLeft, maskRectTop, maskRectRight,
                                  maskRectBottom);
   auto sampling = ImageFilter::SamplingFromIndex(filterQualityIndex);
-  auto layer = std::make_shared<flutter::ShaderMaskLayer>(
+  auto layer = arena_->MakeShared<flutter::ShaderMaskLayer>(
       shader->shader(sampling)->skia_object(), rect,
       static_cast<SkBlendMode>(blendMode));
   PushLayer(layer);
@@ -207,7 +207,7 @@ void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
                                      int shadow_color,
                                      int clipBehavior,
                                      fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
+  auto layer = arena_->MakeShared<flutter::PhysicalShapeLayer>(
       static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
       static_cast<float>(elevation), path->path(),
       static_cast<flutter::Clip>(clipBehavior));
@@ -240,12 +240,12 @@ void SceneBuilder::addPicture(double dx,
   // been disposed but not collected yet, but the display list and picture are
   // both null.
   if (picture->picture()) {
-    auto layer = std::make_unique<flutter::PictureLayer>(
+    auto layer = arena_->MakeShared<flutter::PictureLayer>(
         SkPoint::Make(dx, dy), UIDartState::CreateGPUObject(picture->picture()),
         !!(hints & 1), !!(hints & 2));
     AddLayer(std::move(layer));
   } else if (picture->display_list()) {
-    auto layer = std::make_unique<flutter::DisplayListLayer>(
+    auto layer = arena_->MakeShared<flutter::DisplayListLayer>(
         SkPoint::Make(dx, dy),
         UIDartState::CreateGPUObject(picture->display_list()), !!(hints & 1),
         !!(hints & 2));
@@ -261,7 +261,7 @@ void SceneBuilder::addTexture(double dx,
                               bool freeze,
                               int filterQualityIndex) {
   auto sampling = ImageFilter::SamplingFromIndex(filterQualityIndex);
-  auto layer = std::make_unique<flutter::TextureLayer>(
+  auto layer = arena_->MakeShared<flutter::TextureLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), textureId, freeze,
       sampling);
   AddLayer(std::move(layer));
@@ -272,7 +272,7 @@ void SceneBuilder::addPlatformView(double dx,
                                    double width,
                                    double height,
                                    int64_t viewId) {
-  auto layer = std::make_unique<flutter::PlatformViewLayer>(
+  auto layer = arena_->MakeShared<flutter::PlatformViewLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), viewId);
   AddLayer(std::move(layer));
 }
@@ -284,7 +284,7 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
                                          double bottom) {
   SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
   auto layer =
-      std::make_unique<flutter::PerformanceOverlayLayer>(enabledOptions);
+      arena_->MakeShared<flutter::PerformanceOverlayLayer>(enabledOptions);
   layer->set_paint_bounds(rect);
   AddLayer(std::move(layer));
 }
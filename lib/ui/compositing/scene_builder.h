@@ -9,6 +9,7 @@
 #include <memory>
 #include <vector>
 
+#include "flutter/flow/frame_arena.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
@@ -139,6 +140,9 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
   void PushLayer(std::shared_ptr<ContainerLayer> layer);
   void PopLayer();
 
+  // The layers of the scene. A layer retained by an engine layer only keeps
+  // the arena block it was allocated in alive once the scene is gone.
+  fml::RefPtr<FrameArena> arena_;
   std::vector<std::shared_ptr<ContainerLayer>> layer_stack_;
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
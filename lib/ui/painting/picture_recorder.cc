@@ -29,7 +29,11 @@ PictureRecorder::~PictureRecorder() {}
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
   bool enable_display_list = UIDartState::Current()->enable_display_list();
   if (enable_display_list) {
-    display_list_recorder_ = sk_make_sp<DisplayListCanvasRecorder>(bounds);
+    // Like the SkPicture path below, which records with an rtree, we
+    // build a spatial index so that partially visible pictures only
+    // dispatch the ops that intersect the raster cull rect.
+    display_list_recorder_ =
+        sk_make_sp<DisplayListCanvasRecorder>(bounds, true);
     return display_list_recorder_.get();
   } else {
     return picture_recorder_.beginRecording(bounds, &rtree_factory_);
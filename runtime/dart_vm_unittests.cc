@@ -50,6 +50,7 @@ TEST_F(DartVMTest, DisableTimelineEventHandler) {
   settings.enable_timeline_event_handler = false;
   auto vm = DartVMRef::Create(settings);
   ASSERT_FALSE(fml::tracing::TraceHasTimelineEventHandler());
+  ASSERT_FALSE(FML_TRACE_EVENT_ENABLED("flutter", "DisplayListMemory"));
 }
 
 TEST_F(DartVMTest, TraceGetTimelineMicrosDoesNotGetClockWhenSystraceIsEnabled) {
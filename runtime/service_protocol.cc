@@ -40,6 +40,9 @@ const std::string_view
 const std::string_view
     ServiceProtocol::kRenderFrameWithRasterStatsExtensionName =
         "_flutter.renderFrameWithRasterStats";
+const std::string_view
+    ServiceProtocol::kGetFrameTimingPercentilesExtensionName =
+        "_flutter.getFrameTimingPercentiles";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -60,6 +63,7 @@ ServiceProtocol::ServiceProtocol()
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
           kRenderFrameWithRasterStatsExtensionName,
+          kGetFrameTimingPercentilesExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
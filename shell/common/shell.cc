@@ -11,6 +11,8 @@
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/display_list/display_list_complexity_calibrated.h"
+#include "flutter/display_list/display_list_storage.h"
 #include "flutter/fml/base32.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
@@ -68,6 +70,24 @@ std::unique_ptr<Engine> CreateEngine(
                                   volatile_path_tracker);
 }
 
+// Installs a table of the costs of DisplayList ops that were measured on
+// this device for the raster cache to use when deciding what to cache.
+void LoadComplexityCostTable(const std::string& path) {
+  auto mapping = fml::FileMapping::CreateReadOnly(path);
+  if (!mapping) {
+    FML_LOG(ERROR) << "Could not open the complexity cost table " << path;
+    return;
+  }
+  auto table = DisplayListCostTable::Parse(
+      std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                  mapping->GetSize()));
+  if (!table) {
+    FML_LOG(ERROR) << "Could not parse the complexity cost table " << path;
+    return;
+  }
+  DisplayListCalibratedComplexityCalculator::SetCostTable(std::move(table));
+}
+
 // Though there can be multiple shells, some settings apply to all components in
 // the process. These have to be set up before the shell or any of its
 // sub-components can be initialized. In a perfect world, this would be empty.
@@ -115,6 +135,10 @@ void PerformInitializationTasks(Settings& settings) {
         FML_DLOG(WARNING) << "Skipping ICU initialization in the shell.";
       }
     }
+
+    if (!settings.complexity_cost_table_path.empty()) {
+      LoadComplexityCostTable(settings.complexity_cost_table_path);
+    }
   });
 
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
@@ -203,6 +227,25 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        if (shell->GetSettings().enable_software_tiled_rasterization) {
+          rasterizer->compositor_context()->SetTiledRasterTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner(),
+              shell->GetDartVM()->GetConcurrentMessageLoop()->GetWorkerCount());
+        }
+        if (shell->GetSettings().enable_async_raster_cache) {
+          rasterizer->compositor_context()
+              ->raster_cache()
+              .SetRasterizationTaskRunner(
+                  shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (shell->GetSettings().enable_parallel_preroll) {
+          rasterizer->compositor_context()->SetPrerollTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        rasterizer->compositor_context()->set_reuse_retained_subtrees(
+            shell->GetSettings().enable_retained_subtree_reuse);
+        rasterizer->compositor_context()->set_trace_display_list_memory(
+            shell->GetSettings().trace_display_list_memory);
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
@@ -454,6 +497,11 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolRenderFrameWithRasterStats, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingPercentilesExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingPercentiles, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -558,6 +606,9 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
+  // Release the op storage blocks retained for reuse by future frames.
+  DisplayListStoragePool::GetDefault()->Purge();
+
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
         if (rasterizer) {
@@ -1418,6 +1469,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  frame_timings_histogram_.Record(timing);
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1698,6 +1751,10 @@ double Shell::GetMainDisplayRefreshRate() {
   return display_manager_->GetMainDisplayRefreshRate();
 }
 
+const FrameTimingsHistogram& Shell::GetFrameTimingsHistogram() const {
+  return frame_timings_histogram_;
+}
+
 void Shell::RegisterImageDecoder(ImageGeneratorFactory factory,
                                  int32_t priority) {
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
@@ -1880,6 +1937,45 @@ bool Shell::OnServiceProtocolRenderFrameWithRasterStats(
   }
 }
 
+static rapidjson::Value SerializePercentiles(
+    const FrameTimingsHistogram::Percentiles& percentiles,
+    rapidjson::Document* response) {
+  auto& allocator = response->GetAllocator();
+  rapidjson::Value result;
+  result.SetObject();
+  result.AddMember("p50", percentiles.p50, allocator);
+  result.AddMember("p90", percentiles.p90, allocator);
+  result.AddMember("p99", percentiles.p99, allocator);
+  result.AddMember("max", percentiles.max, allocator);
+  return result;
+}
+
+bool Shell::OnServiceProtocolGetFrameTimingPercentiles(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto summary =
+      frame_timings_histogram_.GetLastCompleteWindow(fml::TimePoint::Now());
+
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "FrameTimingPercentiles", allocator);
+  response->AddMember(
+      "windowStartMicros",
+      summary.window_start.ToEpochDelta().ToMicroseconds(), allocator);
+  response->AddMember("windowMicros", summary.window.ToMicroseconds(),
+                      allocator);
+  response->AddMember<uint64_t>("frameCount", summary.frame_count, allocator);
+  response->AddMember("build", SerializePercentiles(summary.build, response),
+                      allocator);
+  response->AddMember("raster", SerializePercentiles(summary.raster, response),
+                      allocator);
+  response->AddMember(
+      "vsyncToPresent",
+      SerializePercentiles(summary.vsync_to_present, response), allocator);
+  return true;
+}
+
 Rasterizer::Screenshot Shell::Screenshot(
     Rasterizer::ScreenshotType screenshot_type,
     bool base64_encode) {
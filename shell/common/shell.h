@@ -14,6 +14,7 @@
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/flow/frame_timings_histogram.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -382,6 +383,15 @@ class Shell final : public PlatformView::Delegate,
   ///
   double GetMainDisplayRefreshRate();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Distributions of the build, raster and vsync to present
+  ///             durations of the frames rasterized by this shell, over
+  ///             windows of `FrameTimingsHistogram::kDefaultWindow`.
+  ///
+  /// @return     The histogram. It can be read from any thread.
+  ///
+  const FrameTimingsHistogram& GetFrameTimingsHistogram() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Install a new factory that can match against and decode image
   ///             data.
@@ -462,6 +472,9 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // Recorded on the raster thread and read from any thread.
+  FrameTimingsHistogram frame_timings_histogram_;
+
   /// Manages the displays. This class is thread safe, can be accessed from any
   /// of the threads.
   std::unique_ptr<DisplayManager> display_manager_;
@@ -713,6 +726,14 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Responds with the percentiles of the frame timings of the last complete
+  // window of the frame timings histogram, in microseconds.
+  bool OnServiceProtocolGetFrameTimingPercentiles(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // |ResourceCacheLimitItem|
   size_t GetResourceCacheLimit() override { return resource_cache_limit_; };
 
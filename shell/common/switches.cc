@@ -295,6 +295,21 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_software_tiled_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::EnableSoftwareTiledRasterization));
+
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+
+  settings.enable_parallel_preroll =
+      command_line.HasOption(FlagForSwitch(Switch::EnableParallelPreroll));
+
+  settings.enable_retained_subtree_reuse = command_line.HasOption(
+      FlagForSwitch(Switch::EnableRetainedSubtreeReuse));
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::ComplexityCostTable),
+                              &settings.complexity_cost_table_path);
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -330,6 +345,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
+  settings.trace_display_list_memory =
+      command_line.HasOption(FlagForSwitch(Switch::TraceDisplayListMemory));
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
@@ -105,6 +105,33 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful "
            "when testing Flutter on emulators. By default, Flutter will "
            "attempt to either use OpenGL, Metal, or Vulkan.")
+DEF_SWITCH(EnableSoftwareTiledRasterization,
+           "enable-software-tiled-rasterization",
+           "Render large frames into software surfaces by splitting them into "
+           "tiles that are rasterized in parallel on the concurrent worker "
+           "threads. This is useful on many-core machines that render "
+           "without a GPU.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Rasterize the raster cache images of software frames on the "
+           "concurrent worker threads. Content is drawn directly until its "
+           "image is ready, so frames do not wait for the cache to fill.")
+DEF_SWITCH(EnableParallelPreroll,
+           "enable-parallel-preroll",
+           "Preroll the children of layers that have many children in "
+           "parallel on the concurrent worker threads. Only applies to frames "
+           "rendered in software without platform views.")
+DEF_SWITCH(EnableRetainedSubtreeReuse,
+           "enable-retained-subtree-reuse",
+           "Skip the preroll of layer subtrees that the framework retained "
+           "unchanged from the previous frame, and replay a recording of their "
+           "paint instead of painting them again.")
+DEF_SWITCH(ComplexityCostTable,
+           "complexity-cost-table",
+           "The path of a table of DisplayList op costs measured on this "
+           "device by the display_list_benchmarks. When specified, the raster "
+           "cache uses these costs to decide which pictures to cache instead "
+           "of the built in estimates.")
 DEF_SWITCH(Route,
            "route",
            "Start app with an specific route defined on the framework")
@@ -169,6 +196,11 @@ DEF_SWITCH(
     "Trace to the system tracer (instead of the timeline) on platforms where "
     "such a tracer is available. Currently only supported on Android and "
     "Fuchsia.")
+DEF_SWITCH(TraceDisplayListMemory,
+           "trace-display-list-memory",
+           "Report the memory retained by the DisplayLists of each frame to "
+           "the timeline. Collecting the report walks all of the ops of the "
+           "frame, so it is off by default.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -60,6 +60,16 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   SkCanvas* canvas = backing_store->getCanvas();
   canvas->resetMatrix();
 
+  // A backing store that retains the last frame only needs the areas that
+  // changed since then to be repainted, as no other frame was rendered into
+  // it in the meantime.
+  if (delegate_->BackingStoreRetainsContents()) {
+    framebuffer_info.supports_partial_repaint = true;
+    if (backing_store == last_backing_store_) {
+      framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+    }
+  }
+
   SurfaceFrame::SubmitCallback on_submit =
       [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) -> bool {
@@ -70,7 +80,9 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    self->last_backing_store_ = surface_frame.SkiaSurface();
+    return self->delegate_->PresentBackingStore(
+        surface_frame.SkiaSurface(), surface_frame.submit_info().frame_damage);
   };
 
   return std::make_unique<SurfaceFrame>(backing_store,
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <optional>
+
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -43,11 +45,24 @@ class GPUSurfaceSoftwareDelegate {
   ///             backing store and the platform must display it on-screen.
   ///
   /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The area of the backing store that changed
+  ///                            since it was last presented, if known.
   ///
   /// @return     Returns if the platform could present the backing store onto
   ///             the screen.
   ///
-  virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+  virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store,
+                                   const std::optional<SkIRect>& damage) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether |AcquireBackingStore| returns the same backing store,
+  ///             with the pixels of the last frame rendered into it, as long
+  ///             as the size does not change. If so, only the areas of the
+  ///             frame that changed are repainted.
+  ///
+  /// @return     Returns if backing stores retain their contents.
+  ///
+  virtual bool BackingStoreRetainsContents() const;
 };
 
 }  // namespace flutter
@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software.h"
+
+#include <optional>
+
+#include "flutter/fml/message_loop.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class TestSoftwareDelegate : public GPUSurfaceSoftwareDelegate {
+ public:
+  explicit TestSoftwareDelegate(bool retains_contents)
+      : retains_contents_(retains_contents) {}
+
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    if (!backing_store_ || backing_store_->width() != size.width() ||
+        backing_store_->height() != size.height()) {
+      backing_store_ = SkSurface::MakeRasterN32Premul(size.width(),
+                                                      size.height());
+    }
+    return backing_store_;
+  }
+
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store,
+                           const std::optional<SkIRect>& damage) override {
+    present_count_++;
+    presented_damage_ = damage;
+    return true;
+  }
+
+  bool BackingStoreRetainsContents() const override {
+    return retains_contents_;
+  }
+
+  int present_count() const { return present_count_; }
+
+  const std::optional<SkIRect>& presented_damage() const {
+    return presented_damage_;
+  }
+
+ private:
+  const bool retains_contents_;
+  sk_sp<SkSurface> backing_store_;
+  int present_count_ = 0;
+  std::optional<SkIRect> presented_damage_;
+};
+
+void SubmitWithDamage(std::unique_ptr<SurfaceFrame> frame,
+                      const SkIRect& damage) {
+  SurfaceFrame::SubmitInfo submit_info;
+  submit_info.frame_damage = damage;
+  submit_info.buffer_damage = damage;
+  frame->set_submit_info(submit_info);
+  ASSERT_TRUE(frame->Submit());
+}
+
+}  // namespace
+
+TEST(GPUSurfaceSoftware, RetainedBackingStoreOnlyNeedsTheFrameDamage) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TestSoftwareDelegate delegate(true);
+  GPUSurfaceSoftware surface(&delegate, true);
+
+  // Nothing is known about the contents of the first backing store.
+  auto frame = surface.AcquireFrame(SkISize::Make(100, 100));
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  SubmitWithDamage(std::move(frame), SkIRect::MakeWH(100, 100));
+  EXPECT_EQ(delegate.presented_damage(), SkIRect::MakeWH(100, 100));
+
+  // The second frame is rendered into the same backing store, which only
+  // needs the areas that changed since the first frame to be repainted.
+  frame = surface.AcquireFrame(SkISize::Make(100, 100));
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_EQ(frame->framebuffer_info().existing_damage, SkIRect::MakeEmpty());
+  SubmitWithDamage(std::move(frame), SkIRect::MakeXYWH(10, 10, 5, 5));
+  EXPECT_EQ(delegate.presented_damage(), SkIRect::MakeXYWH(10, 10, 5, 5));
+
+  // A new backing store is repainted in full.
+  frame = surface.AcquireFrame(SkISize::Make(200, 100));
+  ASSERT_TRUE(frame);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+}
+
+TEST(GPUSurfaceSoftware, BackingStoreWithoutContentsIsRepaintedInFull) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TestSoftwareDelegate delegate(false);
+  GPUSurfaceSoftware surface(&delegate, true);
+
+  for (int i = 0; i < 2; i++) {
+    // Without partial repaint, the rasterizer computes no damage and paints
+    // the whole frame, which is presented without a damage rect.
+    auto frame = surface.AcquireFrame(SkISize::Make(100, 100));
+    ASSERT_TRUE(frame);
+    EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+    EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+    ASSERT_TRUE(frame->Submit());
+    EXPECT_EQ(delegate.present_count(), i + 1);
+    EXPECT_FALSE(delegate.presented_damage().has_value());
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -102,7 +102,8 @@ sk_sp<SkSurface> AndroidSurfaceSoftware::AcquireBackingStore(
 }
 
 bool AndroidSurfaceSoftware::PresentBackingStore(
-    sk_sp<SkSurface> backing_store) {
+    sk_sp<SkSurface> backing_store,
+    const std::optional<SkIRect>& damage) {
   TRACE_EVENT0("flutter", "AndroidSurfaceSoftware::PresentBackingStore");
   if (!IsValid() || backing_store == nullptr) {
     return false;
@@ -96,6 +96,10 @@ void AndroidExternalViewEmbedder::SubmitFrame(
   // below.
   SkAutoCanvasRestore save(background_canvas, /*doSave=*/true);
 
+  // Each rect corresponds to a native view that renders Flutter UI. The
+  // vector is filled by each query of the rtrees.
+  std::vector<SkRect> intersection_rects;
+
   for (size_t i = 0; i < current_frame_view_count; i++) {
     int64_t view_id = composition_order_[i];
 
@@ -116,9 +120,8 @@ void AndroidExternalViewEmbedder::SubmitFrame(
     for (ssize_t j = i; j >= 0; j--) {
       int64_t current_view_id = composition_order_[j];
       SkRect current_view_rect = GetViewRect(current_view_id);
-      // Each rect corresponds to a native view that renders Flutter UI.
-      std::list<SkRect> intersection_rects =
-          rtree->searchNonOverlappingDrawnRects(current_view_rect);
+      rtree->searchNonOverlappingDrawnRects(current_view_rect,
+                                            &intersection_rects);
 
       // Limit the number of native views, so it doesn't grow forever.
       //
@@ -4,10 +4,10 @@
 
 #import <UIKit/UIGestureRecognizerSubclass.h>
 
-#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/flow/rtree.h"
@@ -484,6 +484,9 @@ bool FlutterPlatformViewsController::SubmitFrame(GrDirectContext* gr_context,
 
   auto did_submit = true;
   auto num_platform_views = composition_order_.size();
+  // Filled by each query of the rtrees, so that one allocation serves all
+  // of the platform views of the frame.
+  std::vector<SkRect> intersection_rects;
 
   for (size_t i = 0; i < num_platform_views; i++) {
     int64_t platform_view_id = composition_order_[i];
@@ -495,8 +498,7 @@ bool FlutterPlatformViewsController::SubmitFrame(GrDirectContext* gr_context,
     for (size_t j = i + 1; j > 0; j--) {
       int64_t current_platform_view_id = composition_order_[j - 1];
       SkRect platform_view_rect = GetPlatformViewRect(current_platform_view_id);
-      std::list<SkRect> intersection_rects =
-          rtree->searchNonOverlappingDrawnRects(platform_view_rect);
+      rtree->searchNonOverlappingDrawnRects(platform_view_rect, &intersection_rects);
       auto allocation_size = intersection_rects.size();
 
       // For testing purposes, the overlay id is used to find the overlay view.
@@ -139,8 +139,8 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+  if (!SAFE_EXISTS_ONE_OF(software_config, surface_present_callback,
+                          surface_present_with_info_callback)) {
     return false;
   }
 
@@ -506,10 +506,30 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
   auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
+      [present = SAFE_ACCESS(software_config, surface_present_callback, nullptr),
+       present_with_info = SAFE_ACCESS(
+           software_config, surface_present_with_info_callback, nullptr),
+       user_data](const void* allocation, size_t row_bytes, size_t height,
+                  const SkIRect& damage) -> bool {
+    if (present) {
+      return present(user_data, allocation, row_bytes, height);
+    }
+    FlutterRect damage_rect = {
+        .left = static_cast<double>(damage.left()),
+        .top = static_cast<double>(damage.top()),
+        .right = static_cast<double>(damage.right()),
+        .bottom = static_cast<double>(damage.bottom()),
+    };
+    FlutterSoftwarePresentInfo present_info = {};
+    present_info.struct_size = sizeof(FlutterSoftwarePresentInfo);
+    present_info.allocation = allocation;
+    present_info.row_bytes = row_bytes;
+    present_info.height = height;
+    present_info.damage_count = damage.isEmpty() ? 0 : 1;
+    present_info.damage = &damage_rect;
+    return present_with_info(user_data, &present_info);
   };
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
@@ -2588,6 +2608,54 @@ FlutterEngineResult FlutterEngineScheduleFrame(FLUTTER_API_SYMBOL(FlutterEngine)
                                   "Could not schedule frame.");
 }
 
+static FlutterFrameTimingPercentiles ToEmbedderPercentiles(
+    const flutter::FrameTimingsHistogram::Percentiles& percentiles) {
+  FlutterFrameTimingPercentiles result = {};
+  result.p50 = percentiles.p50;
+  result.p90 = percentiles.p90;
+  result.p99 = percentiles.p99;
+  result.max = percentiles.max;
+  return result;
+}
+
+FlutterEngineResult FlutterEngineGetFrameTimingSummary(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingSummary* summary) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (summary == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Null summary specified.");
+  }
+
+  auto embedder_engine = reinterpret_cast<flutter::EmbedderEngine*>(engine);
+  if (!embedder_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine is not running.");
+  }
+
+  const auto& histogram =
+      embedder_engine->GetShell().GetFrameTimingsHistogram();
+  auto window_summary = histogram.GetLastCompleteWindow(fml::TimePoint::Now());
+
+#define SET_SUMMARY(member, value)          \
+  if (STRUCT_HAS_MEMBER(summary, member)) { \
+    summary->member = value;                \
+  }
+
+  SET_SUMMARY(window_start,
+              window_summary.window_start.ToEpochDelta().ToNanoseconds());
+  SET_SUMMARY(window_duration, window_summary.window.ToNanoseconds());
+  SET_SUMMARY(frame_count, window_summary.frame_count);
+  SET_SUMMARY(build, ToEmbedderPercentiles(window_summary.build));
+  SET_SUMMARY(raster, ToEmbedderPercentiles(window_summary.raster));
+  SET_SUMMARY(vsync_to_present,
+              ToEmbedderPercentiles(window_summary.vsync_to_present));
+#undef SET_SUMMARY
+
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2639,6 +2707,7 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
   SET_PROC(ScheduleFrame, FlutterEngineScheduleFrame);
+  SET_PROC(GetFrameTimingSummary, FlutterEngineGetFrameTimingSummary);
 #undef SET_PROC
 
   return kSuccess;
@@ -664,6 +664,35 @@ typedef struct {
 
 } FlutterVulkanRendererConfig;
 
+/// This information is passed to the embedder when a software surface is
+/// presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.surface_present_with_info_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwarePresentInfo).
+  size_t struct_size;
+  /// The fully populated buffer. The pixel format of the buffer is the native
+  /// 32-bit RGBA format.
+  const void* allocation;
+  /// The number of bytes in each row of the buffer.
+  size_t row_bytes;
+  /// The number of rows in the buffer.
+  size_t height;
+  /// The number of rectangles in `damage`.
+  size_t damage_count;
+  /// The rectangles of the buffer, in pixels, whose contents changed since the
+  /// buffer was last presented. The rest of the buffer is unchanged, so an
+  /// embedder that keeps a copy of the previous frame only needs to copy these
+  /// rectangles. The whole buffer is reported as damaged if the engine does
+  /// not know which parts of it changed.
+  const FlutterRect* damage;
+} FlutterSoftwarePresentInfo;
+
+/// Callback for when a software surface is presented.
+typedef bool (*SoftwareSurfacePresentWithInfoCallback)(
+    void* /* user data */,
+    const FlutterSoftwarePresentInfo* /* present info */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -671,7 +700,20 @@ typedef struct {
   /// to the user. The pixel format of the buffer is the native 32-bit RGBA
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
+  ///
+  /// Specifying one (and only one) of `surface_present_callback` or
+  /// `surface_present_with_info_callback` is required. Specifying both is an
+  /// error and engine initialization will be terminated.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// The callback presented to the embedder to present a fully populated buffer
+  /// to the user, along with the areas of the buffer that changed since it was
+  /// last presented. The buffer is owned by the Flutter engine and must be
+  /// copied in this callback if needed.
+  ///
+  /// Specifying one (and only one) of `surface_present_callback` or
+  /// `surface_present_with_info_callback` is required. Specifying both is an
+  /// error and engine initialization will be terminated.
+  SoftwareSurfacePresentWithInfoCallback surface_present_with_info_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -1382,6 +1424,36 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// The percentiles of the durations of a phase of the frames rasterized in a
+/// window of time, in microseconds. The percentiles are accurate to about 3%.
+typedef struct {
+  int64_t p50;
+  int64_t p90;
+  int64_t p99;
+  int64_t max;
+} FlutterFrameTimingPercentiles;
+
+/// The distributions of the frame timings in the last complete window of time.
+/// Filled in by `FlutterEngineGetFrameTimingSummary`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingSummary).
+  size_t struct_size;
+  /// The start of the window, in nanoseconds on the clock used by
+  /// `FlutterEngineGetCurrentTime`.
+  uint64_t window_start;
+  /// The duration of the window, in nanoseconds.
+  uint64_t window_duration;
+  /// The number of frames rasterized in the window. The percentiles are zero
+  /// if no frame was rasterized.
+  uint64_t frame_count;
+  /// From the start to the end of the frame build.
+  FlutterFrameTimingPercentiles build;
+  /// From the start to the end of the frame rasterization.
+  FlutterFrameTimingPercentiles raster;
+  /// From the vsync signal to the end of the frame rasterization.
+  FlutterFrameTimingPercentiles vsync_to_present;
+} FlutterFrameTimingSummary;
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -2427,6 +2499,22 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineScheduleFrame(FLUTTER_API_SYMBOL(FlutterEngine)
                                                    engine);
 
+//------------------------------------------------------------------------------
+/// @brief      Gets the percentiles of the frame timings of the last complete
+///             window of time. The engine aggregates the timings of the frames
+///             it rasterizes over windows of 10 seconds. This call may be made
+///             on any thread.
+///
+/// @param[in]  engine   A running engine instance.
+/// @param[out] summary  The summary to fill in. Its `struct_size` must be set.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingSummary(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingSummary* summary);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2545,6 +2633,9 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     size_t display_count);
 typedef FlutterEngineResult (*FlutterEngineScheduleFrameFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine);
+typedef FlutterEngineResult (*FlutterEngineGetFrameTimingSummaryFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingSummary* summary);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2590,6 +2681,7 @@ typedef struct {
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
   FlutterEngineScheduleFrameFnPtr ScheduleFrame;
+  FlutterEngineGetFrameTimingSummaryFnPtr GetFrameTimingSummary;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -79,7 +79,8 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
-    sk_sp<SkSurface> backing_store) {
+    sk_sp<SkSurface> backing_store,
+    const std::optional<SkIRect>& damage) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
@@ -102,10 +103,18 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   }
 
   return software_dispatch_table_.software_present_backing_store(
-      pixmap.addr(),      //
-      pixmap.rowBytes(),  //
-      pixmap.height()     //
+      pixmap.addr(),                    //
+      pixmap.rowBytes(),                //
+      pixmap.height(),                  //
+      damage.value_or(pixmap.bounds())  //
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::BackingStoreRetainsContents() const {
+  // The same backing store is returned for as long as the size of the
+  // surface does not change.
+  return true;
+}
+
 }  // namespace flutter
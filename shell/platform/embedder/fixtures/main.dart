@@ -740,6 +740,24 @@ void verify_b143464703() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void render_partial_update() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+    builder.addPicture(Offset(0.0, 0.0), CreateColoredBox(Color.fromARGB(255, 128, 128, 128), Size(800.0, 600.0)));
+    // Only the color of the small box changes in the second frame.
+    Color color = frame == 0 ? Color.fromARGB(255, 255, 0, 0) : Color.fromARGB(255, 0, 0, 255);
+    builder.addPicture(Offset(100.0, 100.0), CreateColoredBox(color, Size(50.0, 50.0)));
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    frame++;
+    if (frame < 2) {
+      PlatformDispatcher.instance.scheduleFrame();
+    }
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void push_frames_over_and_over() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
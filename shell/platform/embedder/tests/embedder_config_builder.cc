@@ -165,6 +165,23 @@ void EmbedderConfigBuilder::SetOpenGLPresentCallBack() {
 #endif
 }
 
+void EmbedderConfigBuilder::SetSoftwarePresentWithInfoCallBack() {
+  // SetSoftwareRendererConfig must be called before this.
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kSoftware);
+  renderer_config_.software.surface_present_with_info_callback =
+      [](void* context, const FlutterSoftwarePresentInfo* present_info) {
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentWithInfo(present_info);
+      };
+}
+
+void EmbedderConfigBuilder::SetSoftwareRendererConfigWithPresentInfo(
+    SkISize surface_size) {
+  SetSoftwareRendererConfig(surface_size);
+  renderer_config_.software.surface_present_callback = nullptr;
+  SetSoftwarePresentWithInfoCallBack();
+}
+
 void EmbedderConfigBuilder::SetRendererConfig(EmbedderTestContextType type,
                                               SkISize surface_size) {
   switch (type) {
@@ -49,6 +49,12 @@ class EmbedderConfigBuilder {
 
   void SetSoftwareRendererConfig(SkISize surface_size = SkISize::Make(1, 1));
 
+  // Sets up a software renderer that presents through
+  // `software.surface_present_with_info_callback` instead of
+  // `software.surface_present_callback`.
+  void SetSoftwareRendererConfigWithPresentInfo(
+      SkISize surface_size = SkISize::Make(1, 1));
+
   void SetOpenGLRendererConfig(SkISize surface_size);
 
   void SetMetalRendererConfig(SkISize surface_size);
@@ -67,6 +73,12 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to explicitly set a `software.surface_present_with_info_callback`.
+  // Using this method will cause your test to fail since the ctor for this
+  // class sets `software.surface_present_callback`. This method exists as a
+  // utility to explicitly test this behavior.
+  void SetSoftwarePresentWithInfoCallBack();
+
   void SetAssetsPath();
 
   void SetSnapshots();
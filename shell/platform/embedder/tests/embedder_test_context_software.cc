@@ -11,6 +11,7 @@
 #include "flutter/shell/platform/embedder/tests/embedder_test_compositor_software.h"
 #include "flutter/testing/testing.h"
 #include "third_party/dart/runtime/bin/elf_loader.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
@@ -30,6 +31,38 @@ bool EmbedderTestContextSoftware::Present(sk_sp<SkImage> image) {
   return true;
 }
 
+bool EmbedderTestContextSoftware::PresentWithInfo(
+    const FlutterSoftwarePresentInfo* present_info) {
+  PresentInfoCallback callback;
+  {
+    std::scoped_lock lock(present_info_callback_mutex_);
+    callback = present_info_callback_;
+  }
+
+  if (callback) {
+    callback(*present_info);
+  }
+
+  auto image_info = SkImageInfo::MakeN32Premul(
+      SkISize::Make(present_info->row_bytes / 4, present_info->height));
+  SkBitmap bitmap;
+  if (!bitmap.installPixels(image_info,
+                            const_cast<void*>(present_info->allocation),
+                            present_info->row_bytes)) {
+    FML_LOG(ERROR) << "Could not copy pixels for the software "
+                      "composition from the engine.";
+    return false;
+  }
+  bitmap.setImmutable();
+  return Present(SkImage::MakeFromBitmap(bitmap));
+}
+
+void EmbedderTestContextSoftware::SetPresentInfoCallback(
+    PresentInfoCallback callback) {
+  std::scoped_lock lock(present_info_callback_mutex_);
+  present_info_callback_ = callback;
+}
+
 size_t EmbedderTestContextSoftware::GetSurfacePresentCount() const {
   return software_surface_present_count_;
 }
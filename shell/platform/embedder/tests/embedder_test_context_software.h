@@ -12,6 +12,9 @@ namespace testing {
 
 class EmbedderTestContextSoftware : public EmbedderTestContext {
  public:
+  using PresentInfoCallback =
+      std::function<void(const FlutterSoftwarePresentInfo& present_info)>;
+
   explicit EmbedderTestContextSoftware(std::string assets_path = "");
 
   ~EmbedderTestContextSoftware() override;
@@ -23,15 +26,36 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(sk_sp<SkImage> image);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets a callback that will be invoked (on the raster task
+  ///             runner) when the engine presents a buffer through
+  ///             `software.surface_present_with_info_callback`.
+  ///
+  /// @attention  The callback will be invoked on the raster task runner. The
+  ///             callback can be set on the tests host thread.
+  ///
+  /// @param[in]  callback  The callback to set. The previous callback will be
+  ///                       un-registered.
+  ///
+  void SetPresentInfoCallback(PresentInfoCallback callback);
+
  protected:
   virtual void SetupCompositor() override;
 
  private:
+  // This allows the builder to access the hooks.
+  friend class EmbedderConfigBuilder;
+
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
+  std::mutex present_info_callback_mutex_;
+  PresentInfoCallback present_info_callback_;
+
   void SetupSurface(SkISize surface_size) override;
 
+  bool PresentWithInfo(const FlutterSoftwarePresentInfo* present_info);
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextSoftware);
 };
 
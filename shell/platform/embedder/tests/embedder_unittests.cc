@@ -74,6 +74,110 @@ TEST_F(EmbedderTest, CanLaunchAndShutdownWithValidProjectArgs) {
   engine.reset();
 }
 
+TEST_F(EmbedderTest, MustNotRunWithBothSoftwarePresentCallbacksSet) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetSoftwarePresentWithInfoCallBack();
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+// Launches the `render_partial_update` entrypoint, which renders two frames
+// that only differ in the color of a 50x50 box at (100, 100), and calls
+// |callback| with the present info of each frame.
+static void RenderPartialUpdate(
+    EmbedderTestContextSoftware& context,
+    const std::function<void(int frame,
+                             const FlutterSoftwarePresentInfo& present_info)>&
+        callback) {
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfigWithPresentInfo(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_partial_update");
+
+  int frame = 0;
+  fml::CountDownLatch latch(2);
+  context.SetPresentInfoCallback(
+      [&](const FlutterSoftwarePresentInfo& present_info) {
+        if (frame < 2) {
+          callback(frame++, present_info);
+          latch.CountDown();
+        }
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  latch.Wait();
+  context.SetPresentInfoCallback(nullptr);
+}
+
+TEST_F(EmbedderTest, SoftwarePresentInfoReportsFrameDamage) {
+  auto& context = static_cast<EmbedderTestContextSoftware&>(
+      GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+
+  std::vector<std::vector<SkIRect>> damage(2);
+  RenderPartialUpdate(
+      context, [&](int frame, const FlutterSoftwarePresentInfo& present_info) {
+        ASSERT_EQ(present_info.struct_size,
+                  sizeof(FlutterSoftwarePresentInfo));
+        ASSERT_EQ(present_info.height, 600u);
+        for (size_t i = 0; i < present_info.damage_count; i++) {
+          const FlutterRect& rect = present_info.damage[i];
+          damage[frame].push_back(SkIRect::MakeLTRB(rect.left, rect.top,
+                                                    rect.right, rect.bottom));
+        }
+      });
+
+  // Nothing was rendered into the backing store before the first frame.
+  ASSERT_EQ(damage[0].size(), 1u);
+  EXPECT_EQ(damage[0][0], SkIRect::MakeWH(800, 600));
+
+  // The second frame only changes the box, give or take the antialiasing
+  // fringe of its bounds.
+  ASSERT_EQ(damage[1].size(), 1u);
+  EXPECT_TRUE(damage[1][0].contains(SkIRect::MakeXYWH(100, 100, 50, 50)));
+  EXPECT_TRUE(SkIRect::MakeXYWH(98, 98, 54, 54).contains(damage[1][0]));
+}
+
+TEST_F(EmbedderTest, SoftwarePartialRepaintKeepsPixelsOutsideTheDamage) {
+  auto& context = static_cast<EmbedderTestContextSoftware&>(
+      GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+
+  const void* allocations[2] = {};
+  SkColor marker_color = SK_ColorTRANSPARENT;
+  SkColor box_color = SK_ColorTRANSPARENT;
+  RenderPartialUpdate(
+      context, [&](int frame, const FlutterSoftwarePresentInfo& present_info) {
+        allocations[frame] = present_info.allocation;
+        SkPixmap pixmap(SkImageInfo::MakeN32Premul(
+                            present_info.row_bytes / 4, present_info.height),
+                        present_info.allocation, present_info.row_bytes);
+        if (frame == 0) {
+          // Mark a pixel far from the box. It is only kept if the second
+          // frame repaints nothing but the damaged area.
+          *pixmap.writable_addr32(700, 500) =
+              SkPreMultiplyColor(SK_ColorGREEN);
+        } else {
+          marker_color = pixmap.getColor(700, 500);
+          box_color = pixmap.getColor(125, 125);
+        }
+      });
+
+  // The second frame is rendered into the backing store of the first.
+  EXPECT_EQ(allocations[0], allocations[1]);
+  EXPECT_EQ(marker_color, SK_ColorGREEN);
+  EXPECT_EQ(box_color, SK_ColorBLUE);
+}
+
 // TODO(41999): Disabled because flaky.
 TEST_F(EmbedderTest, DISABLED_CanLaunchAndShutdownMultipleTimes) {
   EmbedderConfigBuilder builder(
@@ -1776,6 +1880,25 @@ TEST_F(EmbedderTest, CanScheduleFrame) {
   check_latch.Wait();
 }
 
+TEST_F(EmbedderTest, CanGetFrameTimingSummary) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineGetFrameTimingSummary(engine.get(), nullptr),
+            kInvalidArguments);
+
+  FlutterFrameTimingSummary summary = {};
+  summary.struct_size = sizeof(FlutterFrameTimingSummary);
+  ASSERT_EQ(FlutterEngineGetFrameTimingSummary(engine.get(), &summary),
+            kSuccess);
+  ASSERT_EQ(summary.window_duration, 10000000000u);
+  ASSERT_LE(summary.window_start + summary.window_duration,
+            FlutterEngineGetCurrentTime());
+}
+
 #if defined(FML_OS_MACOSX)
 
 static void MockThreadConfigSetter(const fml::Thread::ThreadConfig& config) {
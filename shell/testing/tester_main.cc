@@ -99,7 +99,8 @@ class TesterPlatformView : public PlatformView,
   }
 
   // |GPUSurfaceSoftwareDelegate|
-  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store,
+                           const std::optional<SkIRect>& damage) override {
     return true;
   }
 
@@ -8,8 +8,6 @@ import argparse
 import csv
 import json
 import sys
-import matplotlib.pyplot as plt
-from matplotlib.backends.backend_pdf import PdfPages as pdfp
 
 class BenchmarkResult:
   def __init__(self, name, backend, timeUnit, drawCallCount):
@@ -52,6 +50,8 @@ class BenchmarkResult:
     self.seriesLabels[family] = label
 
   def plot(self):
+    import matplotlib.pyplot as plt
+
     figures = []
     figures.append(plt.figure(dpi=1200, frameon=False, figsize=(11, 8.5)))
 
@@ -132,9 +132,32 @@ def main():
                       help='Filename to output the PDF of graphs to.')
   parser.add_argument('-c', '--output-csv', dest='outputCSV', action='store', default='output.csv',
                       help='Filename to output the CSV data to.')
+  parser.add_argument('-t', '--cost-table', dest='costTable', action='store', default=None,
+                      help='Filename to output a table of the measured op costs to. The table can be '
+                      'passed to the engine with --complexity-cost-table to have the raster cache '
+                      'use these costs when deciding what to cache.')
+  parser.add_argument('--write-baseline', dest='writeBaseline', action='store', default=None,
+                      help='Filename to save the measured time and counters of each benchmark to, '
+                      'for later runs to be compared against with --baseline.')
+  parser.add_argument('-b', '--baseline', dest='baseline', action='store', default=None,
+                      help='Filename of a baseline saved with --write-baseline. Every benchmark '
+                      'metric that regressed by more than the threshold is reported and the '
+                      'script exits with an error.')
+  parser.add_argument('--threshold', dest='threshold', action='store', type=float, default=0.05,
+                      help='The fraction by which a metric may exceed its baseline before it is '
+                      'reported as a regression. Defaults to 0.05.')
 
   args = parser.parse_args()
   jsonData = parseJSON(args.filename)
+  if args.costTable is not None:
+    writeCostTable(jsonData, args.costTable)
+  if args.writeBaseline is not None or args.baseline is not None:
+    metrics = extractMetrics(jsonData)
+    if args.writeBaseline is not None:
+      writeBaseline(metrics, args.writeBaseline)
+    if args.baseline is not None:
+      return compareToBaseline(metrics, args.baseline, args.threshold)
+    return 0
   return processBenchmarkData(jsonData, args.outputPDF, args.outputCSV)
 
 def error(message):
@@ -159,7 +182,110 @@ def extractAttributesLabel(benchmarkResult):
 
   return label[:-2]
 
+NANOSECONDS_PER_UNIT = { 'ns': 1, 'us': 1e3, 'ms': 1e6, 's': 1e9 }
+
+def fitCost(points):
+  # Least squares fit of time = fixed + perUnit * units, where neither
+  # coefficient may be negative.
+  n = len(points)
+  meanX = sum(x for x, _ in points) / n
+  meanY = sum(y for _, y in points) / n
+  varianceX = sum((x - meanX) ** 2 for x, _ in points)
+  if varianceX == 0:
+    return max(meanY, 0), 0
+  perUnit = sum((x - meanX) * (y - meanY) for x, y in points) / varianceX
+  fixed = meanY - perUnit * meanX
+  if perUnit < 0:
+    return max(meanY, 0), 0
+  if fixed < 0:
+    sumXX = sum(x * x for x, _ in points)
+    return 0, sum(x * y for x, y in points) / sumXX
+  return fixed, perUnit
+
+def writeCostTable(benchmarkJSON, outputFile):
+  # Benchmarks that measure an entry of the cost table are labeled with
+  # the entry, e.g. "Software DrawRect Fill AA", and record the number of
+  # calls to the op and their total cost units as counters.
+  # See DisplayListCostTable in display_list_complexity_calibrated.h.
+  entries = {}
+  for benchmarkResult in benchmarkJSON:
+    if 'aggregate_name' in benchmarkResult:
+      continue
+    if 'CostCalls' not in benchmarkResult or 'label' not in benchmarkResult:
+      continue
+    calls = benchmarkResult['CostCalls']
+    if calls <= 0:
+      continue
+    timeNs = benchmarkResult['real_time'] * NANOSECONDS_PER_UNIT[benchmarkResult['time_unit']]
+    point = (benchmarkResult['CostUnits'] / calls, timeNs / calls)
+    entries.setdefault(benchmarkResult['label'], []).append(point)
+
+  with open(outputFile, 'w') as table:
+    table.write('# <backend> <op> <style> <AA|NoAA> <fixed ns> <ns per unit>\n')
+    for label in sorted(entries):
+      fixed, perUnit = fitCost(entries[label])
+      table.write('%s %.6g %.6g\n' % (label, fixed, perUnit))
+
+# The metrics that are saved in a baseline, where a larger value is
+# worse. The counters are reported by the software backend, see
+# CpuCounters in display_list_benchmarks_cpu_counters.h, and are left
+# out of benchmarks that don't measure them.
+BASELINE_COUNTERS = ['Instructions', 'CacheMisses', 'Allocations', 'AllocatedBytes']
+
+def extractMetrics(benchmarkJSON):
+  metrics = {}
+  for benchmarkResult in benchmarkJSON:
+    if 'aggregate_name' in benchmarkResult:
+      continue
+    timeNs = benchmarkResult['real_time'] * NANOSECONDS_PER_UNIT[benchmarkResult['time_unit']]
+    values = { 'real_time_ns': timeNs }
+    for counter in BASELINE_COUNTERS:
+      if counter in benchmarkResult:
+        values[counter] = benchmarkResult[counter]
+    metrics[benchmarkResult['name']] = values
+  return metrics
+
+def writeBaseline(metrics, outputFile):
+  with open(outputFile, 'w') as baseline:
+    json.dump({ 'benchmarks': metrics }, baseline, indent=2, sort_keys=True)
+    baseline.write('\n')
+
+def compareToBaseline(metrics, baselineFile, threshold):
+  try:
+    with open(baselineFile, 'r') as baseline:
+      baselineMetrics = json.load(baseline)['benchmarks']
+  except (OSError, ValueError, KeyError):
+    error('Unable to load baseline.')
+
+  regressions = []
+  for name in sorted(metrics):
+    if name not in baselineMetrics:
+      print('New benchmark (no baseline): %s' % name)
+      continue
+    for metric, value in sorted(metrics[name].items()):
+      if metric not in baselineMetrics[name]:
+        continue
+      expected = baselineMetrics[name][metric]
+      if value > expected * (1 + threshold):
+        regressions.append((name, metric, expected, value))
+
+  for name in sorted(baselineMetrics):
+    if name not in metrics:
+      print('Missing benchmark (in baseline only): %s' % name)
+
+  if not regressions:
+    print('No regressions beyond %.1f%% in %d benchmarks.' % (threshold * 100, len(metrics)))
+    return 0
+
+  print('Regressions beyond %.1f%%:' % (threshold * 100))
+  for name, metric, expected, value in regressions:
+    change = (value / expected - 1) * 100 if expected > 0 else float('inf')
+    print('  %s %s: %.6g -> %.6g (+%.1f%%)' % (name, metric, expected, value, change))
+  return 1
+
 def processBenchmarkData(benchmarkJSON, outputPDF, outputCSV):
+  from matplotlib.backends.backend_pdf import PdfPages as pdfp
+
   benchmarkResultsData = {}
 
   for benchmarkResult in benchmarkJSON:
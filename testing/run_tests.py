@@ -260,11 +260,16 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter, icu_flags)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter, icu_flags)
 
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter, icu_flags)
 
+  if IsMac():
+    RunEngineExecutable(build_dir, 'impeller_benchmarks', filter, icu_flags)
+
 
 def RunDartTest(build_dir, test_packages, dart_file, verbose_dart_snapshot, multithreaded,
                 enable_observatory=False, expect_failure=False):